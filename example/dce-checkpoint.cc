@@ -0,0 +1,82 @@
+#include "ns3/network-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/dce-module.h"
+#include <sys/wait.h>
+#include <stdlib.h>
+
+using namespace ns3;
+
+// Warm up once, then run one variant of the end of the simulation per
+// client start time, each in its own directory: run-<time>/files-0.
+int main (int argc, char *argv[])
+{
+  std::string times = "5,10,20";
+  CommandLine cmd;
+  cmd.AddValue ("times", "the start times of the client in the variants", times);
+  cmd.Parse (argc, argv);
+
+  // the fibers have to survive a fork.
+  Config::SetDefault ("ns3::TaskManager::FiberManagerType", StringValue ("UcontextFiberManager"));
+
+  NodeContainer nodes;
+  nodes.Create (1);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+
+  DceManagerHelper dceManager;
+  dceManager.Install (nodes);
+
+  DceApplicationHelper dce;
+  ApplicationContainer apps;
+
+  dce.SetStackSize (1 << 20);
+
+  dce.SetBinary ("udp-server");
+  dce.ResetArguments ();
+  apps = dce.Install (nodes.Get (0));
+  apps.Start (Seconds (1.0));
+
+  // the warm up.
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  DceCheckpointHelper checkpoint;
+  checkpoint.Checkpoint ("checkpoint");
+  if (!checkpoint.IsRestored ())
+    {
+      std::vector<pid_t> pids;
+      std::string::size_type start = 0;
+      while (start < times.size ())
+        {
+          std::string::size_type end = times.find (',', start);
+          std::string time = times.substr (start, end - start);
+          pids.push_back (checkpoint.Restore ("run-" + time, time));
+          start = (end == std::string::npos) ? times.size () : end + 1;
+        }
+      int failures = 0;
+      for (std::vector<pid_t>::iterator i = pids.begin (); i != pids.end (); ++i)
+        {
+          int status = checkpoint.Wait (*i);
+          if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+            {
+              failures++;
+            }
+        }
+      checkpoint.Release ();
+      return failures;
+    }
+
+  dce.SetBinary ("udp-client");
+  dce.ResetArguments ();
+  dce.AddArgument ("127.0.0.1");
+  apps = dce.Install (nodes.Get (0));
+  apps.Start (Seconds (atof (checkpoint.GetArguments ().c_str ())));
+
+  Simulator::Stop (Seconds (1000100.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  return 0;
+}
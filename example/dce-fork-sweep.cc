@@ -0,0 +1,65 @@
+#include "ns3/network-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/dce-module.h"
+#include <sys/wait.h>
+#include <iostream>
+
+using namespace ns3;
+
+static DceApplicationHelper g_dce;
+static NodeContainer g_nodes;
+
+// in variant i, the client starts i seconds after the fork.
+static void
+StartClient (uint32_t i)
+{
+  g_dce.SetBinary ("udp-client");
+  g_dce.ResetArguments ();
+  g_dce.AddArgument ("127.0.0.1");
+  ApplicationContainer apps = g_dce.Install (g_nodes.Get (0));
+  apps.Start (Seconds (1.0 + i));
+}
+
+// Warm up once, then run the variants in parallel, in sweep-0, sweep-1, ...
+int main (int argc, char *argv[])
+{
+  uint32_t variants = 4;
+  CommandLine cmd;
+  cmd.AddValue ("variants", "the number of variants", variants);
+  cmd.Parse (argc, argv);
+
+  // the fibers have to survive a fork.
+  Config::SetDefault ("ns3::TaskManager::FiberManagerType", StringValue ("UcontextFiberManager"));
+
+  g_nodes.Create (1);
+
+  InternetStackHelper stack;
+  stack.Install (g_nodes);
+
+  DceManagerHelper dceManager;
+  dceManager.Install (g_nodes);
+
+  g_dce.SetStackSize (1 << 20);
+  g_dce.SetBinary ("udp-server");
+  g_dce.ResetArguments ();
+  ApplicationContainer apps = g_dce.Install (g_nodes.Get (0));
+  apps.Start (Seconds (1.0));
+
+  DceManagerHelper::ForkSweep (Seconds (2.0), variants, MakeCallback (&StartClient));
+
+  Simulator::Stop (Seconds (1000100.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  if (DceManagerHelper::GetSweepIndex () == -1)
+    {
+      std::vector<int> status = DceManagerHelper::GetSweepStatus ();
+      for (uint32_t i = 0; i < status.size (); i++)
+        {
+          std::cout << "variant " << i << ": "
+                    << (WIFEXITED (status[i]) ? WEXITSTATUS (status[i]) : -1) << std::endl;
+        }
+    }
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include "ns3/network-module.h"
+#include "ns3/core-module.h"
+#include "ns3/dce-module.h"
+
+using namespace ns3;
+
+// Runs local-socket-bench on one node: the throughput of the AF_UNIX
+// sockets is written to files-0/var/log/<pid>/stdout.
+int main (int argc, char *argv[])
+{
+  uint32_t megabytes = 16;
+  CommandLine cmd;
+  cmd.AddValue ("megabytes", "Number of megabytes sent through each socket", megabytes);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (1);
+
+  DceManagerHelper dceManager;
+  dceManager.Install (nodes);
+
+  DceApplicationHelper dce;
+  ApplicationContainer apps;
+
+  std::ostringstream oss;
+  oss << "--megabytes=" << megabytes;
+  dce.SetBinary ("local-socket-bench");
+  dce.SetStackSize (1 << 20);
+  dce.AddArgument (oss.str ());
+  apps = dce.Install (nodes.Get (0));
+  apps.Start (Seconds (1.0));
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  return 0;
+}
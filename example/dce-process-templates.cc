@@ -0,0 +1,58 @@
+#include "ns3/network-module.h"
+#include "ns3/core-module.h"
+#include "ns3/dce-module.h"
+#include <iostream>
+
+using namespace ns3;
+
+// How much the ProcessTemplates attribute of the DceManager speeds up the
+// start of processes: Processes runs of libc-bench, one call of each
+// function, are started on one node. The host time is mostly their
+// startup:
+//
+//   ./waf --run "dce-process-templates --Processes=500 --Templates=0"
+//   ./waf --run "dce-process-templates --Processes=500 --Templates=1"
+int main (int argc, char *argv[])
+{
+  uint32_t processes = 100;
+  bool templates = true;
+  CommandLine cmd;
+  cmd.AddValue ("Processes", "Number of processes started", processes);
+  cmd.AddValue ("Templates", "Start the processes from a process template", templates);
+  cmd.Parse (argc, argv);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+
+  NodeContainer nodes;
+  nodes.Create (1);
+
+  DceManagerHelper dceManager;
+  dceManager.SetLoader ("ns3::CoojaLoaderFactory");
+  dceManager.SetAttribute ("ProcessTemplates", BooleanValue (templates));
+  dceManager.Install (nodes);
+
+  DceApplicationHelper dce;
+  ApplicationContainer apps;
+
+  dce.SetBinary ("libc-bench");
+  dce.SetStackSize (1 << 20);
+  dce.AddArgument ("--iterations=1");
+  for (uint32_t i = 0; i < processes; i++)
+    {
+      apps = dce.Install (nodes.Get (0));
+      apps.Start (Seconds (1.0 + i * 0.001));
+    }
+
+  Simulator::Stop (Seconds (1000.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  clock.End ();
+  double elapsedMs = clock.GetElapsedReal ();
+  std::cout << "templates,processes,wall(s),per process(ms)" << std::endl;
+  std::cout << templates << "," << processes << "," << elapsedMs / 1000.0
+            << "," << elapsedMs / processes << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Measures the host cost of one call to some functions of the DCE libc.
+ *
+ * The time is the host cpu time given by getrusage (a NATIVE function)
+ * since the simulated time does not move while the process computes.
+ * Two local trampolines to an empty function give the cost of the
+ * stubs of libc.cc: one copies the argument frame with __builtin_apply
+ * as the stubs of the variadic functions still do, the other one is a
+ * typed stub. sched_yield with a second thread ready to run measures
+ * a task switch there and back, signal check included. The reads of
+ * /dev/urandom give the cost of its keystream. The pipe filters move
+ * 64KB from a pipe to another, as the middle of cat | filter | cat,
+ * with read and write or with splice.
+ *
+ * usage: libc-bench [--iterations=N]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+extern "C" {
+// Same frame size as the trampolines of libc.cc
+#define GCC_BT_NUM_ARGS 128
+
+static void (*g_empty_untyped) (...);
+static int (*g_empty_typed) (int, const void *, size_t);
+
+static int __attribute__ ((noinline)) empty (int a, const void *b, size_t c)
+{
+  asm volatile ("" : : "r" (a), "r" (b), "r" (c) : "memory");
+  return a;
+}
+
+void __attribute__ ((noinline)) untyped_stub (...)
+{
+  void *args = __builtin_apply_args ();
+  void *result = __builtin_apply (g_empty_untyped, args, GCC_BT_NUM_ARGS);
+  __builtin_return (result);
+}
+
+int __attribute__ ((noinline)) typed_stub (int a, const void *b, size_t c)
+{
+  return g_empty_typed (a, b, c);
+}
+}
+
+static uint64_t cpu_ns (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL
+         + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
+static volatile bool g_yielding;
+
+static void *yielder (void *)
+{
+  while (g_yielding)
+    {
+      sched_yield ();
+    }
+  return 0;
+}
+
+static void report (const char *name, uint64_t start, long iterations)
+{
+  double ns = (double)(cpu_ns () - start) / iterations;
+  printf ("%-24s %10.1f ns/call\n", name, ns);
+}
+
+#define BENCH(name, statement)                  \
+  {                                             \
+    uint64_t start = cpu_ns ();                 \
+    for (long i = 0; i < iterations; i++)       \
+      {                                         \
+        statement;                              \
+      }                                         \
+    report (name, start, iterations);           \
+  }
+
+int main (int argc, char *argv[])
+{
+  long iterations = 1000000;
+  for (int i = 1; i < argc; i++)
+    {
+      if (strncmp (argv[i], "--iterations=", strlen ("--iterations=")) == 0)
+        {
+          iterations = atol (argv[i] + strlen ("--iterations="));
+        }
+    }
+  g_empty_untyped = (void (*) (...)) empty;
+  g_empty_typed = empty;
+
+  char src[64];
+  char dst[64];
+  memset (src, 'a', sizeof (src) - 1);
+  src[sizeof (src) - 1] = 0;
+  volatile size_t sink = 0;
+  pthread_mutex_t mutex;
+  pthread_mutex_init (&mutex, 0);
+  struct timeval tv;
+
+  printf ("%ld iterations\n", iterations);
+  BENCH ("loop", sink += i);
+  BENCH ("untyped stub", ((int (*) (int, const void *, size_t)) untyped_stub)(i, src, 1));
+  BENCH ("typed stub", typed_stub (i, src, 1));
+  BENCH ("strlen", sink += strlen (src));
+  BENCH ("memcpy(64)", memcpy (dst, src, sizeof (src)); sink += dst[i & 63]);
+  BENCH ("malloc+free(64)", free (malloc (64)));
+  BENCH ("getpid", sink += getpid ());
+  BENCH ("gettimeofday", gettimeofday (&tv, 0));
+  BENCH ("pthread_mutex_lock+unlock", pthread_mutex_lock (&mutex); pthread_mutex_unlock (&mutex));
+  BENCH ("snprintf (variadic)", snprintf (dst, sizeof (dst), "%d", (int)i));
+
+  char buf[4096];
+  int fd = open ("/dev/urandom", O_RDONLY);
+  BENCH ("read urandom(32)", sink += read (fd, buf, 32));
+  BENCH ("read urandom(4096)", sink += read (fd, buf, sizeof (buf)));
+  close (fd);
+
+  static char chunk[65536];
+  int first[2];
+  int second[2];
+  pipe (first);
+  pipe (second);
+  long chunks = iterations / 100 + 1;
+  {
+    long iterations = chunks;
+    BENCH ("pipe filter read+write", write (first[1], chunk, sizeof (chunk));
+           read (first[0], chunk, sizeof (chunk));
+           write (second[1], chunk, sizeof (chunk));
+           sink += read (second[0], chunk, sizeof (chunk)));
+    BENCH ("pipe filter splice", write (first[1], chunk, sizeof (chunk));
+           splice (first[0], 0, second[1], 0, sizeof (chunk), 0);
+           sink += read (second[0], chunk, sizeof (chunk)));
+  }
+  close (first[0]);
+  close (first[1]);
+  close (second[0]);
+  close (second[1]);
+
+  pthread_t thread;
+  g_yielding = true;
+  pthread_create (&thread, 0, yielder, 0);
+  BENCH ("sched_yield (2 threads)", sched_yield ());
+  g_yielding = false;
+  pthread_join (thread, 0);
+
+  pthread_mutex_destroy (&mutex);
+  return 0;
+}
@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/dce-module.h"
+#include "ns3/mpi-interface.h"
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+// Run Hint :  $ mpirun -np 4 linear-udp-perf-mpi --Size=64
+//
+// linear-udp-perf, partitioned: the chain of Size nodes is split between
+// the ranks of mpirun by DceMpiHelper, each rank a host process which
+// runs its nodes with their own loaders, kernels and allocators. The
+// client is the first node, the udp-perf server the last one; the rank
+// of the server prints the result. The ranks look ahead by Delay, the
+// delay of all the links.
+
+static uint16_t g_serverPid = 0;
+
+static void
+ServerStarted (uint16_t pid)
+{
+  g_serverPid = pid;
+}
+
+static std::string
+AsString (uint32_t i)
+{
+  std::ostringstream oss;
+  oss << i;
+  return oss.str ();
+}
+
+static long
+ReadTotalBytesReceived (uint32_t node)
+{
+  std::ifstream is;
+  std::string filename = "files-" + AsString (node) + "/var/log/" + AsString (g_serverPid) + "/stdout";
+  is.open (filename.c_str (), std::ios_base::in);
+  std::string line, prev;
+  while (getline (is, line))
+    {
+      prev = line;
+    }
+  std::string::size_type i = prev.rfind (" ");
+  NS_ASSERT (i != std::string::npos);
+  long bytes;
+  std::istringstream iss (prev.substr (i + 1));
+  iss >> bytes;
+  return bytes;
+}
+
+int
+main (int argc, char *argv[])
+{
+  MpiInterface::Enable (&argc, &argv);
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DistributedSimulatorImpl"));
+  uint32_t ranks = MpiInterface::GetSize ();
+
+  SystemWallClockMs clock;
+  clock.Start ();
+
+  Time duration = Seconds (10);
+  Time delay = MilliSeconds (1);
+  std::string rate = "5Mbps";
+  uint32_t packetSize = 1000;
+  std::string packetRate = "1000000";
+  uint32_t size = 2;
+  CommandLine cmd;
+  cmd.AddValue ("Duration", "simulation duration", duration);
+  cmd.AddValue ("Delay", "link delay, the lookahead of the ranks", delay);
+  cmd.AddValue ("LinkBandwidth", "link bandwidth", rate);
+  cmd.AddValue ("Size", "number of nodes in the chain", size);
+  cmd.AddValue ("TxPacketSize", "size of packets sent (bytes)", packetSize);
+  cmd.AddValue ("TxBandwidth", "rate at which packets are sent (in bytes per second)", packetRate);
+  cmd.Parse (argc, argv);
+  if (size < 2)
+    {
+      std::cout << "This simulation requires 2 nodes at least." << std::endl;
+      return 1;
+    }
+
+  DceMpiHelper mpi;
+  for (uint32_t i = 0; i + 1 < size; i++)
+    {
+      mpi.AddLink (i, i + 1, delay);
+    }
+  NodeContainer nodes = mpi.Create (size, ranks);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue (rate));
+  p2p.SetChannelAttribute ("Delay", TimeValue (delay));
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer interfaces;
+  for (uint32_t i = 0; i + 1 < size; i++)
+    {
+      NetDeviceContainer devices = p2p.Install (nodes.Get (i), nodes.Get (i + 1));
+      interfaces = address.Assign (devices);
+      address.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  DceManagerHelper dceManager;
+  dceManager.Install (nodes);
+
+  DceApplicationHelper process;
+  ApplicationContainer apps;
+  process.SetStackSize (1 << 16);
+  process.SetBinary ("udp-perf");
+
+  std::ostringstream server;
+  interfaces.GetAddress (1).Print (server);
+  process.AddArgument ("--client");
+  process.AddArgument ("--host=" + server.str ());
+  process.AddArgument ("--pktsize=" + AsString (packetSize));
+  process.AddArgument ("--bandwidth=" + packetRate);
+  apps = process.Install (nodes.Get (0));
+  apps.Start (Seconds (4.0));
+
+  process.ResetArguments ();
+  apps = process.Install (nodes.Get (size - 1));
+  apps.Start (Seconds (4.0));
+  // empty if the server is on another rank.
+  if (apps.GetN () > 0)
+    {
+      apps.Get (0)->TraceConnectWithoutContext ("ProcessStarted", MakeCallback (&ServerStarted));
+    }
+
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  clock.End ();
+  if (DceMpiHelper::IsLocal (nodes.Get (size - 1)))
+    {
+      double elapsedMs = clock.GetElapsedReal ();
+      double pps = ReadTotalBytesReceived (size - 1) / (double) packetSize / elapsedMs * 1000.0;
+      // no link is cut on one rank.
+      Time lookahead = mpi.GetLookahead (mpi.Partition (size, ranks));
+      std::cout << "ranks,n nodes,lookahead(ms),wall(s),pps" << std::endl;
+      std::cout << ranks << "," << size << ","
+                << (lookahead == Time::Max () ? 0 : lookahead.GetMilliSeconds ())
+                << "," << elapsedMs / 1000.0 << "," << pps << std::endl;
+    }
+
+  MpiInterface::Disable ();
+  return 0;
+}
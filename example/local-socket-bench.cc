@@ -0,0 +1,213 @@
+/*
+ * Throughput of the AF_UNIX sockets: a client thread sends to a server
+ * thread of the same process through a stream and a datagram socket,
+ * the server checks what it receives. The rate is given in host cpu
+ * time since the simulated time does not move while copying.
+ *
+ * usage: local-socket-bench [--megabytes=N]
+ */
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#define CHECK(x)                                                        \
+  do {                                                                  \
+      if (!(x))                                                         \
+        {                                                               \
+          fprintf (stderr, "%s:%d: check failed: %s\n",                 \
+                   __FILE__, __LINE__, # x);                            \
+          exit (1);                                                     \
+        }                                                               \
+    } while (0)
+#define CHECK_EQUAL(a, b) CHECK ((a) == (b))
+
+#define STREAM_PATH "/tmp/bench-stream"
+#define DGRAM_PATH "/tmp/bench-dgram"
+#define CHUNK 65536
+#define DGRAM_SIZE 1024
+
+static size_t g_total = 16 * 1024 * 1024;
+
+static uint64_t cpu_ns (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL
+         + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
+static void report (const char *name, uint64_t start, size_t bytes)
+{
+  double s = (cpu_ns () - start) / 1e9;
+  printf ("%-24s %10.1f MB/s\n", name, (s > 0) ? bytes / s / 1e6 : 0.0);
+}
+
+static void fill (uint8_t *buf, size_t len, size_t offset)
+{
+  for (size_t i = 0; i < len; i++)
+    {
+      buf[i] = (uint8_t)((offset + i) % 251);
+    }
+}
+
+static struct sockaddr_un address (const char *path)
+{
+  struct sockaddr_un addr;
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, path);
+  return addr;
+}
+
+static void *
+stream_client (void *arg)
+{
+  sleep (1);
+  int sock = socket (AF_UNIX, SOCK_STREAM, 0);
+  CHECK (sock >= 0);
+  struct sockaddr_un addr = address (STREAM_PATH);
+  int status = connect (sock, (struct sockaddr *) &addr, SUN_LEN (&addr));
+  CHECK_EQUAL (status, 0);
+
+  uint8_t *buf = (uint8_t *) malloc (CHUNK);
+  for (size_t sent = 0; sent < g_total; )
+    {
+      size_t len = (g_total - sent < CHUNK) ? g_total - sent : CHUNK;
+      fill (buf, len, sent);
+      ssize_t ret = write (sock, buf, len);
+      CHECK (ret > 0);
+      sent += ret;
+    }
+  free (buf);
+  close (sock);
+  return arg;
+}
+
+static void *
+stream_server (void *arg)
+{
+  unlink (STREAM_PATH);
+  int sock = socket (AF_UNIX, SOCK_STREAM, 0);
+  CHECK (sock >= 0);
+  struct sockaddr_un addr = address (STREAM_PATH);
+  int status = bind (sock, (struct sockaddr *) &addr, SUN_LEN (&addr));
+  CHECK_EQUAL (status, 0);
+  status = listen (sock, 1);
+  CHECK_EQUAL (status, 0);
+  int sockin = accept (sock, NULL, NULL);
+  CHECK (sockin >= 0);
+
+  uint8_t *buf = (uint8_t *) malloc (CHUNK);
+  uint8_t *expected = (uint8_t *) malloc (CHUNK);
+  uint64_t start = cpu_ns ();
+  size_t received = 0;
+  while (received < g_total)
+    {
+      size_t len = (g_total - received < CHUNK) ? g_total - received : CHUNK;
+      ssize_t ret = read (sockin, buf, len);
+      CHECK (ret > 0);
+      fill (expected, ret, received);
+      CHECK_EQUAL (memcmp (buf, expected, ret), 0);
+      received += ret;
+    }
+  report ("stream", start, received);
+  free (expected);
+  free (buf);
+  close (sockin);
+  close (sock);
+  unlink (STREAM_PATH);
+  return arg;
+}
+
+static void *
+dgram_client (void *arg)
+{
+  sleep (1);
+  int sock = socket (AF_UNIX, SOCK_DGRAM, 0);
+  CHECK (sock >= 0);
+  struct sockaddr_un addr = address (DGRAM_PATH);
+  int status = connect (sock, (struct sockaddr *) &addr, SUN_LEN (&addr));
+  CHECK_EQUAL (status, 0);
+
+  uint8_t buf[DGRAM_SIZE];
+  for (size_t i = 0; i < g_total / DGRAM_SIZE; i++)
+    {
+      fill (buf, sizeof (buf), i);
+      ssize_t ret = send (sock, buf, sizeof (buf), 0);
+      CHECK_EQUAL (ret, sizeof (buf));
+    }
+  close (sock);
+  return arg;
+}
+
+static void *
+dgram_server (void *arg)
+{
+  unlink (DGRAM_PATH);
+  int sock = socket (AF_UNIX, SOCK_DGRAM, 0);
+  CHECK (sock >= 0);
+  struct sockaddr_un addr = address (DGRAM_PATH);
+  int status = bind (sock, (struct sockaddr *) &addr, SUN_LEN (&addr));
+  CHECK_EQUAL (status, 0);
+
+  // one more byte to see that the datagrams keep their size.
+  uint8_t buf[DGRAM_SIZE + 1];
+  uint8_t expected[DGRAM_SIZE];
+  uint64_t start = cpu_ns ();
+  size_t received = 0;
+  for (size_t i = 0; i < g_total / DGRAM_SIZE; i++)
+    {
+      ssize_t ret = recv (sock, buf, sizeof (buf), 0);
+      CHECK_EQUAL (ret, DGRAM_SIZE);
+      fill (expected, sizeof (expected), i);
+      CHECK_EQUAL (memcmp (buf, expected, sizeof (expected)), 0);
+      received += ret;
+    }
+  report ("datagram", start, received);
+  close (sock);
+  unlink (DGRAM_PATH);
+  return arg;
+}
+
+static void
+launch (void * (*clientStart)(void *), void *(*serverStart)(void *))
+{
+  pthread_t theClient;
+  pthread_t theServer;
+
+  int status = pthread_create (&theServer, NULL, serverStart, 0);
+  CHECK_EQUAL (status, 0);
+  status = pthread_create (&theClient, NULL, clientStart, 0);
+  CHECK_EQUAL (status, 0);
+
+  status = pthread_join (theClient, 0);
+  CHECK_EQUAL (status, 0);
+  status = pthread_join (theServer, 0);
+  CHECK_EQUAL (status, 0);
+}
+
+int
+main (int argc, char *argv[])
+{
+  for (int i = 1; i < argc; i++)
+    {
+      if (strncmp (argv[i], "--megabytes=", strlen ("--megabytes=")) == 0)
+        {
+          g_total = atol (argv[i] + strlen ("--megabytes=")) * 1024 * 1024;
+        }
+    }
+  printf ("%lu bytes\n", (unsigned long) g_total);
+  launch (stream_client, stream_server);
+  launch (dgram_client, dgram_server);
+  fflush (stdout);
+  return 0;
+}
@@ -5,6 +5,7 @@
 #include <fstream>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
 NS_LOG_COMPONENT_DEFINE ("CcnClientHelper");
 
@@ -19,34 +20,12 @@ CcnClientHelper::Install (NodeContainer c)
 {
   NS_LOG_FUNCTION (this);
   ApplicationContainer apps;
-  for (NodeContainer::Iterator j = c.Begin (); j != c.End (); ++j)
+  CreateKeystore ();
+  if (!CopyFilesToBase ())
     {
-      int nodeId = (*j)->GetId ();
-      CreateKeystore ();
-      std::stringstream oss;
-
-      oss << "files-" << nodeId << "/root/.ccnx/";
-      UtilsEnsureAllDirectoriesExist (oss.str ());
-      oss << ".ccnx_keystore";
-
-      CopyFile (GetKeystoreTemplate (), oss.str ());
-
-      oss.str ("");
-      oss.clear ();
-
-      oss << "files-" << nodeId;
-      UtilsEnsureDirectoryExists (oss.str ());
-
-      oss << "/var/";
-      UtilsEnsureDirectoryExists (oss.str ());
-
-      oss << "tmp";
-      UtilsEnsureDirectoryExists (oss.str ());
-
-      for (std::vector <std::pair <std::string, std::string> >::iterator i = m_files.begin ();
-           i != m_files.end (); ++i)
+      for (NodeContainer::Iterator j = c.Begin (); j != c.End (); ++j)
         {
-          CopyRealFileToVirtual (nodeId, (*i).first, (*i).second);
+          CopyFilesToNode ((*j)->GetId ());
         }
     }
   return DceApplicationHelper::Install (c);
@@ -57,34 +36,77 @@ CcnClientHelper::InstallInNode (Ptr<Node> node)
 {
   NS_LOG_FUNCTION (this);
   ApplicationContainer apps;
-      int nodeId = node->GetId ();
-      CreateKeystore ();
-      std::stringstream oss;
+  CreateKeystore ();
+  if (!CopyFilesToBase ())
+    {
+      CopyFilesToNode (node->GetId ());
+    }
+  return DceApplicationHelper::InstallInNode (node);
+}
 
-      oss << "files-" << nodeId << "/root/.ccnx/";
-      UtilsEnsureAllDirectoriesExist (oss.str ());
-      oss << ".ccnx_keystore";
+void
+CcnClientHelper::CopyFilesToNode (int nodeId)
+{
+  std::stringstream oss;
 
-      CopyFile (GetKeystoreTemplate (), oss.str ());
+  oss << "files-" << nodeId << "/root/.ccnx/";
+  UtilsEnsureAllDirectoriesExist (oss.str ());
+  oss << ".ccnx_keystore";
 
-      oss.str ("");
-      oss.clear ();
+  CopyFile (GetKeystoreTemplate (), oss.str ());
 
-      oss << "files-" << nodeId;
-      UtilsEnsureDirectoryExists (oss.str ());
+  oss.str ("");
+  oss.clear ();
 
-      oss << "/var/";
-      UtilsEnsureDirectoryExists (oss.str ());
+  oss << "files-" << nodeId;
+  UtilsEnsureDirectoryExists (oss.str ());
 
-      oss << "tmp";
-      UtilsEnsureDirectoryExists (oss.str ());
+  oss << "/var/";
+  UtilsEnsureDirectoryExists (oss.str ());
 
-      for (std::vector <std::pair <std::string, std::string> >::iterator i = m_files.begin ();
-           i != m_files.end (); ++i)
-        {
-          CopyRealFileToVirtual (nodeId, (*i).first, (*i).second);
-        }
-  return DceApplicationHelper::InstallInNode (node);
+  oss << "tmp";
+  UtilsEnsureDirectoryExists (oss.str ());
+
+  for (std::vector <std::pair <std::string, std::string> >::iterator i = m_files.begin ();
+       i != m_files.end (); ++i)
+    {
+      CopyRealFileToVirtual (nodeId, (*i).first, (*i).second);
+    }
+}
+
+bool
+CcnClientHelper::CopyFilesToBase (void)
+{
+  // The files are the same for every node: with a base layer
+  // (DceFilesBase) they are copied there once and shared by the nodes.
+  std::string base = UtilsGetBaseFilePath ("/");
+  if (base.empty ())
+    {
+      return false;
+    }
+  UtilsEnsureAllDirectoriesExist (base + "root/.ccnx/");
+  CopyFileIfNewer (GetKeystoreTemplate (), base + "root/.ccnx/.ccnx_keystore");
+  UtilsEnsureAllDirectoriesExist (base + "var/tmp/");
+  for (std::vector <std::pair <std::string, std::string> >::iterator i = m_files.begin ();
+       i != m_files.end (); ++i)
+    {
+      std::string to = UtilsGetBaseFilePath ((*i).second);
+      UtilsEnsureAllDirectoriesExist (to);
+      CopyFileIfNewer ((*i).first, to);
+    }
+  return true;
+}
+
+void
+CcnClientHelper::CopyFileIfNewer (std::string from, std::string to)
+{
+  struct stat src, dst;
+  if (::stat (from.c_str (), &src) == 0 && ::stat (to.c_str (), &dst) == 0
+      && src.st_size == dst.st_size && src.st_mtime <= dst.st_mtime)
+    {
+      return;
+    }
+  CopyFile (from, to);
 }
 
 std::string
@@ -30,6 +30,10 @@ private:
   std::vector<std::pair <std::string, std::string> > m_files;
 
   void CopyRealFileToVirtual (int nodeId, std::string from, std::string to);
+  void CopyFilesToNode (int nodeId);
+  // true if the files were copied to the base layer instead of the nodes.
+  bool CopyFilesToBase (void);
+  void CopyFileIfNewer (std::string from, std::string to);
 
 
 };
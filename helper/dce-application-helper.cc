@@ -1,5 +1,6 @@
 #include "dce-application-helper.h"
 #include "dce-application.h"
+#include "dce-mpi-helper.h"
 #include "ns3/log.h"
 #include <stdarg.h>
 
@@ -142,6 +143,10 @@ DceApplicationHelper::InstallInNode (Ptr<Node> node)
 {
   NS_LOG_FUNCTION (this);
   ApplicationContainer apps;
+      if (!DceMpiHelper::IsLocal (node))
+        {
+          return apps;
+        }
       Ptr<DceApplication> dce = CreateObject<DceApplication> ();
       dce->SetBinary (m_filename);
       dce->SetStackSize (m_stackSize);
@@ -167,6 +172,11 @@ DceApplicationHelper::Install (NodeContainer c)
   ApplicationContainer apps;
   for (NodeContainer::Iterator j = c.Begin (); j != c.End (); ++j)
     {
+      if (!DceMpiHelper::IsLocal (*j))
+        {
+          // run by the rank of the node.
+          continue;
+        }
       Ptr<DceApplication> dce = CreateObject<DceApplication> ();
       dce->SetBinary (m_filename);
       dce->SetStackSize (m_stackSize);
@@ -85,6 +85,8 @@ public:
 
   /**
    * Install the configured application into node.
+   * Nothing is installed on the nodes of the other ranks of a distributed
+   * simulation.
    *
    * \param c NodeContainer that run this application.
    */
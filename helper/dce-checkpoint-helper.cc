@@ -0,0 +1,440 @@
+#include "dce-checkpoint-helper.h"
+#include "task-manager.h"
+#include "utils.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+NS_LOG_COMPONENT_DEFINE ("DceCheckpointHelper");
+
+namespace ns3 {
+
+namespace {
+// the files of the simulation copied with the snapshot: those of the
+// nodes, and the exit statuses of their processes, exitprocs-<rank> too.
+bool
+IsSnapshotFile (const char *name)
+{
+  return strncmp (name, "files-", 6) == 0 || strncmp (name, "exitprocs", 9) == 0;
+}
+
+std::string
+AbsolutePath (std::string path, std::string cwd)
+{
+  return (!path.empty () && path[0] == '/') ? path : cwd + "/" + path;
+}
+} // anonymous namespace
+
+DceCheckpointHelper::DceCheckpointHelper ()
+  : m_request (-1),
+    m_reply (-1),
+    m_restored (false)
+{
+}
+
+void
+DceCheckpointHelper::Checkpoint (std::string directory)
+{
+  NS_LOG_FUNCTION (this << directory);
+  NS_ASSERT_MSG (m_request == -1, "Only one snapshot per DceCheckpointHelper");
+  CheckForkSafe ();
+  char cwd[PATH_MAX];
+  if (::getcwd (cwd, sizeof (cwd)) == 0)
+    {
+      NS_FATAL_ERROR ("Could not get the current directory: " << strerror (errno));
+    }
+  m_cwd = cwd;
+  m_snapshot = AbsolutePath (directory, m_cwd);
+  UtilsEnsureAllDirectoriesExist (m_snapshot + "/");
+  // the original goes on writing to files-N: copy them now.
+  CopyFiles (m_cwd, m_snapshot);
+
+  // else what is buffered would be written by each copy.
+  std::cout.flush ();
+  std::cerr.flush ();
+  ::fflush (0);
+
+  int request[2];
+  int reply[2];
+  if (::pipe (request) == -1 || ::pipe (reply) == -1)
+    {
+      NS_FATAL_ERROR ("Could not create the pipes of the checkpoint: " << strerror (errno));
+    }
+  pid_t pid = ::fork ();
+  if (pid == -1)
+    {
+      NS_FATAL_ERROR ("Could not fork the checkpoint: " << strerror (errno));
+    }
+  if (pid == 0)
+    {
+      ::close (request[1]);
+      ::close (reply[0]);
+      m_request = request[0];
+      m_reply = reply[1];
+      Serve ();
+      // in a restored copy.
+      return;
+    }
+  ::close (request[0]);
+  ::close (reply[1]);
+  m_request = request[1];
+  m_reply = reply[0];
+}
+
+void
+DceCheckpointHelper::Serve (void)
+{
+  while (true)
+    {
+      struct Request request;
+      if (!ReadAll (m_request, &request, sizeof (request)))
+        {
+          // the original has exited.
+          ::_exit (0);
+        }
+      switch (request.type)
+        {
+        case RESTORE:
+          {
+            std::vector<char> directory (request.directorySize);
+            std::vector<char> arguments (request.argumentsSize);
+            if (directory.empty () || !ReadAll (m_request, &directory[0], directory.size ())
+                || (!arguments.empty () && !ReadAll (m_request, &arguments[0], arguments.size ())))
+              {
+                ::_exit (1);
+              }
+            std::string path = AbsolutePath (std::string (directory.begin (), directory.end ()), m_cwd);
+            pid_t pid = Fork (path, m_snapshot, m_cwd);
+            if (pid == 0)
+              {
+                ::close (m_request);
+                ::close (m_reply);
+                m_request = -1;
+                m_reply = -1;
+                m_cwd = path;
+                m_restored = true;
+                m_arguments = std::string (arguments.begin (), arguments.end ());
+                return;
+              }
+            WriteAll (m_reply, &pid, sizeof (pid));
+          } break;
+        case WAIT:
+          {
+            int status;
+            if (::waitpid (request.pid, &status, 0) == -1)
+              {
+                status = -1;
+              }
+            WriteAll (m_reply, &status, sizeof (status));
+          } break;
+        case RELEASE:
+          // the copies still running are adopted by init.
+          ::_exit (0);
+          break;
+        }
+    }
+}
+
+pid_t
+DceCheckpointHelper::Fork (std::string directory, std::string files, std::string cwd)
+{
+  NS_LOG_FUNCTION (directory << files << cwd);
+  // else what is buffered would be written by each copy.
+  std::cout.flush ();
+  std::cerr.flush ();
+  ::fflush (0);
+
+  pid_t pid = ::fork ();
+  if (pid != 0)
+    {
+      return pid;
+    }
+  directory = AbsolutePath (directory, cwd);
+  UtilsEnsureAllDirectoriesExist (directory + "/");
+  CopyFiles (files, directory);
+  if (::chdir (directory.c_str ()) == -1)
+    {
+      NS_FATAL_ERROR ("Could not enter " << directory << ": " << strerror (errno));
+    }
+  RemapFds (cwd, directory);
+  return 0;
+}
+
+void
+DceCheckpointHelper::CheckForkSafe (void)
+{
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<TaskManager> taskManager = (*i)->GetObject<TaskManager> ();
+      if (taskManager != 0 && !taskManager->IsForkSafe ())
+        {
+          NS_FATAL_ERROR ("A fork of the simulation needs "
+                          "ns3::TaskManager::FiberManagerType=UcontextFiberManager");
+        }
+    }
+}
+
+void
+DceCheckpointHelper::CopyFiles (std::string from, std::string to)
+{
+  NS_LOG_FUNCTION (from << to);
+  DIR *dir = ::opendir (from.c_str ());
+  if (dir == 0)
+    {
+      NS_FATAL_ERROR ("Could not list " << from << ": " << strerror (errno));
+    }
+  struct dirent *entry;
+  while ((entry = ::readdir (dir)) != 0)
+    {
+      if (IsSnapshotFile (entry->d_name))
+        {
+          CopyTree (from + "/" + entry->d_name, to + "/" + entry->d_name);
+        }
+    }
+  ::closedir (dir);
+}
+
+void
+DceCheckpointHelper::CopyTree (std::string from, std::string to)
+{
+  struct stat st;
+  if (::lstat (from.c_str (), &st) == -1)
+    {
+      return;
+    }
+  if (S_ISDIR (st.st_mode))
+    {
+      ::mkdir (to.c_str (), st.st_mode & 07777);
+      DIR *dir = ::opendir (from.c_str ());
+      if (dir == 0)
+        {
+          return;
+        }
+      struct dirent *entry;
+      while ((entry = ::readdir (dir)) != 0)
+        {
+          if (strcmp (entry->d_name, ".") != 0 && strcmp (entry->d_name, "..") != 0)
+            {
+              CopyTree (from + "/" + entry->d_name, to + "/" + entry->d_name);
+            }
+        }
+      ::closedir (dir);
+    }
+  else if (S_ISLNK (st.st_mode))
+    {
+      char target[PATH_MAX];
+      ssize_t len = ::readlink (from.c_str (), target, sizeof (target) - 1);
+      if (len >= 0)
+        {
+          target[len] = 0;
+          ::symlink (target, to.c_str ());
+        }
+    }
+  else if (S_ISREG (st.st_mode))
+    {
+      int in = ::open (from.c_str (), O_RDONLY);
+      int out = ::open (to.c_str (), O_WRONLY | O_CREAT | O_TRUNC, st.st_mode & 07777);
+      // on the heap, not in the frame of each level of the recursion.
+      std::vector<char> buf (1 << 16);
+      ssize_t len;
+      while (in != -1 && out != -1 && (len = ::read (in, &buf[0], buf.size ())) > 0)
+        {
+          if (!WriteAll (out, &buf[0], len))
+            {
+              NS_LOG_WARN ("could not copy " << from << ": " << strerror (errno));
+              break;
+            }
+        }
+      if (in != -1)
+        {
+          ::close (in);
+        }
+      if (out != -1)
+        {
+          ::close (out);
+        }
+    }
+  // sockets and fifos of the nodes are not on the disk.
+}
+
+void
+DceCheckpointHelper::RemapFds (std::string from, std::string to)
+{
+  DIR *dir = ::opendir ("/proc/self/fd");
+  if (dir == 0)
+    {
+      NS_LOG_WARN ("could not list the fds: " << strerror (errno));
+      return;
+    }
+  std::vector<int> fds;
+  struct dirent *entry;
+  while ((entry = ::readdir (dir)) != 0)
+    {
+      if (entry->d_name[0] != '.' && atoi (entry->d_name) != ::dirfd (dir))
+        {
+          fds.push_back (atoi (entry->d_name));
+        }
+    }
+  ::closedir (dir);
+  std::string prefix = from + "/";
+  for (std::vector<int>::const_iterator i = fds.begin (); i != fds.end (); ++i)
+    {
+      std::ostringstream oss;
+      oss << "/proc/self/fd/" << *i;
+      char target[PATH_MAX];
+      ssize_t len = ::readlink (oss.str ().c_str (), target, sizeof (target) - 1);
+      if (len < 0)
+        {
+          continue;
+        }
+      target[len] = 0;
+      std::string path = target;
+      if (path.compare (0, prefix.size (), prefix) != 0
+          || !IsSnapshotFile (path.c_str () + prefix.size ()))
+        {
+          continue;
+        }
+      std::string copy = to + "/" + path.substr (prefix.size ());
+      int flags = ::fcntl (*i, F_GETFL);
+      int fdFlags = ::fcntl (*i, F_GETFD);
+      off_t offset = ::lseek (*i, 0, SEEK_CUR);
+      int fd = ::open (copy.c_str (), flags & ~(O_CREAT | O_EXCL | O_TRUNC));
+      if (fd == -1)
+        {
+          NS_LOG_WARN ("could not reopen " << copy << ": " << strerror (errno));
+          continue;
+        }
+      if (offset != (off_t) -1)
+        {
+          ::lseek (fd, offset, SEEK_SET);
+        }
+      ::dup2 (fd, *i);
+      ::fcntl (*i, F_SETFD, fdFlags);
+      ::close (fd);
+    }
+}
+
+bool
+DceCheckpointHelper::IsRestored (void) const
+{
+  return m_restored;
+}
+
+std::string
+DceCheckpointHelper::GetArguments (void) const
+{
+  return m_arguments;
+}
+
+pid_t
+DceCheckpointHelper::Restore (std::string directory, std::string arguments)
+{
+  NS_LOG_FUNCTION (this << directory << arguments);
+  NS_ASSERT_MSG (!m_restored && m_request != -1, "No snapshot to restore");
+  struct Request request;
+  memset (&request, 0, sizeof (request));
+  request.type = RESTORE;
+  request.directorySize = directory.size ();
+  request.argumentsSize = arguments.size ();
+  pid_t pid;
+  if (!WriteAll (m_request, &request, sizeof (request))
+      || !WriteAll (m_request, directory.c_str (), directory.size ())
+      || !WriteAll (m_request, arguments.c_str (), arguments.size ())
+      || !ReadAll (m_reply, &pid, sizeof (pid)))
+    {
+      return -1;
+    }
+  return pid;
+}
+
+int
+DceCheckpointHelper::Wait (pid_t pid)
+{
+  NS_LOG_FUNCTION (this << pid);
+  NS_ASSERT_MSG (!m_restored && m_request != -1, "No snapshot to wait for");
+  struct Request request;
+  memset (&request, 0, sizeof (request));
+  request.type = WAIT;
+  request.pid = pid;
+  int status;
+  if (!WriteAll (m_request, &request, sizeof (request))
+      || !ReadAll (m_reply, &status, sizeof (status)))
+    {
+      return -1;
+    }
+  return status;
+}
+
+void
+DceCheckpointHelper::Release (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_restored || m_request == -1)
+    {
+      return;
+    }
+  struct Request request;
+  memset (&request, 0, sizeof (request));
+  request.type = RELEASE;
+  WriteAll (m_request, &request, sizeof (request));
+  ::close (m_request);
+  ::close (m_reply);
+  m_request = -1;
+  m_reply = -1;
+}
+
+bool
+DceCheckpointHelper::ReadAll (int fd, void *buf, size_t size)
+{
+  size_t done = 0;
+  while (done < size)
+    {
+      ssize_t len = ::read (fd, (char *)buf + done, size - done);
+      if (len == -1 && errno == EINTR)
+        {
+          continue;
+        }
+      if (len <= 0)
+        {
+          return false;
+        }
+      done += len;
+    }
+  return true;
+}
+
+bool
+DceCheckpointHelper::WriteAll (int fd, const void *buf, size_t size)
+{
+  size_t done = 0;
+  while (done < size)
+    {
+      ssize_t len = ::write (fd, (const char *)buf + done, size - done);
+      if (len == -1 && errno == EINTR)
+        {
+          continue;
+        }
+      if (len <= 0)
+        {
+          return false;
+        }
+      done += len;
+    }
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,128 @@
+#ifndef DCE_CHECKPOINT_HELPER_H
+#define DCE_CHECKPOINT_HELPER_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \brief Run many variants of an experiment from the state of one
+ *        simulation, after its warm up for example.
+ *
+ * This is not a checkpoint on the disk which another run could restore:
+ * Checkpoint takes an in-process fork snapshot. A child forked from the
+ * host process keeps, in memory shared copy-on-write, the whole state of
+ * the simulation: fiber stacks, heaps, loaded binaries and kernels, fd
+ * tables, pending events. Only the files-N directories are copied aside.
+ * The snapshot lives as long as this child: until Release, or the exit
+ * of the original. Each Restore forks the child again, see Fork, and
+ * the copy resumes in a new directory, where Checkpoint returns with
+ * IsRestored true:
+ *
+ * \code
+ * Simulator::Stop (Seconds (60));
+ * Simulator::Run ();
+ * DceCheckpointHelper checkpoint;
+ * checkpoint.Checkpoint ("warm");
+ * if (!checkpoint.IsRestored ())
+ *   {
+ *     pid_t a = checkpoint.Restore ("run-a", "a");
+ *     pid_t b = checkpoint.Restore ("run-b", "b");
+ *     checkpoint.Wait (a);
+ *     checkpoint.Wait (b);
+ *     checkpoint.Release ();
+ *     return 0;
+ *   }
+ * // here in run-a or run-b.
+ * Configure (checkpoint.GetArguments ());
+ * Simulator::Stop (Seconds (600));
+ * Simulator::Run ();
+ * \endcode
+ *
+ * Checkpoint is called between two Simulator::Run. The tasks must be
+ * ucontext fibers: the FiberManagerType attribute of ns3::TaskManager
+ * set to UcontextFiberManager. The files the nodes have opened in
+ * files-N are reopened in the copy of the new directory; other files of
+ * the host are shared with the other runs. DceManagerHelper::ForkSweep
+ * forks its variants the same way, without a snapshot kept aside.
+ */
+class DceCheckpointHelper
+{
+public:
+  DceCheckpointHelper ();
+
+  /**
+   * \param directory where the files-N of the snapshot are copied.
+   *
+   * Returns in the current process, and in each copy started by Restore.
+   */
+  void Checkpoint (std::string directory);
+  // true in a copy started by Restore.
+  bool IsRestored (void) const;
+  // the arguments given to Restore, in a copy.
+  std::string GetArguments (void) const;
+
+  /**
+   * \param directory the working directory of the copy, created.
+   * \param arguments for GetArguments in the copy.
+   * \returns the pid of the host process of the copy, -1 on error.
+   */
+  pid_t Restore (std::string directory, std::string arguments);
+  /**
+   * \returns the status of waitpid for the copy pid, -1 on error.
+   */
+  int Wait (pid_t pid);
+  // Stop the process which keeps the snapshot.
+  void Release (void);
+
+  // Fail unless the tasks of all the nodes survive a fork of the host.
+  static void CheckForkSafe (void);
+  /**
+   * \param directory where the child goes on, created.
+   * \param files the directory of the files of the simulation to copy,
+   *        files-N and exitprocs.
+   * \param cwd the current directory.
+   * \returns as fork: 0 in the child, which goes on in directory with a
+   *          copy of the files and its fds on them reopened, the pid of
+   *          the child in the parent, -1 on error.
+   */
+  static pid_t Fork (std::string directory, std::string files, std::string cwd);
+
+private:
+  enum RequestType
+  {
+    RESTORE,
+    WAIT,
+    RELEASE
+  };
+  struct Request
+  {
+    enum RequestType type;
+    pid_t pid;
+    uint32_t directorySize;
+    uint32_t argumentsSize;
+  };
+  // in the child which keeps the snapshot: returns in a restored copy.
+  void Serve (void);
+  // Copy the files of the simulation in from, files-N and exitprocs, to to.
+  static void CopyFiles (std::string from, std::string to);
+  // Reopen the fds opened on the files of the simulation in from on their
+  // copies in to.
+  static void RemapFds (std::string from, std::string to);
+  static void CopyTree (std::string from, std::string to);
+  static bool ReadAll (int fd, void *buf, size_t size);
+  static bool WriteAll (int fd, const void *buf, size_t size);
+
+  std::string m_snapshot;
+  std::string m_cwd;
+  int m_request;
+  int m_reply;
+  bool m_restored;
+  std::string m_arguments;
+};
+
+} // namespace ns3
+
+#endif /* DCE_CHECKPOINT_HELPER_H */
@@ -5,6 +5,10 @@
 #include "task-scheduler.h"
 #include "task-manager.h"
 #include "loader-factory.h"
+#include "tmpfs.h"
+#include "dce-checkpoint-helper.h"
+#include "dce-mpi-helper.h"
+#include "utils.h"
 #include "ns3/random-variable.h"
 #include "ns3/uinteger.h"
 #include "ns3/string.h"
@@ -19,12 +23,19 @@
 #include <stdio.h>
 #include <limits.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <string.h>
+#include <iostream>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE ("DceManagerHelper");
 
 namespace ns3 {
 
 UniformVariable g_firstPid;
+static int g_sweepIndex = -1;
+static std::vector<int> g_sweepStatus;
 
 NS_OBJECT_ENSURE_REGISTERED (DceManagerHelper);
 
@@ -98,10 +109,27 @@ DceManagerHelper::SetAttribute (std::string n1, const AttributeValue &v1)
   m_managerFactory.Set (n1, v1);
 }
 void
+DceManagerHelper::AddTmpfs (std::string path,
+                            std::string n0, const AttributeValue &v0,
+                            std::string n1, const AttributeValue &v1)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::Tmpfs");
+  factory.Set (n0, v0);
+  factory.Set (n1, v1);
+  m_tmpfsFactories.push_back (std::make_pair (path, factory));
+}
+void
 DceManagerHelper::Install (NodeContainer nodes)
 {
   for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
     {
+      Ptr<Node> node = *i;
+      if (!DceMpiHelper::IsLocal (node))
+        {
+          // simulated by another rank: no tasks, no kernel, no files-N here.
+          continue;
+        }
       Ptr<DceManager> manager = m_managerFactory.Create<DceManager> ();
       Ptr<TaskManager> taskManager = m_taskManagerFactory.Create<TaskManager> ();
       Ptr<TaskScheduler> scheduler = m_schedulerFactory.Create<TaskScheduler> ();
@@ -112,7 +140,6 @@ DceManagerHelper::Install (NodeContainer nodes)
       taskManager->SetScheduler (scheduler);
       taskManager->SetDelayModel (delay);
       manager->SetAttribute ("FirstPid", UintegerValue (g_firstPid.GetInteger (0, 0xffff)));
-      Ptr<Node> node = *i;
       node->AggregateObject (taskManager);
       node->AggregateObject (loader);
       node->AggregateObject (manager);
@@ -120,6 +147,11 @@ DceManagerHelper::Install (NodeContainer nodes)
       node->AggregateObject (CreateObject<LocalSocketFdFactory> ());
       manager->AggregateObject (CreateObject<DceNodeContext> ());
       manager->SetVirtualPath (GetVirtualPath ());
+      for (std::vector<std::pair<std::string, ObjectFactory> >::iterator j = m_tmpfsFactories.begin ();
+           j != m_tmpfsFactories.end (); ++j)
+        {
+          manager->Mount (j->first, j->second.Create<Tmpfs> ());
+        }
     }
 }
 void
@@ -133,11 +165,73 @@ DceManagerHelper::GetVirtualPath () const
   return m_virtualPath;
 }
 
-std::vector<ProcStatus>
-DceManagerHelper::GetProcStatus (void)
+void
+DceManagerHelper::ForkSweep (Time at, uint32_t n, Callback<void, uint32_t> cb, std::string prefix)
 {
-  FILE *f = fopen ("exitprocs","r");
-  std::vector<ProcStatus> res;
+  Simulator::Schedule (at, &DceManagerHelper::DoForkSweep, n, cb, prefix);
+}
+
+void
+DceManagerHelper::DoForkSweep (uint32_t n, Callback<void, uint32_t> cb, std::string prefix)
+{
+  NS_LOG_FUNCTION (n << prefix);
+  DceCheckpointHelper::CheckForkSafe ();
+  char cwd[PATH_MAX];
+  if (::getcwd (cwd, sizeof (cwd)) == 0)
+    {
+      NS_FATAL_ERROR ("Could not get the current directory: " << strerror (errno));
+    }
+  // -1 for the variants which could not be forked.
+  std::vector<pid_t> pids (n, -1);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      std::ostringstream oss;
+      oss << prefix << i;
+      pid_t pid = DceCheckpointHelper::Fork (oss.str (), cwd, cwd);
+      if (pid == -1)
+        {
+          NS_LOG_ERROR ("Could not fork variant " << i << ": " << strerror (errno));
+          continue;
+        }
+      if (pid == 0)
+        {
+          g_sweepIndex = i;
+          if (!cb.IsNull ())
+            {
+              cb (i);
+            }
+          return;
+        }
+      pids[i] = pid;
+    }
+  for (std::vector<pid_t>::const_iterator i = pids.begin (); i != pids.end (); ++i)
+    {
+      int status = -1;
+      if (*i != -1 && ::waitpid (*i, &status, 0) == -1)
+        {
+          status = -1;
+        }
+      g_sweepStatus.push_back (status);
+    }
+  Simulator::Stop ();
+}
+
+int
+DceManagerHelper::GetSweepIndex (void)
+{
+  return g_sweepIndex;
+}
+
+std::vector<int>
+DceManagerHelper::GetSweepStatus (void)
+{
+  return g_sweepStatus;
+}
+
+static void
+ReadProcStatus (std::string file, std::vector<ProcStatus> &res)
+{
+  FILE *f = fopen (file.c_str (),"r");
 
   if (f)
     {
@@ -255,6 +349,18 @@ DceManagerHelper::GetProcStatus (void)
 
       fclose (f);
     }
+}
+
+std::vector<ProcStatus>
+DceManagerHelper::GetProcStatus (void)
+{
+  std::vector<ProcStatus> res;
+  // exitprocs, then the exitprocs-<rank> of the other ranks of this
+  // run: older ones may be left by a run on more ranks.
+  for (uint32_t rank = 0; rank < UtilsGetSystemCount (); rank++)
+    {
+      ReadProcStatus (UtilsGetExitProcsFile (rank), res);
+    }
 
   return res;
 }
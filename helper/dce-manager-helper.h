@@ -6,7 +6,9 @@
 #include "ns3/object-base.h"
 #include "ns3/node-container.h"
 #include "ns3/nstime.h"
+#include "ns3/callback.h"
 #include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -151,11 +153,26 @@ public:
    */
   void SetAttribute (std::string n1, const AttributeValue &v1);
 
+  /**
+   * \param path the directory of the nodes to keep in memory, /tmp for example
+   * \param n0 the name of the attribute to set to the ns3::Tmpfs
+   * \param v0 the value of the attribute to set to the ns3::Tmpfs
+   * \param n1 the name of the attribute to set to the ns3::Tmpfs
+   * \param v1 the value of the attribute to set to the ns3::Tmpfs
+   *
+   * Install mounts one ns3::Tmpfs on path on each node: the files there are
+   * not written in files-N, unless the Dump attribute is set.
+   */
+  void AddTmpfs (std::string path,
+                 std::string n0 = "", const AttributeValue &v0 = EmptyAttributeValue (),
+                 std::string n1 = "", const AttributeValue &v1 = EmptyAttributeValue ());
+
   /**
    * \param nodes a set of nodes
    *
    * This method creates all of DCE related instances to run an applicaion
-   * binary on nodes.
+   * binary on nodes. In a distributed simulation, the nodes of the other
+   * ranks are left alone, see DceMpiHelper.
    */
   void Install (NodeContainer nodes);
 
@@ -176,17 +193,46 @@ public:
   /**
    *
    * This method returns a Vector of process information
-   * that are already finished.
+   * that are already finished, of all the ranks of a distributed
+   * simulation, see DceMpiHelper::MergeProcStatus.
    */
   static std::vector<ProcStatus> GetProcStatus (void);
 
+  /**
+   * \param at the delay after which to fork, as for Simulator::Stop
+   * \param n the number of variants
+   * \param cb called in variant i with i, to change its parameters
+   * \param prefix of the directories of the variants
+   *
+   * At time at, fork the host process n times. Variant i goes on in the
+   * directory prefix<i>, with a copy of the files-N and exitprocs of the
+   * simulation, and its exit status is the one of the host process. The
+   * original waits for them and stops: Simulator::Run returns there, see
+   * GetSweepStatus. Each variant is forked by DceCheckpointHelper::Fork
+   * and the tasks must be ucontext fibers, as for a DceCheckpointHelper.
+   */
+  static void ForkSweep (Time at, uint32_t n, Callback<void, uint32_t> cb,
+                         std::string prefix = "sweep-");
+  /**
+   * returns the index of the variant of ForkSweep, -1 in the original.
+   */
+  static int GetSweepIndex (void);
+  /**
+   * returns the waitpid statuses of the variants, in the original: one
+   * per variant in order, -1 for a variant which could not be forked.
+   */
+  static std::vector<int> GetSweepStatus (void);
+
 private:
+  static void DoForkSweep (uint32_t n, Callback<void, uint32_t> cb, std::string prefix);
+
   ObjectFactory m_loaderFactory;
   ObjectFactory m_schedulerFactory;
   ObjectFactory m_taskManagerFactory;
   ObjectFactory m_managerFactory;
   ObjectFactory m_networkStackFactory;
   ObjectFactory m_delayFactory;
+  std::vector<std::pair<std::string, ObjectFactory> > m_tmpfsFactories;
   std::string m_virtualPath;
   static unsigned long nanoCpt;
 };
@@ -0,0 +1,260 @@
+#include "dce-mpi-helper.h"
+#include "utils.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include <algorithm>
+#include <map>
+#ifdef DCE_MPI
+#include "ns3/mpi-interface.h"
+#include <mpi.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("DceMpiHelper");
+
+namespace ns3 {
+
+namespace {
+// the groups of nodes from the biggest, then from the lowest node.
+bool
+IsBigger (const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b)
+{
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+} // anonymous namespace
+
+DceMpiHelper::DceMpiHelper ()
+  : m_imbalance (0.1)
+{
+}
+
+void
+DceMpiHelper::SetImbalance (double imbalance)
+{
+  m_imbalance = imbalance;
+}
+
+void
+DceMpiHelper::AddLink (uint32_t a, uint32_t b, Time delay, double weight)
+{
+  struct Link link;
+  link.a = a;
+  link.b = b;
+  link.delay = delay;
+  link.weight = weight;
+  m_links.push_back (link);
+}
+
+uint32_t
+DceMpiHelper::Find (std::vector<uint32_t> &parent, uint32_t i)
+{
+  while (parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+  return i;
+}
+
+std::vector<uint32_t>
+DceMpiHelper::Partition (uint32_t n, uint32_t ranks) const
+{
+  NS_LOG_FUNCTION (this << n << ranks);
+  NS_ASSERT (ranks > 0);
+  std::vector<uint32_t> partition (n, 0);
+  if (ranks == 1 || n == 0)
+    {
+      return partition;
+    }
+  uint32_t base = (n + ranks - 1) / ranks;
+  uint32_t capacity = std::max (base, (uint32_t)(base * (1 + m_imbalance)));
+
+  std::vector<Time> delays;
+  for (std::vector<struct Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      NS_ASSERT_MSG (i->a < n && i->b < n, "Link " << i->a << "-" << i->b << " out of the " << n << " nodes");
+      delays.push_back (i->delay);
+    }
+  std::sort (delays.begin (), delays.end ());
+  delays.erase (std::unique (delays.begin (), delays.end ()), delays.end ());
+
+  // The links shorter than delays[level] are kept in the ranks, all of
+  // them at the first level: from the largest lookahead to the smallest,
+  // the first partition of these groups of nodes which fits in the ranks.
+  // At level 0 the nodes are alone, and always fit.
+  for (int32_t level = delays.size (); level >= 0; level--)
+    {
+      std::vector<uint32_t> parent (n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          parent[i] = i;
+        }
+      for (std::vector<struct Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+        {
+          if (level == (int32_t) delays.size () || i->delay < delays[level])
+            {
+              parent[Find (parent, i->a)] = Find (parent, i->b);
+            }
+        }
+      std::vector<uint32_t> group (n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          group[i] = Find (parent, i);
+        }
+      if (Assign (group, ranks, capacity, &partition))
+        {
+          NS_LOG_DEBUG ("lookahead " << GetLookahead (partition));
+          return partition;
+        }
+    }
+  NS_ASSERT_MSG (false, "Nodes alone always fit");
+  return partition;
+}
+
+bool
+DceMpiHelper::Assign (const std::vector<uint32_t> &group, uint32_t ranks, uint32_t capacity,
+                      std::vector<uint32_t> *partition) const
+{
+  uint32_t n = group.size ();
+  std::map<uint32_t, std::vector<uint32_t> > members;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      members[group[i]].push_back (i);
+    }
+  std::vector<std::pair<uint32_t, uint32_t> > order;
+  for (std::map<uint32_t, std::vector<uint32_t> >::const_iterator i = members.begin ();
+       i != members.end (); ++i)
+    {
+      if (i->second.size () > capacity)
+        {
+          return false;
+        }
+      order.push_back (std::make_pair (i->second.size (), i->first));
+    }
+  std::sort (order.begin (), order.end (), IsBigger);
+  std::vector<std::vector<std::pair<uint32_t, double> > > neighbours (n);
+  for (std::vector<struct Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      neighbours[i->a].push_back (std::make_pair (i->b, i->weight));
+      neighbours[i->b].push_back (std::make_pair (i->a, i->weight));
+    }
+
+  // ranks: not assigned yet.
+  partition->assign (n, ranks);
+  std::vector<uint32_t> load (ranks, 0);
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = order.begin ();
+       i != order.end (); ++i)
+    {
+      const std::vector<uint32_t> &nodes = members[i->second];
+      std::vector<double> traffic (ranks, 0.0);
+      for (std::vector<uint32_t>::const_iterator j = nodes.begin (); j != nodes.end (); ++j)
+        {
+          for (std::vector<std::pair<uint32_t, double> >::const_iterator k = neighbours[*j].begin ();
+               k != neighbours[*j].end (); ++k)
+            {
+              uint32_t rank = (*partition)[k->first];
+              if (rank < ranks)
+                {
+                  traffic[rank] += k->second;
+                }
+            }
+        }
+      uint32_t best = ranks;
+      for (uint32_t rank = 0; rank < ranks; rank++)
+        {
+          if (load[rank] + nodes.size () > capacity)
+            {
+              continue;
+            }
+          if (best == ranks || traffic[rank] > traffic[best]
+              || (traffic[rank] == traffic[best] && load[rank] < load[best]))
+            {
+              best = rank;
+            }
+        }
+      if (best == ranks)
+        {
+          return false;
+        }
+      for (std::vector<uint32_t>::const_iterator j = nodes.begin (); j != nodes.end (); ++j)
+        {
+          (*partition)[*j] = best;
+        }
+      load[best] += nodes.size ();
+    }
+  return true;
+}
+
+Time
+DceMpiHelper::GetLookahead (const std::vector<uint32_t> &partition) const
+{
+  Time lookahead = Time::Max ();
+  for (std::vector<struct Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      if (partition[i->a] != partition[i->b] && i->delay < lookahead)
+        {
+          lookahead = i->delay;
+        }
+    }
+  return lookahead;
+}
+
+NodeContainer
+DceMpiHelper::Create (uint32_t n, uint32_t ranks) const
+{
+  NS_LOG_FUNCTION (this << n << ranks);
+  std::vector<uint32_t> partition = Partition (n, ranks);
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      nodes.Add (CreateObject<Node> (partition[i]));
+    }
+  NS_LOG_INFO ("nodes on " << ranks << " ranks, lookahead " << GetLookahead (partition));
+  return nodes;
+}
+
+bool
+DceMpiHelper::IsLocal (Ptr<Node> node)
+{
+#ifdef DCE_MPI
+  return node->GetSystemId () == GetSystemId ();
+#else
+  return true;
+#endif
+}
+
+uint32_t
+DceMpiHelper::GetSystemId (void)
+{
+  return UtilsGetSystemId ();
+}
+
+NodeContainer
+DceMpiHelper::GetLocal (NodeContainer c)
+{
+  NodeContainer local;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      if (IsLocal (*i))
+        {
+          local.Add (*i);
+        }
+    }
+  return local;
+}
+
+std::vector<ProcStatus>
+DceMpiHelper::MergeProcStatus (void)
+{
+  NS_LOG_FUNCTION (GetSystemId ());
+#ifdef DCE_MPI
+  if (MpiInterface::IsEnabled ())
+    {
+      // the exitprocs-<rank> of every rank are complete after it.
+      MPI_Barrier (MPI_COMM_WORLD);
+    }
+#endif
+  return DceManagerHelper::GetProcStatus ();
+}
+
+} // namespace ns3
@@ -0,0 +1,119 @@
+#ifndef DCE_MPI_HELPER_H
+#define DCE_MPI_HELPER_H
+
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+#include "dce-manager-helper.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+class Node;
+
+/**
+ * \brief Split the nodes of a DCE simulation between the ranks of an MPI
+ *        run, ns3::DistributedSimulatorImpl.
+ *
+ * Each rank simulates the nodes whose system id is its rank: the DCE
+ * helpers leave the others alone, and only the files-N of its nodes are
+ * written. The exit statuses of the processes of rank r are written to
+ * exitprocs-r, exitprocs for rank 0.
+ *
+ * The ranks can only look ahead as far as the smallest delay of the
+ * links cut between them: Partition puts the nodes linked by the
+ * shortest delays in the same rank, the links given to AddLink, and
+ * balances the number of nodes of the ranks.
+ *
+ * \code
+ * DceMpiHelper mpi;
+ * mpi.AddLink (0, 1, MilliSeconds (1));
+ * mpi.AddLink (1, 2, MilliSeconds (50));
+ * mpi.AddLink (2, 3, MilliSeconds (1));
+ * NodeContainer nodes = mpi.Create (4, MpiInterface::GetSize ());
+ * // ... the links, the stacks and DceManagerHelper::Install as usual.
+ * Simulator::Run ();
+ * Simulator::Destroy ();
+ * std::vector<ProcStatus> status = DceMpiHelper::MergeProcStatus ();
+ * MpiInterface::Disable ();
+ * \endcode
+ *
+ * The links cut must be point to point links, the only ones ns-3
+ * carries between ranks. Without --enable-mpi, all the nodes are local.
+ */
+class DceMpiHelper
+{
+public:
+  DceMpiHelper ();
+
+  /**
+   * \param imbalance how much a rank may have more nodes than the
+   *        others, 0.1 for 10% more than n / ranks.
+   */
+  void SetImbalance (double imbalance);
+  /**
+   * \param a the index of a node, in the order of Create
+   * \param b the index of the other node
+   * \param delay the delay of the link between them
+   * \param weight how much traffic goes through the link, to keep the
+   *        links of more traffic in a rank when the lookahead is the same
+   */
+  void AddLink (uint32_t a, uint32_t b, Time delay, double weight = 1.0);
+  /**
+   * \param n the number of nodes
+   * \param ranks the number of ranks
+   * \returns the rank of each node.
+   */
+  std::vector<uint32_t> Partition (uint32_t n, uint32_t ranks) const;
+  /**
+   * \returns the lookahead of partition: the smallest delay of the links
+   *          cut, Time::Max () if none is.
+   */
+  Time GetLookahead (const std::vector<uint32_t> &partition) const;
+  /**
+   * Create n nodes with the system ids of Partition (n, ranks).
+   */
+  NodeContainer Create (uint32_t n, uint32_t ranks) const;
+
+  // true if node is simulated by this rank.
+  static bool IsLocal (Ptr<Node> node);
+  // the rank of this process, 0 if the simulation is not distributed.
+  static uint32_t GetSystemId (void);
+  // the nodes of c simulated by this rank.
+  static NodeContainer GetLocal (NodeContainer c);
+  /**
+   * \returns the exit statuses of the processes of all the ranks.
+   *
+   * Called by every rank after Simulator::Destroy, when its processes
+   * have written their exit statuses, and before MpiInterface::Disable:
+   * the ranks wait for each other on an MPI barrier, then read the files
+   * of the current directory. The ranks must share it, on one host or on
+   * a shared file system.
+   */
+  static std::vector<ProcStatus> MergeProcStatus (void);
+
+private:
+  struct Link
+  {
+    uint32_t a;
+    uint32_t b;
+    Time delay;
+    double weight;
+  };
+  static uint32_t Find (std::vector<uint32_t> &parent, uint32_t i);
+  /**
+   * Assign the groups of nodes to the ranks, from the biggest, each to
+   * the rank it has the most traffic with which still has room.
+   * \returns false if a group fits nowhere.
+   */
+  bool Assign (const std::vector<uint32_t> &group, uint32_t ranks, uint32_t capacity,
+               std::vector<uint32_t> *partition) const;
+
+  std::vector<struct Link> m_links;
+  double m_imbalance;
+};
+
+} // namespace ns3
+
+#endif /* DCE_MPI_HELPER_H */
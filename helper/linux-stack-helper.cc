@@ -22,6 +22,7 @@
 #include "ipv6-linux.h"
 #include "linux-socket-fd-factory.h"
 #include "dce-application-helper.h"
+#include "dce-mpi-helper.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
 #include "ns3/names.h"
@@ -108,6 +109,10 @@ LinuxStackHelper::PopulateRoutingTables ()
   for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
     {
       Ptr<Node> node = *i;
+      if (!DceMpiHelper::IsLocal (node))
+        {
+          continue;
+        }
       Ptr<Ipv4Linux> ipv4 = node->GetObject<Ipv4Linux> ();
       ipv4->PopulateRoutingTable ();
     }
@@ -118,6 +123,11 @@ void
 LinuxStackHelper::RunIp (Ptr<Node> node, Time at, std::string str)
 {
 #ifdef KERNEL_STACK
+  if (!DceMpiHelper::IsLocal (node))
+    {
+      // the kernel of the node is in another rank.
+      return;
+    }
   DceApplicationHelper process;
   ApplicationContainer apps;
   process.SetBinary ("ip");
@@ -129,6 +139,27 @@ LinuxStackHelper::RunIp (Ptr<Node> node, Time at, std::string str)
 #endif
 }
 
+void
+LinuxStackHelper::AddRoutes (Ptr<Node> node, Time at, const std::vector<Ipv4RoutingTableEntry> &routes)
+{
+#ifdef KERNEL_STACK
+  if (!DceMpiHelper::IsLocal (node))
+    {
+      return;
+    }
+  Ptr<LinuxSocketFdFactory> sock = node->GetObject<LinuxSocketFdFactory> ();
+  if (!sock)
+    {
+      NS_ASSERT_MSG (0, "No LinuxSocketFdFactory is installed. "
+                     "You may need to do it via DceManagerHelper::Install ()");
+      return;
+    }
+  Simulator::ScheduleWithContext (node->GetId (), at,
+                                  &LinuxSocketFdFactory::ScheduleTask, sock,
+                                  MakeEvent (&LinuxSocketFdFactory::AddRoutes, sock, routes));
+#endif
+}
+
 void
 LinuxStackHelper::SysctlGetCallback (Ptr<Node> node, std::string path,
                                      void (*callback)(std::string, std::string))
@@ -154,6 +185,11 @@ LinuxStackHelper::SysctlGet (Ptr<Node> node, Time at, std::string path,
                              void (*callback)(std::string, std::string))
 {
 #ifdef KERNEL_STACK
+  if (!DceMpiHelper::IsLocal (node))
+    {
+      // asked to the rank of the node.
+      return;
+    }
   Ptr<LinuxSocketFdFactory> sock = node->GetObject<LinuxSocketFdFactory> ();
   if (!sock)
     {
@@ -171,11 +207,20 @@ LinuxStackHelper::SysctlGet (Ptr<Node> node, Time at, std::string path,
 }
 void
 LinuxStackHelper::SysctlSet (NodeContainer c, std::string path, std::string value)
+{
+  SysctlSet (c, std::vector<std::pair<std::string, std::string> > (1, std::make_pair (path, value)));
+}
+void
+LinuxStackHelper::SysctlSet (NodeContainer c, const std::vector<std::pair<std::string, std::string> > &values)
 {
 #ifdef KERNEL_STACK
   for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
     {
       Ptr<Node> node = *i;
+      if (!DceMpiHelper::IsLocal (node))
+        {
+          continue;
+        }
       Ptr<LinuxSocketFdFactory> sock = node->GetObject<LinuxSocketFdFactory> ();
       if (!sock)
         {
@@ -184,8 +229,8 @@ LinuxStackHelper::SysctlSet (NodeContainer c, std::string path, std::string valu
         }
       // i.e., TaskManager::Current() needs it.
       Simulator::ScheduleWithContext (node->GetId (), Seconds (0.1),
-                                      MakeEvent (&LinuxSocketFdFactory::Set, sock,
-                                                 path, value));
+                                      MakeEvent (&LinuxSocketFdFactory::SetAll, sock,
+                                                 values));
     }
 #endif
 }
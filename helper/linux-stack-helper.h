@@ -21,6 +21,8 @@
 #define LINUX_STACK_HELPER_H
 
 #include "ns3/object.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -36,6 +38,9 @@ class Ipv4RoutingHelper;
  *   1 - assign address to devices using Ipv4AddressHelper,
  *   2 - create the static routes using Ipv4GlobalRoutingHelper
  *
+ * In a distributed simulation, Install aggregates Ipv4Linux on the nodes
+ * of all the ranks, for the global routes, but the methods which run in
+ * the kernel of a node do nothing on the nodes of the other ranks.
  *
  */
 class LinuxStackHelper
@@ -99,6 +104,15 @@ public:
    */
   void SysctlSet (NodeContainer c, std::string path, std::string value);
 
+  /**
+   * Configure several Linux kernel parameters at once, in a single kernel
+   * task per node.
+   *
+   * \param c NodeContainer that holds the set of nodes to configure these parameters.
+   * \param values pairs of sysctl parameter and value, applied in order.
+   */
+  void SysctlSet (NodeContainer c, const std::vector<std::pair<std::string, std::string> > &values);
+
   /**
    * Obtain Linux kernel state with traditional 'sysctl' interface.
    *
@@ -131,6 +145,16 @@ public:
    */
   static void RunIp (Ptr<Node> node, Time at, std::string str);
 
+  /**
+   * Add routes to the kernel of a node in one pass, from a kernel task
+   * and without starting any process.
+   *
+   * \param node The node pointer Ptr<Node> to configure.
+   * \param at the delta from the begining of simulation to add the routes.
+   * \param routes the routes, added to the main table.
+   */
+  static void AddRoutes (Ptr<Node> node, Time at, const std::vector<Ipv4RoutingTableEntry> &routes);
+
 private:
   void Initialize ();
   const Ipv4RoutingHelper *m_routing;
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "chacha-stream.h"
+#include <string.h>
+#include <algorithm>
+
+#define CHACHA_LANES 4
+#define CHACHA_BLOCK 64
+#define CHACHA_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+namespace ns3 {
+
+namespace {
+// One word of each of the blocks computed together.
+typedef uint32_t Lanes __attribute__ ((vector_size (CHACHA_LANES * 4)));
+
+inline void
+QuarterRound (Lanes &a, Lanes &b, Lanes &c, Lanes &d)
+{
+  a += b;
+  d ^= a;
+  d = CHACHA_ROTL (d, 16);
+  c += d;
+  b ^= c;
+  b = CHACHA_ROTL (b, 12);
+  a += b;
+  d ^= a;
+  d = CHACHA_ROTL (d, 8);
+  c += d;
+  b ^= c;
+  b = CHACHA_ROTL (b, 7);
+}
+// little endian, whatever the host.
+void
+Store32 (uint8_t *p, uint32_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+} // anonymous namespace
+
+ChaChaStream::ChaChaStream ()
+  : m_leftSize (0)
+{
+  uint32_t key[8];
+  memset (key, 0, sizeof (key));
+  SetKey (key, 0);
+}
+
+void
+ChaChaStream::SetKey (const uint32_t key[8], uint64_t nonce)
+{
+  // "expand 32-byte k"
+  m_input[0] = 0x61707865;
+  m_input[1] = 0x3320646e;
+  m_input[2] = 0x79622d32;
+  m_input[3] = 0x6b206574;
+  for (int i = 0; i < 8; i++)
+    {
+      m_input[4 + i] = key[i];
+    }
+  m_input[12] = 0;
+  m_input[13] = 0;
+  m_input[14] = nonce;
+  m_input[15] = nonce >> 32;
+  m_leftSize = 0;
+}
+
+void
+ChaChaStream::Blocks (uint8_t *out)
+{
+  // x[i] holds word i of each of the blocks.
+  Lanes x[16];
+  Lanes in[16];
+  uint64_t counter = ((uint64_t)m_input[13] << 32) | m_input[12];
+  for (int i = 0; i < 16; i++)
+    {
+      for (int l = 0; l < CHACHA_LANES; l++)
+        {
+          in[i][l] = m_input[i];
+        }
+    }
+  for (int l = 0; l < CHACHA_LANES; l++)
+    {
+      in[12][l] = counter + l;
+      in[13][l] = (counter + l) >> 32;
+    }
+  for (int i = 0; i < 16; i++)
+    {
+      x[i] = in[i];
+    }
+  for (int round = 0; round < 10; round++)
+    {
+      QuarterRound (x[0], x[4], x[8], x[12]);
+      QuarterRound (x[1], x[5], x[9], x[13]);
+      QuarterRound (x[2], x[6], x[10], x[14]);
+      QuarterRound (x[3], x[7], x[11], x[15]);
+      QuarterRound (x[0], x[5], x[10], x[15]);
+      QuarterRound (x[1], x[6], x[11], x[12]);
+      QuarterRound (x[2], x[7], x[8], x[13]);
+      QuarterRound (x[3], x[4], x[9], x[14]);
+    }
+  for (int i = 0; i < 16; i++)
+    {
+      x[i] += in[i];
+    }
+  for (int l = 0; l < CHACHA_LANES; l++)
+    {
+      for (int i = 0; i < 16; i++)
+        {
+          Store32 (out + l * CHACHA_BLOCK + i * 4, x[i][l]);
+        }
+    }
+  counter += CHACHA_LANES;
+  m_input[12] = counter;
+  m_input[13] = counter >> 32;
+}
+
+void
+ChaChaStream::Generate (uint8_t *buf, size_t len)
+{
+  size_t l = std::min (len, m_leftSize);
+  memcpy (buf, m_left + sizeof (m_left) - m_leftSize, l);
+  m_leftSize -= l;
+  buf += l;
+  len -= l;
+  while (len >= sizeof (m_left))
+    {
+      Blocks (buf);
+      buf += sizeof (m_left);
+      len -= sizeof (m_left);
+    }
+  if (len > 0)
+    {
+      Blocks (m_left);
+      memcpy (buf, m_left, len);
+      m_leftSize = sizeof (m_left) - len;
+    }
+}
+
+} // namespace ns3
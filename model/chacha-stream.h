@@ -0,0 +1,35 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef CHACHA_STREAM_H
+#define CHACHA_STREAM_H
+
+#include <stdint.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+/**
+ * The ChaCha20 keystream (64-bit block counter, 64-bit nonce) used as a
+ * deterministic random generator: the same key gives the same bytes
+ * whatever the way they are read. Blocks are computed four at a time,
+ * one per lane of a GCC vector type.
+ */
+class ChaChaStream
+{
+public:
+  ChaChaStream ();
+
+  void SetKey (const uint32_t key[8], uint64_t nonce);
+  void Generate (uint8_t *buf, size_t len);
+
+private:
+  void Blocks (uint8_t *out);
+
+  uint32_t m_input[16];
+  // bytes of the last blocks not given yet.
+  uint8_t m_left[256];
+  size_t m_leftSize;
+};
+
+} // namespace ns3
+
+#endif /* CHACHA_STREAM_H */
@@ -148,8 +148,13 @@ CoojaLoader::Clone (void)
       clonedModule->module->refcount++;
       clonedModule->refcount = module->refcount;
       clonedModule->buffer = malloc (module->module->buffer_size);
+      // the live data section holds our state only if we are the
+      // current user of the module: otherwise, our state is in our
+      // own saved buffer (this happens when a process template is
+      // cloned from within another process).
       memcpy (clonedModule->buffer,
-              module->module->data_buffer,
+              (module->module->current_buffer == module->buffer) ?
+              module->module->data_buffer : module->buffer,
               clonedModule->module->buffer_size);
       // setup deps.
       for (std::list<struct Module *>::iterator j = module->deps.begin ();
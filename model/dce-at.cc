@@ -108,8 +108,10 @@ int dce_unlinkat (int fd, const char *pathname, int flags)
     }
   else
     {
+      // before the removal: then the path would lead to the base layer,
+      // or to nothing.
       realpath = UtilsGetCurrentDirName () + "/" + UtilsGetRealFilePath (pathname);
-      retval = ::unlinkat (fd, realpath.c_str (), flags);
+      retval = UtilsRemoveFile (pathname, flags & AT_REMOVEDIR);
     }
   if (retval == -1)
     {
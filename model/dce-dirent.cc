@@ -30,7 +30,11 @@
 #include "ns3/log.h"
 #include "errno.h"
 #include "dce-stdlib.h"
+#include "dce-manager.h"
+#include "tmpfs.h"
 #include <string.h>
+#include <map>
+#include <set>
 
 NS_LOG_COMPONENT_DEFINE ("DceDirent");
 
@@ -40,6 +44,163 @@ struct my__dirstream
 };
 
 namespace ns3 {
+// The directory of the base layer listed after the one of files-N it is
+// merged with, see UtilsGetLowerDirPath.
+struct LowerDir
+{
+  DIR *dir;
+  std::string upper; // the directory of files-N
+  // the names of files-N, whiteouts included, listed once when the base
+  // layer is reached instead of a lstat per entry.
+  std::set<std::string> masks;
+  bool listed;
+};
+// by process, then by DIR of the process.
+typedef std::map<DIR *, struct LowerDir> LowerDirs;
+static std::map<struct Process *, LowerDirs> g_lowerDirs;
+
+static struct LowerDir *
+LookupLowerDir (struct Process *process, DIR *dirp)
+{
+  std::map<struct Process *, LowerDirs>::iterator i = g_lowerDirs.find (process);
+  if (i == g_lowerDirs.end ())
+    {
+      return 0;
+    }
+  LowerDirs::iterator j = i->second.find (dirp);
+  return (j == i->second.end ()) ? 0 : &j->second;
+}
+
+// process is 0 when it exits, the DIR is then looked up in all of them.
+static void
+CloseLowerDir (struct Process *process, DIR *dirp)
+{
+  for (std::map<struct Process *, LowerDirs>::iterator i = g_lowerDirs.begin ();
+       i != g_lowerDirs.end (); ++i)
+    {
+      if (process != 0 && i->first != process)
+        {
+          continue;
+        }
+      LowerDirs::iterator j = i->second.find (dirp);
+      if (j != i->second.end ())
+        {
+          ::closedir (j->second.dir);
+          i->second.erase (j);
+          if (i->second.empty ())
+            {
+              g_lowerDirs.erase (i);
+            }
+          return;
+        }
+    }
+}
+
+// true if the entry name of the base layer is not to be listed: files-N
+// has it too, or a whiteout.
+static bool
+IsMaskedLowerEntry (struct LowerDir &lower, const char *name)
+{
+  if (strcmp (name, ".") == 0 || strcmp (name, "..") == 0)
+    {
+      return true;
+    }
+  if (!lower.listed)
+    {
+      lower.masks.clear ();
+      DIR *upper = ::opendir (lower.upper.c_str ());
+      if (upper != 0)
+        {
+          struct dirent *entry;
+          while ((entry = ::readdir (upper)) != 0)
+            {
+              lower.masks.insert (entry->d_name);
+            }
+          ::closedir (upper);
+        }
+      lower.listed = true;
+    }
+  return lower.masks.find (name) != lower.masks.end ()
+         || lower.masks.find (std::string (".wh.") + name) != lower.masks.end ();
+}
+
+// next calls readdir or readdir64 on the directory of files-N, then on
+// the one of the base layer.
+template <typename D>
+static D *
+ReadMergedDir (DIR *dirp, D * (*next)(DIR *))
+{
+  D *entry = next (dirp);
+  struct LowerDir *lower = LookupLowerDir (Current ()->process, dirp);
+  if (lower == 0)
+    {
+      return entry;
+    }
+  while (entry != 0 && strncmp (entry->d_name, ".wh.", 4) == 0)
+    {
+      entry = next (dirp);
+    }
+  if (entry == 0)
+    {
+      do
+        {
+          entry = next (lower->dir);
+        }
+      while (entry != 0 && IsMaskedLowerEntry (*lower, entry->d_name));
+    }
+  return entry;
+}
+
+// A directory of a Tmpfs: it has no real fd to give to readdir, its
+// entries are listed when opened and rewound.
+struct TmpfsDir
+{
+  Ptr<Tmpfs> fs;
+  std::string path; // in fs
+  std::vector<std::string> names;
+  uint32_t next;
+  struct dirent entry;
+  struct dirent64 entry64;
+};
+static std::map<DIR *, struct TmpfsDir> g_tmpfsDirs;
+
+static void
+ListTmpfsDir (struct TmpfsDir &dir)
+{
+  dir.names.clear ();
+  dir.names.push_back (".");
+  dir.names.push_back ("..");
+  dir.fs->List (dir.path, &dir.names);
+  dir.next = 0;
+}
+
+template <typename D>
+static D *
+ReadTmpfsDir (struct TmpfsDir &dir, D *entry)
+{
+  while (dir.next < dir.names.size ())
+    {
+      const std::string &name = dir.names[dir.next++];
+      Ptr<TmpfsInode> inode = dir.fs->Lookup (name == "." || name == ".." ? dir.path
+                                              : (dir.path.empty () ? name : dir.path + "/" + name));
+      if (inode == 0 || name.size () >= sizeof (entry->d_name))
+        {
+          // removed since listed.
+          continue;
+        }
+      struct stat st;
+      inode->Stat (&st);
+      memset (entry, 0, sizeof (*entry));
+      entry->d_ino = st.st_ino;
+      entry->d_off = dir.next;
+      entry->d_reclen = sizeof (*entry);
+      entry->d_type = inode->IsDir () ? DT_DIR : DT_REG;
+      strcpy (entry->d_name, name.c_str ());
+      return entry;
+    }
+  return 0;
+}
+
 void
 remove_dir (DIR *d, Thread *current)
 {
@@ -66,6 +227,23 @@ int dce_internalClosedir (DIR *dirp, struct Thread *cur)
   struct my__dirstream *ds = (struct my__dirstream *) dirp;
   int saveFd = -1;
 
+  CloseLowerDir (cur ? cur->process : 0, dirp);
+  std::map<DIR *, struct TmpfsDir>::iterator j = g_tmpfsDirs.find (dirp);
+  if (j != g_tmpfsDirs.end ())
+    {
+      g_tmpfsDirs.erase (j);
+      saveFd = ds->fd;
+      // the fd of the DIR was closed by dce_fdopendir.
+      ds->fd = -1;
+      ::closedir (dirp);
+      if (cur && saveFd < 0)
+        {
+          dce_close (-saveFd);
+          remove_dir (dirp, cur);
+        }
+      return 0;
+    }
+
   if (cur)
     {
       saveFd = ds->fd;
@@ -122,6 +300,29 @@ DIR * dce_opendir (const char *name)
   if (res == 0)
     {
       dce_close (fd);
+      return 0;
+    }
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (name, &rest);
+  if (fs != 0)
+    {
+      struct TmpfsDir &dir = g_tmpfsDirs[res];
+      dir.fs = fs;
+      dir.path = rest;
+      ListTmpfsDir (dir);
+      return res;
+    }
+  std::string lower = UtilsGetLowerDirPath (name);
+  if (!lower.empty ())
+    {
+      struct LowerDir dir;
+      dir.dir = ::opendir (lower.c_str ());
+      dir.upper = UtilsGetRealFilePath (name);
+      dir.listed = false;
+      if (dir.dir != 0)
+        {
+          g_lowerDirs[current->process][res] = dir;
+        }
     }
   return res;
 }
@@ -152,6 +353,11 @@ struct dirent * dce_readdir (DIR *dirp)
   NS_ASSERT (Current () != 0);
   Thread *current = Current ();
   struct my__dirstream *ds = (struct my__dirstream *) dirp;
+  std::map<DIR *, struct TmpfsDir>::iterator i = g_tmpfsDirs.find (dirp);
+  if (i != g_tmpfsDirs.end ())
+    {
+      return ReadTmpfsDir (i->second, &i->second.entry);
+    }
   int saveFd = ds->fd;
   if (saveFd >= 0)
     {
@@ -166,7 +372,7 @@ struct dirent * dce_readdir (DIR *dirp)
       return 0;
     }
   ds->fd = realFd;
-  struct dirent *ret = readdir (dirp);
+  struct dirent *ret = ReadMergedDir (dirp, &readdir);
   ds->fd = saveFd;
 
   return ret;
@@ -178,6 +384,11 @@ struct dirent64 * dce_readdir64 (DIR *dirp)
   NS_ASSERT (Current () != 0);
   Thread *current = Current ();
   struct my__dirstream *ds = (struct my__dirstream *) dirp;
+  std::map<DIR *, struct TmpfsDir>::iterator i = g_tmpfsDirs.find (dirp);
+  if (i != g_tmpfsDirs.end ())
+    {
+      return ReadTmpfsDir (i->second, &i->second.entry64);
+    }
   int saveFd = ds->fd;
   if (saveFd >= 0)
     {
@@ -192,7 +403,7 @@ struct dirent64 * dce_readdir64 (DIR *dirp)
       return 0;
     }
   ds->fd = realFd;
-  struct dirent64 *ret = readdir64 (dirp);
+  struct dirent64 *ret = ReadMergedDir (dirp, &readdir64);
   ds->fd = saveFd;
 
   return ret;
@@ -204,6 +415,12 @@ int dce_readdir_r (DIR *dirp, struct dirent *entry, struct dirent **result)
   NS_ASSERT (Current () != 0);
   Thread *current = Current ();
   struct my__dirstream *ds = (struct my__dirstream *) dirp;
+  std::map<DIR *, struct TmpfsDir>::iterator j = g_tmpfsDirs.find (dirp);
+  if (j != g_tmpfsDirs.end ())
+    {
+      *result = ReadTmpfsDir (j->second, entry);
+      return 0;
+    }
 
   int saveFd = ds->fd;
   if (saveFd >= 0)
@@ -220,6 +437,23 @@ int dce_readdir_r (DIR *dirp, struct dirent *entry, struct dirent **result)
     }
   ds->fd = realFd;
   int ret = readdir_r (dirp, entry, result);
+  struct LowerDir *lower = LookupLowerDir (current->process, dirp);
+  if (lower != 0)
+    {
+      while (ret == 0 && *result != 0 && strncmp (entry->d_name, ".wh.", 4) == 0)
+        {
+          ret = readdir_r (dirp, entry, result);
+        }
+      while (ret == 0 && *result == 0)
+        {
+          ret = readdir_r (lower->dir, entry, result);
+          if (ret != 0 || *result == 0 || !IsMaskedLowerEntry (*lower, entry->d_name))
+            {
+              break;
+            }
+          *result = 0;
+        }
+    }
   ds->fd = saveFd;
 
   return ret;
@@ -245,6 +479,12 @@ void dce_rewinddir (DIR *dirp)
   NS_ASSERT (Current () != 0);
   Thread *current = Current ();
   struct my__dirstream *ds = (struct my__dirstream *) dirp;
+  std::map<DIR *, struct TmpfsDir>::iterator j = g_tmpfsDirs.find (dirp);
+  if (j != g_tmpfsDirs.end ())
+    {
+      ListTmpfsDir (j->second);
+      return;
+    }
 
   int saveFd = ds->fd;
   if (saveFd >= 0)
@@ -260,6 +500,12 @@ void dce_rewinddir (DIR *dirp)
   ds->fd = realFd;
   rewinddir (dirp);
   ds->fd = saveFd;
+  struct LowerDir *lower = LookupLowerDir (current->process, dirp);
+  if (lower != 0)
+    {
+      rewinddir (lower->dir);
+      lower->listed = false;
+    }
 }
 int dce_scandir (const char *dirp, struct dirent ***namelist,
                  int (*filter)(const struct dirent *),
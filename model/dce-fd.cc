@@ -31,6 +31,8 @@
 #include "file-usage.h"
 #include "dce-stdlib.h"
 #include "pipe-fd.h"
+#include "tmpfs.h"
+#include "tmpfs-fd.h"
 
 NS_LOG_COMPONENT_DEFINE ("SimuFd");
 
@@ -103,15 +105,36 @@ int dce_open (const char *path, int flags, ...)
       return -1;
     }
   UnixFd *unixFd = 0;
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (path, &rest);
 
-  if ((std::string (path) == "/dev/random") || (std::string (path) == "/dev/urandom")
+  if (fs != 0)
+    {
+      Ptr<TmpfsInode> inode;
+      int status = fs->Open (rest, flags, mode & ~(current->process->uMask), &inode);
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      unixFd = new TmpfsFd (fs, inode, flags);
+    }
+  else if ((std::string (path) == "/dev/random") || (std::string (path) == "/dev/urandom")
       || (std::string (path) == "/dev/srandom"))
     {
       unixFd = new UnixRandomFd (path);
     }
   else
     {
-      std::string fullpath = UtilsGetRealFilePath (path);
+      std::string fullpath;
+      if ((flags & O_ACCMODE) != O_RDONLY || (flags & (O_CREAT | O_TRUNC)))
+        {
+          fullpath = UtilsGetWritableFilePath (path, flags & O_CREAT);
+        }
+      else
+        {
+          fullpath = UtilsGetRealFilePath (path);
+        }
 
       int realFd = ::open (fullpath.c_str (), flags, mode);
       if (realFd == -1)
@@ -142,7 +165,33 @@ int dce_creat (const char *path, mode_t mode)
 
 int dce_unlink_real (const char *pathname)
 {
-  DEFINE_FORWARDER_PATH (unlink, pathname);
+  Thread *current = Current ();
+  NS_LOG_FUNCTION (current << UtilsGetNodeId () << pathname);
+  NS_ASSERT (current != 0);
+
+  if (std::string (pathname) == "")
+    {
+      current->err = ENOENT;
+      return -1;
+    }
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (pathname, &rest);
+  if (fs != 0)
+    {
+      int status = fs->Unlink (rest);
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      return 0;
+    }
+  if (UtilsRemoveFile (pathname, false) == -1)
+    {
+      current->err = errno;
+      return -1;
+    }
+  return 0;
 }
 
 void unlink_notify (std::string fullpath)
@@ -165,12 +214,12 @@ void unlink_notify (std::string fullpath)
 int dce_unlink (const char *pathname)
 {
   NS_LOG_FUNCTION (pathname);
+  // as in dce_unlinkat, the path of the file removed.
+  std::string fullpath = UtilsGetRealFilePath (pathname);
   int ret = dce_unlink_real (pathname);
 
   if (0 == ret)
     {
-      std::string fullpath = UtilsGetRealFilePath (pathname);
-
       unlink_notify (fullpath);
     }
 
@@ -178,15 +227,80 @@ int dce_unlink (const char *pathname)
 }
 int dce_mkdir (const char *pathname, mode_t mode)
 {
-  mode_t m =  (mode & ~(Current ()->process->uMask));
-  DEFINE_FORWARDER_PATH (mkdir, pathname, m);
+  Thread *current = Current ();
+  NS_LOG_FUNCTION (current << UtilsGetNodeId () << pathname << mode);
+  NS_ASSERT (current != 0);
+
+  if (std::string (pathname) == "")
+    {
+      current->err = ENOENT;
+      return -1;
+    }
+  mode_t m =  (mode & ~(current->process->uMask));
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (pathname, &rest);
+  if (fs != 0)
+    {
+      int status = fs->Mkdir (rest, m);
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      return 0;
+    }
+  std::string fullpath = UtilsGetWritableFilePath (pathname, true);
+  if (::mkdir (fullpath.c_str (), m) == -1)
+    {
+      current->err = errno;
+      return -1;
+    }
+  return 0;
 }
 int dce_rmdir (const char *pathname)
 {
-  DEFINE_FORWARDER_PATH (rmdir, pathname);
+  Thread *current = Current ();
+  NS_LOG_FUNCTION (current << UtilsGetNodeId () << pathname);
+  NS_ASSERT (current != 0);
+
+  if (std::string (pathname) == "")
+    {
+      current->err = ENOENT;
+      return -1;
+    }
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (pathname, &rest);
+  if (fs != 0)
+    {
+      int status = fs->Rmdir (rest);
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      return 0;
+    }
+  if (UtilsRemoveFile (pathname, true) == -1)
+    {
+      current->err = errno;
+      return -1;
+    }
+  return 0;
 }
 int dce_access (const char *pathname, int mode)
 {
+  std::string rest;
+  Ptr<Tmpfs> fs = Current ()->process->manager->LookupTmpfs (pathname, &rest);
+  if (fs != 0)
+    {
+      // no permission in a Tmpfs: only the existence is checked.
+      if (fs->Lookup (rest) == 0)
+        {
+          Current ()->err = ENOENT;
+          return -1;
+        }
+      return 0;
+    }
   DEFINE_FORWARDER_PATH (access, pathname, mode);
 }
 int dce_close (int fd)
@@ -335,13 +449,19 @@ ssize_t dce_writev (int fd, const struct iovec *iov, int iovcnt)
   return retval;
 }
 
+static ssize_t DoRead (Thread *current, int fd, void *buf, size_t count)
+{
+  OPENED_FD_METHOD (int, Read (buf, count))
+}
 ssize_t dce_read (int fd, void *buf, size_t count)
 {
   Thread *current = Current ();
   NS_LOG_FUNCTION (current << UtilsGetNodeId () << fd << buf << count);
   NS_ASSERT (current != 0);
 
-  OPENED_FD_METHOD (int, Read (buf, count))
+  ssize_t ret = DoRead (current, fd, buf, count);
+  UtilsSpinIo (current, fd, POLLIN, ret);
+  return ret;
 }
 int dce_socket (int domain, int type, int protocol)
 {
@@ -511,13 +631,19 @@ ssize_t dce_recvfrom (int fd, void *buf, size_t len, int flags,
     }
   return retval;
 }
+static ssize_t DoRecvmsg (Thread *current, int fd, struct msghdr *msg, int flags)
+{
+  OPENED_FD_METHOD (ssize_t, Recvmsg (msg, flags))
+}
 ssize_t dce_recvmsg (int fd, struct msghdr *msg, int flags)
 {
   Thread *current = Current ();
   NS_LOG_FUNCTION (current << UtilsGetNodeId () << fd << msg << flags);
   NS_ASSERT (current != 0);
 
-  OPENED_FD_METHOD (ssize_t, Recvmsg (msg, flags))
+  ssize_t ret = DoRecvmsg (current, fd, msg, flags);
+  UtilsSpinIo (current, fd, POLLIN, ret);
+  return ret;
 }
 int dce_setsockopt (int fd, int level, int optname,
                     const void *optval, socklen_t optlen)
@@ -869,3 +995,178 @@ ssize_t dce_sendfile(int out_fd, int in_fd, off_t * offset, size_t count)
   free (read_buf);
   return ret;
 }
+
+// Take a reference on the file of fd as OPENED_FD_METHOD does, for the
+// calls which use two files.
+static UnixFd *
+AcquireFd (Thread *current, int fd)
+{
+  std::map<int,FileUsage *>::iterator it = current->process->openFiles.find (fd);
+  if (current->process->openFiles.end () == it || it->second->IsClosed ())
+    {
+      current->err = EBADF;
+      return 0;
+    }
+  return it->second->GetFileInc ();
+}
+static void
+ReleaseFd (Thread *current, int fd)
+{
+  std::map<int,FileUsage *>::iterator it = current->process->openFiles.find (fd);
+  if (current->process->openFiles.end () != it && it->second->DecUsage ())
+    {
+      delete it->second;
+      current->process->openFiles.erase (it);
+    }
+}
+// Move the offset of file to *off for the duration of a splice.
+static off64_t
+SpliceSeek (UnixFd *file, loff_t *off)
+{
+  if (off == 0)
+    {
+      return 0;
+    }
+  off64_t saved = file->Lseek (0, SEEK_CUR);
+  if (saved < 0 || file->Lseek (*off, SEEK_SET) < 0)
+    {
+      return -1;
+    }
+  return saved;
+}
+static void
+SpliceSeekBack (UnixFd *file, loff_t *off, off64_t saved, ssize_t ret)
+{
+  if (off == 0)
+    {
+      return;
+    }
+  if (ret > 0)
+    {
+      *off += ret;
+    }
+  file->Lseek (saved, SEEK_SET);
+}
+static ssize_t
+DoSplice (UnixFd *in, loff_t *off_in, UnixFd *out, loff_t *off_out, size_t len, unsigned int flags)
+{
+  Thread *current = Current ();
+  PipeFd *pipeIn = dynamic_cast<PipeFd *> (in);
+  PipeFd *pipeOut = dynamic_cast<PipeFd *> (out);
+  bool nonBlock = flags & SPLICE_F_NONBLOCK;
+
+  if ((pipeIn != 0 && off_in != 0) || (pipeOut != 0 && off_out != 0))
+    {
+      current->err = ESPIPE;
+      return -1;
+    }
+  if (pipeIn != 0 && pipeOut != 0)
+    {
+      return pipeIn->Splice (pipeOut, len, nonBlock);
+    }
+  if (pipeIn != 0)
+    {
+      off64_t saved = SpliceSeek (out, off_out);
+      if (saved < 0)
+        {
+          return -1;
+        }
+      ssize_t ret = pipeIn->SpliceTo (out, len, nonBlock);
+      SpliceSeekBack (out, off_out, saved, ret);
+      return ret;
+    }
+  if (pipeOut != 0)
+    {
+      off64_t saved = SpliceSeek (in, off_in);
+      if (saved < 0)
+        {
+          return -1;
+        }
+      ssize_t ret = pipeOut->SpliceFrom (in, len, nonBlock);
+      SpliceSeekBack (in, off_in, saved, ret);
+      return ret;
+    }
+  // one of the two must be a pipe.
+  current->err = EINVAL;
+  return -1;
+}
+ssize_t dce_splice (int fd_in, loff_t *off_in, int fd_out, loff_t *off_out, size_t len, unsigned int flags)
+{
+  Thread *current = Current ();
+  NS_LOG_FUNCTION (current << UtilsGetNodeId () << fd_in << off_in << fd_out << off_out << len << flags);
+  NS_ASSERT (current != 0);
+
+  UnixFd *in = AcquireFd (current, fd_in);
+  if (in == 0)
+    {
+      return -1;
+    }
+  UnixFd *out = AcquireFd (current, fd_out);
+  if (out == 0)
+    {
+      ReleaseFd (current, fd_in);
+      return -1;
+    }
+  ssize_t ret = DoSplice (in, off_in, out, off_out, len, flags);
+  ReleaseFd (current, fd_out);
+  ReleaseFd (current, fd_in);
+  return ret;
+}
+ssize_t dce_tee (int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  Thread *current = Current ();
+  NS_LOG_FUNCTION (current << UtilsGetNodeId () << fd_in << fd_out << len << flags);
+  NS_ASSERT (current != 0);
+
+  UnixFd *in = AcquireFd (current, fd_in);
+  if (in == 0)
+    {
+      return -1;
+    }
+  UnixFd *out = AcquireFd (current, fd_out);
+  if (out == 0)
+    {
+      ReleaseFd (current, fd_in);
+      return -1;
+    }
+  PipeFd *pipeIn = dynamic_cast<PipeFd *> (in);
+  PipeFd *pipeOut = dynamic_cast<PipeFd *> (out);
+  ssize_t ret;
+  if (pipeIn != 0 && pipeOut != 0)
+    {
+      ret = pipeIn->Tee (pipeOut, len, flags & SPLICE_F_NONBLOCK);
+    }
+  else
+    {
+      current->err = EINVAL;
+      ret = -1;
+    }
+  ReleaseFd (current, fd_out);
+  ReleaseFd (current, fd_in);
+  return ret;
+}
+ssize_t dce_vmsplice (int fd, const struct iovec *iov, size_t nr_segs, unsigned int flags)
+{
+  Thread *current = Current ();
+  NS_LOG_FUNCTION (current << UtilsGetNodeId () << fd << iov << nr_segs << flags);
+  NS_ASSERT (current != 0);
+
+  UnixFd *file = AcquireFd (current, fd);
+  if (file == 0)
+    {
+      return -1;
+    }
+  PipeFd *pipe = dynamic_cast<PipeFd *> (file);
+  ssize_t ret;
+  if (pipe != 0)
+    {
+      ret = pipe->Vmsplice (iov, nr_segs, flags & SPLICE_F_NONBLOCK);
+    }
+  else
+    {
+      current->err = EBADF;
+      ret = -1;
+    }
+  ReleaseFd (current, fd);
+  return ret;
+}
@@ -32,6 +32,7 @@
 #include "sys/dce-stat.h"
 #include "loader-factory.h"
 #include "ns3/node.h"
+#include "ns3/node-list.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/ipv4-address.h"
@@ -39,6 +40,7 @@
 #include "ns3/ptr.h"
 #include "ns3/uinteger.h"
 #include "ns3/boolean.h"
+#include "ns3/nstime.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/enum.h"
 #include "file-usage.h"
@@ -46,6 +48,9 @@
 #include "waiter.h"
 #include "dce-dirent.h"
 #include "exec-utils.h"
+#include "startup-profiler.h"
+#include "libc-profile.h"
+#include "tmpfs.h"
 
 #include <errno.h>
 #include <dlfcn.h>
@@ -57,6 +62,8 @@
 #include <signal.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <fstream>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("DceManager");
 
@@ -66,6 +73,23 @@ NS_OBJECT_ENSURE_REGISTERED (DceManager);
 
 class Waiter;
 
+// The fake libraries loaded before the main binary of every process
+// and the routine used to set each of them up.
+static const struct
+{
+  const char *library;
+  const char *setup;
+  // names of the phases reported by the startup profiler.
+  const char *loadPhase;
+  const char *setupPhase;
+} g_dceLibraries[DceManager::DCE_NUM_LIBRARIES] = {
+  { "libc-ns3.so", "libc_setup", "load-libc", "setup-libc" },
+  { "libpthread-ns3.so", "libpthread_setup", "load-libpthread", "setup-libpthread" },
+  { "librt-ns3.so", "librt_setup", "load-librt", "setup-librt" },
+  { "libm-ns3.so", "libm_setup", "load-libm", "setup-libm" },
+};
+
+
 TypeId
 DceManager::GetTypeId (void)
 {
@@ -84,11 +108,56 @@ DceManager::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&DceManager::m_minimizeFiles),
                    MakeBooleanChecker ())
+    .AddAttribute ("ProcessTemplates", "If true, the first process of the node keeps a copy of the relocated and"
+                   " set-up data sections of the libraries of DCE (libc, libpthread, librt, libm) and the later"
+                   " processes of the node start from a copy of it instead of loading them again. The binary itself"
+                   " is loaded as usual, its constructors run in each process. Requires a loader able to clone"
+                   " itself (ns3::CoojaLoaderFactory): with another one, a warning is logged and the processes load"
+                   " as usual.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DceManager::m_processTemplates),
+                   MakeBooleanChecker ())
+    .AddAttribute ("StartupProfiling", "If true, record the host time spent in each phase of the creation of the processes"
+                   " (CreateProcess, PrepareDoStartProcess, LoadMain and Execve). The profile of each process is appended"
+                   " to its status file and a per-binary report is appended to the file 'startup-profile' when the"
+                   " manager is disposed, 'startup-profile-<rank>' for the other MPI ranks than 0.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DceManager::m_startupProfiling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SyscallProfiling", "If true, the processes created from now on count the calls to each function of"
+                   " the DCE libc and the host time spent in them, not including the time spent blocked. The top entries"
+                   " of each process are appended to its status file and the profile of the node is appended to the file"
+                   " 'syscall-profile' when the manager is disposed.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DceManager::m_syscallProfiling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SyscallProfilingTopN", "The number of entries of the reports of SyscallProfiling.",
+                   UintegerValue (20),
+                   MakeUintegerAccessor (&DceManager::m_syscallProfilingTopN),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("SpinDetection", "If true, a thread which keeps making non-blocking calls without progress (poll,"
+                   " select or epoll_wait with a 0 timeout, read or recv giving EAGAIN, sched_yield) at the same simulated"
+                   " time waits longer and longer, for one of the files it polls if any. If false, a call repeated at the same time waits 1us, as before.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&DceManager::m_spinDetection),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SpinThreshold", "The number of calls without progress after which the wait of SpinDetection"
+                   " doubles at each call.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&DceManager::m_spinThreshold),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("SpinMaxWait", "The longest wait of SpinDetection.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&DceManager::m_spinMaxWait),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
 
 DceManager::DceManager ()
+  : m_profiler (0),
+    m_syscallProfile (0),
+    m_socketProcess (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -112,9 +181,68 @@ DceManager::DoDispose (void)
       DeleteProcess (tmp, PEC_NS3_END);
     }
   mapCopy.clear ();
+  m_socketProcess = 0;
+  for (std::vector<std::pair<std::string, Ptr<Tmpfs> > >::iterator i = m_mounts.begin ();
+       i != m_mounts.end (); ++i)
+    {
+      i->second->Dispose ();
+    }
+  m_mounts.clear ();
+  if (m_profiler != 0)
+    {
+      WriteStartupReport ();
+      delete m_profiler;
+      m_profiler = 0;
+    }
+  if (m_syscallProfile != 0)
+    {
+      WriteSyscallReport ();
+      delete m_syscallProfile;
+      m_syscallProfile = 0;
+    }
   Object::DoDispose ();
 }
 
+StartupProfiler *
+DceManager::PeekProfiler (void)
+{
+  if (m_startupProfiling && m_profiler == 0)
+    {
+      m_profiler = new StartupProfiler ();
+    }
+  return m_profiler;
+}
+
+void
+DceManager::WriteStartupReport (void)
+{
+  // the nodes of one rank append to its own file.
+  std::string file = UtilsGetRankFile ("startup-profile", UtilsGetSystemId ());
+  std::ofstream report (file.c_str (), std::ios::out | std::ios::app);
+  if (!report)
+    {
+      NS_LOG_ERROR ("Could not open " << file);
+      return;
+    }
+  Ptr<Node> node = GetObject<Node> ();
+  report << "NODE " << ((node != 0) ? node->GetId () : UtilsGetNodeId ()) << std::endl;
+  m_profiler->Report (report);
+}
+
+void
+DceManager::WriteSyscallReport (void)
+{
+  std::ofstream report ("syscall-profile", std::ios::out | std::ios::app);
+  if (!report)
+    {
+      NS_LOG_ERROR ("Could not open syscall-profile");
+      return;
+    }
+  Ptr<Node> node = GetObject<Node> ();
+  report << "NODE " << ((node != 0) ? node->GetId () : UtilsGetNodeId ()) << std::endl;
+  m_syscallProfile->Report (report, m_syscallProfilingTopN, "  ");
+}
+
 struct ::Libc *
 DceManager::GetLibc (void)
 {
@@ -127,6 +255,18 @@ DceManager::GetLibc (void)
   return libc;
 }
 
+struct ::Libc *
+DceManager::GetProfiledLibc (void)
+{
+  static struct ::Libc *libc = 0;
+  if (libc != 0)
+    {
+      return libc;
+    }
+  libc_profile (GetLibc (), &libc);
+  return libc;
+}
+
 void
 DceManager::EnsureDirectoryExists (struct Thread *current, std::string dirName)
 {
@@ -174,9 +314,14 @@ int (*DceManager::PrepareDoStartProcess (Thread * current)) (int, char **, char
   int (*main)(int, char **, char **) = 0;
   GetLibc ();
   UnixFd *unixFd = 0;
+  StartupProfiler *profiler = current->process->manager->PeekProfiler ();
+  uint64_t start = (profiler != 0) ? UtilsGetHostTime () : 0;
+  uint16_t pid = current->process->pid;
+  std::string binary = current->process->name;
 
   if (current->process->stdinFilename.length () > 0)
     {
+      StartupProfiler::Span span (profiler, pid, binary, "open-stdin");
       std::string fullpath = UtilsGetRealFilePath (current->process->stdinFilename);
       int realFd = ::open (fullpath.c_str (), O_RDONLY, 0);
 
@@ -194,38 +339,41 @@ int (*DceManager::PrepareDoStartProcess (Thread * current)) (int, char **, char
   unixFd->IncFdCount ();
   current->process->openFiles[0] = new FileUsage (0, unixFd);
 
-  // create fd 1
-  int fd = CreatePidFile (current, "stdout");
-  NS_ASSERT (fd == 1);
-  // create fd 2
-  fd = CreatePidFile (current, "stderr");
-  NS_ASSERT (fd == 2);
-
-  fd = CreatePidFile (current, "cmdline");
-  NS_ASSERT (fd == 3);
-  for (int i = 0; i < current->process->originalArgc; i++)
-    {
-      char *cur = current->process->originalArgv[i];
-      dce_write (fd, cur, strlen (cur));
-      dce_write (fd, " ", 1);
-      current->process->timing.cmdLine += cur;
-      if (i < (current->process->originalArgc - 1))
-        {
-          current->process->timing.cmdLine += ' ';
-        }
-    }
-  dce_write (fd, "\n", 1);
-  dce_close (fd);
-
-  fd = CreatePidFile (current, "status");
-  NS_ASSERT (fd == 3);
   {
-    std::ostringstream oss;
-    oss << "Start Time: " << GetTimeStamp () << std::endl;
-    std::string tmp = oss.str ();
-    const char *str = tmp.c_str ();
-    dce_write (fd, str, strlen (str));
+    StartupProfiler::Span span (profiler, pid, binary, "pid-files");
+    // create fd 1
+    int fd = CreatePidFile (current, "stdout");
+    NS_ASSERT (fd == 1);
+    // create fd 2
+    fd = CreatePidFile (current, "stderr");
+    NS_ASSERT (fd == 2);
+
+    fd = CreatePidFile (current, "cmdline");
+    NS_ASSERT (fd == 3);
+    for (int i = 0; i < current->process->originalArgc; i++)
+      {
+        char *cur = current->process->originalArgv[i];
+        dce_write (fd, cur, strlen (cur));
+        dce_write (fd, " ", 1);
+        current->process->timing.cmdLine += cur;
+        if (i < (current->process->originalArgc - 1))
+          {
+            current->process->timing.cmdLine += ' ';
+          }
+      }
+    dce_write (fd, "\n", 1);
     dce_close (fd);
+
+    fd = CreatePidFile (current, "status");
+    NS_ASSERT (fd == 3);
+    {
+      std::ostringstream oss;
+      oss << "Start Time: " << GetTimeStamp () << std::endl;
+      std::string tmp = oss.str ();
+      const char *str = tmp.c_str ();
+      dce_write (fd, str, strlen (str));
+      dce_close (fd);
+    }
   }
   std::string vpath = "";
   char *pvpath = seek_env ("PATH", current->process->originalEnvp);
@@ -234,7 +382,11 @@ int (*DceManager::PrepareDoStartProcess (Thread * current)) (int, char **, char
       vpath = std::string (pvpath);
     }
   int errNo = 0;
-  std::string exeFullPath = SearchExecFile (current->process->originalArgv[0], vpath, getuid (), getgid (), &errNo);
+  std::string exeFullPath;
+  {
+    StartupProfiler::Span span (profiler, pid, binary, "search-exec");
+    exeFullPath = SearchExecFile (current->process->originalArgv[0], vpath, getuid (), getgid (), &errNo);
+  }
 
   if (exeFullPath.length () <= 0)
     {
@@ -247,10 +399,13 @@ int (*DceManager::PrepareDoStartProcess (Thread * current)) (int, char **, char
       return 0;
     }
 
-  main = (int (*) (int, char **, char **))LoadMain (current->process->loader,
-                                                    exeFullPath,
-                                                    current->process,
-                                                    err);
+  {
+    StartupProfiler::Span span (profiler, pid, binary, "load-main");
+    main = (int (*) (int, char **, char **))LoadMain (current->process->loader,
+                                                      exeFullPath,
+                                                      current->process,
+                                                      err);
+  }
 
   if (!main)
     {
@@ -265,6 +420,12 @@ int (*DceManager::PrepareDoStartProcess (Thread * current)) (int, char **, char
       std::string  line = "Starting: " + exeFullPath;
       AppendStatusFile (current->process->pid, current->process->nodeId, line);
     }
+  if (profiler != 0)
+    {
+      profiler->Record (pid, binary, "prepare-start", UtilsGetHostTime () - start);
+      std::string line = profiler->Flush (pid);
+      AppendStatusFile (current->process->pid, current->process->nodeId, line);
+    }
 
   return main;
 }
@@ -294,6 +455,8 @@ DceManager::CreateProcess (std::string name, std::string stdinfilename, std::vec
                            std::vector<std::pair<std::string,std::string> > envs, int pid)
 {
   struct Process *process = new Process ();
+  process->pid = pid ? pid : AllocatePid ();
+  StartupProfiler::Span span (PeekProfiler (), process->pid, name, "create-process");
   process->euid = 0;
   process->ruid = 0;
   process->suid = 0;
@@ -304,11 +467,17 @@ DceManager::CreateProcess (std::string name, std::string stdinfilename, std::vec
   process->originalArgv = 0;
   process->originalArgc = 0;
   process->originalEnvp = 0;
-  SetArgv (process, name, args);
-  SetEnvp (process, envs);
-  Ptr<LoaderFactory> loaderFactory = this->GetObject<LoaderFactory> ();
-  process->loader = loaderFactory->Create (process->originalArgc, process->originalArgv,
-                                           process->originalEnvp);
+  {
+    StartupProfiler::Span span (PeekProfiler (), process->pid, name, "argv-envp");
+    SetArgv (process, name, args);
+    SetEnvp (process, envs);
+  }
+  {
+    StartupProfiler::Span span (PeekProfiler (), process->pid, name, "loader-create");
+    Ptr<LoaderFactory> loaderFactory = this->GetObject<LoaderFactory> ();
+    process->loader = loaderFactory->Create (process->originalArgc, process->originalArgv,
+                                             process->originalEnvp);
+  }
   process->timing.exitValue = 0;
   process->timing.ns3Start = Now ().GetNanoSeconds ();
   process->timing.realStart = time (0);
@@ -319,9 +488,9 @@ DceManager::CreateProcess (std::string name, std::string stdinfilename, std::vec
   process->name = name;
   process->ppid = 0;
   process->pgid = 0;
-  process->pid = pid ? pid : AllocatePid ();
   process->manager = this;
-  sigemptyset (&process->pendingSignals);
+  process->pendingSignals = 0;
+  process->itimerStalled = false;
 
   SetDefaultSigHandler (process->signalHandlers);
 
@@ -355,6 +524,11 @@ DceManager::CreateProcess (std::string name, std::string stdinfilename, std::vec
 
   process->minimizeFiles = (m_minimizeFiles ? 1 : 0);
 
+  process->syscallProfile = m_syscallProfiling ? new SyscallProfile () : 0;
+  process->spinCalls = 0;
+  process->spinWaits = 0;
+  process->spinSkipped = Time (0);
+
   if (!pid)
     {
       m_processes[process->pid] = process;
@@ -371,8 +545,16 @@ DceManager::TaskSwitch (enum Task::SwitchType type, void *context)
     case Task::TO:
       process->loader->NotifyStartExecute ();
       process->alloc->SwitchTo ();
+      if (process->syscallProfile != 0)
+        {
+          SyscallProfileSwitchTo (Current ());
+        }
       break;
     case Task::FROM:
+      if (process->syscallProfile != 0)
+        {
+          SyscallProfileSwitchFrom (Current ());
+        }
       process->loader->NotifyEndExecute ();
       break;
     }
@@ -389,7 +571,11 @@ DceManager::Start (std::string name, std::string stdinfilename, std::vector<std:
   process->rgid = gid;
   process->egid = egid;
   struct Thread *thread = CreateThread (process);
-  Task *task = TaskManager::Current ()->Start (&DceManager::DoStartProcess, thread);
+  Task *task;
+  {
+    StartupProfiler::Span span (PeekProfiler (), process->pid, name, "fiber-create");
+    task = TaskManager::Current ()->Start (&DceManager::DoStartProcess, thread);
+  }
   task->SetContext (thread);
   task->SetSwitchNotifier (&DceManager::TaskSwitch, process);
   thread->task = task;
@@ -408,7 +594,11 @@ DceManager::Start (std::string name, std::string stdinfilename, uint32_t stackSi
   process->rgid = gid;
   process->egid = egid;
   struct Thread *thread = CreateThread (process);
-  Task *task = TaskManager::Current ()->Start (&DceManager::DoStartProcess, thread, stackSize);
+  Task *task;
+  {
+    StartupProfiler::Span span (PeekProfiler (), process->pid, name, "fiber-create");
+    task = TaskManager::Current ()->Start (&DceManager::DoStartProcess, thread, stackSize);
+  }
   task->SetContext (thread);
   task->SetSwitchNotifier (&DceManager::TaskSwitch, process);
   thread->task = task;
@@ -459,6 +649,22 @@ DceManager::SuspendTemporaryTask (uint16_t pid)
   TaskManager::Current ()->LeaveHiTask (thread->task);
   return;
 }
+struct Process *
+DceManager::GetSocketProcess (void)
+{
+  if (m_socketProcess == 0)
+    {
+      std::vector<std::string> nullargs;
+      std::vector<std::pair<std::string,std::string> > envs;
+      m_socketProcess = CreateProcess ("socket", "dummy-stdin", nullargs, envs, 0);
+      struct Thread *thread = CreateThread (m_socketProcess);
+      Task *task = new Task ();
+      task->SetContext (thread);
+      thread->task = task;
+      NS_LOG_FUNCTION (this << m_socketProcess->pid);
+    }
+  return m_socketProcess;
+}
 void
 DceManager::StopTemporaryTask (uint16_t pid)
 {
@@ -529,9 +735,14 @@ DceManager::CreateThread (struct Process *process)
   thread->hasExitValue = false;
   thread->joinWaiter = 0;
   thread->lastTime = Time (0);
+  thread->spinCount = 0;
   thread->childWaiter = 0;
   thread->pollTable = 0;
+  thread->pollTableCache = 0;
   thread->ioWait = std::make_pair ((UnixFd*)0,(WaitQueueEntry*)0);
+  thread->profileBlocked = 0;
+  thread->profileSwitchOut = 0;
+  thread->pendingSignals = 0;
   sigemptyset (&thread->signalMask);
   if (!process->threads.empty ())
     {
@@ -624,7 +835,8 @@ DceManager::Clone (Thread *thread)
   // don't copy threads, semaphores, mutexes, condition vars
   // XXX: what about file streams ?
   clone->manager = this;
-  sigemptyset (&clone->pendingSignals);
+  clone->pendingSignals = 0;
+  clone->itimerStalled = false;
 
   SetDefaultSigHandler (clone->signalHandlers);
 
@@ -636,6 +848,11 @@ DceManager::Clone (Thread *thread)
   clone->pstdout = thread->process->pstdout;
   clone->pstderr = thread->process->pstderr;
   clone->penvp = thread->process->penvp;
+  // the child runs the same, possibly profiled, libc table.
+  clone->syscallProfile = (thread->process->syscallProfile != 0) ? new SyscallProfile () : 0;
+  clone->spinCalls = 0;
+  clone->spinWaits = 0;
+  clone->spinSkipped = Time (0);
 
   //"seeding" random variable
   clone->rndVarible = UniformVariable (0, RAND_MAX);
@@ -706,6 +923,36 @@ DceManager::Stop (uint16_t pid)
   AppendStatusFile (process->pid, process->nodeId, statusWord);
   DeleteProcess (process, PEC_NS3_STOP);
 }
+Time
+DceManager::NotifySpin (Thread *thread)
+{
+  NS_LOG_FUNCTION (this << thread << thread->spinCount);
+  if (!m_spinDetection)
+    {
+      // a repeated call at the same time still lets time move.
+      return (Now () == thread->lastTime) ? MicroSeconds (1) : Time (0);
+    }
+  Process *process = thread->process;
+  process->spinCalls++;
+  if (Now () != thread->lastTime)
+    {
+      thread->spinCount = 0;
+    }
+  thread->spinCount++;
+  if (thread->spinCount < 2)
+    {
+      // the first call at this time.
+      return Time (0);
+    }
+  process->spinWaits++;
+  if (thread->spinCount <= m_spinThreshold)
+    {
+      return MicroSeconds (1);
+    }
+  uint32_t shift = std::min (thread->spinCount - m_spinThreshold, (uint32_t)40);
+  Time wait = MicroSeconds (((int64_t)1) << shift);
+  return (wait < m_spinMaxWait) ? wait : m_spinMaxWait;
+}
 void
 DceManager::SigkillHandler (int signal)
 {
@@ -766,6 +1013,11 @@ DceManager::DeleteThread (struct Thread *thread)
       thread->childWaiter = 0;
       delete lb;
     }
+  if (0 != thread->pollTableCache)
+    {
+      delete thread->pollTableCache;
+      thread->pollTableCache = 0;
+    }
   delete thread;
 }
 
@@ -774,6 +1026,36 @@ DceManager::DeleteProcess (struct Process *process, ProcessEndCause type)
 {
   NS_LOG_FUNCTION (this << process << "pid" << std::dec << process->pid << "ppid" << process->ppid);
 
+  if (m_profiler != 0)
+    {
+      // forget the spans of a process which did not complete its startup.
+      m_profiler->Flush (process->pid);
+    }
+  if (process->syscallProfile != 0)
+    {
+      if (!process->syscallProfile->IsEmpty ())
+        {
+          std::string line = process->syscallProfile->Summary (m_syscallProfilingTopN);
+          AppendStatusFile (process->pid, process->nodeId, line);
+          if (m_syscallProfile == 0)
+            {
+              m_syscallProfile = new SyscallProfile ();
+            }
+          m_syscallProfile->Add (*process->syscallProfile);
+        }
+      delete process->syscallProfile;
+      process->syscallProfile = 0;
+    }
+  if (process->spinWaits != 0)
+    {
+      std::ostringstream oss;
+      oss << "Busy poll: " << process->spinCalls << " calls without progress, "
+          << process->spinWaits << " waits, " << process->spinSkipped.GetSeconds () << "s skipped.";
+      std::string line = oss.str ();
+      AppendStatusFile (process->pid, process->nodeId, line);
+      NS_LOG_INFO ("pid " << process->pid << " " << line);
+    }
+
   // Remove Threads Waiters
   struct Thread *tmp;
   std::vector<Thread *> threads = process->threads;
@@ -1029,6 +1311,25 @@ void
 DceManager::AppendStatusFile (uint16_t pid, uint32_t nodeId,  std::string &line)
 {
   std::ostringstream oss;
+  oss << "/var/log/" << pid << "/status";
+  Ptr<Node> node = (nodeId < NodeList::GetNNodes ()) ? NodeList::GetNode (nodeId) : 0;
+  Ptr<DceManager> manager = (node != 0) ? node->GetObject<DceManager> () : 0;
+  std::string rest;
+  Ptr<Tmpfs> fs = (manager != 0) ? manager->LookupTmpfs (oss.str (), &rest) : 0;
+  if (fs != 0)
+    {
+      Ptr<TmpfsInode> inode;
+      if (fs->Open (rest, O_WRONLY, 0, &inode) == 0)
+        {
+          std::ostringstream entry;
+          entry << "      Time: " << GetTimeStamp () << " --> " << line << std::endl;
+          std::string wholeLine = entry.str ();
+          fs->Write (inode, wholeLine.c_str (), wholeLine.length (), inode->GetSize ());
+        }
+      return;
+    }
+  oss.str ("");
+  oss.clear ();
   oss << "files-" << nodeId << "/var/log/" << pid << "/status";
   std::string s = oss.str ();
 
@@ -1047,6 +1348,69 @@ DceManager::AppendStatusFile (uint16_t pid, uint32_t nodeId,  std::string &line)
     }
 }
 void
+DceManager::Mount (std::string path, Ptr<Tmpfs> fs)
+{
+  NS_LOG_FUNCTION (this << path << fs);
+  while (path.size () > 1 && path[path.size () - 1] == '/')
+    {
+      path.resize (path.size () - 1);
+    }
+  NS_ASSERT_MSG (path.size () > 1 && path[0] == '/', "Cannot mount on " << path);
+  Ptr<Node> node = GetObject<Node> ();
+  fs->SetMountPoint ((node != 0) ? node->GetId () : 0, path);
+  m_mounts.push_back (std::make_pair (path, fs));
+}
+Ptr<Tmpfs>
+DceManager::LookupTmpfs (std::string path, std::string *rest) const
+{
+  if (m_mounts.empty ())
+    {
+      return 0;
+    }
+  // normalize: no //, . nor ..
+  std::string vpath = UtilsGetVirtualFilePath (path);
+  std::vector<std::string> components;
+  std::string::size_type start = 0;
+  while (start <= vpath.size ())
+    {
+      std::string::size_type end = vpath.find ('/', start);
+      if (end == std::string::npos)
+        {
+          end = vpath.size ();
+        }
+      std::string component = vpath.substr (start, end - start);
+      if (component == "..")
+        {
+          if (!components.empty ())
+            {
+              components.pop_back ();
+            }
+        }
+      else if (!component.empty () && component != ".")
+        {
+          components.push_back (component);
+        }
+      start = end + 1;
+    }
+  std::string normalized;
+  for (std::vector<std::string>::const_iterator i = components.begin (); i != components.end (); ++i)
+    {
+      normalized += "/" + *i;
+    }
+  for (std::vector<std::pair<std::string, Ptr<Tmpfs> > >::const_iterator i = m_mounts.begin ();
+       i != m_mounts.end (); ++i)
+    {
+      const std::string &mount = i->first;
+      if (normalized.compare (0, mount.size (), mount) == 0
+          && (normalized.size () == mount.size () || normalized[mount.size ()] == '/'))
+        {
+          *rest = (normalized.size () == mount.size ()) ? "" : normalized.substr (mount.size () + 1);
+          return i->second;
+        }
+    }
+  return 0;
+}
+void
 DceManager::AppendProcFile (Process *p)
 {
   if (!p)
@@ -1054,7 +1418,9 @@ DceManager::AppendProcFile (Process *p)
       return;
     }
   std::ostringstream oss;
-  int fd = ::open ("exitprocs", O_WRONLY | O_APPEND | O_CREAT, 0644);
+  // one file per rank, the others write theirs at the same time.
+  std::string file = UtilsGetExitProcsFile (UtilsGetSystemId ());
+  int fd = ::open (file.c_str (), O_WRONLY | O_APPEND | O_CREAT, 0644);
 
   if (fd >= 0)
     {
@@ -1192,95 +1558,111 @@ DceManager::CopyEnv (char *const envp[], std::vector<std::pair<std::string,std::
 void*
 DceManager::LoadMain (Loader *ld, std::string filename, Process *proc, int &err)
 {
-  void *h = ld->Load ("libc-ns3.so", RTLD_GLOBAL);
-  void *symbol = 0;
-  struct ::Libc *libc = GetLibc ();
-
-  if (h == 0)
+  bool useTemplate = proc->manager != 0 && proc->manager->m_processTemplates;
+  StartupProfiler *profiler = (proc->manager != 0) ? proc->manager->PeekProfiler () : 0;
+  struct ::Libc *libc = (proc->syscallProfile != 0) ? GetProfiledLibc () : GetLibc ();
+  bool loaded = false;
+  if (useTemplate)
     {
-      err = ENOMEM;
-      return 0;
+      NS_ASSERT (ld == proc->loader);
+      StartupProfiler::Span span (profiler, proc->pid, filename, "template-clone");
+      loaded = LoadLibrariesFromTemplate (proc, libc);
+      ld = proc->loader;
     }
-  else
+
+  void *setups[DCE_NUM_LIBRARIES];
+  void *h = 0;
+  void *symbol = 0;
+
+  for (uint32_t i = 0; i < DCE_NUM_LIBRARIES && !loaded; i++)
     {
-      symbol = ld->Lookup (h, "libc_setup");
+      {
+        StartupProfiler::Span span (profiler, proc->pid, filename, g_dceLibraries[i].loadPhase);
+        h = ld->Load (g_dceLibraries[i].library, RTLD_GLOBAL);
+      }
+      if (h == 0)
+        {
+          err = ENOMEM;
+          return 0;
+        }
+      symbol = ld->Lookup (h, g_dceLibraries[i].setup);
       if (symbol == 0)
         {
-          NS_FATAL_ERROR ("This is not our fake libc !");
+          NS_FATAL_ERROR ("This is not our fake " << g_dceLibraries[i].library << " !");
         }
-      // construct the libc now
-      void (*libc_setup)(const struct Libc *fn);
-      libc_setup = (void (*) (const struct Libc *))(symbol);
-      libc_setup (libc);
+      // construct the library now
+      setups[i] = symbol;
+      void (*setup)(const struct Libc *fn);
+      setup = (void (*) (const struct Libc *))(symbol);
+      StartupProfiler::Span span (profiler, proc->pid, filename, g_dceLibraries[i].setupPhase);
+      setup (libc);
+    }
 
-      h = ld->Load ("libpthread-ns3.so", RTLD_GLOBAL);
-      if (h == 0)
+  if (useTemplate && !loaded)
+    {
+      // Only the libraries of DCE, before the binary is loaded: what its
+      // constructors allocate and register belongs to its process.
+      Loader *clone = ld->Clone ();
+      if (clone != 0)
         {
-          err = ENOMEM;
-          return 0;
+          Ptr<LoaderFactory> factory = proc->manager->GetObject<LoaderFactory> ();
+          factory->SetTemplate (clone, std::vector<void *> (setups, setups + DCE_NUM_LIBRARIES));
+          NS_LOG_DEBUG ("Saved the process template");
         }
       else
         {
-          symbol = ld->Lookup (h, "libpthread_setup");
-          if (symbol == 0)
-            {
-              NS_FATAL_ERROR ("This is not our fake libpthread !");
-            }
-          // construct libpthread now
-          void (*libpthread_setup)(const struct Libc *fn);
-          libpthread_setup = (void (*) (const struct Libc *))(symbol);
-          libpthread_setup (libc);
-
-          h = ld->Load ("librt-ns3.so", RTLD_GLOBAL);
-          if (h == 0)
-            {
-              err = ENOMEM;
-              return 0;
-            }
-          symbol = ld->Lookup (h, "librt_setup");
-          if (symbol == 0)
-            {
-              NS_FATAL_ERROR ("This is not our fake librt !");
-            }
-          // construct librt now
-          void (*librt_setup)(const struct Libc *fn);
-          librt_setup = (void (*) (const struct Libc *))(symbol);
-          librt_setup (libc);
-
-          h = ld->Load ("libm-ns3.so", RTLD_GLOBAL);
-          if (h == 0)
-            {
-              err = ENOMEM;
-              return 0;
-            }
-          symbol = ld->Lookup (h, "libm_setup");
-          if (symbol == 0)
-            {
-              NS_FATAL_ERROR ("This is not our fake libm !");
-            }
-          // construct libm now
-          void (*libm_setup)(const struct Libc *fn);
-          libm_setup = (void (*) (const struct Libc *))(symbol);
-          libm_setup (libc);
+          // said once: the processes of this node load as usual.
+          NS_LOG_WARN ("ProcessTemplates is ignored: the loader of node " << proc->nodeId
+                       << " cannot clone itself, use ns3::CoojaLoaderFactory");
+          proc->manager->m_processTemplates = false;
+        }
+    }
 
-          // finally, call into 'main'.
-          h = ld->Load (filename, RTLD_GLOBAL);
+  // finally, call into 'main'.
+  {
+    StartupProfiler::Span span (profiler, proc->pid, filename, "load-binary");
+    h = ld->Load (filename, RTLD_GLOBAL);
+  }
 
-          if (h == 0)
-            {
-              err = EACCES;
-              return 0;
-            }
-          else
-            {
-              proc->mainHandle = h;
-              symbol = ld->Lookup (h, "main");
-              err = (0 != symbol) ? 0 : ENOEXEC;
-            }
-        }
+  if (h == 0)
+    {
+      err = EACCES;
+      return 0;
     }
+  proc->mainHandle = h;
+  symbol = ld->Lookup (h, "main");
+  err = (0 != symbol) ? 0 : ENOEXEC;
   return symbol;
 }
+bool
+DceManager::LoadLibrariesFromTemplate (Process *proc, struct ::Libc *libc)
+{
+  Ptr<LoaderFactory> factory = proc->manager->GetObject<LoaderFactory> ();
+  if (factory->PeekTemplate () == 0)
+    {
+      return false;
+    }
+  Loader *ld = factory->PeekTemplate ()->Clone ();
+  if (ld == 0)
+    {
+      return false;
+    }
+  NS_LOG_DEBUG ("Start the libraries of " << proc->pid << " from the process template");
+  delete proc->loader;
+  proc->loader = ld;
+  // make the copied data sections the live ones.
+  ld->NotifyStartExecute ();
+
+  // The Libc table is already in place but the per-process variables
+  // (stdin, environ, progname...) must be set up again.
+  for (uint32_t j = 0; j < DCE_NUM_LIBRARIES; j++)
+    {
+      void (*setup)(const struct Libc *fn);
+      setup = (void (*) (const struct Libc *))(factory->GetTemplateSetups ()[j]);
+      setup (libc);
+    }
+  return true;
+}
 void
 DceManager::DoExecProcess (void *c)
 {
@@ -1294,22 +1676,26 @@ DceManager::DoExecProcess (void *c)
   dce_exit (retval);
 }
 void
-DceManager::SetDefaultSigHandler (std::vector<SignalHandler> &signalHandlers)
+DceManager::SetDefaultSigHandler (struct SignalHandler *signalHandlers)
 {
+  for (int i = 0; i < DCE_NSIG; i++)
+    {
+      signalHandlers[i].signal = 0;
+    }
+
   // setup a signal handler for SIGKILL which calls dce_exit.
-  struct SignalHandler handler;
-  handler.signal = SIGKILL;
-  handler.flags = 0;
-  sigemptyset (&handler.mask);
-  handler.handler = &DceManager::SigkillHandler;
-  signalHandlers.push_back (handler);
+  struct SignalHandler *handler = &signalHandlers[SIGKILL - 1];
+  handler->signal = SIGKILL;
+  handler->flags = 0;
+  sigemptyset (&handler->mask);
+  handler->handler = &DceManager::SigkillHandler;
 
   // setup a signal handler for SIGABRT which calls dce_exit.
-  handler.signal = SIGABRT;
-  handler.flags = 0;
-  sigemptyset (&handler.mask);
-  handler.handler = &DceManager::SigabrtHandler;
-  signalHandlers.push_back (handler);
+  handler = &signalHandlers[SIGABRT - 1];
+  handler->signal = SIGABRT;
+  handler->flags = 0;
+  sigemptyset (&handler->mask);
+  handler->handler = &DceManager::SigabrtHandler;
 }
 int
 DceManager::Execve (const char *path, const char *argv0, char *const argv[], char *const envp[])
@@ -1318,6 +1704,12 @@ DceManager::Execve (const char *path, const char *argv0, char *const argv[], cha
   Process *process = Current ()->process;
   std::vector<std::pair<std::string,std::string> > envs;
   memset (&pTemp, 0, sizeof (Process));
+  pTemp.manager = this;
+  pTemp.pid = process->pid;
+  // LoadMain binds the profiled libc to the new image too.
+  pTemp.syscallProfile = process->syscallProfile;
+  StartupProfiler *profiler = PeekProfiler ();
+  uint64_t start = (profiler != 0) ? UtilsGetHostTime () : 0;
 
   // Parse Verify environnement and arguments
   if (CopyEnv (envp, envs))
@@ -1374,8 +1766,11 @@ DceManager::Execve (const char *path, const char *argv0, char *const argv[], cha
   AppendStatusFile (process->pid, process->nodeId, line);
 
   // Try to load the code and find a MAIN
-  Ptr<LoaderFactory> loaderFactory = this->GetObject<LoaderFactory> ();
-  pTemp.loader = loaderFactory->Create (pTemp.originalArgc, pTemp.originalArgv, pTemp.originalEnvp);
+  {
+    StartupProfiler::Span span (profiler, process->pid, filename, "loader-create");
+    Ptr<LoaderFactory> loaderFactory = this->GetObject<LoaderFactory> ();
+    pTemp.loader = loaderFactory->Create (pTemp.originalArgc, pTemp.originalArgv, pTemp.originalEnvp);
+  }
 
   int err = 0;
 
@@ -1393,7 +1788,11 @@ DceManager::Execve (const char *path, const char *argv0, char *const argv[], cha
   process->penvp = 0;
   process->originalProgname = pTemp.originalProgname;
 
-  void *main = LoadMain (pTemp.loader, filename, &pTemp, err);
+  void *main;
+  {
+    StartupProfiler::Span span (profiler, process->pid, filename, "load-main");
+    main = LoadMain (pTemp.loader, filename, &pTemp, err);
+  }
 
   if (!main)
     {
@@ -1434,8 +1833,12 @@ DceManager::Execve (const char *path, const char *argv0, char *const argv[], cha
 
   struct Thread *thread = CreateThread (process);
 
-  Task *task = TaskManager::Current ()->Start (&DceManager::DoExecProcess, main,
-                                               TaskManager::Current ()->GetStackSize (Current ()->task));
+  Task *task;
+  {
+    StartupProfiler::Span span (profiler, process->pid, filename, "fiber-create");
+    task = TaskManager::Current ()->Start (&DceManager::DoExecProcess, main,
+                                           TaskManager::Current ()->GetStackSize (Current ()->task));
+  }
   task->SetContext (thread);
   task->SetSwitchNotifier (&DceManager::TaskSwitch, process);
   thread->task = task;
@@ -1458,7 +1861,6 @@ DceManager::Execve (const char *path, const char *argv0, char *const argv[], cha
   process->originalEnvp = pTemp.originalEnvp;
   *process->penvp = process->originalEnvp;
   process->name = std::string (path);
-  process->signalHandlers.clear ();
   SetDefaultSigHandler (process->signalHandlers);
   process->atExitHandlers.clear ();
   process->nextMid = process->nextSid = process->nextCid = 0;
@@ -1523,6 +1925,12 @@ DceManager::Execve (const char *path, const char *argv0, char *const argv[], cha
 
   line = "EXEC SUCCESS";
   AppendStatusFile (process->pid, process->nodeId, line);
+  if (profiler != 0)
+    {
+      profiler->Record (process->pid, filename, "exec", UtilsGetHostTime () - start);
+      line = profiler->Flush (process->pid);
+      AppendStatusFile (process->pid, process->nodeId, line);
+    }
   TaskManager::Current ()->Exit ();
   // NEVER REACHED
   return -1;
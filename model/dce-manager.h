@@ -37,6 +37,9 @@ struct Process;
 struct Thread;
 struct SignalHandler;
 class Loader;
+class StartupProfiler;
+struct SyscallProfile;
+class Tmpfs;
 
 
 /**
@@ -80,6 +83,10 @@ public:
     PEC_NS3_END, // NO MORE EVENTS
     PEC_NS3_STOP, // STOP AT PREDEFINED TIME
   } ProcessEndCause;
+  enum
+  {
+    DCE_NUM_LIBRARIES = 4, // libc, libpthread, librt and libm
+  };
 
   static TypeId GetTypeId (void);
 
@@ -123,8 +130,22 @@ public:
   void StopTemporaryTask (uint16_t pid);
   void ResumeTemporaryTask (uint16_t pid);
   void SuspendTemporaryTask (uint16_t pid);
+  // The process in which the sockets of the node call the kernel, created
+  // the first time. Its first thread has a task to enter with EnterHiTask.
+  struct Process * GetSocketProcess (void);
   struct Process* CreateProcess (std::string name, std::string stdinfilename, std::vector<std::string> args,
                                  std::vector<std::pair<std::string,std::string> > envs, int pid);
+  // Keep the files below path, /tmp for example, in fs instead of files-N.
+  void Mount (std::string path, Ptr<Tmpfs> fs);
+  /**
+   * \returns the Tmpfs mounted on path or one of its parents, 0 if none,
+   * and in rest the path inside it. A relative path is relative to the
+   * cwd of the current process.
+   */
+  Ptr<Tmpfs> LookupTmpfs (std::string path, std::string *rest) const;
+  // Busy poll detection: how long thread, which made a non-blocking call
+  // without progress, should wait. See UtilsSpin.
+  Time NotifySpin (Thread *thread);
 
 private:
   // inherited from Object.
@@ -139,6 +160,8 @@ private:
   static void SigabrtHandler (int signal);
   bool ThreadExists (Thread *thread);
   static struct ::Libc * GetLibc (void);
+  // the table whose entries count their calls. See SyscallProfiling.
+  static struct ::Libc * GetProfiledLibc (void);
   void SetArgv (struct Process *process, std::string filename, std::vector<std::string> args);
   void SetEnvp (struct Process *process, std::vector<std::pair<std::string,std::string> > envp);
   static void EnsureDirectoryExists (struct Thread *current, std::string dirName);
@@ -152,8 +175,15 @@ private:
   std::vector<std::string> CopyArgs (char *const argv[]);
   int CopyEnv (char *const envp[], std::vector<std::pair<std::string,std::string> > &res);
   static void* LoadMain (Loader *ld, std::string filename, Process *proc, int &err);
+  // Process templates, held by the LoaderFactory of the node: see the
+  // ProcessTemplates attribute. false if there is no template yet.
+  static bool LoadLibrariesFromTemplate (Process *proc, struct ::Libc *libc);
+  // returns 0 unless the StartupProfiling attribute is set.
+  StartupProfiler * PeekProfiler (void);
+  void WriteStartupReport (void);
+  void WriteSyscallReport (void);
   static void DoExecProcess (void *c);
-  static void SetDefaultSigHandler (std::vector<SignalHandler> &signalHandlers);
+  static void SetDefaultSigHandler (struct SignalHandler *signalHandlers);
 
   std::map<uint16_t, Process *> m_processes; // Key is the pid
   uint16_t m_nextPid;
@@ -161,6 +191,19 @@ private:
   // If true close stderr and stdout between writes .
   bool m_minimizeFiles;
   std::string m_virtualPath;
+  bool m_processTemplates;
+  bool m_startupProfiling;
+  StartupProfiler *m_profiler;
+  bool m_syscallProfiling;
+  uint32_t m_syscallProfilingTopN;
+  // sum of the profiles of the processes of this node already deleted.
+  struct SyscallProfile *m_syscallProfile;
+  struct Process *m_socketProcess;
+  // by mount point, without trailing slash.
+  std::vector<std::pair<std::string, Ptr<Tmpfs> > > m_mounts;
+  bool m_spinDetection;
+  uint32_t m_spinThreshold;
+  Time m_spinMaxWait;
 };
 
 } // namespace ns3
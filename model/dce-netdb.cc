@@ -17,91 +17,250 @@
 #include "sys/dce-socket.h"
 #include "dce-unistd.h"
 #include "dce-signal.h"
+#include "dce-node-context.h"
+#include "dce-resolver.h"
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE ("DceNetdb");
 
 using namespace ns3;
 
+static DceResolver *
+GetResolver (void)
+{
+  return DceNodeContext::GetNodeContext ()->GetResolver ();
+}
+static struct sockaddr *
+MakeSockaddr (const DceResolver::Address &address, int port, socklen_t *len)
+{
+  if (address.family == AF_INET)
+    {
+      struct sockaddr_in *in4 = (struct sockaddr_in *) dce_malloc (sizeof (struct sockaddr_in));
+      memset (in4, 0, sizeof (struct sockaddr_in));
+      in4->sin_family = AF_INET;
+      in4->sin_port = htons (port);
+      memcpy (&in4->sin_addr, address.bytes, 4);
+      *len = sizeof (struct sockaddr_in);
+      return (struct sockaddr *) in4;
+    }
+  struct sockaddr_in6 *in6 = (struct sockaddr_in6 *) dce_malloc (sizeof (struct sockaddr_in6));
+  memset (in6, 0, sizeof (struct sockaddr_in6));
+  in6->sin6_family = AF_INET6;
+  in6->sin6_port = htons (port);
+  memcpy (&in6->sin6_addr, address.bytes, 16);
+  *len = sizeof (struct sockaddr_in6);
+  return (struct sockaddr *) in6;
+}
+
 struct hostent * dce_gethostbyname (const char *name)
 {
-  NS_LOG_FUNCTION (Current () << UtilsGetNodeId () << name);
+  return dce_gethostbyname2 (name, AF_INET);
+}
+struct hostent * dce_gethostbyname2 (const char *name, int af)
+{
+  NS_LOG_FUNCTION (Current () << UtilsGetNodeId () << name << af);
   NS_ASSERT (Current () != 0);
   static struct hostent host;
-  static uint32_t addr;
-  static char *alias_end = 0;
-  static char *addr_list[2];
+  static std::string canonical;
+  static std::vector<std::string> aliases;
+  static std::vector<DceResolver::Address> addresses;
+  static std::vector<char *> aliasList;
+  static std::vector<char *> addrList;
 
+  if (af != AF_INET && af != AF_INET6)
+    {
+      h_errno = NO_RECOVERY;
+      return 0;
+    }
+  aliases.clear ();
+  addresses.clear ();
+  DceResolver::Address address;
+  if (DceResolver::ParseAddress (name, af, &address))
+    {
+      canonical = name;
+      addresses.push_back (address);
+    }
+  else if (!GetResolver ()->GetHostByName (name, af, &canonical, &aliases, &addresses))
+    {
+      h_errno = HOST_NOT_FOUND;
+      return 0;
+    }
+  aliasList.clear ();
+  for (std::vector<std::string>::iterator i = aliases.begin (); i != aliases.end (); ++i)
+    {
+      aliasList.push_back ((char *) i->c_str ());
+    }
+  aliasList.push_back (0);
+  addrList.clear ();
+  for (std::vector<DceResolver::Address>::iterator i = addresses.begin (); i != addresses.end (); ++i)
+    {
+      addrList.push_back ((char *) i->bytes);
+    }
+  addrList.push_back (0);
 
-  Ipv4Address ipv4 = Ipv4Address (name);
-  addr = htonl (ipv4.Get ());
-
-  //XXX: We do not implement dns lookup here for now. We just
-  // interpret simple ip strings.
-
-  host.h_name = (char *)name;
-  host.h_addrtype = AF_INET;
-  host.h_aliases = &alias_end;
-  host.h_length = 4;
-  host.h_addr_list = addr_list;
-  addr_list[0] = (char *)&addr;
-  addr_list[1] = 0;
+  host.h_name = (char *) canonical.c_str ();
+  host.h_aliases = &aliasList[0];
+  host.h_addrtype = af;
+  host.h_length = (af == AF_INET) ? 4 : 16;
+  host.h_addr_list = &addrList[0];
   return &host;
 }
-struct hostent * dce_gethostbyname2 (const char *name, int af)
-{
-  NS_ASSERT (af == AF_INET);
-  return dce_gethostbyname (name);
-}
 int dce_getaddrinfo (const char *node, const char *service,
                      const struct addrinfo *hints,
                      struct addrinfo **res)
 {
   NS_LOG_FUNCTION (Current () << UtilsGetNodeId () << ((NULL == node) ? "" : node) << ((NULL == service) ? "" : service) << hints << res);
   NS_ASSERT (Current () != 0);
-  struct addrinfo *tmp = 0;
-  int status = ::getaddrinfo (node, service, hints, &tmp);
-  // copy outgoing data structure so that the memory is allocated from the calling process memory pool.
-  struct addrinfo *cur, *prev, *head;
-  head = 0;
-  prev = 0;
-  for (cur = tmp; cur != 0; cur = cur->ai_next)
-    {
-      struct addrinfo *copy = (struct addrinfo*)dce_malloc (sizeof(struct addrinfo));
-      memcpy (copy, cur, sizeof (struct addrinfo));
-      copy->ai_addr = (struct sockaddr*)dce_malloc (cur->ai_addrlen);
-      if (cur->ai_canonname != 0)
+  int flags = 0;
+  int family = AF_UNSPEC;
+  int socktype = 0;
+  int protocol = 0;
+  if (hints != 0)
+    {
+      flags = hints->ai_flags;
+      family = hints->ai_family;
+      socktype = hints->ai_socktype;
+      protocol = hints->ai_protocol;
+    }
+  *res = 0;
+  if (node == 0 && service == 0)
+    {
+      return EAI_NONAME;
+    }
+  if (family != AF_UNSPEC && family != AF_INET && family != AF_INET6)
+    {
+      return EAI_FAMILY;
+    }
+  DceResolver *resolver = GetResolver ();
+
+  // the socket types asked, each with its port.
+  struct
+  {
+    int socktype;
+    int protocol;
+    const char *proto;
+    int port;
+  } types[3];
+  int ntypes = 0;
+  if ((socktype == 0 || socktype == SOCK_STREAM) && (protocol == 0 || protocol == IPPROTO_TCP))
+    {
+      types[ntypes].socktype = SOCK_STREAM;
+      types[ntypes].protocol = IPPROTO_TCP;
+      types[ntypes].proto = "tcp";
+      ntypes++;
+    }
+  if ((socktype == 0 || socktype == SOCK_DGRAM) && (protocol == 0 || protocol == IPPROTO_UDP))
+    {
+      types[ntypes].socktype = SOCK_DGRAM;
+      types[ntypes].protocol = IPPROTO_UDP;
+      types[ntypes].proto = "udp";
+      ntypes++;
+    }
+  if ((socktype == 0 && protocol == 0 && service == 0) || socktype == SOCK_RAW)
+    {
+      types[ntypes].socktype = SOCK_RAW;
+      types[ntypes].protocol = protocol;
+      types[ntypes].proto = 0;
+      ntypes++;
+    }
+  if (ntypes == 0)
+    {
+      return EAI_SOCKTYPE;
+    }
+  if (service != 0)
+    {
+      char *end;
+      long port = strtol (service, &end, 10);
+      bool numeric = *service != 0 && *end == 0;
+      if (!numeric && (flags & AI_NUMERICSERV))
         {
-          copy->ai_canonname = dce_strdup (cur->ai_canonname);
+          return EAI_NONAME;
         }
-      else
+      if (numeric && (port < 0 || port > 65535))
+        {
+          return EAI_SERVICE;
+        }
+      int n = 0;
+      for (int i = 0; i < ntypes; i++)
         {
-          copy->ai_canonname = 0;
+          if (!numeric && types[i].proto != 0)
+            {
+              port = resolver->GetServByName (service, types[i].proto);
+            }
+          if (port >= 0 && (numeric || types[i].proto != 0))
+            {
+              types[i].port = port;
+              types[n++] = types[i];
+            }
         }
-      memcpy (copy->ai_addr, cur->ai_addr, cur->ai_addrlen);
-      if (prev != 0)
+      ntypes = n;
+      if (ntypes == 0)
         {
-          prev->ai_next = copy;
+          return EAI_SERVICE;
         }
-      else
+    }
+  else
+    {
+      for (int i = 0; i < ntypes; i++)
         {
-          head = copy;
+          types[i].port = 0;
         }
-      prev = copy;
     }
-  if (prev != 0)
+
+  std::string canonical;
+  std::vector<DceResolver::Address> addresses;
+  DceResolver::Address address;
+  if (node == 0)
     {
-      prev->ai_next = 0;
+      const char *any4 = (flags & AI_PASSIVE) ? "0.0.0.0" : "127.0.0.1";
+      const char *any6 = (flags & AI_PASSIVE) ? "::" : "::1";
+      if (family != AF_INET6)
+        {
+          DceResolver::ParseAddress (any4, AF_INET, &address);
+          addresses.push_back (address);
+        }
+      if (family != AF_INET)
+        {
+          DceResolver::ParseAddress (any6, AF_INET6, &address);
+          addresses.push_back (address);
+        }
     }
-  if (status == 0)
+  else if (DceResolver::ParseAddress (node, family, &address))
     {
-      *res = head;
+      canonical = node;
+      addresses.push_back (address);
     }
-  else
+  else if ((flags & AI_NUMERICHOST)
+           || !resolver->GetHostByName (node, family, &canonical, 0, &addresses))
     {
-      *res = 0;
+      return EAI_NONAME;
+    }
+
+  struct addrinfo *head = 0;
+  struct addrinfo **tail = &head;
+  for (std::vector<DceResolver::Address>::iterator i = addresses.begin (); i != addresses.end (); ++i)
+    {
+      for (int j = 0; j < ntypes; j++)
+        {
+          struct addrinfo *ai = (struct addrinfo *) dce_malloc (sizeof (struct addrinfo));
+          memset (ai, 0, sizeof (struct addrinfo));
+          ai->ai_flags = flags;
+          ai->ai_family = i->family;
+          ai->ai_socktype = types[j].socktype;
+          ai->ai_protocol = types[j].protocol;
+          ai->ai_addr = MakeSockaddr (*i, types[j].port, &ai->ai_addrlen);
+          if (head == 0 && (flags & AI_CANONNAME) && node != 0)
+            {
+              ai->ai_canonname = dce_strdup (canonical.c_str ());
+            }
+          *tail = ai;
+          tail = &ai->ai_next;
+        }
     }
-  ::freeaddrinfo (tmp);
-  return status;
+  *res = head;
+  return 0;
 }
 void dce_freeaddrinfo (struct addrinfo *res)
 {
@@ -128,7 +287,7 @@ const char * dce_gai_strerror (int errcode)
 int dce_getnameinfo (const struct sockaddr *sa, socklen_t salen, char *host,
                      socklen_t hostlen, char *serv, socklen_t servlen, unsigned int flags)
 {
-  NS_LOG_FUNCTION (Current ());
+  NS_LOG_FUNCTION (Current () << UtilsGetNodeId () << sa << salen << flags);
 
   if ((0 == sa) || (0 == salen))
     {
@@ -136,6 +295,8 @@ int dce_getnameinfo (const struct sockaddr *sa, socklen_t salen, char *host,
       return EAI_SYSTEM;
     }
 
+  DceResolver::Address address;
+  int port;
   switch (sa->sa_family)
     {
     case AF_INET:
@@ -146,48 +307,117 @@ int dce_getnameinfo (const struct sockaddr *sa, socklen_t salen, char *host,
             return EAI_SYSTEM;
           }
         const struct sockaddr_in *inAddr = (const struct sockaddr_in *) sa;
-
-        if (0 != serv)
-          {
-            int r = snprintf (serv, servlen, "%d",  htons (inAddr->sin_port));
-
-            if (r > (int)servlen)
-              {
-                return EAI_OVERFLOW;
-              }
-            if (r < 0)
-              {
-                Current ()->err = errno;
-                return EAI_SYSTEM;
-              }
-          }
-        if  (0 != host)
+        address.family = AF_INET;
+        memcpy (address.bytes, &inAddr->sin_addr, 4);
+        port = ntohs (inAddr->sin_port);
+      }
+      break;
+    case AF_INET6:
+      {
+        if (salen < sizeof (struct sockaddr_in6))
           {
-            Ipv4Address ipv4 = Ipv4Address (htonl (inAddr->sin_addr.s_addr));
-            std::ostringstream oss;
-            ipv4.Print (oss);
-
-            int r = snprintf (host, hostlen, "%s", oss.str ().c_str ());
-
-            if (r > (int)hostlen)
-              {
-                return EAI_OVERFLOW;
-              }
-            if (r < 0)
-              {
-                Current ()->err = errno;
-                return EAI_SYSTEM;
-              }
+            Current ()->err = EINVAL;
+            return EAI_SYSTEM;
           }
-        return 0;
+        const struct sockaddr_in6 *in6Addr = (const struct sockaddr_in6 *) sa;
+        address.family = AF_INET6;
+        memcpy (address.bytes, &in6Addr->sin6_addr, 16);
+        port = ntohs (in6Addr->sin6_port);
       }
       break;
-
     default:
       return EAI_FAMILY;
     }
 
-  return 0; // XXX : cheater
+  DceResolver *resolver = GetResolver ();
+  if (0 != serv)
+    {
+      std::string name;
+      if ((flags & NI_NUMERICSERV)
+          || !resolver->GetServByPort (port, (flags & NI_DGRAM) ? "udp" : "tcp", &name))
+        {
+          std::ostringstream oss;
+          oss << port;
+          name = oss.str ();
+        }
+      if (name.size () >= servlen)
+        {
+          return EAI_OVERFLOW;
+        }
+      strcpy (serv, name.c_str ());
+    }
+  if (0 != host)
+    {
+      std::string name;
+      if ((flags & NI_NUMERICHOST) || !resolver->GetHostByAddr (address, &name))
+        {
+          if (flags & NI_NAMEREQD)
+            {
+              return EAI_NONAME;
+            }
+          char str[INET6_ADDRSTRLEN];
+          inet_ntop (address.family, address.bytes, str, sizeof (str));
+          name = str;
+        }
+      if (name.size () >= hostlen)
+        {
+          return EAI_OVERFLOW;
+        }
+      strcpy (host, name.c_str ());
+    }
+  return 0;
+}
+static struct servent *
+MakeServent (const std::string &name, int port, const std::string &proto)
+{
+  static struct servent serv;
+  static std::string servName;
+  static std::string servProto;
+  static char *aliases[1];
+  servName = name;
+  servProto = proto;
+  aliases[0] = 0;
+  serv.s_name = (char *) servName.c_str ();
+  serv.s_aliases = aliases;
+  serv.s_port = htons (port);
+  serv.s_proto = (char *) servProto.c_str ();
+  return &serv;
+}
+struct servent * dce_getservbyname (const char *name, const char *proto)
+{
+  NS_LOG_FUNCTION (Current () << UtilsGetNodeId () << name);
+  NS_ASSERT (Current () != 0);
+  DceResolver *resolver = GetResolver ();
+  std::string p = (proto != 0) ? proto : "";
+  std::string official;
+  int port = resolver->GetServByName (name, p, &official);
+  if (port < 0)
+    {
+      return 0;
+    }
+  if (p.empty ())
+    {
+      p = (resolver->GetServByName (name, "tcp") == port) ? "tcp" : "udp";
+    }
+  return MakeServent (official, port, p);
+}
+struct servent * dce_getservbyport (int port, const char *proto)
+{
+  NS_LOG_FUNCTION (Current () << UtilsGetNodeId () << ntohs (port));
+  NS_ASSERT (Current () != 0);
+  DceResolver *resolver = GetResolver ();
+  std::string p = (proto != 0) ? proto : "";
+  std::string name;
+  if (!resolver->GetServByPort (ntohs (port), p, &name))
+    {
+      return 0;
+    }
+  if (p.empty ())
+    {
+      std::string tcp;
+      p = (resolver->GetServByPort (ntohs (port), "tcp", &tcp)) ? "tcp" : "udp";
+    }
+  return MakeServent (name, ntohs (port), p);
 }
 
 void dce_herror (const char *string)
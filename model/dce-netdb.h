@@ -17,6 +17,9 @@ const char * dce_gai_strerror (int errcode);
 int dce_getnameinfo (const struct sockaddr *sa, socklen_t salen, char *host,
                      socklen_t hostlen, char *serv, socklen_t servlen, unsigned int flags);
 
+struct servent * dce_getservbyname (const char *name, const char *proto);
+struct servent * dce_getservbyport (int port, const char *proto);
+
 void dce_herror (const char *string);
 int dce_getifaddrs (struct ifaddrs **ifap);
 
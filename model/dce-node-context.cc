@@ -29,6 +29,7 @@
 #include <string.h>
 #include "process.h"
 #include "dce-manager.h"
+#include "ns3/random-variable.h"
 
 NS_LOG_COMPONENT_DEFINE ("DceNodeContext");
 
@@ -50,10 +51,30 @@ DceNodeContext::GetInstanceTypeId (void) const
   return DceNodeContext::GetTypeId ();
 }
 DceNodeContext::DceNodeContext ()
+  : m_keyed (false)
 {
-  m_randomCtx = NormalVariable (0, 2 ^ 32 - 1);
-  m_rndBuffer = m_randomCtx.GetInteger ();
-  m_rndOffset = 0;
+  // The key comes from a stream of the simulator of its own, so that the
+  // bytes only depend on the seed and the run number. GetInteger can not
+  // draw a full 32 bit word: two halves.
+  UniformVariable seed;
+  for (int i = 0; i < 8; i++)
+    {
+      m_key[i] = (seed.GetInteger (0, 0xffff) << 16) | seed.GetInteger (0, 0xffff);
+    }
+  m_random.SetKey (m_key, 0);
+}
+
+void
+DceNodeContext::NotifyNewAggregate (void)
+{
+  // the node id as nonce: two nodes never share a keystream.
+  Ptr<Node> node = GetObject<Node> ();
+  if (node != 0 && !m_keyed)
+    {
+      m_random.SetKey (m_key, node->GetId ());
+      m_keyed = true;
+    }
+  Object::NotifyNewAggregate ();
 }
 
 DceNodeContext::~DceNodeContext ()
@@ -112,24 +133,15 @@ DceNodeContext::GetNodeContext ()
 int
 DceNodeContext::RandomRead (void *buf, size_t count)
 {
-  uint8_t *crsr = (uint8_t*)buf;
-  for (uint32_t i = 0; i < count; i++)
-    {
-      *crsr++ = GetNextRnd ();
-    }
+  NS_LOG_FUNCTION (this << buf << count);
+  m_random.Generate ((uint8_t *)buf, count);
   return count;
 }
 
-uint8_t
-DceNodeContext::GetNextRnd ()
+DceResolver *
+DceNodeContext::GetResolver (void)
 {
-  uint8_t v = ((uint8_t *)  &m_rndBuffer) [ m_rndOffset++ ];
-  if (m_rndOffset >= 4)
-    {
-      m_rndOffset = 0;
-      m_rndBuffer = m_randomCtx.GetInteger ();
-    }
-  return v;
+  return &m_resolver;
 }
 
 } // namespace ns3
@@ -27,7 +27,8 @@
 #include "ns3/traced-callback.h"
 #include "ns3/simulator.h"
 #include <sys/utsname.h>
-#include "ns3/random-variable.h"
+#include "chacha-stream.h"
+#include "dce-resolver.h"
 
 extern "C" struct Libc;
 
@@ -52,19 +53,25 @@ public:
 
   static Ptr<DceNodeContext> GetNodeContext ();
 
+  // The bytes of /dev/random, /dev/urandom and getrandom.
   int RandomRead (void *buf, size_t count);
 
+  DceResolver * GetResolver (void);
+
+protected:
+  virtual void NotifyNewAggregate (void);
+
 private:
-  inline uint8_t GetNextRnd ();
 
   std::string m_sysName;
   std::string m_nodeName;
   std::string m_release;
   std::string m_version;
   std::string m_hardId;
-  RandomVariable m_randomCtx;
-  uint32_t m_rndBuffer;
-  uint8_t m_rndOffset;
+  uint32_t m_key[8];
+  bool m_keyed;
+  ChaChaStream m_random;
+  DceResolver m_resolver;
 };
 
 } // namespace ns3
@@ -8,35 +8,61 @@
 #include "dce-manager.h"
 #include "process.h"
 #include "errno.h"
-#include <map>
+#include <vector>
 
 
 NS_LOG_COMPONENT_DEFINE ("PollSelect");
 
 using namespace ns3;
 
-int dce_poll (struct pollfd *fds, nfds_t nfds, int timeout)
+// Poll again one item of a poll call, without registering in the wait
+// queue of its file. Return 1 if the item is ready.
+static int PollItem (Thread *current, struct pollfd *fd)
 {
-  int count = -1;
+  if (!CheckFdExists (current->process, fd->fd, true))
+    {
+      return 0;
+    }
+  UnixFd *unixFd = current->process->openFiles[fd->fd]->GetFile ();
+  int mask = unixFd->Poll (0);
+
+  mask &= (fd->events | POLLERR | POLLHUP);
+  fd->revents = mask;
+  return (mask != 0) ? 1 : 0;
+}
+
+namespace ns3 {
+
+int PollTimeout (struct pollfd *fds, nfds_t nfds, Time timeout)
+{
+  int count = 0;
   int timed_out = 0;
   Time endtime;
-  // key fd
-  std::map <int, FileUsage*> toUnRef;
+  // one entry per reference taken on a file.
+  std::vector<FileUsage*> toUnRef;
   Thread *current = Current ();
   NS_LOG_FUNCTION (current << UtilsGetNodeId () << fds << nfds << timeout);
-  PollTable *table = new PollTable ();
-  PollTable *currentTable = table;
-
   NS_ASSERT (current != 0);
+  PollTable *table = 0;
 
-  if (0 == timeout)
+  if (timeout.IsZero ())
     {
-      currentTable = 0;
       timed_out = 1;
     }
-  else if (timeout > 0)
+  else
     {
-      endtime = Now () + MilliSeconds (timeout);
+      if (timeout.IsStrictlyPositive ())
+        {
+          endtime = Now () + timeout;
+        }
+      // reuse the table, and its entries, of the previous poll.
+      table = current->pollTableCache;
+      current->pollTableCache = 0;
+      if (table == 0)
+        {
+          table = new PollTable ();
+        }
+      toUnRef.reserve (nfds);
     }
 
   for (uint32_t i = 0; i < nfds; ++i)
@@ -44,50 +70,46 @@ int dce_poll (struct pollfd *fds, nfds_t nfds, int timeout)
       // initialize all outgoing events.
       fds[i].revents = 0;
     }
-  while (true)
+  // Poll every item and register in the wait queues of the files until
+  // one is ready.
+  for (uint32_t i = 0; i < nfds; ++i)
     {
-      int validFd = 0;
-      count = 0;
-      for (uint32_t i = 0; i < nfds; ++i)
+      if (CheckFdExists (current->process, fds[i].fd, true))
         {
-          if (CheckFdExists (current->process, fds[i].fd, true))
-            {
-              validFd++;
-              UnixFd *unixFd = 0;
-              FileUsage *fu = current->process->openFiles[fds[i].fd];
+          UnixFd *unixFd = 0;
+          PollTable *currentTable = 0;
+          FileUsage *fu = current->process->openFiles[fds[i].fd];
 
-              if (currentTable)
-                {
-                  unixFd = fu->GetFileInc ();
-                  toUnRef[fds[i].fd] = fu;
-                  currentTable->SetEventMask (fds[i].events | POLLERR | POLLHUP);
-                }
-              else
-                {
-                  unixFd = fu->GetFile ();
-                }
+          if (table != 0 && count == 0)
+            {
+              unixFd = fu->GetFileInc ();
+              toUnRef.push_back (fu);
+              table->SetEventMask (fds[i].events | POLLERR | POLLHUP);
+              table->SetIndex (i);
+              currentTable = table;
+            }
+          else
+            {
+              unixFd = fu->GetFile ();
+            }
 
-              int mask = unixFd->Poll (currentTable);
+          int mask = unixFd->Poll (currentTable);
 
-              mask &= (fds[i].events | POLLERR | POLLHUP);
-              fds[i].revents = mask;
-              if (mask)
-                {
-                  count++;
-                  currentTable = 0;
-                }
+          mask &= (fds[i].events | POLLERR | POLLHUP);
+          fds[i].revents = mask;
+          if (mask)
+            {
+              count++;
             }
         }
-      currentTable = 0; // Register only first time.
-
-      if (count || timed_out)
-        {
-          break;
-        }
+    }
 
-      if (timeout != 0)
+  // Then only poll again the items whose files woke us up.
+  while (count == 0 && !timed_out)
+    {
+      if (!table->IsRescanNeeded () && table->GetReady ().empty ())
         {
-          if (timeout < 0)
+          if (timeout.IsNegative ())
             {
               current->pollTable = table;
               table->Wait (Seconds (0));
@@ -108,21 +130,69 @@ int dce_poll (struct pollfd *fds, nfds_t nfds, int timeout)
                 }
             }
         }
+      if (table->IsRescanNeeded ())
+        {
+          table->ClearReady ();
+          for (uint32_t i = 0; i < nfds; ++i)
+            {
+              count += PollItem (current, &fds[i]);
+            }
+        }
+      else
+        {
+          // an item may be woken up several times, and more may be while
+          // we poll.
+          for (uint32_t j = 0; j < table->GetReady ().size (); ++j)
+            {
+              uint32_t i = table->GetReady ()[j];
+              if (fds[i].revents == 0)
+                {
+                  count += PollItem (current, &fds[i]);
+                }
+            }
+          table->ClearReady ();
+        }
     }
 
-  table->FreeWait ();
-  delete (table);
+  if (table != 0)
+    {
+      table->FreeWait ();
+      if (current->pollTableCache == 0)
+        {
+          current->pollTableCache = table;
+        }
+      else
+        {
+          delete table;
+        }
+    }
 
-  for (std::map <int, FileUsage*>::iterator i = toUnRef.begin ();
+  for (std::vector<FileUsage*>::iterator i = toUnRef.begin ();
        i != toUnRef.end (); ++i)
     {
-      i->second->DecUsage ();
+      (*i)->DecUsage ();
     }
 
-  // Try to break infinite loop in poll with a 0 timeout !
-  if ((0 == count) && (0 == timeout))
+  return count;
+}
+
+} // namespace ns3
+
+int dce_poll (struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  Thread *current = Current ();
+  NS_LOG_FUNCTION (current << UtilsGetNodeId () << fds << nfds << timeout);
+  NS_ASSERT (current != 0);
+
+  int count = PollTimeout (fds, nfds, (timeout < 0) ? Seconds (-1) : MilliSeconds (timeout));
+  if (count != 0)
+    {
+      UtilsSpinProgress (current);
+    }
+  else if (0 == timeout)
     {
-      UtilsAdvanceTime (current);
+      // Maybe a busy poll loop: wait for one of the fds for a while.
+      count = UtilsSpin (current, fds, nfds);
     }
 
   return count;
@@ -134,9 +204,8 @@ int dce_select (int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
   Thread *current = Current ();
   NS_LOG_FUNCTION (current << UtilsGetNodeId () << nfds << timeout);
   NS_ASSERT (current != 0);
-  std::map <int, int> eventByFd;
 
-  if (nfds == -1)
+  if (nfds < 0)
     {
       current->err = EINVAL;
       return -1;
@@ -154,6 +223,20 @@ int dce_select (int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
           return -1;
         }
     }
+  if (nfds > FD_SETSIZE)
+    {
+      nfds = FD_SETSIZE;
+    }
+  // select(2):
+  // Some  code  calls  select() with all three sets empty, nfds zero, and a
+  // non-NULL timeout as a fairly portable way to sleep with subsecond
+  // precision.
+  // 130825: this condition will be passed by dce_poll ()
+
+  // at most one item per descriptor, in the order of the descriptors.
+  struct pollfd pollFd[nfds];
+  int j = 0;
+
   for (int fd = 0; fd < nfds; fd++)
     {
       int event = 0;
@@ -178,26 +261,12 @@ int dce_select (int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
               current->err = EBADF;
               return -1;
             }
-          eventByFd[fd] = event;
+          pollFd[j].events = event;
+          pollFd[j].fd = fd;
+          pollFd[j++].revents = 0;
         }
     }
-  nfds = eventByFd.size ();
-
-  // select(2):
-  // Some  code  calls  select() with all three sets empty, nfds zero, and a
-  // non-NULL timeout as a fairly portable way to sleep with subsecond
-  // precision.
-  // 130825: this condition will be passed by dce_poll ()
-
-  struct pollfd pollFd[nfds];
-  int j = 0;
-
-  for (std::map<int, int>::iterator i = eventByFd.begin (); i != eventByFd.end (); ++i)
-    {
-      pollFd[j].events = (*i).second;
-      pollFd[j].fd = (*i).first;
-      pollFd[j++].revents = 0;
-    }
+  nfds = j;
 
   int pollTo = -1;
 
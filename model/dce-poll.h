@@ -11,6 +11,13 @@ int dce_poll (struct pollfd *fds, nfds_t nfds, int timeout);
 
 #ifdef __cplusplus
 }
+
+namespace ns3 {
+class Time;
+// dce_poll with a timeout in simulated time, negative to wait forever,
+// and without the busy poll detection.
+int PollTimeout (struct pollfd *fds, nfds_t nfds, Time timeout);
+}
 #endif
 
 #endif /* SIMU_POLL_H */
@@ -391,7 +391,15 @@ int dce_pthread_kill (pthread_t th, int sig)
       return ESRCH;
     }
 
-  sigaddset (&thread->pendingSignals, sig);
+  if (sig == 0)
+    {
+      return 0;
+    }
+  if (sig < 1 || sig > DCE_NSIG)
+    {
+      return EINVAL;
+    }
+  thread->pendingSignals |= DCE_SIGBIT (sig);
   if (sigismember (&thread->signalMask, sig) == 0)
     {
       // signal not blocked by thread.
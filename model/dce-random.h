@@ -1,6 +1,7 @@
 #ifndef SIMU_RANDOM_H
 #define SIMU_RANDOM_H
 
+#include <sys/types.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,6 +20,7 @@ double dce_erand48 (unsigned short xsubi[3]);
 long int dce_jrand48 (unsigned short int xsubi[3]);
 void dce_srand48 (long int seedval);
 void dce_lcong48 (unsigned short param[7]);
+ssize_t dce_getrandom (void *buf, size_t buflen, unsigned int flags);
 
 #ifdef __cplusplus
 }
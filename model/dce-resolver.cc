@@ -0,0 +1,603 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "dce-resolver.h"
+#include "utils.h"
+#include "process.h"
+#include "dce-poll.h"
+#include "dce-unistd.h"
+#include "sys/dce-socket.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("DceResolver");
+
+#define DNS_PORT 53
+#define DNS_TYPE_A 1
+#define DNS_TYPE_AAAA 28
+#define DNS_CLASS_IN 1
+#define DNS_MAX_PACKET 1500
+
+namespace ns3 {
+
+namespace {
+std::string
+ToLower (std::string str)
+{
+  for (std::string::iterator i = str.begin (); i != str.end (); ++i)
+    {
+      *i = tolower (*i);
+    }
+  return str;
+}
+// The words of a line without its comment.
+std::vector<std::string>
+Words (std::string line)
+{
+  std::string::size_type comment = line.find ('#');
+  if (comment != std::string::npos)
+    {
+      line.erase (comment);
+    }
+  std::vector<std::string> words;
+  std::istringstream iss (line);
+  std::string word;
+  while (iss >> word)
+    {
+      words.push_back (word);
+    }
+  return words;
+}
+std::string
+AddressKey (const DceResolver::Address &address)
+{
+  return std::string ((const char *) address.bytes, (address.family == AF_INET) ? 4 : 16);
+}
+bool
+Ipv4First (const DceResolver::Address &a, const DceResolver::Address &b)
+{
+  return a.family == AF_INET && b.family != AF_INET;
+}
+// Offset after the name at offset in a message, 0 if it does not fit.
+size_t
+SkipName (const uint8_t *msg, size_t len, size_t offset)
+{
+  while (offset < len)
+    {
+      uint8_t l = msg[offset];
+      if (l == 0)
+        {
+          return offset + 1;
+        }
+      if ((l & 0xc0) == 0xc0)
+        {
+          return (offset + 2 <= len) ? offset + 2 : 0;
+        }
+      offset += 1 + l;
+    }
+  return 0;
+}
+uint16_t
+Read16 (const uint8_t *p)
+{
+  return (p[0] << 8) | p[1];
+}
+} // anonymous namespace
+
+DceResolver::DceResolver ()
+  : m_ndots (1),
+    m_timeout (5),
+    m_attempts (2),
+    m_queryId (0)
+{
+  m_hostsFile.path = "/etc/hosts";
+  m_hostsFile.exists = false;
+  m_servicesFile.path = "/etc/services";
+  // the well-known ports are the same everywhere.
+  m_servicesFile.fallback = "/etc/services";
+  m_servicesFile.exists = false;
+  m_resolvFile.path = "/etc/resolv.conf";
+  m_resolvFile.exists = false;
+  // nothing parsed yet: the first Changed is true whatever the files.
+  m_hostsFile.mtime.tv_sec = m_servicesFile.mtime.tv_sec = m_resolvFile.mtime.tv_sec = -1;
+}
+
+bool
+DceResolver::ParseAddress (const std::string &str, int family, Address *address)
+{
+  if (family != AF_INET6 && inet_pton (AF_INET, str.c_str (), address->bytes) == 1)
+    {
+      address->family = AF_INET;
+      return true;
+    }
+  if (family != AF_INET && inet_pton (AF_INET6, str.c_str (), address->bytes) == 1)
+    {
+      address->family = AF_INET6;
+      return true;
+    }
+  return false;
+}
+
+bool
+DceResolver::Changed (File *file)
+{
+  std::string path = UtilsGetRealFilePath (file->path);
+  struct stat st;
+  int status = ::stat (path.c_str (), &st);
+  if (status != 0 && !file->fallback.empty ())
+    {
+      path = file->fallback;
+      status = ::stat (path.c_str (), &st);
+    }
+  if (status != 0)
+    {
+      bool changed = file->exists || file->mtime.tv_sec == -1;
+      file->real = "";
+      file->exists = false;
+      file->mtime.tv_sec = 0;
+      return changed;
+    }
+  if (file->exists && file->dev == st.st_dev && file->ino == st.st_ino
+      && file->size == st.st_size && file->mtime.tv_sec == st.st_mtim.tv_sec
+      && file->mtime.tv_nsec == st.st_mtim.tv_nsec)
+    {
+      return false;
+    }
+  file->real = path;
+  file->exists = true;
+  file->dev = st.st_dev;
+  file->ino = st.st_ino;
+  file->size = st.st_size;
+  // with the nanoseconds: a file rewritten with the same size in the
+  // same second is still seen.
+  file->mtime = st.st_mtim;
+  return true;
+}
+
+void
+DceResolver::AddHost (const Host &host)
+{
+  size_t index = m_hosts.size ();
+  m_hosts.push_back (host);
+  m_hostsByName[ToLower (host.name)].push_back (index);
+  for (std::vector<std::string>::const_iterator i = host.aliases.begin ();
+       i != host.aliases.end (); ++i)
+    {
+      m_hostsByName[ToLower (*i)].push_back (index);
+    }
+  // the first line of an address gives its name.
+  m_hostsByAddress.insert (std::make_pair (AddressKey (host.address), index));
+}
+
+void
+DceResolver::UpdateHosts (void)
+{
+  if (!Changed (&m_hostsFile))
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_hostsFile.exists);
+  m_hosts.clear ();
+  m_hostsByName.clear ();
+  m_hostsByAddress.clear ();
+  std::ifstream in (m_hostsFile.real.c_str ());
+  std::string line;
+  while (std::getline (in, line))
+    {
+      std::vector<std::string> words = Words (line);
+      Host host;
+      if (words.size () < 2 || !ParseAddress (words[0], AF_UNSPEC, &host.address))
+        {
+          continue;
+        }
+      host.name = words[1];
+      host.aliases.assign (words.begin () + 2, words.end ());
+      AddHost (host);
+    }
+  // as the resolver of the libc, which knows localhost without the file.
+  if (m_hostsByName.find ("localhost") == m_hostsByName.end ())
+    {
+      Host host;
+      host.name = "localhost";
+      ParseAddress ("127.0.0.1", AF_INET, &host.address);
+      AddHost (host);
+      ParseAddress ("::1", AF_INET6, &host.address);
+      AddHost (host);
+    }
+}
+
+void
+DceResolver::UpdateServices (void)
+{
+  if (!Changed (&m_servicesFile))
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_servicesFile.exists);
+  m_servicesByName.clear ();
+  m_servicesByPort.clear ();
+  std::ifstream in (m_servicesFile.real.c_str ());
+  std::string line;
+  while (std::getline (in, line))
+    {
+      // name port/proto aliases...
+      std::vector<std::string> words = Words (line);
+      if (words.size () < 2)
+        {
+          continue;
+        }
+      std::string::size_type slash = words[1].find ('/');
+      if (slash == std::string::npos)
+        {
+          continue;
+        }
+      int port = atoi (words[1].substr (0, slash).c_str ());
+      std::string proto = words[1].substr (slash + 1);
+      if (port <= 0 || port > 65535)
+        {
+          continue;
+        }
+      m_servicesByPort.insert (std::make_pair (PortKey (port, proto), words[0]));
+      for (size_t i = 0; i < words.size (); i++)
+        {
+          if (i != 1)
+            {
+              m_servicesByName.insert (std::make_pair (ServiceKey (words[i], proto),
+                                                       Service (port, words[0])));
+            }
+        }
+    }
+}
+
+void
+DceResolver::UpdateResolvConf (void)
+{
+  if (!Changed (&m_resolvFile))
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_resolvFile.exists);
+  m_nameservers.clear ();
+  m_search.clear ();
+  m_ndots = 1;
+  m_timeout = 5;
+  m_attempts = 2;
+  std::ifstream in (m_resolvFile.real.c_str ());
+  std::string line;
+  while (std::getline (in, line))
+    {
+      std::vector<std::string> words = Words (line);
+      if (words.size () < 2)
+        {
+          continue;
+        }
+      if (words[0] == "nameserver")
+        {
+          Address address;
+          if (!ParseAddress (words[1], AF_UNSPEC, &address))
+            {
+              continue;
+            }
+          struct sockaddr_storage server;
+          memset (&server, 0, sizeof (server));
+          if (address.family == AF_INET)
+            {
+              struct sockaddr_in *in4 = (struct sockaddr_in *) &server;
+              in4->sin_family = AF_INET;
+              in4->sin_port = htons (DNS_PORT);
+              memcpy (&in4->sin_addr, address.bytes, 4);
+            }
+          else
+            {
+              struct sockaddr_in6 *in6 = (struct sockaddr_in6 *) &server;
+              in6->sin6_family = AF_INET6;
+              in6->sin6_port = htons (DNS_PORT);
+              memcpy (&in6->sin6_addr, address.bytes, 16);
+            }
+          m_nameservers.push_back (server);
+        }
+      else if (words[0] == "search" || words[0] == "domain")
+        {
+          // the last of them wins.
+          m_search.assign (words.begin () + 1, words.end ());
+        }
+      else if (words[0] == "options")
+        {
+          for (size_t i = 1; i < words.size (); i++)
+            {
+              if (words[i].compare (0, 6, "ndots:") == 0)
+                {
+                  m_ndots = atoi (words[i].c_str () + 6);
+                }
+              else if (words[i].compare (0, 8, "timeout:") == 0)
+                {
+                  m_timeout = std::max (1, atoi (words[i].c_str () + 8));
+                }
+              else if (words[i].compare (0, 9, "attempts:") == 0)
+                {
+                  m_attempts = std::max (1, atoi (words[i].c_str () + 9));
+                }
+            }
+        }
+    }
+}
+
+bool
+DceResolver::GetHostByName (std::string name, int family, std::string *canonical,
+                            std::vector<std::string> *aliases, std::vector<Address> *addresses)
+{
+  NS_LOG_FUNCTION (this << name << family);
+  UpdateHosts ();
+  std::map<std::string, std::vector<size_t> >::const_iterator found = m_hostsByName.find (ToLower (name));
+  if (found != m_hostsByName.end ())
+    {
+      bool first = true;
+      for (std::vector<size_t>::const_iterator i = found->second.begin ();
+           i != found->second.end (); ++i)
+        {
+          const Host &host = m_hosts[*i];
+          if (family != AF_UNSPEC && host.address.family != family)
+            {
+              continue;
+            }
+          if (first)
+            {
+              if (canonical != 0)
+                {
+                  *canonical = host.name;
+                }
+              if (aliases != 0)
+                {
+                  *aliases = host.aliases;
+                }
+              first = false;
+            }
+          addresses->push_back (host.address);
+        }
+      if (!first)
+        {
+          std::stable_sort (addresses->begin (), addresses->end (), Ipv4First);
+          return true;
+        }
+    }
+  if (!QueryDns (name, family, addresses))
+    {
+      return false;
+    }
+  if (canonical != 0)
+    {
+      *canonical = name;
+    }
+  if (aliases != 0)
+    {
+      aliases->clear ();
+    }
+  return true;
+}
+
+bool
+DceResolver::GetHostByAddr (const Address &address, std::string *name)
+{
+  UpdateHosts ();
+  std::map<std::string, size_t>::const_iterator found = m_hostsByAddress.find (AddressKey (address));
+  if (found == m_hostsByAddress.end ())
+    {
+      return false;
+    }
+  *name = m_hosts[found->second].name;
+  return true;
+}
+
+int
+DceResolver::GetServByName (const std::string &name, const std::string &proto, std::string *official)
+{
+  UpdateServices ();
+  if (proto.empty ())
+    {
+      int port = GetServByName (name, "tcp", official);
+      return (port >= 0) ? port : GetServByName (name, "udp", official);
+    }
+  std::map<ServiceKey, Service>::const_iterator found = m_servicesByName.find (ServiceKey (name, proto));
+  if (found == m_servicesByName.end ())
+    {
+      return -1;
+    }
+  if (0 != official)
+    {
+      *official = found->second.second;
+    }
+  return found->second.first;
+}
+
+bool
+DceResolver::GetServByPort (int port, const std::string &proto, std::string *name)
+{
+  UpdateServices ();
+  if (proto.empty ())
+    {
+      return GetServByPort (port, "tcp", name) || GetServByPort (port, "udp", name);
+    }
+  std::map<PortKey, std::string>::const_iterator found = m_servicesByPort.find (PortKey (port, proto));
+  if (found == m_servicesByPort.end ())
+    {
+      return false;
+    }
+  *name = found->second;
+  return true;
+}
+
+bool
+DceResolver::QueryDns (const std::string &name, int family, std::vector<Address> *addresses)
+{
+  UpdateResolvConf ();
+  if (m_nameservers.empty () || name.empty ())
+    {
+      return false;
+    }
+  // the names to try, as the libc resolver does.
+  std::vector<std::string> names;
+  if (name[name.size () - 1] == '.')
+    {
+      names.push_back (name.substr (0, name.size () - 1));
+    }
+  else
+    {
+      int dots = std::count (name.begin (), name.end (), '.');
+      if (dots >= m_ndots)
+        {
+          names.push_back (name);
+        }
+      for (std::vector<std::string>::const_iterator i = m_search.begin (); i != m_search.end (); ++i)
+        {
+          names.push_back (name + "." + *i);
+        }
+      if (dots < m_ndots)
+        {
+          names.push_back (name);
+        }
+    }
+  // the queries change errno.
+  Thread *current = Current ();
+  int err = current->err;
+  bool found = false;
+  for (std::vector<std::string>::const_iterator n = names.begin (); n != names.end () && !found; ++n)
+    {
+      for (int type = 0; type < 2; type++)
+        {
+          if ((type == 0 && family == AF_INET6) || (type == 1 && family == AF_INET))
+            {
+              continue;
+            }
+          bool answered = false;
+          for (int attempt = 0; attempt < m_attempts && !answered; attempt++)
+            {
+              for (std::vector<struct sockaddr_storage>::const_iterator s = m_nameservers.begin ();
+                   s != m_nameservers.end () && !answered; ++s)
+                {
+                  socklen_t len = (s->ss_family == AF_INET) ? sizeof (struct sockaddr_in)
+                    : sizeof (struct sockaddr_in6);
+                  int status = QueryServer (&*s, len, *n, (type == 0) ? DNS_TYPE_A : DNS_TYPE_AAAA,
+                                            addresses);
+                  answered = status >= 0;
+                  found = found || status > 0;
+                }
+            }
+        }
+    }
+  current->err = err;
+  return found;
+}
+
+int
+DceResolver::QueryServer (const struct sockaddr_storage *server, socklen_t len,
+                          const std::string &name, int type, std::vector<Address> *addresses)
+{
+  NS_LOG_FUNCTION (this << name << type);
+  uint8_t msg[DNS_MAX_PACKET];
+  uint16_t id = ++m_queryId;
+  memset (msg, 0, 12);
+  msg[0] = id >> 8;
+  msg[1] = id;
+  msg[2] = 0x01; // recursion desired
+  msg[5] = 1; // one question
+  size_t size = 12;
+  std::string::size_type start = 0;
+  while (start < name.size ())
+    {
+      std::string::size_type end = name.find ('.', start);
+      if (end == std::string::npos)
+        {
+          end = name.size ();
+        }
+      size_t label = end - start;
+      if (label == 0 || label > 63 || size + label + 6 > 12 + 255)
+        {
+          return 0;
+        }
+      msg[size++] = label;
+      memcpy (msg + size, name.data () + start, label);
+      size += label;
+      start = end + 1;
+    }
+  msg[size++] = 0;
+  msg[size++] = type >> 8;
+  msg[size++] = type;
+  msg[size++] = DNS_CLASS_IN >> 8;
+  msg[size++] = DNS_CLASS_IN & 0xff;
+
+  int fd = dce_socket (server->ss_family, SOCK_DGRAM, 0);
+  if (fd < 0)
+    {
+      return -1;
+    }
+  ssize_t r = dce_sendto (fd, msg, size, 0, (const struct sockaddr *) server, len);
+  struct pollfd pfd;
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (r < 0 || PollTimeout (&pfd, 1, Seconds (m_timeout)) <= 0)
+    {
+      dce_close (fd);
+      return -1;
+    }
+  r = dce_recvfrom (fd, msg, sizeof (msg), 0, 0, 0);
+  dce_close (fd);
+  if (r < 12 || Read16 (msg) != id || (msg[2] & 0x80) == 0)
+    {
+      return -1;
+    }
+  int rcode = msg[3] & 0x0f;
+  if (rcode == 3)
+    {
+      // no such name
+      return 0;
+    }
+  if (rcode != 0)
+    {
+      return -1;
+    }
+  size = r;
+  size_t offset = 12;
+  for (int i = Read16 (msg + 4); i > 0 && offset != 0; i--)
+    {
+      offset = SkipName (msg, size, offset);
+      offset = (offset != 0 && offset + 4 <= size) ? offset + 4 : 0;
+    }
+  int found = 0;
+  for (int i = Read16 (msg + 6); i > 0 && offset != 0; i--)
+    {
+      offset = SkipName (msg, size, offset);
+      if (offset == 0 || offset + 10 > size)
+        {
+          break;
+        }
+      int rrType = Read16 (msg + offset);
+      int rrClass = Read16 (msg + offset + 2);
+      size_t rrLen = Read16 (msg + offset + 8);
+      offset += 10;
+      if (offset + rrLen > size)
+        {
+          break;
+        }
+      Address address;
+      address.family = (rrType == DNS_TYPE_A) ? AF_INET : AF_INET6;
+      if (rrType == type && rrClass == DNS_CLASS_IN
+          && rrLen == ((type == DNS_TYPE_A) ? 4u : 16u))
+        {
+          memcpy (address.bytes, msg + offset, rrLen);
+          addresses->push_back (address);
+          found = 1;
+        }
+      offset += rrLen;
+    }
+  return found;
+}
+
+} // namespace ns3
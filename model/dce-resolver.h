@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef DCE_RESOLVER_H
+#define DCE_RESOLVER_H
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * The name resolution of a node: its /etc/hosts, /etc/services and
+ * /etc/resolv.conf, read from the files of the node and never from the
+ * host. Each file is parsed in an index the first time it is needed and
+ * again when it changed. Names which are not in /etc/hosts are asked to
+ * the nameservers of resolv.conf, which must run in the simulation.
+ */
+class DceResolver
+{
+public:
+  struct Address
+  {
+    int family; // AF_INET or AF_INET6
+    uint8_t bytes[16];
+  };
+
+  DceResolver ();
+
+  /**
+   * \param family AF_INET, AF_INET6 or AF_UNSPEC for both.
+   * \param canonical the official name of the host.
+   * \return false if the name is unknown.
+   */
+  bool GetHostByName (std::string name, int family, std::string *canonical,
+                      std::vector<std::string> *aliases, std::vector<Address> *addresses);
+  bool GetHostByAddr (const Address &address, std::string *name);
+  // proto is "tcp", "udp" or empty for any. -1 if the service is unknown.
+  // official is set to the name of the service when name is an alias.
+  int GetServByName (const std::string &name, const std::string &proto,
+                     std::string *official = 0);
+  bool GetServByPort (int port, const std::string &proto, std::string *name);
+
+  // Parse a numeric address of family, or of any family with AF_UNSPEC.
+  static bool ParseAddress (const std::string &str, int family, Address *address);
+
+private:
+  struct File
+  {
+    std::string path; // in the node
+    // the file of the host used when the node has none, if any.
+    std::string fallback;
+    std::string real; // the file parsed
+    bool exists;
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime;
+  };
+  struct Host
+  {
+    std::string name;
+    std::vector<std::string> aliases;
+    Address address;
+  };
+  typedef std::pair<std::string, std::string> ServiceKey;
+  typedef std::pair<int, std::string> PortKey;
+  // port and official name.
+  typedef std::pair<int, std::string> Service;
+
+  // true if the file is not the one parsed last time.
+  static bool Changed (File *file);
+  void UpdateHosts (void);
+  void UpdateServices (void);
+  void UpdateResolvConf (void);
+  void AddHost (const Host &host);
+
+  bool QueryDns (const std::string &name, int family, std::vector<Address> *addresses);
+  int QueryServer (const struct sockaddr_storage *server, socklen_t len,
+                   const std::string &name, int type, std::vector<Address> *addresses);
+
+  File m_hostsFile;
+  std::vector<struct Host> m_hosts;
+  // lowercase name or alias to the entries in m_hosts, in file order.
+  std::map<std::string, std::vector<size_t> > m_hostsByName;
+  // address bytes to the first entry.
+  std::map<std::string, size_t> m_hostsByAddress;
+
+  File m_servicesFile;
+  std::map<ServiceKey, Service> m_servicesByName;
+  std::map<PortKey, std::string> m_servicesByPort;
+
+  File m_resolvFile;
+  std::vector<struct sockaddr_storage> m_nameservers;
+  std::vector<std::string> m_search;
+  int m_ndots;
+  int m_timeout; // seconds
+  int m_attempts;
+  uint16_t m_queryId;
+};
+
+} // namespace ns3
+
+#endif /* DCE_RESOLVER_H */
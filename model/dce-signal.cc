@@ -40,61 +40,47 @@ int dce_sigaction (int signum, const struct sigaction *act,
   NS_LOG_FUNCTION (current << UtilsGetNodeId () << signum << act << oldact);
   NS_ASSERT (current != 0);
 
-  for (std::vector<SignalHandler>::iterator i = current->process->signalHandlers.begin ();
-       i != current->process->signalHandlers.end (); ++i)
+  if (signum < 1 || signum > DCE_NSIG)
     {
-      if (i->signal == signum)
+      current->err = EINVAL;
+      return -1;
+    }
+  struct SignalHandler *handler = &current->process->signalHandlers[signum - 1];
+  if (oldact != 0)
+    {
+      if (handler->signal == 0)
         {
-          if (oldact != 0)
+          oldact->sa_handler = SIG_IGN;
+          oldact->sa_flags = 0;
+          sigemptyset (&oldact->sa_mask);
+        }
+      else
+        {
+          oldact->sa_flags = handler->flags;
+          oldact->sa_mask = handler->mask;
+          if (oldact->sa_flags & SA_SIGINFO)
             {
-              oldact->sa_flags = i->flags;
-              oldact->sa_mask = i->mask;
-              if (oldact->sa_flags & SA_SIGINFO)
-                {
-                  oldact->sa_sigaction = i->sigaction;
-                }
-              else
-                {
-                  oldact->sa_handler = i->handler;
-                }
+              oldact->sa_sigaction = handler->sigaction;
             }
-          if (act != 0)
+          else
             {
-              i->flags = act->sa_flags;
-              i->mask = act->sa_mask;
-              if (act->sa_flags & SA_SIGINFO)
-                {
-                  i->sigaction = act->sa_sigaction;
-                }
-              else
-                {
-                  i->handler = act->sa_handler;
-                }
+              oldact->sa_handler = handler->handler;
             }
-          return 0;
         }
     }
   if (act != 0)
     {
-      struct SignalHandler handler;
-      handler.signal = signum;
-      handler.flags = act->sa_flags;
-      handler.mask = act->sa_mask;
+      handler->signal = signum;
+      handler->flags = act->sa_flags;
+      handler->mask = act->sa_mask;
       if (act->sa_flags & SA_SIGINFO)
         {
-          handler.sigaction = act->sa_sigaction;
+          handler->sigaction = act->sa_sigaction;
         }
       else
         {
-          handler.handler = act->sa_handler;
+          handler->handler = act->sa_handler;
         }
-      current->process->signalHandlers.push_back (handler);
-    }
-  if (oldact != 0)
-    {
-      oldact->sa_handler = SIG_IGN;
-      oldact->sa_flags = 0;
-      sigemptyset (&oldact->sa_mask);
     }
 
   return 0;
@@ -7,6 +7,8 @@
 #include "ns3/assert.h"
 #include <errno.h>
 #include "file-usage.h"
+#include "dce-manager.h"
+#include "tmpfs.h"
 
 using namespace ns3;
 
@@ -22,6 +24,18 @@ int dce___xstat (int ver, const char *path, struct stat *buf)
       current->err = ENOENT;
       return -1;
     }
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (path, &rest);
+  if (fs != 0)
+    {
+      int status = fs->Stat (rest, buf);
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      return 0;
+    }
   int retval = ::__xstat (ver, UtilsGetRealFilePath (path).c_str (), buf);
   if (retval == -1)
     {
@@ -40,6 +54,18 @@ int dce___xstat64 (int ver, const char *path, struct stat64 *buf)
       current->err = ENOENT;
       return -1;
     }
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (path, &rest);
+  if (fs != 0)
+    {
+      int status = fs->Stat64 (rest, buf);
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      return 0;
+    }
   int retval = ::__xstat64 (ver, UtilsGetRealFilePath (path).c_str (), buf);
   if (retval == -1)
     {
@@ -74,6 +100,18 @@ int dce___lxstat (int ver, const char *pathname, struct stat *buf)
       current->err = ENOENT;
       return -1;
     }
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (pathname, &rest);
+  if (fs != 0)
+    {
+      int status = fs->Stat (rest, buf);
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      return 0;
+    }
   int retval = ::__lxstat (ver, UtilsGetRealFilePath (pathname).c_str (), buf);
   if (retval == -1)
     {
@@ -92,6 +130,18 @@ int dce___lxstat64 (int ver, const char *pathname, struct stat64 *buf)
       current->err = ENOENT;
       return -1;
     }
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (pathname, &rest);
+  if (fs != 0)
+    {
+      int status = fs->Stat64 (rest, buf);
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      return 0;
+    }
   int retval = ::__lxstat64 (ver, UtilsGetRealFilePath (pathname).c_str (), buf);
   if (retval == -1)
     {
@@ -7,6 +7,8 @@
 #include "process.h"
 #include "utils.h"
 #include "unix-fd.h"
+#include "dce-manager.h"
+#include "tmpfs.h"
 #include "ns3/log.h"
 #include <errno.h>
 #include <fcntl.h>
@@ -696,8 +698,25 @@ int dce_remove (const char *pathname)
       current->err = ENOENT;
       return -1;
     }
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (pathname, &rest);
+  if (fs != 0)
+    {
+      Ptr<TmpfsInode> inode = fs->Lookup (rest);
+      if (inode == 0)
+        {
+          current->err = ENOENT;
+          return -1;
+        }
+      return inode->IsDir () ? dce_rmdir (pathname) : dce_unlink (pathname);
+    }
   std::string fullpath = UtilsGetRealFilePath (pathname);
-  int status = ::remove (fullpath.c_str ());
+  struct stat st;
+  int status = ::lstat (fullpath.c_str (), &st);
+  if (status == 0)
+    {
+      status = UtilsRemoveFile (pathname, S_ISDIR (st.st_mode));
+    }
   if (status == -1)
     {
       current->err = errno;
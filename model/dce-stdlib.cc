@@ -5,6 +5,7 @@
 #include "unix-fd.h"
 #include "unix-file-fd.h"
 #include "file-usage.h"
+#include "tmpfs.h"
 #include "ns3/log.h"
 #include <errno.h>
 #include <limits.h>
@@ -95,7 +96,7 @@ int dce_mkstemp (char *temp)
   NS_LOG_FUNCTION (current << UtilsGetNodeId ());
   NS_ASSERT (current != 0);
 
-  std::string fullpath = UtilsGetRealFilePath (temp);
+  std::string fullpath = UtilsGetWritableFilePath (temp, true);
   NS_LOG_FUNCTION (fullpath);
   int realFd = mkstemp ((char *)fullpath.c_str ());
   if (realFd == -1)
@@ -127,10 +128,20 @@ int dce_rename (const char *oldpath, const char *newpath)
   NS_LOG_FUNCTION (current << UtilsGetNodeId ());
   NS_ASSERT (current != 0);
 
-  std::string oldFullpath = UtilsGetRealFilePath (oldpath);
-  std::string newFullpath = UtilsGetRealFilePath (newpath);
-
-  int ret = rename (oldFullpath.c_str (), newFullpath.c_str ());
+  std::string oldRest, newRest;
+  Ptr<Tmpfs> oldFs = current->process->manager->LookupTmpfs (oldpath, &oldRest);
+  Ptr<Tmpfs> newFs = current->process->manager->LookupTmpfs (newpath, &newRest);
+  if (oldFs != 0 || newFs != 0)
+    {
+      int status = (oldFs == newFs) ? oldFs->Rename (oldRest, newRest) : -EXDEV;
+      if (status < 0)
+        {
+          current->err = -status;
+          return -1;
+        }
+      return 0;
+    }
+  int ret = UtilsRenameFile (oldpath, newpath);
   if (ret == -1)
     {
       current->err = errno;
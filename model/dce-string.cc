@@ -37,6 +37,36 @@ char * dce_strstr (const char *u, const char *d)
   return (char*)strstr (u, d);
 }
 
+void * dce_memchr (const void *s, int c, size_t n)
+{
+  return (void*)memchr (s, c, n);
+}
+
+void * dce_memrchr (const void *s, int c, size_t n)
+{
+  return (void*)memrchr (s, c, n);
+}
+
+char * dce_strchr (const char *s, int c)
+{
+  return (char*)strchr (s, c);
+}
+
+char * dce_strrchr (const char *s, int c)
+{
+  return (char*)strrchr (s, c);
+}
+
+char * dce_index (const char *s, int c)
+{
+  return (char*)index (s, c);
+}
+
+char * dce_rindex (const char *s, int c)
+{
+  return (char*)rindex (s, c);
+}
+
 void * dce_memcpy (void *dest, const void *source, size_t num)
 {
     return memcpy(dest, source, num);
@@ -14,6 +14,12 @@ char * dce___strcpy_chk (char *__restrict __dest,
                          size_t __destlen);
 char * dce_strpbrk (const char *s, const char *accept);
 char * dce_strstr (const char *h, const char *n);
+void * dce_memchr (const void *s, int c, size_t n);
+void * dce_memrchr (const void *s, int c, size_t n);
+char * dce_strchr (const char *s, int c);
+char * dce_strrchr (const char *s, int c);
+char * dce_index (const char *s, int c);
+char * dce_rindex (const char *s, int c);
 void * dce_memcpy (void *dest, const void *source, size_t num);
 void * dce___rawmemchr (const void *s, int c);
 void * dce___memcpy_chk(void * dest, const void * src, size_t len, size_t destlen);
@@ -111,7 +111,7 @@ int dce_utime (const char *filename, const struct utimbuf *times)
   NS_LOG_FUNCTION (Current () << UtilsGetNodeId ());
   NS_ASSERT (Current () != 0);
 
-  std::string fullpath = UtilsGetRealFilePath (filename);
+  std::string fullpath = UtilsGetWritableFilePath (filename, false);
 
   return utime (fullpath.c_str (), times);
 }
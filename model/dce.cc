@@ -1,6 +1,7 @@
 #include "dce-manager.h"
 #include "process.h"
 #include "utils.h"
+#include "tmpfs.h"
 #include "exec-utils.h"
 #include "dce-errno.h"
 #include "dce-libc-private.h"
@@ -33,6 +34,12 @@
 #include "ns3/random-variable.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "socket-fd-factory.h"
+#include "dce-node-context.h"
+
+#ifndef GRND_NONBLOCK
+#define GRND_NONBLOCK 0x01
+#define GRND_RANDOM 0x02
+#endif
 
 NS_LOG_COMPONENT_DEFINE ("Dce");
 
@@ -429,6 +436,19 @@ void dce_srand (unsigned int seed)
 {
   return;
 }
+ssize_t dce_getrandom (void *buf, size_t buflen, unsigned int flags)
+{
+  Thread *current = Current ();
+  NS_LOG_FUNCTION (current << UtilsGetNodeId () << buf << buflen << flags);
+  NS_ASSERT (current != 0);
+  // the pool never runs out: GRND_NONBLOCK and GRND_RANDOM change nothing.
+  if (flags & ~(GRND_NONBLOCK | GRND_RANDOM))
+    {
+      current->err = EINVAL;
+      return -1;
+    }
+  return DceNodeContext::GetNodeContext ()->RandomRead (buf, buflen);
+}
 
 const char * dce_inet_ntop (int af, const void *src,
                             char *dst, socklen_t cnt)
@@ -508,18 +528,10 @@ int dce_sched_yield (void)
   NS_LOG_FUNCTION (current << UtilsGetNodeId ());
   NS_ASSERT (current != 0);
   current->process->manager->Yield ();
+  // a loop around sched_yield waits for something which needs time.
+  UtilsSpin (current, 0, 0);
   return 0;
 }
-static void Itimer (Process *process)
-{
-  if (!process->itimerInterval.IsZero ())
-    {
-      process->itimer = Simulator::Schedule (process->itimerInterval,
-                                             &Itimer, process);
-    }
-  // wakeup one thread
-  UtilsSendSignal (process, SIGALRM);
-}
 int dce_getitimer (int which, struct itimerval *value)
 {
 
@@ -534,7 +546,7 @@ int dce_getitimer (int which, struct itimerval *value)
   // We don't support other kinds of timers.
   NS_ASSERT (which == ITIMER_REAL);
   value->it_interval = UtilsTimeToTimeval (current->process->itimerInterval);
-  value->it_value = UtilsTimeToTimeval (Simulator::GetDelayLeft (current->process->itimer));
+  value->it_value = UtilsTimeToTimeval (UtilsItimerLeft (current->process));
   return 0;
 }
 int dce_setitimer (int which, const struct itimerval *value,
@@ -553,20 +565,18 @@ int dce_setitimer (int which, const struct itimerval *value,
   if (ovalue != 0)
     {
       ovalue->it_interval = UtilsTimeToTimeval (current->process->itimerInterval);
-      ovalue->it_value = UtilsTimeToTimeval (Simulator::GetDelayLeft (current->process->itimer));
+      ovalue->it_value = UtilsTimeToTimeval (UtilsItimerLeft (current->process));
     }
 
   current->process->itimer.Cancel ();
+  current->process->itimerStalled = false;
   current->process->itimerInterval = UtilsTimevalToTime (value->it_interval);
   if (value->it_value.tv_sec == 0
       && value->it_value.tv_usec == 0)
     {
       return 0;
     }
-  TaskManager *manager = TaskManager::Current ();
-  current->process->itimer = manager->ScheduleMain (
-      UtilsTimevalToTime (value->it_value),
-      MakeEvent (&Itimer, current->process));
+  UtilsItimerArm (current->process, UtilsTimevalToTime (value->it_value));
 
   return 0;
 }
@@ -630,6 +640,19 @@ int dce_chdir (const char *path)
   NS_ASSERT (current != 0);
 
   int retval;
+  std::string rest;
+  Ptr<Tmpfs> fs = current->process->manager->LookupTmpfs (path, &rest);
+  if (fs != 0)
+    {
+      Ptr<TmpfsInode> inode = fs->Lookup (rest);
+      if (inode == 0 || !inode->IsDir ())
+        {
+          current->err = (inode == 0) ? ENOENT : ENOTDIR;
+          return -1;
+        }
+      current->process->cwd = UtilsGetVirtualFilePath (path);
+      return 0;
+    }
   std::string newCwd = UtilsGetRealFilePath (path);
   // test to see if the target directory exists
   retval = ::open (newCwd.c_str (), O_DIRECTORY | O_RDONLY);
@@ -662,6 +685,16 @@ int dce_fchdir (int fd)
       return -1;
     }
   std::string base = UtilsGetCurrentDirName () + "/" +  UtilsGetRealFilePath ("/");
+  std::string lower = UtilsGetBaseFilePath ("/");
+  if (!lower.empty () && lower[0] != '/')
+    {
+      lower = UtilsGetCurrentDirName () + "/" + lower;
+    }
+  if (!lower.empty () && p.compare (0, lower.length () - 1, lower, 0, lower.length () - 1) == 0)
+    {
+      // a directory of the base layer
+      base = lower;
+    }
   current->process->cwd =  UtilsGetVirtualFilePath (std::string (p, base.length () - 1));
   return 0;
 }
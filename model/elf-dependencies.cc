@@ -1,5 +1,6 @@
 #include "elf-dependencies.h"
 #include "elf-ldd.h"
+#include "utils.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include <string.h>
@@ -20,12 +21,171 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("ElfDependencies");
 
+bool
+ElfDependencies::FileIdentity::operator < (const struct FileIdentity &o) const
+{
+  if (dev != o.dev)
+    {
+      return dev < o.dev;
+    }
+  if (ino != o.ino)
+    {
+      return ino < o.ino;
+    }
+  if (size != o.size)
+    {
+      return size < o.size;
+    }
+  return mtime < o.mtime;
+}
+
+bool
+ElfDependencies::FileIdentity::operator == (const struct FileIdentity &o) const
+{
+  return dev == o.dev && ino == o.ino && size == o.size && mtime == o.mtime;
+}
+
+bool
+ElfDependencies::CacheKey::operator < (const struct CacheKey &o) const
+{
+  if (id < o.id)
+    {
+      return true;
+    }
+  if (o.id < id)
+    {
+      return false;
+    }
+  return mode < o.mode;
+}
+
+struct ElfDependencies::Cache *
+ElfDependencies::PeekCache (void)
+{
+  // Shared by all the loaders of the process: the same binary started
+  // on many nodes is resolved only once.
+  static struct Cache *cache = 0;
+  if (cache == 0)
+    {
+      cache = new Cache ();
+      memset (&cache->stats, 0, sizeof (cache->stats));
+    }
+  return cache;
+}
+
+struct ElfDependencies::Stats &
+ElfDependencies::PeekStats (void)
+{
+  return PeekCache ()->stats;
+}
+
+struct ElfDependencies::Stats
+ElfDependencies::GetStats (void)
+{
+  return PeekStats ();
+}
+
+void
+ElfDependencies::FlushCache (void)
+{
+  struct Cache *cache = PeekCache ();
+  cache->present.clear ();
+  cache->absent.clear ();
+  cache->deps.clear ();
+  ElfLdd::FlushCache ();
+}
+
+bool
+ElfDependencies::CachedStat (std::string filename, struct stat *st)
+{
+  struct Cache *cache = PeekCache ();
+  std::map<std::string, struct stat>::const_iterator i = cache->present.find (filename);
+  if (i != cache->present.end ())
+    {
+      cache->stats.statCached++;
+      *st = i->second;
+      return true;
+    }
+  if (cache->absent.find (filename) != cache->absent.end ())
+    {
+      cache->stats.statCached++;
+      return false;
+    }
+  cache->stats.statCalls++;
+  if (::stat (filename.c_str (), st) == 0)
+    {
+      cache->present[filename] = *st;
+      return true;
+    }
+  cache->absent[filename] = true;
+  return false;
+}
+
+bool
+ElfDependencies::GetFileIdentity (std::string filename, struct FileIdentity *id)
+{
+  // never from the cache: the file may have been touched or replaced
+  // since the previous load.
+  struct Cache *cache = PeekCache ();
+  struct stat st;
+  cache->stats.statCalls++;
+  if (::stat (filename.c_str (), &st) != 0)
+    {
+      return false;
+    }
+  cache->present[filename] = st;
+  cache->absent.erase (filename);
+  id->dev = st.st_dev;
+  id->ino = st.st_ino;
+  id->size = st.st_size;
+  id->mtime = st.st_mtime;
+  return true;
+}
+
+bool
+ElfDependencies::GetIdentities (const std::vector<struct Dependency> &deps,
+                                 std::vector<struct FileIdentity> *ids)
+{
+  ids->resize (deps.size ());
+  for (uint32_t i = 0; i < deps.size (); i++)
+    {
+      if (!GetFileIdentity (deps[i].found, &(*ids)[i]))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 ElfDependencies::ElfDependencies (std::string filename)
 {
+  struct Cache *cache = PeekCache ();
+  uint64_t start = UtilsGetHostTime ();
+  cache->stats.lookups++;
   std::string fullname;
   bool found;
   found = SearchFile (filename, &fullname);
   NS_ASSERT (found);
+
+  struct CacheKey key;
+  char *ldLibraryPath = getenv ("LD_LIBRARY_PATH");
+  key.mode = std::string (getenv ("OLDDEP") ? "ldd" : "elf") + ":" + filename
+    + ":" + (ldLibraryPath ? ldLibraryPath : "");
+  bool cacheable = GetFileIdentity (fullname, &key.id);
+  if (cacheable)
+    {
+      std::map<struct CacheKey, struct CachedDeps>::const_iterator i = cache->deps.find (key);
+      std::vector<struct FileIdentity> ids;
+      // a dependency reinstalled since is resolved again.
+      if (i != cache->deps.end () && GetIdentities (i->second.deps, &ids) && ids == i->second.ids)
+        {
+          NS_LOG_DEBUG ("Dependencies of " << fullname << " found in cache");
+          m_deps = i->second.deps;
+          cache->stats.hits++;
+          cache->stats.resolutionTime += UtilsGetHostTime () - start;
+          return;
+        }
+    }
   if (getenv ("OLDDEP"))
     {
       m_deps = GatherDependencies (fullname);
@@ -43,6 +203,13 @@ ElfDependencies::ElfDependencies (std::string filename)
       dependency.found = fullname;
       m_deps.push_back (dependency);
     }
+  struct CachedDeps cached;
+  if (cacheable && GetIdentities (m_deps, &cached.ids))
+    {
+      cached.deps = m_deps;
+      cache->deps[key] = cached;
+    }
+  cache->stats.resolutionTime += UtilsGetHostTime () - start;
 }
 
 std::vector<struct ElfDependencies::Dependency>
@@ -245,8 +412,7 @@ ElfDependencies::Exists (std::string filename) const
 {
   //NS_LOG_FUNCTION (this << filename);
   struct stat st;
-  int retval = ::stat (filename.c_str (), &st);
-  return retval == 0;
+  return CachedStat (filename, &st);
 }
 
 bool
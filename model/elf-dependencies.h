@@ -4,6 +4,10 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 namespace ns3 {
 
@@ -17,12 +21,79 @@ public:
   };
   typedef std::vector<struct Dependency>::const_iterator Iterator;
 
+  /**
+   * Counters of the process-wide dependency cache. Times are host
+   * wall-clock nanoseconds spent inside dependency resolution.
+   */
+  struct Stats
+  {
+    uint64_t lookups;       // number of ElfDependencies built
+    uint64_t hits;          // lookups answered from the dependency cache
+    uint64_t elfParsed;     // ELF dynamic sections actually parsed
+    uint64_t elfCached;     // ELF dynamic sections served from the cache
+    uint64_t statCalls;     // stat calls actually issued to the host
+    uint64_t statCached;    // stat calls answered from the cache (positive or negative)
+    uint64_t resolutionTime;
+  };
+
+  /**
+   * Identity of a file on the host: two paths with the same identity
+   * have the same dependencies.
+   */
+  struct FileIdentity
+  {
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    time_t mtime;
+    bool operator < (const struct FileIdentity &o) const;
+    bool operator == (const struct FileIdentity &o) const;
+  };
+
   ElfDependencies (std::string filename);
 
   Iterator Begin (void) const;
   Iterator End (void) const;
 
+  static struct Stats GetStats (void);
+  /**
+   * Forget everything cached so far: use it if files are added to or
+   * removed from the search directories while the simulation runs. A
+   * binary or one of the dependencies found for it modified or replaced
+   * is noticed without it: their identities are checked at each load.
+   */
+  static void FlushCache (void);
+
+  // Cached host lookups shared with ElfLdd.
+  static bool CachedStat (std::string filename, struct stat *st);
+  static bool GetFileIdentity (std::string filename, struct FileIdentity *id);
+  static struct Stats & PeekStats (void);
+
 private:
+  struct CacheKey
+  {
+    struct FileIdentity id;
+    std::string mode;
+    bool operator < (const struct CacheKey &o) const;
+  };
+  // the dependencies of a binary, with the identities of the files found.
+  struct CachedDeps
+  {
+    std::vector<struct Dependency> deps;
+    std::vector<struct FileIdentity> ids;
+  };
+  struct Cache
+  {
+    std::map<std::string, struct stat> present;
+    std::map<std::string, bool> absent;
+    std::map<struct CacheKey, struct CachedDeps> deps;
+    struct Stats stats;
+  };
+  static struct Cache * PeekCache (void);
+  // false if the files found have changed since, or if one is missing.
+  static bool GetIdentities (const std::vector<struct Dependency> &deps,
+                             std::vector<struct FileIdentity> *ids);
+
   std::list<std::string> Split (std::string input, std::string sep) const;
   std::list<std::string> GetSearchDirectories (void) const;
   bool Exists (std::string filename) const;
@@ -121,12 +121,11 @@ SharedLibrary::AddPath (string p)
             }
           if (res.length () > 0)
             {
-              DIR *d = opendir (res.c_str ());
+              struct stat st;
 
-              if (d)
+              if (ElfDependencies::CachedStat (res, &st) && S_ISDIR (st.st_mode))
                 {
                   m_path.push_back (res);
-                  closedir (d);
                 }
             }
         }
@@ -204,7 +203,7 @@ SharedLibrary::SearchLibs ()
           string fullPath = *j + p.first;
           struct stat st;
 
-          if (!stat (fullPath.c_str (), &st))
+          if (ElfDependencies::CachedStat (fullPath, &st))
             {
               p.second = fullPath;
               n.insert (p);
@@ -277,41 +276,56 @@ ElfW (Addr) vaddr_2_foffset (const ElfW (Ehdr) * he, const ElfW (Phdr) * pr, con
 
   return vma;
 }
-SharedLibrary*
-ElfLdd::ExtractLibraries (std::string sName, std::string fullPath)
+// What ExtractLibraries reads from the dynamic section of an ELF file.
+struct ElfInfo
+{
+  vector <string> needed;
+  vector <string> paths;
+  string soname;
+  bool arch32;
+  bool arch64;
+};
+
+static map <struct ElfDependencies::FileIdentity, struct ElfInfo> *
+PeekElfInfos (void)
+{
+  static map <struct ElfDependencies::FileIdentity, struct ElfInfo> *infos = 0;
+  if (infos == 0)
+    {
+      infos = new map <struct ElfDependencies::FileIdentity, struct ElfInfo> ();
+    }
+  return infos;
+}
+
+static bool
+ParseElf (std::string fullPath, struct ElfInfo *res)
 {
-  NS_LOG_FUNCTION (sName << fullPath);
   int fd = open (fullPath.c_str (), O_RDONLY);
   if (fd == -1)
     {
       NS_LOG_ERROR (fullPath << ": unable to open file errno: " << errno);
-      return 0;
+      return false;
     }
   struct stat st;
   int retval = fstat (fd, &st);
   if (retval)
     {
       NS_LOG_ERROR (fullPath << ": unable to fstat file errno: " << errno);
-      return 0;
+      close (fd);
+      return false;
     }
   uint64_t size = st.st_size;
   uint8_t *buffer = (uint8_t *) mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
   if (((void*)-1) == buffer)
     {
       NS_LOG_ERROR (fullPath << ": unable to mmap file errno: " << errno);
-      return 0;
+      close (fd);
+      return false;
     }
   close (fd);
-  SharedLibrary *res = new SharedLibrary (sName, fullPath);
   const ElfW (Ehdr) * header = (ElfW (Ehdr) *)buffer;
-  if (header->e_ident [EI_CLASS] == ELFCLASS64)
-    {
-      res->SetArch64 ();
-    }
-  if (header->e_ident [EI_CLASS] == ELFCLASS32)
-    {
-      res->SetArch32 ();
-    }
+  res->arch64 = (header->e_ident [EI_CLASS] == ELFCLASS64);
+  res->arch32 = (header->e_ident [EI_CLASS] == ELFCLASS32);
   const ElfW (Phdr) * programTable = (ElfW (Phdr) *)(buffer + header->e_phoff);
   const ElfW (Shdr) * sectionTable = (ElfW (Shdr) *)(buffer + header->e_shoff);
   for (int s = 0; s < header->e_shnum ; s++)
@@ -350,20 +364,20 @@ ElfLdd::ExtractLibraries (std::string sName, std::string fullPath)
 
                 case DT_NEEDED:
                   {
-                    res->AddLibrary (string ((char*)(buffer + dt_strtab + dynamics [n].d_un.d_ptr)));
+                    res->needed.push_back (string ((char*)(buffer + dt_strtab + dynamics [n].d_un.d_ptr)));
                   }
                   break;
 
                 case DT_RPATH:
                 case DT_RUNPATH:
                   {
-                    res->AddPath (string ((char*)(buffer + dt_strtab + dynamics [n].d_un.d_ptr)));
+                    res->paths.push_back (string ((char*)(buffer + dt_strtab + dynamics [n].d_un.d_ptr)));
                   }
                   break;
 
                 case DT_SONAME:
                   {
-                    res->SetSoName (string ((char*)(buffer + dt_strtab + dynamics [n].d_un.d_ptr)));
+                    res->soname = string ((char*)(buffer + dt_strtab + dynamics [n].d_un.d_ptr));
                   }
                   break;
                 }
@@ -374,6 +388,62 @@ ElfLdd::ExtractLibraries (std::string sName, std::string fullPath)
     }
   retval = ::munmap (buffer, size);
 
+  return true;
+}
+
+SharedLibrary*
+ElfLdd::ExtractLibraries (std::string sName, std::string fullPath)
+{
+  NS_LOG_FUNCTION (sName << fullPath);
+  map <struct ElfDependencies::FileIdentity, struct ElfInfo> *infos = PeekElfInfos ();
+  struct ElfDependencies::FileIdentity id;
+  struct ElfInfo info;
+  bool cacheable = ElfDependencies::GetFileIdentity (fullPath, &id);
+  map <struct ElfDependencies::FileIdentity, struct ElfInfo>::const_iterator cached = infos->end ();
+
+  if (cacheable)
+    {
+      cached = infos->find (id);
+    }
+  if (cached != infos->end ())
+    {
+      ElfDependencies::PeekStats ().elfCached++;
+      info = cached->second;
+    }
+  else
+    {
+      if (!ParseElf (fullPath, &info))
+        {
+          return 0;
+        }
+      ElfDependencies::PeekStats ().elfParsed++;
+      if (cacheable)
+        {
+          (*infos)[id] = info;
+        }
+    }
+
+  SharedLibrary *res = new SharedLibrary (sName, fullPath);
+  if (info.arch64)
+    {
+      res->SetArch64 ();
+    }
+  if (info.arch32)
+    {
+      res->SetArch32 ();
+    }
+  for (vector <string>::const_iterator i = info.needed.begin (); i != info.needed.end (); ++i)
+    {
+      res->AddLibrary (*i);
+    }
+  for (vector <string>::const_iterator i = info.paths.begin (); i != info.paths.end (); ++i)
+    {
+      res->AddPath (*i);
+    }
+  if (info.soname.length () > 0)
+    {
+      res->SetSoName (info.soname);
+    }
   return res;
 }
 
@@ -496,6 +566,12 @@ ElfLdd::End (void) const
   return m_deps.end ();
 }
 
+void
+ElfLdd::FlushCache (void)
+{
+  PeekElfInfos ()->clear ();
+}
+
 } // namespace ns3
 
 
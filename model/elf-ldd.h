@@ -39,6 +39,7 @@ public:
   ElfDependencies::Iterator Begin (void) const;
   ElfDependencies::Iterator End (void) const;
 
+  static void FlushCache (void);
 
 private:
   void Loop (std::string s, std::string f);
@@ -409,7 +409,14 @@ SearchExecFile (std::string file, std::string vpath, uid_t uid, gid_t gid, int *
   userData.gid = gid;
   userData.errNo = errNo;
 
-  return SearchFile (file, vroot, vpath, dcepath, cwd, altRoots, &userData, CheckFileExe);
+  std::string res = SearchFile (file, vroot, vpath, dcepath, cwd, altRoots, &userData, CheckFileExe);
+  std::string lower = UtilsGetBaseFilePath ("/");
+  if (res.length () == 0 && lower.length () > 0)
+    {
+      // the binaries shared by the nodes
+      res = SearchFile (file, lower, vpath, "", cwd, "", &userData, CheckFileExe);
+    }
+  return res;
 }
 std::string
 SearchExecFile (std::string file, uid_t uid, gid_t gid, int *errNo)
@@ -431,7 +438,13 @@ SearchExecFile (std::string file, uid_t uid, gid_t gid, int *errNo)
   userData.gid = gid;
   userData.errNo = errNo;
 
-  return SearchFile (file, vroot,  cwd, altRoots, &userData, CheckFileExe);
+  std::string res = SearchFile (file, vroot,  cwd, altRoots, &userData, CheckFileExe);
+  std::string lower = UtilsGetBaseFilePath ("/");
+  if (res.length () == 0 && lower.length () > 0)
+    {
+      res = SearchFile (file, lower, cwd, "", &userData, CheckFileExe);
+    }
+  return res;
 }
 // Search using only a real path within a real environment variable
 std::string
@@ -18,6 +18,15 @@ public:
     return 0;
   }
 
+  /**
+   * \returns true if the fibers survive a fork of the host process,
+   * that is if they are only memory and not host threads.
+   */
+  virtual bool IsForkSafe (void) const
+  {
+    return false;
+  }
+
   /**
    * \param callback function to use as main loop for the
    *        newly-created fiber
@@ -847,7 +847,8 @@ void
 KernelSocketFdFactory::PollEvent (int flag, void *context)
 {
   PollTable* ptable = (PollTable*)context;
-  ptable->WakeUpCallback ();
+  // the kernel does not tell which socket of the poll call this is.
+  ptable->WakeUpAll ();
 }
 
 /**
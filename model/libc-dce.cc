@@ -174,15 +174,12 @@ void libc_dce (struct Libc **libc)
   *libc = new Libc;
 
 #define DCE(name) (*libc)->name ## _fn = (func_t)(__typeof (&name))dce_ ## name;
-#define DCET(rtype,name) DCE (name)
+// no cast: the compiler checks the prototypes of libc-ns3.h.
 #define DCE_EXPLICIT(name,rtype,...) (*libc)->name ## _fn = dce_ ## name;
 
 #define NATIVE(name)                                                    \
   (*libc)->name ## _fn = (func_t)name;
-#define NATIVET(rtype, name) NATIVE(name)
-
-#define NATIVE_EXPLICIT(name, type)                             \
-  (*libc)->name ## _fn = (func_t)((type)name);
+#define NATIVE_EXPLICIT(name,rtype,...) (*libc)->name ## _fn = name;
 
 #include "libc-ns3.h"
 
@@ -12,6 +12,19 @@
  * DCE_WITH_ALIAS2 is similar to DCE_WITH_ALIAS but accepts two
  * parameter, name of the function (will be weak alias) and name of
  * the internal implementation
+ *
+ * Each of these macros has an _EXPLICIT variant which also gives the
+ * prototype of the function: its return type followed by the types of
+ * its arguments. They are used for all the functions which are not
+ * variadic and whose prototype can be written with the types of
+ * sys/types.h and FILE, which libc.h declares (DIR is struct
+ * __dirstream...), exactly as libc declares them:
+ * libc.cc then exports a typed stub which calls directly the table
+ * entry instead of copying a whole argument frame with
+ * __builtin_apply. DCE_EXPLICIT is defaulted to DCE and the other
+ * _EXPLICIT variants default the same way as their untyped versions.
+ * DCE_NORETURN is DCE_EXPLICIT for the void functions which never
+ * return, exit, abort and alike.
  */
 
 #ifndef DCE
@@ -38,8 +51,32 @@
 #define DCE_WITH_ALIAS2(name,internal) DCE_WITH_ALIAS (name)
 #endif
 
+#ifndef DCE_EXPLICIT
+#define DCE_EXPLICIT(name,...) DCE (name)
+#endif
+
 #ifndef NATIVE_EXPLICIT
-#define NATIVE_EXPLICIT(name,type) NATIVE (name)
+#define NATIVE_EXPLICIT DCE_EXPLICIT
+#endif
+
+#ifndef NATIVE_WITH_ALIAS_EXPLICIT
+#define NATIVE_WITH_ALIAS_EXPLICIT NATIVE_EXPLICIT
+#endif
+
+#ifndef NATIVE_WITH_ALIAS2_EXPLICIT
+#define NATIVE_WITH_ALIAS2_EXPLICIT(name,internal,...) NATIVE_WITH_ALIAS_EXPLICIT (name, __VA_ARGS__)
+#endif
+
+#ifndef DCE_WITH_ALIAS_EXPLICIT
+#define DCE_WITH_ALIAS_EXPLICIT DCE_EXPLICIT
+#endif
+
+#ifndef DCE_NORETURN
+#define DCE_NORETURN(name,...) DCE_EXPLICIT (name, void, ## __VA_ARGS__)
+#endif
+
+#ifndef DCE_WITH_ALIAS2_EXPLICIT
+#define DCE_WITH_ALIAS2_EXPLICIT(name,internal,...) DCE_WITH_ALIAS_EXPLICIT (name, __VA_ARGS__)
 #endif
 
 // #ifndef ALIAS
@@ -47,355 +84,360 @@
 // #endif
 
 // // not really a libc function, but we still need to get pointer from DCE to this function
-NATIVE (dce_global_variables_setup)
+NATIVE_EXPLICIT (dce_global_variables_setup, void, struct DceGlobalVariables *)
 
 // Not sure where it is defined and implemented
 // NATIVE (__xpg_strerror_r)
 
 
-DCE    (__cxa_finalize)
-DCE    (__cxa_atexit)
+DCE_EXPLICIT (__cxa_finalize, void, void *)
+DCE_EXPLICIT (__cxa_atexit, int, void (*)(void *), void *, void *)
 // Not sure where it is defined and implemented
 NATIVE (__gxx_personality_v0)
 
 // STDLIB.H
-DCE (atexit)
-DCE (random)
-DCE (srandom)
-DCE (rand)
-DCE (srand)
-DCE (drand48)
-DCE (erand48)
-DCE (lrand48)
-DCE (nrand48)
-DCE (mrand48)
-DCE (jrand48)
-DCE (srand48)
-DCE (seed48)
-DCE (lcong48)
-NATIVE (drand48_r)
-NATIVE (erand48_r)
-NATIVE (lrand48_r)
-NATIVE (nrand48_r)
-NATIVE (mrand48_r)
-NATIVE (jrand48_r)
-NATIVE (srand48_r)
-NATIVE (seed48_r)
-NATIVE (lcong48_r)
-DCE (calloc)
-DCE_WITH_ALIAS2 (malloc, valloc)
-DCE (free)
-DCE (realloc)
-NATIVE (atoi)
-NATIVE (atol)
-NATIVE (atoll)
-NATIVET (double, atof)
-DCE_WITH_ALIAS2 (strtol, __strtol_internal)
-DCET (long long int, strtoll)
-DCE (strtoul)
-DCE (strtoull)
-DCET (double, strtod)
-DCE (getenv)
-NATIVE (secure_getenv)
-DCE (putenv)
-DCE (setenv)
-DCE (unsetenv)
-DCE (clearenv)
-DCE (realpath)
-NATIVE (qsort)
-DCE (abort)
-DCE (__assert_fail)
-DCE (__stack_chk_fail)
-DCE (mkstemp)
-DCE (tmpfile)
-DCE (rename)
+DCE_EXPLICIT (atexit, int, void (*)())
+DCE_EXPLICIT (random, long int)
+DCE_EXPLICIT (srandom, void, unsigned int)
+DCE_EXPLICIT (rand, int)
+DCE_EXPLICIT (srand, void, unsigned int)
+DCE_EXPLICIT (drand48, double)
+DCE_EXPLICIT (erand48, double, unsigned short int *)
+DCE_EXPLICIT (lrand48, long int)
+DCE_EXPLICIT (nrand48, long int, unsigned short int *)
+DCE_EXPLICIT (mrand48, long int)
+DCE_EXPLICIT (jrand48, long int, unsigned short int *)
+DCE_EXPLICIT (srand48, void, long int)
+DCE_EXPLICIT (seed48, unsigned short int *, unsigned short int *)
+DCE_EXPLICIT (lcong48, void, unsigned short int *)
+NATIVE_EXPLICIT (drand48_r, int, struct drand48_data *, double *)
+NATIVE_EXPLICIT (erand48_r, int, unsigned short int *, struct drand48_data *, double *)
+NATIVE_EXPLICIT (lrand48_r, int, struct drand48_data *, long int *)
+NATIVE_EXPLICIT (nrand48_r, int, unsigned short int *, struct drand48_data *, long int *)
+NATIVE_EXPLICIT (mrand48_r, int, struct drand48_data *, long int *)
+NATIVE_EXPLICIT (jrand48_r, int, unsigned short int *, struct drand48_data *, long int *)
+NATIVE_EXPLICIT (srand48_r, int, long int, struct drand48_data *)
+NATIVE_EXPLICIT (seed48_r, int, unsigned short int *, struct drand48_data *)
+NATIVE_EXPLICIT (lcong48_r, int, unsigned short int *, struct drand48_data *)
+DCE_EXPLICIT (calloc, void *, size_t, size_t)
+DCE_WITH_ALIAS2_EXPLICIT (malloc, valloc, void *, size_t)
+DCE_EXPLICIT (free, void, void *)
+DCE_EXPLICIT (realloc, void *, void *, size_t)
+NATIVE_EXPLICIT (atoi, int, const char *)
+NATIVE_EXPLICIT (atol, long int, const char *)
+NATIVE_EXPLICIT (atoll, long long int, const char *)
+NATIVE_EXPLICIT (atof, double, const char *)
+DCE_WITH_ALIAS2_EXPLICIT (strtol, __strtol_internal, long int, const char *, char **, int)
+DCE_EXPLICIT (strtoll, long long int, const char *, char **, int)
+DCE_EXPLICIT (strtoul, unsigned long int, const char *, char **, int)
+DCE_EXPLICIT (strtoull, unsigned long long int, const char *, char **, int)
+DCE_EXPLICIT (strtod, double, const char *, char **)
+DCE_EXPLICIT (getenv, char *, const char *)
+NATIVE_EXPLICIT (secure_getenv, char *, const char *)
+DCE_EXPLICIT (putenv, int, char *)
+DCE_EXPLICIT (setenv, int, const char *, const char *, int)
+DCE_EXPLICIT (unsetenv, int, const char *)
+DCE_EXPLICIT (clearenv, int)
+DCE_EXPLICIT (realpath, char *, const char *, char *)
+NATIVE_EXPLICIT (qsort, void, void *, size_t, size_t, int (*)(const void *, const void *))
+DCE_NORETURN (abort)
+DCE_NORETURN (__assert_fail, const char *, const char *, unsigned int, const char *)
+DCE_NORETURN (__stack_chk_fail)
+DCE_EXPLICIT (mkstemp, int, char *)
+DCE_EXPLICIT (tmpfile, FILE *)
+DCE_EXPLICIT (rename, int, const char *, const char *)
 
 // STRING.H
-NATIVE (bzero)
-NATIVE (strerror)
-NATIVE (strerror_r)
-NATIVE (strcoll)
-NATIVE (memset)
+NATIVE_EXPLICIT (bzero, void, void *, size_t)
+NATIVE_EXPLICIT (strerror, char *, int)
+NATIVE_EXPLICIT (strerror_r, char *, int, char *, size_t)
+NATIVE_EXPLICIT (strcoll, int, const char *, const char *)
+NATIVE_EXPLICIT (memset, void *, void *, int, size_t)
 //NATIVE (memcpy)
-DCE (memcpy)
-DCE (__memcpy_chk)
-NATIVE (bcopy)
-NATIVE (memcmp)
-NATIVE (memmove)
-NATIVE_EXPLICIT (memchr, void * (*)(void *, int, size_t))
-NATIVE_EXPLICIT (memrchr, void * (*)(void *, int, size_t))
-DCE (__rawmemchr)
-NATIVE (strcpy)
-NATIVE (strncpy)
-NATIVE (strcat)
-NATIVE (strncat)
-NATIVE (strcmp)
-NATIVE (strncmp)
-NATIVE (strlen)
-NATIVE (strnlen)
-NATIVE (strcspn)
-NATIVE (strspn)
-NATIVE_EXPLICIT (strchr, char* (*)(char *, int))
-NATIVE_EXPLICIT (strrchr, const char * (*)(const char *, int))
-NATIVE (strcasecmp)
-NATIVE (strncasecmp)
-DCE_WITH_ALIAS (strdup) // because C++ defines both const and non-const functions
-DCE (strndup)
-NATIVE_EXPLICIT (index, char * (*)(char *, int))
-NATIVE_EXPLICIT (rindex, char * (*)(char *, int))
-NATIVE_EXPLICIT (strtok, char * (*)(char *, const char *))
-NATIVE_EXPLICIT (strtok_r,  char * (*)(char *, const char *, char **))
-NATIVE_EXPLICIT (__strtok_r,  char * (*)(char *, const char *, char **))
-NATIVE (strsep)
-NATIVE (stpcpy)
+DCE_EXPLICIT (memcpy, void *, void *, const void *, size_t)
+DCE_EXPLICIT (__memcpy_chk, void *, void *, const void *, size_t, size_t)
+NATIVE_EXPLICIT (bcopy, void, const void *, void *, size_t)
+NATIVE_EXPLICIT (memcmp, int, const void *, const void *, size_t)
+NATIVE_EXPLICIT (memmove, void *, void *, const void *, size_t)
+// C++ only declares const correct overloads of these: dce-string.cc
+// gives the C functions.
+DCE_EXPLICIT (memchr, void *, const void *, int, size_t)
+DCE_EXPLICIT (memrchr, void *, const void *, int, size_t)
+DCE_EXPLICIT (__rawmemchr, void *, const void *, int)
+NATIVE_EXPLICIT (strcpy, char *, char *, const char *)
+NATIVE_EXPLICIT (strncpy, char *, char *, const char *, size_t)
+NATIVE_EXPLICIT (strcat, char *, char *, const char *)
+NATIVE_EXPLICIT (strncat, char *, char *, const char *, size_t)
+NATIVE_EXPLICIT (strcmp, int, const char *, const char *)
+NATIVE_EXPLICIT (strncmp, int, const char *, const char *, size_t)
+NATIVE_EXPLICIT (strlen, size_t, const char *)
+NATIVE_EXPLICIT (strnlen, size_t, const char *, size_t)
+NATIVE_EXPLICIT (strcspn, size_t, const char *, const char *)
+NATIVE_EXPLICIT (strspn, size_t, const char *, const char *)
+DCE_EXPLICIT (strchr, char *, const char *, int)
+DCE_EXPLICIT (strrchr, char *, const char *, int)
+NATIVE_EXPLICIT (strcasecmp, int, const char *, const char *)
+NATIVE_EXPLICIT (strncasecmp, int, const char *, const char *, size_t)
+DCE_WITH_ALIAS_EXPLICIT (strdup, char *, const char *) // because C++ defines both const and non-const functions
+DCE_EXPLICIT (strndup, char *, const char *, size_t)
+DCE_EXPLICIT (index, char *, const char *, int)
+DCE_EXPLICIT (rindex, char *, const char *, int)
+NATIVE_EXPLICIT (strtok, char *, char *, const char *)
+NATIVE_EXPLICIT (strtok_r, char *, char *, const char *, char **)
+NATIVE_EXPLICIT (__strtok_r, char *, char *, const char *, char **)
+NATIVE_EXPLICIT (strsep, char *, char **, const char *)
+NATIVE_EXPLICIT (stpcpy, char *, char *, const char *)
 
 // LOCALE.H
-DCE    (setlocale)
-NATIVE_WITH_ALIAS (newlocale)
-NATIVE_WITH_ALIAS (uselocale)
+DCE_EXPLICIT (setlocale, char *, int, const char *)
+NATIVE_WITH_ALIAS_EXPLICIT (newlocale, struct __locale_struct *, int, const char *, struct __locale_struct *)
+NATIVE_WITH_ALIAS_EXPLICIT (uselocale, struct __locale_struct *, struct __locale_struct *)
 
 // WCHAR.H
-NATIVE (wctob)
-NATIVE (btowc)
+NATIVE_EXPLICIT (wctob, int, unsigned int)
+NATIVE_EXPLICIT (btowc, unsigned int, int)
 NATIVE (mbrlen)
 
 // ARPA/INET.H
-NATIVE (htonl)
-NATIVE (htons)
-NATIVE (ntohl)
-NATIVE (ntohs)
-NATIVE (lockf)
-NATIVE (inet_aton)
-NATIVE (inet_addr)
-NATIVE (inet_network)
+NATIVE_EXPLICIT (htonl, __uint32_t, __uint32_t)
+NATIVE_EXPLICIT (htons, __uint16_t, __uint16_t)
+NATIVE_EXPLICIT (ntohl, __uint32_t, __uint32_t)
+NATIVE_EXPLICIT (ntohs, __uint16_t, __uint16_t)
+NATIVE_EXPLICIT (lockf, int, int, int, __off_t)
+NATIVE_EXPLICIT (inet_aton, int, const char *, struct in_addr *)
+NATIVE_EXPLICIT (inet_addr, __uint32_t, const char *)
+NATIVE_EXPLICIT (inet_network, __uint32_t, const char *)
 NATIVE (inet_ntoa)
 NATIVE (inet_makeaddr)
 NATIVE (inet_lnaof)
 NATIVE (inet_netof)
-DCE (inet_ntop)
-NATIVE (inet_pton)
-NATIVE (inet6_opt_find)
+DCE_EXPLICIT (inet_ntop, const char *, int, const void *, char *, __socklen_t)
+NATIVE_EXPLICIT (inet_pton, int, int, const char *, void *)
+NATIVE_EXPLICIT (inet6_opt_find, int, void *, __socklen_t, int, __uint8_t, __socklen_t *, void **)
 
 // SYS/SOCKET.H
-DCE (socket)
-DCE (socketpair)
-DCE (getsockname)
-DCE (getpeername)
-DCE (bind)
-DCE (connect)
-DCE (setsockopt)
-DCE (getsockopt)
-DCE (listen)
-DCE (accept)
-DCE (shutdown)
-DCE (send)
-DCE (sendto)
-DCE (sendmsg)
-DCE (recv)
-DCE (recvfrom)
-DCE (recvmsg)
-DCE (getnameinfo)
+DCE_EXPLICIT (socket, int, int, int, int)
+DCE_EXPLICIT (socketpair, int, int, int, int, int *)
+DCE_EXPLICIT (getsockname, int, int, struct sockaddr *, __socklen_t *)
+DCE_EXPLICIT (getpeername, int, int, struct sockaddr *, __socklen_t *)
+DCE_EXPLICIT (bind, int, int, const struct sockaddr *, __socklen_t)
+DCE_EXPLICIT (connect, int, int, const struct sockaddr *, __socklen_t)
+DCE_EXPLICIT (setsockopt, int, int, int, int, const void *, __socklen_t)
+DCE_EXPLICIT (getsockopt, int, int, int, int, void *, __socklen_t *)
+DCE_EXPLICIT (listen, int, int, int)
+DCE_EXPLICIT (accept, int, int, struct sockaddr *, __socklen_t *)
+DCE_EXPLICIT (shutdown, int, int, int)
+DCE_EXPLICIT (send, ssize_t, int, const void *, size_t, int)
+DCE_EXPLICIT (sendto, ssize_t, int, const void *, size_t, int, const struct sockaddr *, __socklen_t)
+DCE_EXPLICIT (sendmsg, ssize_t, int, const struct msghdr *, int)
+DCE_EXPLICIT (recv, ssize_t, int, void *, size_t, int)
+DCE_EXPLICIT (recvfrom, ssize_t, int, void *, size_t, int, struct sockaddr *, __socklen_t *)
+DCE_EXPLICIT (recvmsg, ssize_t, int, struct msghdr *, int)
+DCE_EXPLICIT (getnameinfo, int, const struct sockaddr *, __socklen_t, char *, __socklen_t, char *, __socklen_t, unsigned int)
 
 
 // UNISTD.H
-DCE (read)
-DCE (write)
-DCE (sleep)
-DCE (usleep)
-DCE (getopt)
-DCE (getopt_long)
-DCE (getpid)
-DCE (getppid)
-DCE (getuid)
-DCE (geteuid)
-DCE (setuid)
-DCE (setgid)
-DCE (seteuid)
-DCE (setegid)
-DCE (setreuid)
-DCE (setregid)
-DCE (setresuid)
-DCE (setresgid)
-DCE (dup)
-DCE (dup2)
-DCE (close)
-DCE (unlink)
-DCE (rmdir)
+DCE_EXPLICIT (read, ssize_t, int, void *, size_t)
+DCE_EXPLICIT (write, ssize_t, int, const void *, size_t)
+DCE_EXPLICIT (sleep, unsigned int, unsigned int)
+DCE_EXPLICIT (usleep, int, useconds_t)
+DCE_EXPLICIT (getopt, int, int, char * const *, const char *)
+DCE_EXPLICIT (getopt_long, int, int, char * const *, const char *, const struct option *, int *)
+DCE_EXPLICIT (getpid, pid_t)
+DCE_EXPLICIT (getppid, pid_t)
+DCE_EXPLICIT (getuid, uid_t)
+DCE_EXPLICIT (geteuid, uid_t)
+DCE_EXPLICIT (setuid, int, uid_t)
+DCE_EXPLICIT (setgid, int, gid_t)
+DCE_EXPLICIT (seteuid, int, uid_t)
+DCE_EXPLICIT (setegid, int, gid_t)
+DCE_EXPLICIT (setreuid, int, uid_t, uid_t)
+DCE_EXPLICIT (setregid, int, gid_t, gid_t)
+DCE_EXPLICIT (setresuid, int, uid_t, uid_t, uid_t)
+DCE_EXPLICIT (setresgid, int, gid_t, gid_t, gid_t)
+DCE_EXPLICIT (dup, int, int)
+DCE_EXPLICIT (dup2, int, int, int)
+DCE_EXPLICIT (close, int, int)
+DCE_EXPLICIT (unlink, int, const char *)
+DCE_EXPLICIT (rmdir, int, const char *)
 DCE (select)
-DCE (isatty)
-DCE (exit)
-DCE (getcwd)
-DCE (getwd)
-DCE (get_current_dir_name)
-DCE (chdir)
-DCE (fchdir)
-DCE (fork)
-DCE (execv)
+DCE_EXPLICIT (isatty, int, int)
+DCE_NORETURN (exit, int)
+DCE_EXPLICIT (getcwd, char *, char *, size_t)
+DCE_EXPLICIT (getwd, char *, char *)
+DCE_EXPLICIT (get_current_dir_name, char *)
+DCE_EXPLICIT (chdir, int, const char *)
+DCE_EXPLICIT (fchdir, int, int)
+DCE_EXPLICIT (fork, pid_t)
+DCE_EXPLICIT (execv, int, const char *, char * const *)
 DCE (execl)
-DCE (execve)
-DCE (execvp)
+DCE_EXPLICIT (execve, int, const char *, char * const *, char * const *)
+DCE_EXPLICIT (execvp, int, const char *, char * const *)
 DCE (execlp)
 DCE (execle)
-DCE (truncate)
-DCE (ftruncate)
-DCE (ftruncate64)
-NATIVE (sysconf)
-DCE (ttyname)
-DCE (sbrk)
-DCE (getpagesize)
-DCE (getgid)
-DCE (getegid)
-DCE (gethostname)
-DCE (getpgrp)
-DCE (lseek)
-DCE (lseek64)
-DCE (euidaccess)
-DCE (eaccess)
-DCE (access)
-DCE (pipe)
-NATIVE (pathconf)
-NATIVE (getdtablesize)
-DCE (pread)
-DCE (pwrite)
-DCE (daemon)
-DCE (alarm)
-DCE (readlink)
-DCE (chown)
-DCE (chmod)
-DCE (initgroups)
-DCE (fsync)
-
-DCE (__fdelt_chk)
-DCE (sendfile)
+DCE_EXPLICIT (truncate, int, const char *, off_t)
+DCE_EXPLICIT (ftruncate, int, int, off_t)
+DCE_EXPLICIT (ftruncate64, int, int, off_t)
+NATIVE_EXPLICIT (sysconf, long int, int)
+DCE_EXPLICIT (ttyname, char *, int)
+DCE_EXPLICIT (sbrk, void *, __intptr_t)
+DCE_EXPLICIT (getpagesize, int)
+DCE_EXPLICIT (getgid, gid_t)
+DCE_EXPLICIT (getegid, gid_t)
+DCE_EXPLICIT (gethostname, int, char *, size_t)
+DCE_EXPLICIT (getpgrp, pid_t)
+DCE_EXPLICIT (lseek, off_t, int, off_t, int)
+DCE_EXPLICIT (lseek64, off64_t, int, off64_t, int)
+DCE_EXPLICIT (euidaccess, int, const char *, int)
+DCE_EXPLICIT (eaccess, int, const char *, int)
+DCE_EXPLICIT (access, int, const char *, int)
+DCE_EXPLICIT (pipe, int, int *)
+NATIVE_EXPLICIT (pathconf, long int, const char *, int)
+NATIVE_EXPLICIT (getdtablesize, int)
+DCE_EXPLICIT (pread, ssize_t, int, void *, size_t, off_t)
+DCE_EXPLICIT (pwrite, ssize_t, int, const void *, size_t, off_t)
+DCE_EXPLICIT (daemon, int, int, int)
+DCE_EXPLICIT (alarm, unsigned int, unsigned int)
+DCE_EXPLICIT (readlink, ssize_t, const char *, char *, size_t)
+DCE_EXPLICIT (chown, int, const char *, uid_t, gid_t)
+DCE_EXPLICIT (chmod, int, const char *, mode_t)
+DCE_EXPLICIT (initgroups, int, const char *, gid_t)
+DCE_EXPLICIT (fsync, int, int)
+
+DCE_EXPLICIT (__fdelt_chk, long int, long int)
+DCE_EXPLICIT (sendfile, ssize_t, int, int, off_t *, size_t)
 
 // SYS/UIO.H
-DCE (readv)
-DCE (writev)
+DCE_EXPLICIT (readv, ssize_t, int, const struct iovec *, int)
+DCE_EXPLICIT (writev, ssize_t, int, const struct iovec *, int)
 
 // STDIO.H
-DCE_WITH_ALIAS2 (clearerr,clearerr_unlocked)
-DCE (setvbuf)
-DCE (setbuf)
-DCE (setbuffer)
-DCE (setlinebuf)
-DCE (fseek)
-DCE (ftell)
-DCE (fseeko)
-DCE (ftello)
-DCE (rewind)
+DCE_WITH_ALIAS2_EXPLICIT (clearerr, clearerr_unlocked, void, FILE *)
+DCE_EXPLICIT (setvbuf, int, FILE *, char *, int, size_t)
+DCE_EXPLICIT (setbuf, void, FILE *, char *)
+DCE_EXPLICIT (setbuffer, void, FILE *, char *, size_t)
+DCE_EXPLICIT (setlinebuf, void, FILE *)
+DCE_EXPLICIT (fseek, int, FILE *, long int, int)
+DCE_EXPLICIT (ftell, long int, FILE *)
+DCE_EXPLICIT (fseeko, int, FILE *, off_t, int)
+DCE_EXPLICIT (ftello, off_t, FILE *)
+DCE_EXPLICIT (rewind, void, FILE *)
 DCE (fgetpos)
 DCE (fsetpos)
 DCE (printf)
 NATIVE (fprintf)
 NATIVE_WITH_ALIAS2 (sprintf, __sprintf_chk)
 DCE_WITH_ALIAS2 (asprintf, __asprintf)
-DCE (vasprintf)
+DCE_EXPLICIT (vasprintf, int, char **, const char *, va_list)
 NATIVE (dprintf)
-NATIVE (vdprintf)
-DCE_WITH_ALIAS2 (fgetc,fgetc_unlocked)
-NATIVE (getc)
-NATIVE (getc_unlocked)
-DCE_WITH_ALIAS2 (getchar,getchar_unlocked)
-DCE (_IO_getc)
-DCE_WITH_ALIAS2 (fputc,fputc_unlocked)
-NATIVE (putc)
-NATIVE (putc_unlocked)
-DCE_WITH_ALIAS2 (putchar, putchar_unlocked)
-DCE (_IO_putc)
-DCE_WITH_ALIAS2 (fgets, fgets_unlocked)
-DCE_WITH_ALIAS2 (fputs, fputs_unlocked)
-DCE (puts)
-DCE (ungetc)
-DCE (fclose)
-DCE (fcloseall)
-DCE (fopen)
-DCE (fopen64)
-DCE (freopen)
-DCE (fdopen)
-DCE_WITH_ALIAS2 (fread, fread_unlocked)
-DCE_WITH_ALIAS2 (fwrite,fwrite_unlocked)
-DCE_WITH_ALIAS2 (fflush,fflush_unlocked)
-DCE_WITH_ALIAS2 (ferror,ferror_unlocked)
-DCE_WITH_ALIAS2 (feof,feof_unlocked)
-DCE_WITH_ALIAS2 (fileno,fileno_unlocked)
-DCE (perror)
-DCE (remove)
+NATIVE_EXPLICIT (vdprintf, int, int, const char *, va_list)
+DCE_WITH_ALIAS2_EXPLICIT (fgetc, fgetc_unlocked, int, FILE *)
+NATIVE_EXPLICIT (getc, int, FILE *)
+NATIVE_EXPLICIT (getc_unlocked, int, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (getchar, getchar_unlocked, int)
+DCE_EXPLICIT (_IO_getc, int, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (fputc, fputc_unlocked, int, int, FILE *)
+NATIVE_EXPLICIT (putc, int, int, FILE *)
+NATIVE_EXPLICIT (putc_unlocked, int, int, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (putchar, putchar_unlocked, int, int)
+DCE_EXPLICIT (_IO_putc, int, int, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (fgets, fgets_unlocked, char *, char *, int, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (fputs, fputs_unlocked, int, const char *, FILE *)
+DCE_EXPLICIT (puts, int, const char *)
+DCE_EXPLICIT (ungetc, int, int, FILE *)
+DCE_EXPLICIT (fclose, int, FILE *)
+DCE_EXPLICIT (fcloseall, int)
+DCE_EXPLICIT (fopen, FILE *, const char *, const char *)
+DCE_EXPLICIT (fopen64, FILE *, const char *, const char *)
+DCE_EXPLICIT (freopen, FILE *, const char *, const char *, FILE *)
+DCE_EXPLICIT (fdopen, FILE *, int, const char *)
+DCE_WITH_ALIAS2_EXPLICIT (fread, fread_unlocked, size_t, void *, size_t, size_t, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (fwrite, fwrite_unlocked, size_t, const void *, size_t, size_t, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (fflush, fflush_unlocked, int, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (ferror, ferror_unlocked, int, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (feof, feof_unlocked, int, FILE *)
+DCE_WITH_ALIAS2_EXPLICIT (fileno, fileno_unlocked, int, FILE *)
+DCE_EXPLICIT (perror, void, const char *)
+DCE_EXPLICIT (remove, int, const char *)
 //NATIVE (sscanf)
 NATIVE_WITH_ALIAS2 (sscanf, __isoc99_sscanf)
-NATIVE (flockfile)
-NATIVE (funlockfile)
-NATIVE (popen)
-NATIVE (pclose)
+NATIVE_EXPLICIT (flockfile, void, FILE *)
+NATIVE_EXPLICIT (funlockfile, void, FILE *)
+NATIVE_EXPLICIT (popen, FILE *, const char *, const char *)
+NATIVE_EXPLICIT (pclose, int, FILE *)
 
 // STDARG.H
-DCE (vprintf)
-NATIVE (vfprintf)
-NATIVE (vsprintf)
+DCE_EXPLICIT (vprintf, int, const char *, va_list)
+NATIVE_EXPLICIT (vfprintf, int, FILE *, const char *, va_list)
+NATIVE_EXPLICIT (vsprintf, int, char *, const char *, va_list)
 
 // FCNTL.H
 DCE (fcntl)
 DCE_WITH_ALIAS2 (open, __open_2)
 DCE (open64)
-DCE (unlinkat)
+DCE_EXPLICIT (unlinkat, int, int, const char *, int)
+DCE_EXPLICIT (splice, ssize_t, int, loff_t *, int, loff_t *, size_t, unsigned int)
+DCE_EXPLICIT (tee, ssize_t, int, int, size_t, unsigned int)
+DCE_EXPLICIT (vmsplice, ssize_t, int, const struct iovec *, size_t, unsigned int)
 
 // TIME.H
-DCE (nanosleep)
-DCE (asctime)
-NATIVE (asctime_r)
-DCE (ctime)
-NATIVE (ctime_r)
-DCE_WITH_ALIAS2 (gmtime, localtime)
-NATIVE_WITH_ALIAS2 (gmtime_r, localtime_r)
-NATIVE (mktime)
-NATIVE (strftime)
-NATIVE (strptime)
-NATIVE (timegm)
-NATIVE (timelocal)
+DCE_EXPLICIT (nanosleep, int, const struct timespec *, struct timespec *)
+DCE_EXPLICIT (asctime, char *, const struct tm *)
+NATIVE_EXPLICIT (asctime_r, char *, const struct tm *, char *)
+DCE_EXPLICIT (ctime, char *, const time_t *)
+NATIVE_EXPLICIT (ctime_r, char *, const time_t *, char *)
+DCE_WITH_ALIAS2_EXPLICIT (gmtime, localtime, struct tm *, const time_t *)
+NATIVE_WITH_ALIAS2_EXPLICIT (gmtime_r, localtime_r, struct tm *, const time_t *, struct tm *)
+NATIVE_EXPLICIT (mktime, time_t, struct tm *)
+NATIVE_EXPLICIT (strftime, size_t, char *, size_t, const char *, const struct tm *)
+NATIVE_EXPLICIT (strptime, char *, const char *, const char *, struct tm *)
+NATIVE_EXPLICIT (timegm, time_t, struct tm *)
+NATIVE_EXPLICIT (timelocal, time_t, struct tm *)
 DCE_EXPLICIT (clock_gettime, int, clockid_t, struct timespec *)
 DCE_EXPLICIT (clock_getres, int, clockid_t, struct timespec *)
 
-DCE (timer_create)
-DCE (timer_settime)
-DCE (timer_gettime)
+DCE_EXPLICIT (timer_create, int, clockid_t, struct sigevent *, void **)
+DCE_EXPLICIT (timer_settime, int, int, int, const struct itimerspec *, struct itimerspec *)
+DCE_EXPLICIT (timer_gettime, int, int, struct itimerspec *)
 
 // UTIME.H
-DCE (utime)
-DCE (tzset)
+DCE_EXPLICIT (utime, int, const char *, const struct utimbuf *)
+DCE_EXPLICIT (tzset, void)
 
 // SYS/TIME.H
-DCE (gettimeofday)
-DCE (time)
-DCE (setitimer)
-DCE (getitimer)
+DCE_EXPLICIT (gettimeofday, int, struct timeval *, struct timezone *)
+DCE_EXPLICIT (time, time_t, time_t *)
+DCE_EXPLICIT (setitimer, int, int, const struct itimerval *, struct itimerval *)
+DCE_EXPLICIT (getitimer, int, int, struct itimerval *)
 
-DCE (sysinfo)
+DCE_EXPLICIT (sysinfo, int, struct sysinfo *)
 
 // SYS/MAP.H
-DCE (mmap)
-DCE (mmap64)
-DCE (munmap)
+DCE_EXPLICIT (mmap, void *, void *, size_t, int, int, int, off_t)
+DCE_EXPLICIT (mmap64, void *, void *, size_t, int, int, int, off64_t)
+DCE_EXPLICIT (munmap, int, void *, size_t)
 
 // SYS/STAT/H
-DCE (mkdir)
-DCE (umask)
+DCE_EXPLICIT (mkdir, int, const char *, mode_t)
+DCE_EXPLICIT (umask, mode_t, mode_t)
 
 // SYS/IOCTL.H
 DCE (ioctl)
 
 // SCHED.H
-DCE (sched_yield)
+DCE_EXPLICIT (sched_yield, int)
 
 // POLL.H
-DCE (poll)
+DCE_EXPLICIT (poll, int, struct pollfd *, unsigned long int, int)
 
 // SYS/EPOLL.H
-DCE (epoll_create)
-DCE (epoll_ctl)
-DCE (epoll_wait)
+DCE_EXPLICIT (epoll_create, int, int)
+DCE_EXPLICIT (epoll_ctl, int, int, int, int, struct epoll_event *)
+DCE_EXPLICIT (epoll_wait, int, int, struct epoll_event *, int, int)
 
 // SIGNAL.H
-DCE (signal)
-DCE (sigaction)
+DCE_EXPLICIT (signal, void (*)(int), int, void (*)(int))
+DCE_EXPLICIT (sigaction, int, int, const struct sigaction *, struct sigaction *)
 NATIVE (sigemptyset)
 NATIVE (sigfillset)
 NATIVE (sigaddset)
@@ -403,60 +445,60 @@ NATIVE (sigdelset)
 NATIVE (sigismember)
 DCE (sigprocmask)
 DCE    (sigwait)
-DCE    (kill)
+DCE_EXPLICIT (kill, int, pid_t, int)
 NATIVE (sys_siglist)
-NATIVE (__libc_current_sigrtmin)
-NATIVE (__libc_current_sigrtmax)
+NATIVE_EXPLICIT (__libc_current_sigrtmin, int)
+NATIVE_EXPLICIT (__libc_current_sigrtmax, int)
 
 // PTHREAD.H
-DCE (pthread_create)
-DCE (pthread_exit)
-DCE (pthread_self)
-DCE_WITH_ALIAS (pthread_once)
-DCE (pthread_getspecific)
-DCE (pthread_setspecific)
-DCE_WITH_ALIAS (pthread_key_create)
-DCE (pthread_key_delete)
-DCE (pthread_mutex_destroy)
-DCE (pthread_mutex_init)
+DCE_EXPLICIT (pthread_create, int, pthread_t *, const pthread_attr_t *, void * (*)(void *), void *)
+DCE_NORETURN (pthread_exit, void *)
+DCE_EXPLICIT (pthread_self, pthread_t)
+DCE_WITH_ALIAS_EXPLICIT (pthread_once, int, pthread_once_t *, void (*)())
+DCE_EXPLICIT (pthread_getspecific, void *, pthread_key_t)
+DCE_EXPLICIT (pthread_setspecific, int, pthread_key_t, const void *)
+DCE_WITH_ALIAS_EXPLICIT (pthread_key_create, int, pthread_key_t *, void (*)(void *))
+DCE_EXPLICIT (pthread_key_delete, int, pthread_key_t)
+DCE_EXPLICIT (pthread_mutex_destroy, int, pthread_mutex_t *)
+DCE_EXPLICIT (pthread_mutex_init, int, pthread_mutex_t *, const pthread_mutexattr_t *)
 DCE_EXPLICIT (pthread_mutex_lock, int, pthread_mutex_t *)
 DCE_EXPLICIT (pthread_mutex_unlock, int, pthread_mutex_t *)
-DCE (pthread_mutex_trylock)
-DCE (pthread_mutexattr_init)
-DCE (pthread_mutexattr_destroy)
-DCE (pthread_mutexattr_settype)
-DCE (pthread_cancel)
-DCE (pthread_kill)
-DCE (pthread_join)
-DCE (pthread_detach)
-DCE (pthread_cond_destroy)
-DCE (pthread_cond_init)
-DCE (pthread_cond_broadcast)
-DCE (pthread_cond_signal)
+DCE_EXPLICIT (pthread_mutex_trylock, int, pthread_mutex_t *)
+DCE_EXPLICIT (pthread_mutexattr_init, int, pthread_mutexattr_t *)
+DCE_EXPLICIT (pthread_mutexattr_destroy, int, pthread_mutexattr_t *)
+DCE_EXPLICIT (pthread_mutexattr_settype, int, pthread_mutexattr_t *, int)
+DCE_EXPLICIT (pthread_cancel, int, pthread_t)
+DCE_EXPLICIT (pthread_kill, int, pthread_t, int)
+DCE_EXPLICIT (pthread_join, int, pthread_t, void **)
+DCE_EXPLICIT (pthread_detach, int, pthread_t)
+DCE_EXPLICIT (pthread_cond_destroy, int, pthread_cond_t *)
+DCE_EXPLICIT (pthread_cond_init, int, pthread_cond_t *, const pthread_condattr_t *)
+DCE_EXPLICIT (pthread_cond_broadcast, int, pthread_cond_t *)
+DCE_EXPLICIT (pthread_cond_signal, int, pthread_cond_t *)
 DCE_EXPLICIT (pthread_cond_timedwait, int, pthread_cond_t*, pthread_mutex_t*, const struct timespec *)
 DCE_EXPLICIT (pthread_cond_wait, int, pthread_cond_t*, pthread_mutex_t*)
-DCE (pthread_condattr_destroy)
-DCE (pthread_condattr_init)
-DCE (pthread_setname_np)
-NATIVE (pthread_rwlock_init)
-NATIVE (pthread_rwlock_unlock)
-NATIVE (pthread_rwlock_wrlock)
-NATIVE (pthread_rwlock_rdlock)
-NATIVE (pthread_rwlock_destroy)
-NATIVE (pthread_rwlockattr_init)
-NATIVE (pthread_rwlockattr_setkind_np)
-NATIVE (pthread_rwlockattr_destroy)
-NATIVE (posix_memalign)
-NATIVE (pthread_setcancelstate)
+DCE_EXPLICIT (pthread_condattr_destroy, int, pthread_condattr_t *)
+DCE_EXPLICIT (pthread_condattr_init, int, pthread_condattr_t *)
+DCE_EXPLICIT (pthread_setname_np, int, pthread_t, const char *)
+NATIVE_EXPLICIT (pthread_rwlock_init, int, pthread_rwlock_t *, const pthread_rwlockattr_t *)
+NATIVE_EXPLICIT (pthread_rwlock_unlock, int, pthread_rwlock_t *)
+NATIVE_EXPLICIT (pthread_rwlock_wrlock, int, pthread_rwlock_t *)
+NATIVE_EXPLICIT (pthread_rwlock_rdlock, int, pthread_rwlock_t *)
+NATIVE_EXPLICIT (pthread_rwlock_destroy, int, pthread_rwlock_t *)
+NATIVE_EXPLICIT (pthread_rwlockattr_init, int, pthread_rwlockattr_t *)
+NATIVE_EXPLICIT (pthread_rwlockattr_setkind_np, int, pthread_rwlockattr_t *, int)
+NATIVE_EXPLICIT (pthread_rwlockattr_destroy, int, pthread_rwlockattr_t *)
+NATIVE_EXPLICIT (posix_memalign, int, void **, size_t, size_t)
+NATIVE_EXPLICIT (pthread_setcancelstate, int, int, int *)
 NATIVE (pthread_sigmask)
-NATIVE (pthread_equal)
-NATIVE (pthread_spin_init)
-NATIVE (pthread_spin_lock)
-NATIVE (pthread_spin_unlock)
-NATIVE (pthread_spin_destroy)
-NATIVE (pthread_attr_init)
-NATIVE (pthread_attr_setscope)
-NATIVE (pthread_attr_destroy)
+NATIVE_EXPLICIT (pthread_equal, int, pthread_t, pthread_t)
+NATIVE_EXPLICIT (pthread_spin_init, int, pthread_spinlock_t *, int)
+NATIVE_EXPLICIT (pthread_spin_lock, int, pthread_spinlock_t *)
+NATIVE_EXPLICIT (pthread_spin_unlock, int, pthread_spinlock_t *)
+NATIVE_EXPLICIT (pthread_spin_destroy, int, pthread_spinlock_t *)
+NATIVE_EXPLICIT (pthread_attr_init, int, pthread_attr_t *)
+NATIVE_EXPLICIT (pthread_attr_setscope, int, pthread_attr_t *, int)
+NATIVE_EXPLICIT (pthread_attr_destroy, int, pthread_attr_t *)
 
 
 // SEMAPHORE.H
@@ -469,201 +511,207 @@ DCE (sem_trywait)
 DCE (sem_getvalue)
 
 // NETDB.H
-DCE (gethostbyname)
-DCE (gethostbyname2)
-DCE (getaddrinfo)
-DCE (freeaddrinfo)
-DCE (gai_strerror)
-DCE (getifaddrs)
-NATIVE (freeifaddrs)
-NATIVE (gethostent)
-NATIVE (sethostent)
-NATIVE (endhostent)
-DCE (herror)
-NATIVE (hstrerror) // this could be replaced by DCE call
-NATIVE (getprotoent)
-NATIVE (getprotobyname)
-NATIVE (getprotobynumber)
-NATIVE (setprotoent)
-NATIVE (endprotoent)
-NATIVE (getservent)
-NATIVE (getservbyname)
-NATIVE (getservbyport)
-NATIVE (setservent)
-NATIVE (endservent)
+DCE_EXPLICIT (gethostbyname, struct hostent *, const char *)
+DCE_EXPLICIT (gethostbyname2, struct hostent *, const char *, int)
+DCE_EXPLICIT (getaddrinfo, int, const char *, const char *, const struct addrinfo *, struct addrinfo **)
+DCE_EXPLICIT (freeaddrinfo, void, struct addrinfo *)
+DCE_EXPLICIT (gai_strerror, const char *, int)
+DCE_EXPLICIT (getifaddrs, int, struct ifaddrs **)
+NATIVE_EXPLICIT (freeifaddrs, void, struct ifaddrs *)
+NATIVE_EXPLICIT (gethostent, struct hostent *)
+NATIVE_EXPLICIT (sethostent, void, int)
+NATIVE_EXPLICIT (endhostent, void)
+DCE_EXPLICIT (herror, void, const char *)
+NATIVE_EXPLICIT (hstrerror, const char *, int) // this could be replaced by DCE call
+NATIVE_EXPLICIT (getprotoent, struct protoent *)
+NATIVE_EXPLICIT (getprotobyname, struct protoent *, const char *)
+NATIVE_EXPLICIT (getprotobynumber, struct protoent *, int)
+NATIVE_EXPLICIT (setprotoent, void, int)
+NATIVE_EXPLICIT (endprotoent, void)
+NATIVE_EXPLICIT (getservent, struct servent *)
+DCE_EXPLICIT (getservbyname, struct servent *, const char *, const char *)
+DCE_EXPLICIT (getservbyport, struct servent *, int, const char *)
+NATIVE_EXPLICIT (setservent, void, int)
+NATIVE_EXPLICIT (endservent, void)
 
 // CTYPE.H
-NATIVE (toupper)
-NATIVE (tolower)
-NATIVE (isdigit)
-NATIVE (isxdigit)
-NATIVE (isalnum)
-NATIVE (isspace)
-NATIVE (__ctype_toupper_loc)
+NATIVE_EXPLICIT (toupper, int, int)
+NATIVE_EXPLICIT (tolower, int, int)
+NATIVE_EXPLICIT (isdigit, int, int)
+NATIVE_EXPLICIT (isxdigit, int, int)
+NATIVE_EXPLICIT (isalnum, int, int)
+NATIVE_EXPLICIT (isspace, int, int)
+NATIVE_EXPLICIT (__ctype_toupper_loc, const __int32_t **)
 
 // SYS/TIMERFD.H
-DCE (timerfd_create)
-DCE (timerfd_settime)
-DCE (timerfd_gettime)
+DCE_EXPLICIT (timerfd_create, int, int, int)
+DCE_EXPLICIT (timerfd_settime, int, int, int, const struct itimerspec *, struct itimerspec *)
+DCE_EXPLICIT (timerfd_gettime, int, int, struct itimerspec *)
 
 // NET/IF.H
-DCE (if_nametoindex)
-DCE (if_indextoname)
+DCE_EXPLICIT (if_nametoindex, unsigned int, const char *)
+DCE_EXPLICIT (if_indextoname, char *, unsigned int, char *)
 
 // DIRENT.H
-DCE (opendir)
-DCE (fdopendir)
-DCE (readdir)
-DCE (readdir_r)
-DCE (readdir64)
-DCE (closedir)
-DCE (dirfd)
-DCE (rewinddir)
-DCE (scandir)
-NATIVE (alphasort)
-NATIVE (alphasort64)
-NATIVE (versionsort)
+DCE_EXPLICIT (opendir, struct __dirstream *, const char *)
+DCE_EXPLICIT (fdopendir, struct __dirstream *, int)
+DCE_EXPLICIT (readdir, struct dirent *, struct __dirstream *)
+DCE_EXPLICIT (readdir_r, int, struct __dirstream *, struct dirent *, struct dirent **)
+DCE_EXPLICIT (readdir64, struct dirent64 *, struct __dirstream *)
+DCE_EXPLICIT (closedir, int, struct __dirstream *)
+DCE_EXPLICIT (dirfd, int, struct __dirstream *)
+DCE_EXPLICIT (rewinddir, void, struct __dirstream *)
+DCE_EXPLICIT (scandir, int, const char *, struct dirent ***, int (*)(const struct dirent *), int (*)(const struct dirent **, const struct dirent **))
+NATIVE_EXPLICIT (alphasort, int, const struct dirent **, const struct dirent **)
+NATIVE_EXPLICIT (alphasort64, int, const struct dirent64 **, const struct dirent64 **)
+NATIVE_EXPLICIT (versionsort, int, const struct dirent **, const struct dirent **)
 
 // SYS/UTSNAME.H
-DCE (uname)
+DCE_EXPLICIT (uname, int, struct utsname *)
+
+// SYS/RANDOM.H
+DCE_EXPLICIT (getrandom, ssize_t, void *, size_t, unsigned int)
 
 // SYS/WAIT.H
-DCE (wait)
-DCE (waitpid)
+DCE_EXPLICIT (wait, pid_t, void *)
+DCE_EXPLICIT (waitpid, pid_t, pid_t, int *, int)
 
 // LIBGEN.H
-NATIVE (basename)
-NATIVE (dirname)
-NATIVE (__xpg_basename)
+NATIVE_EXPLICIT (basename, char *, char *)
+NATIVE_EXPLICIT (dirname, char *, char *)
+NATIVE_EXPLICIT (__xpg_basename, char *, char *)
 
 // GRP.H
-NATIVE (getgrnam)
+NATIVE_EXPLICIT (getgrnam, struct group *, const char *)
 
 // SYS/RESOURCE.H
-NATIVE (getrusage) // not sure if native call will give stats about the requested process..
-NATIVE (getrlimit)
-NATIVE (setrlimit)
+NATIVE_EXPLICIT (getrusage, int, int, struct rusage *) // not sure if native call will give stats about the requested process..
+NATIVE_EXPLICIT (getrlimit, int, int, struct rlimit *)
+NATIVE_EXPLICIT (setrlimit, int, int, const struct rlimit *)
 
 // SYSLOG.H
-DCE (openlog)
-DCE (closelog)
-DCE (setlogmask)
+DCE_EXPLICIT (openlog, void, const char *, int, int)
+DCE_EXPLICIT (closelog, void)
+DCE_EXPLICIT (setlogmask, int, int)
 DCE (syslog)
-DCE (vsyslog)
+DCE_EXPLICIT (vsyslog, void, int, const char *, va_list)
 
 // SETJMP.H
-NATIVE (__sigsetjmp)
-NATIVE (siglongjmp)
+NATIVE_EXPLICIT (__sigsetjmp, int, struct __jmp_buf_tag *, int)
+NATIVE_EXPLICIT (siglongjmp, void, struct __jmp_buf_tag *, int)
 
 // LIBINTL.H
-NATIVE (bindtextdomain)
-NATIVE (textdomain)
-NATIVE (gettext)
-NATIVE (catopen)
-NATIVE (catgets)
+NATIVE_EXPLICIT (bindtextdomain, char *, const char *, const char *)
+NATIVE_EXPLICIT (textdomain, char *, const char *)
+NATIVE_EXPLICIT (gettext, char *, const char *)
+NATIVE_EXPLICIT (catopen, void *, const char *, int)
+NATIVE_EXPLICIT (catgets, char *, void *, int, int, const char *)
 
 // PWD.H
-NATIVE (getpwnam)
-DCE (getpwuid)
-DCE (endpwent)
+NATIVE_EXPLICIT (getpwnam, struct passwd *, const char *)
+DCE_EXPLICIT (getpwuid, struct passwd *, uid_t)
+DCE_EXPLICIT (endpwent, void)
 
 // INTTYPES.H
 NATIVE (strtoimax)
 NATIVE (strtoumax)
 
 // NETINET/ETHER.H
-NATIVE (ether_aton_r)
-NATIVE (ether_aton)
+NATIVE_EXPLICIT (ether_aton_r, struct ether_addr *, const char *, struct ether_addr *)
+NATIVE_EXPLICIT (ether_aton, struct ether_addr *, const char *)
 
 // SEARCH.H
-NATIVE (tsearch)
-NATIVE (tfind)
-NATIVE (tdelete)
+NATIVE_EXPLICIT (tsearch, void *, const void *, void **, int (*)(const void *, const void *))
+NATIVE_EXPLICIT (tfind, void *, const void *, void * const *, int (*)(const void *, const void *))
+NATIVE_EXPLICIT (tdelete, void *, const void *, void **, int (*)(const void *, const void *))
 NATIVE (twalk)
-NATIVE (tdestroy)
+NATIVE_EXPLICIT (tdestroy, void, void *, void (*)(void *))
 
 // FNMATCH.H
-NATIVE (fnmatch)
+NATIVE_EXPLICIT (fnmatch, int, const char *, const char *, int)
 
 // LANGINFO.H
-NATIVE (nl_langinfo)
+NATIVE_EXPLICIT (nl_langinfo, char *, int)
 
 // SYS/VFS.H
-DCE (fstatfs)
-DCE (fstatfs64)
-DCE (statfs)
-DCE (statfs64)
+DCE_EXPLICIT (fstatfs, int, int, struct statfs *)
+DCE_EXPLICIT (fstatfs64, int, int, struct statfs *)
+DCE_EXPLICIT (statfs, int, const char *, struct statfs *)
+DCE_EXPLICIT (statfs64, int, const char *, struct statfs *)
 
 // SYS/STATVFS.H
-DCE (statvfs)
-DCE (fstatvfs)
+DCE_EXPLICIT (statvfs, int, const char *, struct statvfs *)
+DCE_EXPLICIT (fstatvfs, int, int, struct statvfs *)
 
 // TERMIO.H
-DCE (tcgetattr)
-DCE (tcsetattr)
+DCE_EXPLICIT (tcgetattr, int, int, struct termios *)
+DCE_EXPLICIT (tcsetattr, int, int, int, const struct termios *)
 
 ///////////////////// END OF INVENTAIRE //////////////////////////////////////////////////
 
 // ctype.h
-NATIVE (__ctype_b_loc)
-NATIVE_WITH_ALIAS (wctype_l)
-NATIVE (__ctype_tolower_loc)
+NATIVE_EXPLICIT (__ctype_b_loc, const unsigned short int **)
+NATIVE_WITH_ALIAS_EXPLICIT (wctype_l, unsigned long int, const char *, struct __locale_struct *)
+NATIVE_EXPLICIT (__ctype_tolower_loc, const __int32_t **)
 
 // stdlib.h
-NATIVE (__ctype_get_mb_cur_max)
+NATIVE_EXPLICIT (__ctype_get_mb_cur_max, size_t)
 
 // stdio.h
-DCE (__fpurge)
-DCE (__fpending)
+DCE_EXPLICIT (__fpurge, void, FILE *)
+DCE_EXPLICIT (__fpending, size_t, FILE *)
 
-DCE (__strcpy_chk)
+DCE_EXPLICIT (__strcpy_chk, char *, char *, const char *, size_t)
 DCE    (__printf_chk)
-DCE    (__vfprintf_chk)
+DCE_EXPLICIT (__vfprintf_chk, int, FILE *, int, const char *, va_list)
 DCE    (__fprintf_chk)
 DCE    (__snprintf_chk)
-DCE    (__errno_location)
-DCE    (__vsnprintf_chk)
-
-DCE    (__xstat)
-DCE    (__lxstat)
-DCE    (__fxstat)
-DCE    (__xstat64)
-DCE    (__lxstat64)
-DCE    (__fxstat64)
-DCE    (__fxstatat)
-NATIVE (__cmsg_nxthdr)
+DCE_EXPLICIT (__errno_location, int *)
+DCE_EXPLICIT (__vsnprintf_chk, int, char *, size_t, int, size_t, const char *, va_list)
+
+DCE_EXPLICIT (__xstat, int, int, const char *, struct stat *)
+DCE_EXPLICIT (__lxstat, int, int, const char *, struct stat *)
+DCE_EXPLICIT (__fxstat, int, int, int, struct stat *)
+DCE_EXPLICIT (__xstat64, int, int, const char *, struct stat64 *)
+DCE_EXPLICIT (__lxstat64, int, int, const char *, struct stat64 *)
+DCE_EXPLICIT (__fxstat64, int, int, int, struct stat64 *)
+DCE_EXPLICIT (__fxstatat, int, int, int, const char *, struct stat *, int)
+NATIVE_EXPLICIT (__cmsg_nxthdr, struct cmsghdr *, struct msghdr *, struct cmsghdr *)
 
 // math.h
-NATIVE (lrintl)
-NATIVE (llrintl)
-NATIVE (ceil)
-NATIVE (floor)
-NATIVE (exp)
-NATIVE (__isnan)
-NATIVE (__isinf)
-NATIVE (__finite)
-NATIVE (log)
-NATIVE (pow)
-NATIVE (modf)
-NATIVE (fmod)
-NATIVE (frexp)
-NATIVE (ldexp)
+NATIVE_EXPLICIT (lrintl, long int, long double)
+NATIVE_EXPLICIT (llrintl, long long int, long double)
+NATIVE_EXPLICIT (ceil, double, double)
+NATIVE_EXPLICIT (floor, double, double)
+NATIVE_EXPLICIT (exp, double, double)
+NATIVE_EXPLICIT (__isnan, int, double)
+NATIVE_EXPLICIT (__isinf, int, double)
+NATIVE_EXPLICIT (__finite, int, double)
+NATIVE_EXPLICIT (log, double, double)
+NATIVE_EXPLICIT (pow, double, double, double)
+NATIVE_EXPLICIT (modf, double, double, double *)
+NATIVE_EXPLICIT (fmod, double, double, double)
+NATIVE_EXPLICIT (frexp, double, double, int *)
+NATIVE_EXPLICIT (ldexp, double, double, int)
 
 // libio.h
-NATIVE (__uflow)
+NATIVE_EXPLICIT (__uflow, int, FILE *)
 
 // libintl.h
-NATIVE (__dcgettext)
+NATIVE_EXPLICIT (__dcgettext, char *, const char *, const char *, int)
 
-NATIVE (dl_iterate_phdr)
+NATIVE_EXPLICIT (dl_iterate_phdr, int, int (*)(struct dl_phdr_info *, size_t, void *), void *)
 #undef DCE
-#undef DCET
 #undef DCE_EXPLICIT
 #undef NATIVE
-#undef NATIVET
+#undef NATIVE_EXPLICIT
 #undef NATIVE_WITH_ALIAS
 #undef NATIVE_WITH_ALIAS2
-#undef NATIVE_EXPLICIT
+#undef NATIVE_WITH_ALIAS_EXPLICIT
+#undef NATIVE_WITH_ALIAS2_EXPLICIT
 #undef DCE_WITH_ALIAS
 #undef DCE_WITH_ALIAS2
+#undef DCE_WITH_ALIAS_EXPLICIT
+#undef DCE_WITH_ALIAS2_EXPLICIT
+#undef DCE_NORETURN
 
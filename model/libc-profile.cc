@@ -0,0 +1,241 @@
+/* -*-	Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "libc-profile.h"
+#include "libc.h"
+#include "process.h"
+#include "utils.h"
+#include "ns3/log.h"
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+NS_LOG_COMPONENT_DEFINE ("LibcProfile");
+
+using namespace ns3;
+
+// Same frame size as the trampolines of libc.cc
+#define GCC_BT_NUM_ARGS 128
+
+// The X-macro list of libc-ns3.h is expanded four times: to number the
+// entries, to name them, to generate one wrapper per entry and to fill
+// the profiled table. All the other macros of libc-ns3.h default to DCE
+// and libc-ns3.h undefines them when done.
+
+namespace {
+
+enum
+{
+#define DCE(name) LIBC_PROFILE_ ## name,
+#include "libc-ns3.h"
+  LIBC_PROFILE_SIZE
+};
+
+const char *g_libcProfileNames[] = {
+#define DCE(name) # name,
+#include "libc-ns3.h"
+};
+
+// the table the wrappers forward to.
+struct Libc g_libcProfileOriginal;
+
+struct LibcProfileCall
+{
+  Thread *thread;
+  uint64_t start;
+  uint64_t blocked;
+};
+
+inline void
+LibcProfileEnter (struct LibcProfileCall *call)
+{
+  call->thread = Current ();
+  call->start = UtilsGetHostTime ();
+  call->blocked = (call->thread != 0) ? call->thread->profileBlocked : 0;
+}
+
+inline void
+LibcProfileLeave (struct LibcProfileCall *call, uint32_t index)
+{
+  Thread *thread = Current ();
+  // the caller may have exited or, after a fork, be another thread.
+  if (thread == 0 || thread != call->thread)
+    {
+      return;
+    }
+  struct SyscallProfile *profile = thread->process->syscallProfile;
+  if (profile == 0)
+    {
+      return;
+    }
+  uint64_t elapsed = UtilsGetHostTime () - call->start - (thread->profileBlocked - call->blocked);
+  profile->counts[index]++;
+  profile->times[index] += elapsed;
+}
+
+#define DCE(name)                                                       \
+  void libc_profile_ ## name (...)                                      \
+  {                                                                     \
+    void *args = __builtin_apply_args ();                               \
+    struct LibcProfileCall call;                                        \
+    LibcProfileEnter (&call);                                           \
+    void *result = __builtin_apply ((void (*) (...)) g_libcProfileOriginal.name ## _fn, \
+                                    args, GCC_BT_NUM_ARGS);             \
+    LibcProfileLeave (&call, LIBC_PROFILE_ ## name);                    \
+    __builtin_return (result);                                          \
+  }
+#include "libc-ns3.h"
+
+} // anonymous namespace
+
+extern "C" {
+
+void libc_profile (const struct Libc *original, struct Libc **profiled)
+{
+  g_libcProfileOriginal = *original;
+  *profiled = new Libc;
+  **profiled = *original;
+
+#define DCE(name) (*profiled)->name ## _fn = (__typeof ((*profiled)->name ## _fn)) & libc_profile_ ## name;
+#include "libc-ns3.h"
+}
+
+} // extern "C"
+
+namespace ns3 {
+
+SyscallProfile::SyscallProfile ()
+  : counts (LIBC_PROFILE_SIZE, 0),
+    times (LIBC_PROFILE_SIZE, 0)
+{
+}
+
+void
+SyscallProfile::Add (const struct SyscallProfile &o)
+{
+  for (uint32_t i = 0; i < LIBC_PROFILE_SIZE; i++)
+    {
+      counts[i] += o.counts[i];
+      times[i] += o.times[i];
+    }
+}
+
+bool
+SyscallProfile::IsEmpty (void) const
+{
+  for (uint32_t i = 0; i < LIBC_PROFILE_SIZE; i++)
+    {
+      if (counts[i] != 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+namespace {
+struct ByTime
+{
+  ByTime (const SyscallProfile *p) : profile (p)
+  {
+  }
+  bool operator () (uint32_t a, uint32_t b) const
+  {
+    if (profile->times[a] != profile->times[b])
+      {
+        return profile->times[a] > profile->times[b];
+      }
+    return profile->counts[a] > profile->counts[b];
+  }
+  const SyscallProfile *profile;
+};
+} // anonymous namespace
+
+void
+SyscallProfile::Report (std::ostream &os, uint32_t topN, std::string prefix) const
+{
+  std::vector<uint32_t> order;
+  uint64_t totalCount = 0;
+  uint64_t totalTime = 0;
+  for (uint32_t i = 0; i < LIBC_PROFILE_SIZE; i++)
+    {
+      if (counts[i] != 0)
+        {
+          order.push_back (i);
+          totalCount += counts[i];
+          totalTime += times[i];
+        }
+    }
+  std::sort (order.begin (), order.end (), ByTime (this));
+  os << prefix << std::left << std::setw (28) << "FUNCTION"
+     << std::right << std::setw (14) << "CALLS"
+     << std::setw (14) << "TIME(ms)"
+     << std::setw (10) << "TIME(%)"
+     << std::setw (12) << "MEAN(us)" << std::endl;
+  for (uint32_t i = 0; i < order.size () && i < topN; i++)
+    {
+      uint32_t j = order[i];
+      os << prefix << std::left << std::setw (28) << GetName (j)
+         << std::right << std::setw (14) << counts[j]
+         << std::fixed << std::setprecision (3)
+         << std::setw (14) << (times[j] / 1000000.0)
+         << std::setprecision (1)
+         << std::setw (10) << ((totalTime != 0) ? (100.0 * times[j] / totalTime) : 0.0)
+         << std::setprecision (3)
+         << std::setw (12) << (times[j] / 1000.0 / counts[j]) << std::endl;
+    }
+  os << prefix << std::left << std::setw (28) << "TOTAL"
+     << std::right << std::setw (14) << totalCount
+     << std::setprecision (3) << std::setw (14) << (totalTime / 1000000.0) << std::endl;
+}
+
+std::string
+SyscallProfile::Summary (uint32_t topN) const
+{
+  std::vector<uint32_t> order;
+  for (uint32_t i = 0; i < LIBC_PROFILE_SIZE; i++)
+    {
+      if (counts[i] != 0)
+        {
+          order.push_back (i);
+        }
+    }
+  std::sort (order.begin (), order.end (), ByTime (this));
+  std::ostringstream oss;
+  oss << "Top calls (count/us):";
+  for (uint32_t i = 0; i < order.size () && i < topN; i++)
+    {
+      uint32_t j = order[i];
+      oss << ' ' << GetName (j) << '=' << counts[j] << '/' << (times[j] / 1000);
+    }
+  return oss.str ();
+}
+
+uint32_t
+SyscallProfile::GetSize (void)
+{
+  return LIBC_PROFILE_SIZE;
+}
+
+const char *
+SyscallProfile::GetName (uint32_t index)
+{
+  return g_libcProfileNames[index];
+}
+
+void
+SyscallProfileSwitchFrom (struct Thread *thread)
+{
+  thread->profileSwitchOut = UtilsGetHostTime ();
+}
+
+void
+SyscallProfileSwitchTo (struct Thread *thread)
+{
+  if (thread->profileSwitchOut != 0)
+    {
+      thread->profileBlocked += UtilsGetHostTime () - thread->profileSwitchOut;
+      thread->profileSwitchOut = 0;
+    }
+}
+
+} // namespace ns3
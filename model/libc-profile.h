@@ -0,0 +1,52 @@
+/* -*-	Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef LIBC_PROFILE_H
+#define LIBC_PROFILE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+struct Libc;
+
+extern "C" {
+/**
+ * Build a copy of the table original in which every entry generated from
+ * libc-ns3.h counts its calls and the host time spent in it before
+ * forwarding to the original entry.
+ */
+void libc_profile (const struct Libc *original, struct Libc **profiled);
+}
+
+namespace ns3 {
+
+struct Thread;
+
+/**
+ * Per-process or per-node call counts and host time of the functions
+ * of libc-ns3.h. The time excludes the time spent switched out in
+ * blocking calls.
+ */
+struct SyscallProfile
+{
+  SyscallProfile ();
+  void Add (const struct SyscallProfile &o);
+  bool IsEmpty (void) const;
+  // top entries by host time, one line per entry prefixed by prefix.
+  void Report (std::ostream &os, uint32_t topN, std::string prefix) const;
+  std::string Summary (uint32_t topN) const;
+
+  static uint32_t GetSize (void);
+  static const char * GetName (uint32_t index);
+
+  std::vector<uint64_t> counts;
+  std::vector<uint64_t> times;
+};
+
+// called on fiber switches of the threads of profiled processes.
+void SyscallProfileSwitchFrom (struct Thread *thread);
+void SyscallProfileSwitchTo (struct Thread *thread);
+
+} // namespace ns3
+
+#endif /* LIBC_PROFILE_H */
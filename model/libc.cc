@@ -15,9 +15,11 @@ extern "C" {
 // \see http://tigcc.ticalc.org/doc/gnuexts.html#SEC67___builtin_apply_args
 // FIXME: 120925: 128 was heuristically picked to pass the test under 32bits environment.
 #define NATIVE DCE
-#define NATIVET DCET
 #define NATIVE_WITH_ALIAS DCE_WITH_ALIAS
 #define NATIVE_WITH_ALIAS2 DCE_WITH_ALIAS2
+#define NATIVE_EXPLICIT DCE_EXPLICIT
+#define NATIVE_WITH_ALIAS_EXPLICIT DCE_WITH_ALIAS_EXPLICIT
+#define NATIVE_WITH_ALIAS2_EXPLICIT DCE_WITH_ALIAS2_EXPLICIT
 
 #define GCC_BT_NUM_ARGS 128
 
@@ -28,20 +30,10 @@ extern "C" {
     __builtin_return (result); \
   }
 
-#define GCC_BUILTIN_APPLYT(rtype, export_symbol, func_to_call) \
-  rtype export_symbol (...) { \
-    void *args =  __builtin_apply_args (); \
-    void *result = __builtin_apply ((void (*) (...)) g_libc.func_to_call ## _fn, args, GCC_BT_NUM_ARGS); \
-    __builtin_return (result); \
-  }
-
 
 #define DCE(name)                                                               \
   GCC_BUILTIN_APPLY (name,name)
 
-#define DCET(rtype,name)                                                               \
-  GCC_BUILTIN_APPLYT (rtype,name,name)
-
 /* From gcc/testsuite/gcc.dg/cpp/vararg2.c */
 /* C99 __VA_ARGS__ versions */
 #define c99_count(...)    _c99_count1 (, ## __VA_ARGS__) /* If only ## worked.*/
@@ -49,11 +41,14 @@ extern "C" {
 #define _c99_count2(_,x0,x1,x2,x3,x4,x5,x6,x7,x8,x9,n,...) n
 
 #define FULL_ARGS_0()
-#define FULL_ARGS_1(X0)  X0 a0
-#define FULL_ARGS_2(X0,X1)  X0 a0, X1 a1
-#define FULL_ARGS_3(X0,X1,X2)  X0 a0, X1 a1, X2 a2
-#define FULL_ARGS_4(X0,X1,X2,X3)  X0 a0, X1 a1, X2 a2, X3 a3
-#define FULL_ARGS_5(X0,X1,X2,X3,X4)  X0 a0, X1 a1, X2 a2, X3 a3, X4 a4
+// __typeof allows function pointer types in the prototypes.
+#define FULL_ARGS_1(X0)  __typeof (X0) a0
+#define FULL_ARGS_2(X0,X1)  FULL_ARGS_1 (X0), __typeof (X1) a1
+#define FULL_ARGS_3(X0,X1,X2)  FULL_ARGS_2 (X0,X1), __typeof (X2) a2
+#define FULL_ARGS_4(X0,X1,X2,X3)  FULL_ARGS_3 (X0,X1,X2), __typeof (X3) a3
+#define FULL_ARGS_5(X0,X1,X2,X3,X4)  FULL_ARGS_4 (X0,X1,X2,X3), __typeof (X4) a4
+#define FULL_ARGS_6(X0,X1,X2,X3,X4,X5)  FULL_ARGS_5 (X0,X1,X2,X3,X4), __typeof (X5) a5
+#define FULL_ARGS_7(X0,X1,X2,X3,X4,X5,X6)  FULL_ARGS_6 (X0,X1,X2,X3,X4,X5), __typeof (X6) a6
 
 #define _ARGS_0()
 #define _ARGS_1(X0)  a0
@@ -61,6 +56,8 @@ extern "C" {
 #define _ARGS_3(X0,X1,X2)  a0, a1, a2
 #define _ARGS_4(X0,X1,X2,X3)  a0, a1, a2, a3
 #define _ARGS_5(X0,X1,X2,X3,X4) a0, a1, a2, a3, a4
+#define _ARGS_6(X0,X1,X2,X3,X4,X5) a0, a1, a2, a3, a4, a5
+#define _ARGS_7(X0,X1,X2,X3,X4,X5,X6) a0, a1, a2, a3, a4, a5, a6
 
 #define CAT(a, ...) PRIMITIVE_CAT (a, __VA_ARGS__)
 #define PRIMITIVE_CAT(a, ...) a ## __VA_ARGS__
@@ -69,10 +66,23 @@ extern "C" {
 #define  ARGS(...) CAT (_ARGS_,c99_count (__VA_ARGS__)) (__VA_ARGS__)
 
 
+// Typed stubs: no copy of the argument frame and the call to the
+// table entry can be a tail call.
+#define DCE_TYPED_STUB(export_symbol,func_to_call,rtype,...)            \
+  __typeof (rtype) export_symbol (FULL_ARGS (__VA_ARGS__))              \
+  {                                                                     \
+    return g_libc.func_to_call ## _fn (ARGS (__VA_ARGS__));             \
+  }
+
 #define DCE_EXPLICIT(name,rtype,...)                                    \
-  rtype name (FULL_ARGS (__VA_ARGS__))    \
-  {                                                             \
-    return g_libc.name ## _fn (ARGS (__VA_ARGS__));              \
+  DCE_TYPED_STUB (name,name,rtype, ## __VA_ARGS__)
+
+// the table entry does not return either.
+#define DCE_NORETURN(name,...)                                          \
+  void name (FULL_ARGS (__VA_ARGS__))                                   \
+  {                                                                     \
+    g_libc.name ## _fn (ARGS (__VA_ARGS__));                            \
+    __builtin_unreachable ();                                           \
   }
 
 #define DCE_WITH_ALIAS(name)                                    \
@@ -83,6 +93,14 @@ extern "C" {
   GCC_BUILTIN_APPLY (internal,name)                        \
   weak_alias (internal, name);
 
+#define DCE_WITH_ALIAS_EXPLICIT(name,rtype,...)                         \
+  DCE_TYPED_STUB (__ ## name,name,rtype, ## __VA_ARGS__)                \
+  weak_alias (__ ## name, name);
+
+#define DCE_WITH_ALIAS2_EXPLICIT(name,internal,rtype,...)               \
+  DCE_TYPED_STUB (internal,name,rtype, ## __VA_ARGS__)                  \
+  weak_alias (internal, name);
+
 
 // Note: it looks like that the stdio.h header does
 // not define putc and getc as macros if you include
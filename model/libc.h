@@ -5,16 +5,15 @@
 #define _SYS_SELECT_H
 #include <sys/types.h>
 #undef _SYS_SELECT_H
+// as stdio.h declares it, for the prototypes of libc-ns3.h.
+typedef struct _IO_FILE FILE;
 
 struct Libc
 {
 
 #define DCE(name) void (*name ## _fn) (...);
 
-#define DCET(rtype, name) DCE (name)
-#define NATIVET(rtype, name) NATIVE (name)
-
-#define DCE_EXPLICIT(name,rtype,...) rtype (*name ## _fn) (__VA_ARGS__);
+#define DCE_EXPLICIT(name,rtype,...) __typeof (rtype) (*name ## _fn) (__VA_ARGS__);
 #include "libc-ns3.h"
 
   char* (*strpbrk_fn)(const char *s, const char *accept);
@@ -8,6 +8,10 @@
 #include "ns3/simulator.h"
 #include "ns3/event-id.h"
 #include "ns3/node.h"
+#include <string.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 
 
 NS_LOG_COMPONENT_DEFINE ("LinuxSocketFdFactory");
@@ -61,34 +65,59 @@ LinuxSocketFdFactory::NotifyNewAggregate (void)
     }
 }
 
+struct SimSysFile *
+LinuxSocketFdFactory::LookupSysFile (std::string path)
+{
+  std::map<std::string,struct SimSysFile *>::const_iterator i = m_sysFiles.find (path);
+  if (i == m_sysFiles.end ())
+    {
+      // devices add their entries to the tree after the first lookups.
+      IndexSysFiles ();
+      i = m_sysFiles.find (path);
+      if (i == m_sysFiles.end ())
+        {
+          NS_LOG_WARN ("no sysctl " << path);
+          return 0;
+        }
+    }
+  return i->second;
+}
+
 void
-LinuxSocketFdFactory::SetTask (std::string path, std::string value)
+LinuxSocketFdFactory::SetTask (std::vector<std::pair<std::string,std::string> > values)
 {
-  NS_LOG_FUNCTION (path << value);
-  std::vector<std::pair<std::string,struct SimSysFile *> > files = GetSysFileList ();
-  for (uint32_t i = 0; i < files.size (); i++)
+  NS_LOG_FUNCTION (this << values.size ());
+  for (uint32_t i = 0; i < values.size (); i++)
     {
-      if (files[i].first == path)
+      NS_LOG_FUNCTION (values[i].first << values[i].second);
+      struct SimSysFile *file = LookupSysFile (values[i].first);
+      if (file != 0)
         {
-          const char *s = value.c_str ();
-          int toWrite = value.size ();
-          int written;
-          written = m_exported->sys_file_write (files[i].second, s, toWrite, 0);
-          break;
+          const char *s = values[i].second.c_str ();
+          int toWrite = values[i].second.size ();
+          m_loader->NotifyStartExecute ();
+          m_exported->sys_file_write (file, s, toWrite, 0);
+          m_loader->NotifyEndExecute ();
         }
     }
 }
 
 void
 LinuxSocketFdFactory::Set (std::string path, std::string value)
+{
+  SetAll (std::vector<std::pair<std::string,std::string> > (1, std::make_pair (path, value)));
+}
+
+void
+LinuxSocketFdFactory::SetAll (const std::vector<std::pair<std::string,std::string> > &values)
 {
   if (m_manager == 0)
     {
-      m_earlySysfs.push_back (std::make_pair (path,value));
+      m_earlySysfs.insert (m_earlySysfs.end (), values.begin (), values.end ());
     }
   else
     {
-      KernelSocketFdFactory::ScheduleTask (MakeEvent (&LinuxSocketFdFactory::SetTask, this, path, value));
+      KernelSocketFdFactory::ScheduleTask (MakeEvent (&LinuxSocketFdFactory::SetTask, this, values));
     }
 }
 
@@ -97,24 +126,129 @@ LinuxSocketFdFactory::Get (std::string path)
 {
   NS_LOG_FUNCTION (path);
   std::string ret;
-  std::vector<std::pair<std::string,struct SimSysFile *> > files = GetSysFileList ();
-  for (uint32_t i = 0; i < files.size (); i++)
+  struct SimSysFile *file = LookupSysFile (path);
+  if (file != 0)
+    {
+      char buffer[512];
+      memset (buffer, 0, sizeof(buffer));
+      m_loader->NotifyStartExecute ();
+      m_exported->sys_file_read (file, buffer, sizeof(buffer), 0);
+      m_loader->NotifyEndExecute ();
+      NS_LOG_FUNCTION ("sysctl read: " << buffer);
+      ret = std::string (buffer);
+    }
+  return ret;
+}
+
+void
+LinuxSocketFdFactory::AddRoutes (const std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_LOG_FUNCTION (this << routes.size ());
+  // well below the default netlink socket buffer, sendmsg fails above.
+  const size_t batchSize = 16384;
+  const size_t routeSize = NLMSG_SPACE (sizeof (struct rtmsg)) + 2 * RTA_SPACE (4);
+
+  struct SimSocket *socket;
+  m_loader->NotifyStartExecute ();
+  int retval = m_exported->sock_socket (AF_NETLINK, SOCK_RAW, NETLINK_ROUTE, &socket);
+  m_loader->NotifyEndExecute ();
+  if (retval < 0)
+    {
+      NS_LOG_WARN ("no netlink socket in the kernel: " << -retval);
+      return;
+    }
+
+  std::vector<char> buffer;
+  buffer.reserve (batchSize);
+  for (uint32_t i = 0; i < routes.size (); i++)
     {
-      if (files[i].first == path)
+      if (buffer.size () + routeSize > batchSize)
+        {
+          SendRoutes (socket, buffer);
+        }
+      size_t offset = buffer.size ();
+      buffer.resize (offset + routeSize, 0);
+      struct nlmsghdr *nlh = (struct nlmsghdr *)&buffer[offset];
+      nlh->nlmsg_len = routeSize;
+      nlh->nlmsg_type = RTM_NEWROUTE;
+      // no NLM_F_ACK: only the routes the kernel refuses are answered.
+      nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_CREATE | NLM_F_EXCL;
+      nlh->nlmsg_seq = i;
+      struct rtmsg *rtm = (struct rtmsg *)NLMSG_DATA (nlh);
+      rtm->rtm_family = AF_INET;
+      rtm->rtm_dst_len = routes[i].GetDestNetworkMask ().GetPrefixLength ();
+      rtm->rtm_table = RT_TABLE_MAIN;
+      rtm->rtm_protocol = RTPROT_BOOT;
+      rtm->rtm_scope = RT_SCOPE_UNIVERSE;
+      rtm->rtm_type = RTN_UNICAST;
+      struct rtattr *rta = (struct rtattr *)((char *)rtm + NLMSG_ALIGN (sizeof (struct rtmsg)));
+      rta->rta_type = RTA_DST;
+      rta->rta_len = RTA_LENGTH (4);
+      routes[i].GetDest ().Serialize ((uint8_t *)RTA_DATA (rta));
+      rta = (struct rtattr *)((char *)rta + RTA_SPACE (4));
+      rta->rta_type = RTA_GATEWAY;
+      rta->rta_len = RTA_LENGTH (4);
+      routes[i].GetGateway ().Serialize ((uint8_t *)RTA_DATA (rta));
+    }
+  SendRoutes (socket, buffer);
+
+  m_loader->NotifyStartExecute ();
+  m_exported->sock_close (socket);
+  m_loader->NotifyEndExecute ();
+}
+
+void
+LinuxSocketFdFactory::SendRoutes (struct SimSocket *socket, std::vector<char> &buffer)
+{
+  if (buffer.empty ())
+    {
+      return;
+    }
+  struct iovec iov;
+  struct msghdr msg;
+  memset (&msg, 0, sizeof (msg));
+  iov.iov_base = &buffer[0];
+  iov.iov_len = buffer.size ();
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  m_loader->NotifyStartExecute ();
+  ssize_t retval = m_exported->sock_sendmsg (socket, &msg, 0);
+  m_loader->NotifyEndExecute ();
+  if (retval < 0)
+    {
+      NS_LOG_WARN ("routes not sent: " << -retval);
+    }
+  buffer.clear ();
+
+  // the kernel handles the messages in sendmsg, the errors are already
+  // queued.
+  char reply[4096];
+  while (true)
+    {
+      iov.iov_base = reply;
+      iov.iov_len = sizeof (reply);
+      m_loader->NotifyStartExecute ();
+      retval = m_exported->sock_recvmsg (socket, &msg, MSG_DONTWAIT);
+      m_loader->NotifyEndExecute ();
+      if (retval <= 0)
         {
-          char buffer[512];
-          memset (buffer, 0, sizeof(buffer));
-          m_exported->sys_file_read (files[i].second, buffer, sizeof(buffer), 0);
-          NS_LOG_FUNCTION ("sysctl read: " << buffer);
-          ret = std::string (buffer);
           break;
         }
+      int len = retval;
+      for (struct nlmsghdr *nlh = (struct nlmsghdr *)reply; NLMSG_OK (nlh, len);
+           nlh = NLMSG_NEXT (nlh, len))
+        {
+          if (nlh->nlmsg_type == NLMSG_ERROR)
+            {
+              struct nlmsgerr *err = (struct nlmsgerr *)NLMSG_DATA (nlh);
+              NS_LOG_WARN ("route " << nlh->nlmsg_seq << " refused: " << -err->error);
+            }
+        }
     }
-  return ret;
 }
 
-std::vector<std::pair<std::string,struct SimSysFile *> >
-LinuxSocketFdFactory::GetSysFileList (void)
+void
+LinuxSocketFdFactory::IndexSysFiles (void)
 {
   struct MyIterator
   {
@@ -135,35 +269,34 @@ LinuxSocketFdFactory::GetSysFileList (void)
     {
       struct MyIterator *self = (struct MyIterator *)iter;
       std::string path = self->m_currentPath + "." + filename;
-      self->m_list.push_back (std::make_pair (path, file));
+      (*self->m_files)[path] = file;
     }
     std::vector<std::string> m_stack;
-    std::vector<std::pair<std::string,struct SimSysFile *> > m_list;
+    std::map<std::string,struct SimSysFile *> *m_files;
     std::string m_currentPath;
   } iter;
+  NS_LOG_FUNCTION (this);
   iter.head.report_start_dir = &MyIterator::ReportStartDir;
   iter.head.report_end_dir = &MyIterator::ReportEndDir;
   iter.head.report_file = &MyIterator::ReportFile;
+  iter.m_files = &m_sysFiles;
+  m_sysFiles.clear ();
   m_loader->NotifyStartExecute ();
   m_exported->sys_iterate_files ((struct SimSysIterator *)&iter);
   m_loader->NotifyEndExecute ();
-  return iter.m_list;
 }
 
 void
 LinuxSocketFdFactory::InitializeStack (void)
 {
   KernelSocketFdFactory::InitializeStack ();
-  Set (".net.ipv4.conf.all.forwarding", "1");
-  Set (".net.ipv4.conf.all.log_martians", "1");
-  Set (".net.ipv6.conf.all.forwarding", "0");
-
-  while (!m_earlySysfs.empty ())
-    {
-      std::pair<std::string,std::string> op = m_earlySysfs.front ();
-      Set (op.first, op.second);
-      m_earlySysfs.pop_front ();
-    }
+  std::vector<std::pair<std::string,std::string> > values;
+  values.push_back (std::make_pair (".net.ipv4.conf.all.forwarding", "1"));
+  values.push_back (std::make_pair (".net.ipv4.conf.all.log_martians", "1"));
+  values.push_back (std::make_pair (".net.ipv6.conf.all.forwarding", "0"));
+  values.insert (values.end (), m_earlySysfs.begin (), m_earlySysfs.end ());
+  m_earlySysfs.clear ();
+  SetAll (values);
 }
 
 } // namespace ns3
@@ -2,7 +2,9 @@
 #define LINUX_SOCKET_FD_FACTORY_H
 
 #include "kernel-socket-fd-factory.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include <vector>
+#include <map>
 
 extern "C" {
 struct SimExported;
@@ -23,15 +25,28 @@ public:
   virtual ~LinuxSocketFdFactory ();
 
   void Set (std::string path, std::string value);
+  // all the values in one kernel task.
+  void SetAll (const std::vector<std::pair<std::string,std::string> > &values);
   std::string Get (std::string path);
+  /**
+   * Add the routes to the main table of the kernel with RTM_NEWROUTE
+   * messages, batched in as few sendmsg on one netlink socket as the
+   * socket buffer allows. Must run in a kernel task (see ScheduleTask).
+   */
+  void AddRoutes (const std::vector<Ipv4RoutingTableEntry> &routes);
 
 private:
   virtual void NotifyNewAggregate (void);
   void InitializeStack (void);
-  std::vector<std::pair<std::string,struct SimSysFile *> > GetSysFileList (void);
-  void SetTask (std::string path, std::string value);
+  void IndexSysFiles (void);
+  struct SimSysFile * LookupSysFile (std::string path);
+  void SetTask (std::vector<std::pair<std::string,std::string> > values);
+  void SendRoutes (struct SimSocket *socket, std::vector<char> &buffer);
 
   std::list<std::pair<std::string,std::string> > m_earlySysfs;
+  // the sysctl tree of the kernel, by path. Filled by one walk of the
+  // tree, then read once per value set or got: a few thousand entries.
+  std::map<std::string,struct SimSysFile *> m_sysFiles;
 };
 
 } // namespace ns3
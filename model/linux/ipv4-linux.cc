@@ -561,13 +561,15 @@ Ipv4Linux::PopulateRoutingTable ()
   Ptr<Ipv4GlobalRouting> globalRouting = DynamicCast<Ipv4GlobalRouting> (GetRoutingProtocol ());
   NS_ASSERT_MSG (globalRouting, "No global routing");
 
+  // the whole table at once, a process per route takes hours on large
+  // topologies.
+  std::vector<Ipv4RoutingTableEntry> routes;
+  routes.reserve (globalRouting->GetNRoutes ());
   for (uint32_t i = 0; i < globalRouting->GetNRoutes (); i++)
     {
-      Ipv4RoutingTableEntry route = globalRouting->GetRoute (i);
-      std::ostringstream oss;
-      oss << "route add to " << route.GetDest () << '/' << route.GetDestNetworkMask () << " via " << route.GetGateway ();
-      LinuxStackHelper::RunIp (node, NanoSeconds (++m_nanoSec), oss.str ());
+      routes.push_back (globalRouting->GetRoute (i));
     }
+  LinuxStackHelper::AddRoutes (node, NanoSeconds (++m_nanoSec), routes);
 
   std::ostringstream oss;
   oss.str ("");
@@ -30,6 +30,7 @@
 #include "process.h"
 #include "utils.h"
 #include "file-usage.h"
+#include "wait-queue.h"
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <poll.h>
@@ -143,7 +144,7 @@ LinuxSocketImpl::LinuxSocketImpl ()
   NS_LOG_FUNCTION_NOARGS ();
   m_listening = false;
   m_conn_inprogress = false;
-  m_pid = -1;
+  m_pollTable = 0;
   SetNs3ToPosixConverter (MakeCallback (&LinuxSocketImpl::Ns3AddressToPosixAddress, this));
   SetPosixToNs3Converter (MakeCallback (&LinuxSocketImpl::PosixAddressToNs3Address, this));
 }
@@ -154,37 +155,20 @@ LinuxSocketImpl::~LinuxSocketImpl ()
     {
       m_poll.Cancel ();
     }
-  Ptr<Node> node = GetNode ();
-  Ptr<DceManager> manager = node->GetObject<DceManager> ();
-}
-
-void
-LinuxSocketImpl::ScheduleTaskTrampoline (void *context)
-{
-  Task *current = TaskManager::Current ()->CurrentTask ();
-  LinuxSocketImpl *self = (LinuxSocketImpl *) current->GetExtraContext ();
-  current->SetExtraContext (0);
-  EventImpl *event = (EventImpl *)context;
-  event->Invoke ();
-  event->Unref ();
-  TaskManager::Current ()->Exit ();
-}
-
-void
-LinuxSocketImpl::ScheduleTask (EventImpl *event)
-{
-  Ptr<Node> node = GetNode ();
-  Ptr<DceManager> manager = node->GetObject<DceManager> ();
-  Ptr<TaskManager> taskManager = this->GetObject<TaskManager> ();
-  std::vector<std::string> nullargs;
-  std::vector<std::pair<std::string,std::string> > envs;
-  struct Process *process = manager->CreateProcess ("dummy-task", "dummy-stdin", nullargs, envs, 0);
-  struct Thread *thread = manager->CreateThread (process);
-  Task *task = TaskManager::Current ()->Start (&LinuxSocketImpl::ScheduleTaskTrampoline,
-                                               event, 1 << 17);
-  task->SetContext (thread);
-  thread->task = task;
-  task->SetExtraContext (this);
+  if (m_pollTable == 0)
+    {
+      return;
+    }
+  // The socket was not closed and the kernel may still wake up the
+  // table: silent first, then out of the wait queue if the kernel of the
+  // node is still there.
+  m_pollTable->SetWakeUpCallback (MakeNullCallback<void> ());
+  if (m_node != 0 && m_node->GetObject<DceManager> () != 0 && TaskManager::Current () != 0)
+    {
+      uint16_t pid = EnterFakeTask ();
+      StopPoll ();
+      LeaveFakeTask (pid);
+    }
 }
 
 enum Socket::SocketErrno
@@ -223,27 +207,21 @@ LinuxSocketImpl::GetSocketType (void) const
 uint16_t
 LinuxSocketImpl::EnterFakeTask ()
 {
-  NS_LOG_FUNCTION (this << m_pid);
   Ptr<Node> node = GetNode ();
   Ptr<DceManager> manager = node->GetObject<DceManager> ();
-  if (m_pid == 65535)
-    {
-      m_pid = manager->StartTemporaryTask ();
-    }
-  else
-    {
-      manager->ResumeTemporaryTask (m_pid);
-    }
-  return m_pid;
+  struct Process *process = manager->GetSocketProcess ();
+  NS_LOG_FUNCTION (this << process->pid);
+  TaskManager::Current ()->EnterHiTask (process->threads.front ()->task);
+  return process->pid;
 }
 
 void
 LinuxSocketImpl::LeaveFakeTask (uint16_t pid)
 {
-  NS_LOG_FUNCTION (this << m_pid << pid);
+  NS_LOG_FUNCTION (this << pid);
   Ptr<Node> node = GetNode ();
   Ptr<DceManager> manager = node->GetObject<DceManager> ();
-  manager->SuspendTemporaryTask (pid);
+  TaskManager::Current ()->LeaveHiTask (manager->GetSocketProcess ()->threads.front ()->task);
   return;
 }
 
@@ -300,7 +278,12 @@ int
 LinuxSocketImpl::Close (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  if (m_poll.IsRunning ())
+    {
+      m_poll.Cancel ();
+    }
   uint16_t pid = EnterFakeTask ();
+  StopPoll ();
   int ret = this->m_kernsock->Close ();
   LeaveFakeTask (pid);
   return ret;
@@ -539,115 +522,144 @@ LinuxSocketImpl::Getsockopt (int level, int optname,
   return ret;
 }
 
+void
+LinuxSocketImpl::StartPoll (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_pollTable = new PollTable ();
+  m_pollTable->SetEventMask (POLLIN | POLLOUT | POLLERR | POLLHUP | POLLRDHUP);
+  m_pollTable->SetWakeUpCallback (MakeCallback (&LinuxSocketImpl::PollWakeUp, this));
+  uint16_t pid = EnterFakeTask ();
+  this->m_kernsock->Poll (m_pollTable);
+  LeaveFakeTask (pid);
+  // what is already ready, once the callbacks are set.
+  PollWakeUp ();
+}
+
+void
+LinuxSocketImpl::StopPoll (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_pollTable != 0)
+    {
+      m_pollTable->FreeWait ();
+      delete m_pollTable;
+      m_pollTable = 0;
+    }
+}
+
+void
+LinuxSocketImpl::PollWakeUp (void)
+{
+  // The kernel is running: the callbacks, which may call the kernel
+  // again, are notified afterwards, once for all the wakeups until then.
+  if (!m_poll.IsRunning ())
+    {
+      m_poll = Simulator::ScheduleNow (&LinuxSocketImpl::Poll, this);
+    }
+}
+
 void
 LinuxSocketImpl::Poll ()
 {
   NS_LOG_FUNCTION (this);
-  PollTable *table = new PollTable ();
-  table->SetEventMask (POLLIN | POLLOUT | POLLERR | POLLHUP | POLLRDHUP);
-  PollTable *pwait = table;
+  uint16_t pid = EnterFakeTask ();
+  int mask = this->m_kernsock->Poll (0);
+  LeaveFakeTask (pid);
+  if (mask < 0)
+    {
+      NS_LOG_INFO ("poll returns " << mask);
+      return;
+    }
 
-  // Infinite loop
-  while (true)
+  mask &= (POLLIN | POLLOUT | POLLERR | POLLHUP | POLLRDHUP);
+  if (!mask)
     {
-      uint16_t pid = EnterFakeTask ();
-      int mask = this->m_kernsock->Poll (pwait);
-      if (mask < 0)
+      return;
+    }
+  if (m_listening)
+    {
+      while (true)
         {
-          NS_LOG_INFO ("poll returns " << mask << " errno " << Current ()->err);
-          continue;
-        }
-      LeaveFakeTask (pid);
+          struct sockaddr_storage my_addr;
+          socklen_t addrlen = sizeof (struct sockaddr_storage);
 
-      // Notify the data
-      mask &= (POLLIN | POLLOUT | POLLERR | POLLHUP | POLLRDHUP);
-      if (mask)
-        {
-          Ptr<LinuxSocketFdFactory> factory = 0;
-          Ptr<Node> node = GetNode ();
-          Ptr<DceManager> manager = node->GetObject<DceManager> ();
-          factory = manager->GetObject<LinuxSocketFdFactory> ();
-          if (m_listening)
+          pid = EnterFakeTask ();
+          int sock = this->m_kernsock->Accept ((struct sockaddr *)&my_addr, &addrlen);
+          if (sock < 0)
             {
-              struct sockaddr_storage my_addr;
-              socklen_t addrlen = sizeof (struct sockaddr_storage);
-              Address fromAddress;
-
-              NS_LOG_INFO ("notify accept");
-              Ptr<LinuxSocketImpl> newSock = CreateObject<LinuxSocketImpl> ();
-              newSock->SetNode (m_node);
-              newSock->m_family = m_family;
-              newSock->m_socktype = m_socktype;
-              newSock->m_protocol = m_protocol;
-
-              pid = EnterFakeTask ();
-              int sock = this->m_kernsock->Accept ((struct sockaddr *)&my_addr, &addrlen);
-              if (sock < 0)
-                {
-                  NS_LOG_INFO ("accept error");
-                }
-              KernelSocketFd *kern_sock;
-              FileUsage *fu = Current ()->process->openFiles[sock];
-              kern_sock = (KernelSocketFd *)fu->GetFileInc ();
-              kern_sock->IncFdCount ();
-              kern_sock->Fcntl (F_SETFL, O_NONBLOCK);
-
-              newSock->m_kernsock = kern_sock;
-              newSock->m_listening = false;
-              fromAddress = m_posixtons3 ((struct sockaddr *)&my_addr, addrlen);
+              NS_LOG_INFO ("accept returns " << sock << " errno " << Current ()->err);
               LeaveFakeTask (pid);
-              NotifyNewConnectionCreated (newSock, fromAddress);
-              Simulator::ScheduleWithContext (m_node->GetId (), Seconds (0.0),
-                                              &LinuxSocketImpl::ScheduleTask, newSock,
-                                              MakeEvent (&LinuxSocketImpl::Poll, newSock));
-            }
-          else if (m_conn_inprogress)
-            {
-              NS_LOG_INFO ("notify conn inprogress finish");
-              NotifyConnectionSucceeded ();
-              m_conn_inprogress = false;
-
-              NS_LOG_FUNCTION ("CALL>> Wait mask (after conn) " << mask);
-              table->Wait (Seconds (0));
-              NS_LOG_FUNCTION ("RTRN<< Wait mask  (after conn) " << mask);
-            }
-          else
-            {
-              // FIXME: handle closed socket
-              if (mask & POLLRDHUP || mask & POLLHUP || mask & POLLERR)
-                {
-                  NS_LOG_FUNCTION ("socket has closed ?" << mask);
-                  // FIXME: may need m_closed flag
-                  // Close ();
-                  // XXX:::...
-                  Current ()->process->manager->Wait ();
-                }
-
-              else if (mask & POLLIN || mask & POLLERR)
-                {
-                  NS_LOG_INFO ("notify recv");
-                  NotifyDataRecv ();
-                }
-              else if (mask & POLLOUT)
-                {
-                  Simulator::ScheduleWithContext (m_node->GetId (), Seconds (0.0),
-                                                  MakeEvent (&LinuxSocketImpl::NotifySend, this, 0));
-                  NS_LOG_INFO ("wait send for next poll event");
-                  table->Wait (Seconds (0));
-                  NS_LOG_INFO ("awaken");
-                }
+              break;
             }
+          NS_LOG_INFO ("notify accept");
+          Ptr<LinuxSocketImpl> newSock = CreateObject<LinuxSocketImpl> ();
+          newSock->SetNode (m_node);
+          newSock->m_family = m_family;
+          newSock->m_socktype = m_socktype;
+          newSock->m_protocol = m_protocol;
+
+          // the new socket owns the kernel socket, as one from
+          // CreateSocket: its fd is released at once, else the fds of
+          // all the connections accepted on the node would add up in the
+          // table of the socket process, up to MAX_FDS.
+          KernelSocketFd *kern_sock;
+          FileUsage *fu = Current ()->process->openFiles[sock];
+          kern_sock = (KernelSocketFd *)fu->GetFile ();
+          kern_sock->Ref ();
+          Current ()->process->openFiles.erase (sock);
+          delete fu;
+          kern_sock->Fcntl (F_SETFL, O_NONBLOCK);
+
+          newSock->m_kernsock = kern_sock;
+          newSock->m_listening = false;
+          Address fromAddress = m_posixtons3 ((struct sockaddr *)&my_addr, addrlen);
+          LeaveFakeTask (pid);
+          NotifyNewConnectionCreated (newSock, fromAddress);
+          newSock->StartPoll ();
+        }
+      return;
+    }
+  if (m_conn_inprogress)
+    {
+      if (mask & POLLOUT)
+        {
+          NS_LOG_INFO ("notify conn inprogress finish");
+          m_conn_inprogress = false;
+          NotifyConnectionSucceeded ();
+        }
+      else if (mask & (POLLERR | POLLHUP))
+        {
+          NS_LOG_INFO ("notify conn inprogress failure");
+          m_conn_inprogress = false;
+          NotifyConnectionFailed ();
+          return;
         }
-      // if not masked
       else
         {
-          NS_LOG_INFO ("wait for next poll event");
-          table->Wait (Seconds (0));
-          NS_LOG_INFO ("awaken");
+          return;
         }
-
-      // next loop
-      pwait = NULL;
+    }
+  // the data which came with the hangup is read first.
+  if (mask & POLLIN)
+    {
+      NS_LOG_INFO ("notify recv");
+      NotifyDataRecv ();
+    }
+  if (mask & POLLRDHUP || mask & POLLHUP || mask & POLLERR)
+    {
+      NS_LOG_FUNCTION ("socket has closed ?" << mask);
+      // no more notifications, as when each socket had its own poll
+      // loop; the callback may have closed the socket already.
+      pid = EnterFakeTask ();
+      StopPoll ();
+      LeaveFakeTask (pid);
+      return;
+    }
+  if (!(mask & POLLIN) && (mask & POLLOUT))
+    {
+      NS_LOG_INFO ("notify send");
+      NotifySend (GetTxAvailable ());
     }
 }
 
@@ -700,10 +712,8 @@ LinuxSocketImpl::CreateSocket ()
   kern_sock->Fcntl (F_SETFL, O_NONBLOCK);
   this->m_kernsock = kern_sock;
 
-  // Poll to register recv callback
-  Simulator::ScheduleWithContext (m_node->GetId (), Seconds (0.0),
-                                  &LinuxSocketImpl::ScheduleTask, this,
-                                  MakeEvent (&LinuxSocketImpl::Poll, this));
+  // to notify the callbacks
+  StartPoll ();
   return;
 }
 
@@ -29,6 +29,7 @@ namespace ns3 {
 class Node;
 class Packet;
 class Task;
+class PollTable;
 class KernelSocketFd;
 
 class LinuxSocketImpl : public Socket
@@ -67,6 +68,7 @@ public:
   virtual void BindToNetDevice (Ptr<NetDevice> netdevice);
   virtual bool SetAllowBroadcast (bool allowBroadcast);
   virtual bool GetAllowBroadcast () const;
+  // Notify the readiness of the kernel socket to the callbacks.
   void Poll ();
 
   void Setsockopt (int level, int optname,
@@ -105,8 +107,12 @@ private:
   virtual bool GetMtuDiscover (void) const;
   uint16_t EnterFakeTask ();
   void LeaveFakeTask (uint16_t pid);
-  void ScheduleTask (EventImpl *event);
-  static void ScheduleTaskTrampoline (void *context);
+  // Register in the wait queue of the kernel socket.
+  void StartPoll (void);
+  // Remove the socket from the wait queue, in a task.
+  void StopPoll (void);
+  // Called by the kernel, from the wait queue, on an event of the socket.
+  void PollWakeUp (void);
 
   enum SocketErrno m_errno;
   Ptr<Node> m_node;
@@ -115,8 +121,9 @@ private:
   uint16_t m_protocol;
   bool m_listening;
   bool m_conn_inprogress;
-  uint16_t m_pid;
+  // the Poll scheduled by a wakeup of m_pollTable, one at most.
   EventId m_poll;
+  PollTable *m_pollTable;
 
 };
 
@@ -20,8 +20,38 @@ LoaderFactory::GetTypeId (void)
     .SetParent<Object> ();
   return tid;
 }
+LoaderFactory::LoaderFactory ()
+  : m_template (0)
+{
+}
 LoaderFactory::~LoaderFactory ()
 {
 }
+void
+LoaderFactory::DoDispose (void)
+{
+  delete m_template;
+  m_template = 0;
+  m_templateSetups.clear ();
+  Object::DoDispose ();
+}
+
+void
+LoaderFactory::SetTemplate (Loader *loader, const std::vector<void *> &setups)
+{
+  delete m_template;
+  m_template = loader;
+  m_templateSetups = setups;
+}
+Loader *
+LoaderFactory::PeekTemplate (void) const
+{
+  return m_template;
+}
+const std::vector<void *> &
+LoaderFactory::GetTemplateSetups (void) const
+{
+  return m_templateSetups;
+}
 
 } // namespace ns3
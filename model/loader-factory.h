@@ -3,6 +3,7 @@
 
 #include "ns3/object.h"
 #include "ns3/simple-ref-count.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -23,8 +24,28 @@ class LoaderFactory : public Object
 {
 public:
   static TypeId GetTypeId (void);
+  LoaderFactory ();
   virtual ~LoaderFactory () = 0;
   virtual Loader * Create (int argc, char **argv, char **envp) = 0;
+
+  /**
+   * \param loader a loader of the libraries of DCE, set up, taken over.
+   * \param setups the setup functions of these libraries.
+   *
+   * The process template of the node, see the ProcessTemplates attribute
+   * of DceManager: deleted with the factory.
+   */
+  void SetTemplate (Loader *loader, const std::vector<void *> &setups);
+  // 0 if there is no template.
+  Loader * PeekTemplate (void) const;
+  const std::vector<void *> & GetTemplateSetups (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  Loader *m_template;
+  std::vector<void *> m_templateSetups;
 };
 
 } // namespace ns3
@@ -54,6 +54,7 @@ LocalDatagramSocketFd::LocalDatagramSocketFd (Ptr<LocalSocketFdFactory> f)
     m_peer (0)
 {
   m_factory = f;
+  m_framed = true;
 }
 LocalDatagramSocketFd::~LocalDatagramSocketFd ()
 {
@@ -103,7 +104,7 @@ LocalDatagramSocketFd::Write (const void *buf, size_t count)
 }
 
 ssize_t
-LocalDatagramSocketFd::Read (void *buf, size_t count, bool noWait, bool peek)
+LocalDatagramSocketFd::Read (const struct iovec *iov, int iovcnt, bool noWait, bool peek, size_t *msgSize)
 {
   NS_LOG_FUNCTION (this << "state:" << m_state);
   WaitQueueEntryTimeout *wq = 0;
@@ -111,11 +112,11 @@ LocalDatagramSocketFd::Read (void *buf, size_t count, bool noWait, bool peek)
   while (BINDED == m_state)
     {
       // Is There some already received data ?
-      if (m_readBuffer.size () > 0)
+      if (HasReadData ())
         {
-          ssize_t ret = ReadData ((uint8_t*) buf, count, peek);
+          ssize_t ret = ReadData (iov, iovcnt, peek, msgSize);
 
-          if ((ret > 0)&&(0 != m_peer))
+          if (!peek && (0 != m_peer))
             {
               // WakeUP peer because we made room
               short po = POLLOUT;
@@ -125,11 +126,11 @@ LocalDatagramSocketFd::Read (void *buf, size_t count, bool noWait, bool peek)
         }
 
       // Should Wait data ?
-      if (noWait || m_shutRead)
+      if (m_shutRead)
         {
           RETURNFREE (0);
         }
-      if (m_statusFlags & O_NONBLOCK)
+      if (noWait || (m_statusFlags & O_NONBLOCK))
         {
           // Socket do not want to wait
           Current ()->err = EAGAIN;
@@ -146,9 +147,20 @@ LocalDatagramSocketFd::Read (void *buf, size_t count, bool noWait, bool peek)
           wq = new WaitQueueEntryTimeout (POLLIN | POLLHUP, GetRecvTimeout ());
         }
       AddWaitQueue (wq, true);
+      if (!peek)
+        {
+          SetDirectRead (wq, iov, iovcnt);
+        }
       WaitPoint::Result res = wq->Wait ();
+      ssize_t direct = TakeDirectRead (wq, msgSize);
       RemoveWaitQueue (wq, true);
 
+      if (direct >= 0)
+        {
+          // a writer gave us its datagram.
+          RETURNFREE (direct);
+        }
+
       switch (res)
         {
         case WaitPoint::OK:
@@ -156,7 +168,7 @@ LocalDatagramSocketFd::Read (void *buf, size_t count, bool noWait, bool peek)
 
         case WaitPoint::INTERRUPTED:
           UtilsDoSignal ();
-          if (0 == m_readBuffer.size ())
+          if (!HasReadData ())
             {
               Current ()->err = EINTR;
               RETURNFREE (-1);
@@ -164,7 +176,7 @@ LocalDatagramSocketFd::Read (void *buf, size_t count, bool noWait, bool peek)
           break;
 
         case WaitPoint::TIMEOUT:
-          if (0 == m_readBuffer.size ())
+          if (!HasReadData ())
             {
               Current ()->err = EAGAIN;
               RETURNFREE (-1);
@@ -446,7 +458,7 @@ LocalDatagramSocketFd::Bind (const struct sockaddr *my_addr, socklen_t addrlen)
       return -1;
     }
 
-  std::string realPath = UtilsGetRealFilePath (std::string (((struct sockaddr_un*) my_addr)->sun_path));
+  std::string realPath = UtilsGetWritableFilePath (std::string (((struct sockaddr_un*) my_addr)->sun_path), true);
   struct sockaddr_un realAddr;
 
   memset (&realAddr, 0, sizeof(realAddr));
@@ -595,7 +607,7 @@ LocalDatagramSocketFd::CanRecv (void) const
       return 1;
 
     case BINDED:
-      return m_readBufferSize > 0;
+      return HasReadData ();
 
     case REMOTECLOSED:
     case CONNECTED:
@@ -608,7 +620,7 @@ LocalDatagramSocketFd::CanRecv (void) const
 bool
 LocalDatagramSocketFd::CanSend (void) const
 {
-  return ((CONNECTED == m_state) && (0 != m_peer) && (m_peer->m_readBufferSize < LOCAL_SOCKET_MAX_BUFFER))
+  return ((CONNECTED == m_state) && (0 != m_peer) && m_peer->HasRoom ())
          || (CONNECTED != m_state);
 }
 
@@ -636,43 +648,17 @@ LocalDatagramSocketFd::Recvmsg (struct msghdr *msg, int flags)
       return -1;
     }
 
-  size_t retval = 0;
-  for (uint32_t i = 0; i < msg->msg_iovlen; ++i)
-    {
-      uint8_t *buf = (uint8_t *) msg->msg_iov[i].iov_base;
-      ssize_t len = msg->msg_iov[i].iov_len;
-      msg->msg_namelen = 0;
-
-      ssize_t ret = Read (buf, len, (retval > 0) || (flags & MSG_DONTWAIT), (flags & MSG_PEEK));
-      NS_LOG_FUNCTION (this << "len:" << len << " read-> " << ret);
-      if (ret <= 0)
-        {
-          NS_LOG_FUNCTION (this << "4");
+  // One datagram is read, scattered in all the iovs.
+  size_t msgSize = 0;
+  msg->msg_namelen = 0;
+  ssize_t ret = Read (msg->msg_iov, msg->msg_iovlen, (flags & MSG_DONTWAIT), (flags & MSG_PEEK), &msgSize);
+  NS_LOG_FUNCTION (this << " read-> " << ret << " size:" << msgSize);
 
-          break;
-        }
-      if (ret > 0)
-        {
-          retval += ret;
-        }
-    }
-
-  if (retval > 0)
-    {
-      if ((!(flags & MSG_PEEK) && (m_readBufferSize > 0))
-          || ((flags & MSG_PEEK) && (m_readBufferSize > retval)))
-        {
-          msg->msg_flags |= MSG_TRUNC;
-        }
-      return retval;
-    }
-
-  if (flags & MSG_DONTWAIT)
+  if ((ret >= 0) && (msgSize > (size_t) ret))
     {
-      Current ()->err = EAGAIN;
+      msg->msg_flags |= MSG_TRUNC;
     }
-
-  return -1;
+  return ret;
 }
 
 ssize_t
@@ -724,81 +710,80 @@ LocalDatagramSocketFd::Sendmsg (const struct msghdr *msg, int flags)
       return -1;
     }
 
-  ssize_t retval = 0;
+  size_t len = 0;
+  for (uint32_t i = 0; i < msg->msg_iovlen; ++i)
+    {
+      len += msg->msg_iov[i].iov_len;
+    }
+  if (0 == len)
+    {
+      return 0;
+    }
+
+  // The iovs are gathered in one datagram.
   WaitQueueEntryTimeout *wq = 0;
 
-  for (uint32_t i = 0; i < msg->msg_iovlen; ++i)
+  while (m_state < REMOTECLOSED)
     {
-      uint8_t *buf = (uint8_t *) msg->msg_iov[i].iov_base;
-      ssize_t len = msg->msg_iov[i].iov_len;
-      size_t ret = 0;
+      ssize_t ret = listener->DoRecvPacket (msg->msg_iov, msg->msg_iovlen);
 
-      while (m_state < REMOTECLOSED)
+      switch (ret)
         {
-          ret = listener->DoRecvPacket (buf, len);
-
-          switch (ret)
-            {
-            case 0: // NO ROOM
+        case 0: // NO ROOM
+          {
+            if (flags & MSG_DONTWAIT)
+              {
+                Current ()->err = EAGAIN;
+                RETURNFREE (-1);
+              }
+            if (!wq)
               {
-                if (flags & MSG_DONTWAIT)
-                  {
-                    Current ()->err = EAGAIN;
-                    RETURNFREE (-1);
-                  }
-                if (!wq)
-                  {
-                    wq = new WaitQueueEntryTimeout (POLLOUT | POLLHUP, GetSendTimeout ());
-                  }
-                AddWaitQueue (wq, true);
-                WaitPoint::Result res = wq->Wait ();
-                RemoveWaitQueue (wq, true);
-
-                switch (res)
-                  {
-                  case WaitPoint::OK:
-                    break;
-                  case WaitPoint::INTERRUPTED:
-                    {
-                      UtilsDoSignal ();
-                      Current ()->err = EINTR;
-                      RETURNFREE (-1);
-                    }
-                    break;
-                  case WaitPoint::TIMEOUT:
-                    {
-                      Current ()->err = EAGAIN;
-                      RETURNFREE (-1);
-                    }
-                    break;
-                  }
-
-                if (m_state >= REMOTECLOSED)
-                  {
-                    Current ()->err = ECONNREFUSED;
-                    RETURNFREE (-1);
-                  }
-                continue;
+                wq = new WaitQueueEntryTimeout (POLLOUT | POLLHUP, GetSendTimeout ());
               }
+            AddWaitQueue (wq, true);
+            WaitPoint::Result res = wq->Wait ();
+            RemoveWaitQueue (wq, true);
 
-            case - 1: // NOMEM !
-              RETURNFREE (-1);
+            switch (res)
+              {
+              case WaitPoint::OK:
+                break;
+              case WaitPoint::INTERRUPTED:
+                {
+                  UtilsDoSignal ();
+                  Current ()->err = EINTR;
+                  RETURNFREE (-1);
+                }
+                break;
+              case WaitPoint::TIMEOUT:
+                {
+                  Current ()->err = EAGAIN;
+                  RETURNFREE (-1);
+                }
+                break;
+              }
 
-            case - 2: // CLOSED !
+            if (m_state >= REMOTECLOSED)
               {
                 Current ()->err = ECONNREFUSED;
                 RETURNFREE (-1);
               }
-            }
+            continue;
+          }
 
-          if (ret > 0)
-            {
-              retval += ret;
-              break;
-            }
+        case - 1: // NOMEM or EMSGSIZE !
+          RETURNFREE (-1);
+
+        case - 2: // CLOSED !
+          {
+            Current ()->err = ECONNREFUSED;
+            RETURNFREE (-1);
+          }
         }
+      RETURNFREE (ret);
     }
-  RETURNFREE (retval);
+  Current ()->err = ECONNREFUSED;
+  RETURNFREE (-1);
 }
 
 bool
@@ -844,7 +829,10 @@ LocalDatagramSocketFd::UnBind (void)
 ssize_t
 LocalDatagramSocketFd::Read (void *buf, size_t count)
 {
-  return Read (buf, count, false, false);
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = count;
+  return Read (&iov, 1, false, false, 0);
 }
 bool
 LocalDatagramSocketFd::IsClosed (void) const
@@ -84,7 +84,7 @@ protected:
 private:
   bool IsBinded (void);
   void UnBind (void);
-  ssize_t Read (void *buf, size_t count, bool noWait, bool peek);
+  ssize_t Read (const struct iovec *iov, int iovcnt, bool noWait, bool peek, size_t *msgSize);
   void AddConnected (LocalDatagramSocketFd *newone);
   void RemoveConnected (LocalDatagramSocketFd *freeOne, bool andWakeUp);
 
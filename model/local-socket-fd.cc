@@ -29,6 +29,7 @@
 #include <sys/un.h>
 #include "unix-fd.h"
 #include <exception>
+#include <algorithm>
 #include "poll.h"
 
 NS_LOG_COMPONENT_DEFINE ("LocalSocketFd");
@@ -46,8 +47,9 @@ LocalSocketFd::GetInstanceTypeId (void) const
 {
   return LocalSocketFd::GetTypeId ();
 }
-LocalSocketFd::LocalSocketFd () : m_readBuffer (0),
+LocalSocketFd::LocalSocketFd () : m_readBuffer (LOCAL_SOCKET_MAX_BUFFER),
                                   m_readBufferSize (0),
+                                  m_framed (false),
                                   m_sendTimeout (0),
                                   m_recvTimeout (0),
                                   m_factory (0),
@@ -55,7 +57,13 @@ LocalSocketFd::LocalSocketFd () : m_readBuffer (0),
                                   m_bindPath (""),
                                   m_connectPath (""),
                                   m_shutRead (false),
-                                  m_shutWrite (false)
+                                  m_shutWrite (false),
+                                  m_directWait (0),
+                                  m_directIov (0),
+                                  m_directProcess (0),
+                                  m_directIovcnt (0),
+                                  m_directFill (-1),
+                                  m_directMsgSize (0)
 {
 }
 LocalSocketFd::~LocalSocketFd ()
@@ -229,6 +237,48 @@ LocalSocketFd::GetSendTimeout (void)
   return m_sendTimeout;
 }
 
+namespace {
+size_t
+IovLength (const struct iovec *iov, int iovcnt)
+{
+  size_t len = 0;
+  for (int i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+  return len;
+}
+// Copy the len first bytes of src to dst.
+size_t
+IovCopy (const struct iovec *dst, int dstcnt, const struct iovec *src, int srccnt, size_t len)
+{
+  size_t copied = 0;
+  size_t dOff = 0;
+  size_t sOff = 0;
+  int d = 0;
+  int s = 0;
+  while ((copied < len) && (d < dstcnt) && (s < srccnt))
+    {
+      size_t l = std::min (len - copied, std::min (dst[d].iov_len - dOff, src[s].iov_len - sOff));
+      memcpy ((uint8_t *) dst[d].iov_base + dOff, (const uint8_t *) src[s].iov_base + sOff, l);
+      copied += l;
+      dOff += l;
+      sOff += l;
+      if (dOff == dst[d].iov_len)
+        {
+          d++;
+          dOff = 0;
+        }
+      if (sOff == src[s].iov_len)
+        {
+          s++;
+          sOff = 0;
+        }
+    }
+  return copied;
+}
+} // anonymous namespace
+
 // Return :
 //   the size readed ,
 //  or 0 if no more space available,
@@ -236,37 +286,99 @@ LocalSocketFd::GetSendTimeout (void)
 ssize_t
 LocalSocketFd::DoRecvPacket (uint8_t* buf, size_t len)
 {
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = len;
+  return DoRecvPacket (&iov, 1);
+}
+
+ssize_t
+LocalSocketFd::DoRecvPacket (const struct iovec *iov, int iovcnt)
+{
+  size_t len = IovLength (iov, iovcnt);
   NS_LOG_FUNCTION (this << len << " shutRead:" << m_shutRead << "Closed:" << IsClosed ());
 
   if ((m_shutRead)|| IsClosed ())
     {
       return -2;
     }
-  if (m_readBufferSize >= LOCAL_SOCKET_MAX_BUFFER)
+
+  size_t header = m_framed ? sizeof (uint32_t) : 0;
+  if (m_framed && (header + len > LOCAL_SOCKET_MAX_BUFFER))
     {
-      return 0;
+      // A datagram must fit whole in the buffer.
+      Current ()->err = EMSGSIZE;
+      return -1;
     }
 
-  size_t maxi = LOCAL_SOCKET_MAX_BUFFER - m_readBufferSize;
-
-  int l = std::min (maxi, len);
-
-  struct Buffer *myBuf = new struct Buffer;
+  // A reader of the same process waits for this data: give it directly.
+  // The buffer of a reader of another process is in memory which is not
+  // mapped while the writer runs, its data sections and heap.
+  Thread *current = Current ();
+  if ((0 != m_directIov) && (-1 == m_directFill) && (0 == m_readBuffer.GetSize ())
+      && (0 != current) && (current->process == m_directProcess))
+    {
+      size_t room = IovLength (m_directIov, m_directIovcnt);
+      if (!m_framed || len <= room)
+        {
+          size_t l = IovCopy (m_directIov, m_directIovcnt, iov, iovcnt, len);
+          m_directFill = l;
+          m_directMsgSize = len;
+          m_directIov = 0;
+          NS_LOG_DEBUG ("DoRecvPacket direct copy " << l);
+          short pi = POLLIN;
+          WakeWaiters (&pi);
+          if (m_framed || l == len)
+            {
+              return len;
+            }
+          // the remaining goes to the buffer.
+          struct iovec rest[iovcnt];
+          int restcnt = 0;
+          size_t skip = l;
+          for (int i = 0; i < iovcnt; i++)
+            {
+              if (skip >= iov[i].iov_len)
+                {
+                  skip -= iov[i].iov_len;
+                  continue;
+                }
+              rest[restcnt].iov_base = (uint8_t *) iov[i].iov_base + skip;
+              rest[restcnt].iov_len = iov[i].iov_len - skip;
+              restcnt++;
+              skip = 0;
+            }
+          ssize_t ret = DoRecvPacket (rest, restcnt);
+          return (ret < 0) ? l : l + ret;
+        }
+    }
 
-  myBuf->data = (uint8_t*) malloc (l);
-  if (0 == myBuf->data)
+  if (m_readBuffer.GetSpace () <= header)
+    {
+      return 0;
+    }
+  size_t l = std::min (len, m_readBuffer.GetSpace () - header);
+  if (m_framed && l < len)
     {
-      Thread *current = Current ();
-      NS_ASSERT (current != 0);
-      current->err = ENOMEM;
+      return 0;
+    }
+  if (!m_readBuffer.Reserve (header + l))
+    {
+      Current ()->err = ENOMEM;
       return -1;
     }
-  myBuf->readOffset = 0;
-  myBuf->size = l;
-
-  memcpy (myBuf->data, buf, l);
-
-  m_readBuffer.push_back (myBuf);
+  if (m_framed)
+    {
+      uint32_t size = len;
+      m_readBuffer.Write ((const uint8_t *) &size, sizeof (size));
+    }
+  size_t written = 0;
+  for (int i = 0; i < iovcnt && written < l; i++)
+    {
+      size_t chunk = std::min (iov[i].iov_len, l - written);
+      m_readBuffer.Write ((const uint8_t *) iov[i].iov_base, chunk);
+      written += chunk;
+    }
 
   m_readBufferSize += l;
 
@@ -281,83 +393,120 @@ LocalSocketFd::DoRecvPacket (uint8_t* buf, size_t len)
 size_t
 LocalSocketFd::ReadData (uint8_t* buf, size_t len, bool peek)
 {
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = len;
+  return ReadData (&iov, 1, peek, 0);
+}
+
+size_t
+LocalSocketFd::ReadData (const struct iovec *iov, int iovcnt, bool peek, size_t *msgSize)
+{
+  size_t len = IovLength (iov, iovcnt);
   size_t fill = 0;
-  size_t rest = len;
+  size_t size = 0;
 
-  if (peek)
+  if (m_framed)
     {
-      for (std::list<struct Buffer*>::iterator i = m_readBuffer.begin (); i != m_readBuffer.end (); ++i)
+      uint32_t header;
+      if (m_readBuffer.Peek ((uint8_t *) &header, sizeof (header), 0) != sizeof (header))
         {
-          if ((fill >= len) || (rest <= 0))
-            {
-              break;
-            }
-
-          struct Buffer* myBuf = *i;
-
-          size_t avail = std::min (rest, myBuf->size - myBuf->readOffset);
-          NS_LOG_DEBUG ("ReadData avail:" << avail << " offset:" <<  myBuf->readOffset << " size:" << myBuf->size);
-
-          if (avail > 0)
-            {
-              memcpy (buf + fill, myBuf->data + myBuf->readOffset, avail);
-              fill += avail;
-              rest -= avail;
-            }
+          return 0;
+        }
+      size = header;
+      fill = m_readBuffer.Peekv (iov, iovcnt, std::min (len, size), sizeof (header));
+      if (!peek)
+        {
+          // the part which did not fit is lost.
+          m_readBuffer.Drop (sizeof (header) + size);
+          m_readBufferSize -= size;
         }
     }
   else
     {
-      while ((fill < len) && (m_readBuffer.size () > 0) && (rest > 0))
+      fill = m_readBuffer.Peekv (iov, iovcnt, len, 0);
+      size = fill;
+      if (!peek)
         {
-          struct Buffer* myBuf = m_readBuffer.front ();
+          m_readBuffer.Drop (fill);
+          m_readBufferSize -= fill;
+        }
+    }
+  NS_LOG_DEBUG ("ReadData fill:" << fill << " size:" << size << " peek:" << peek);
+  if (0 != msgSize)
+    {
+      *msgSize = size;
+    }
+  return fill;
+}
 
-          size_t avail = std::min (rest, myBuf->size - myBuf->readOffset);
-          NS_LOG_DEBUG ("ReadData avail:" << avail << " offset:" <<  myBuf->readOffset << " size:" << myBuf->size);
+bool
+LocalSocketFd::HasReadData (void) const
+{
+  return m_readBuffer.GetSize () > 0;
+}
 
-          if (avail > 0)
-            {
-              memcpy (buf + fill, myBuf->data + myBuf->readOffset, avail);
-              fill += avail;
-              rest -= avail;
+bool
+LocalSocketFd::HasRoom (void) const
+{
+  return m_readBuffer.GetSpace () > (m_framed ? sizeof (uint32_t) : 0);
+}
 
-              m_readBufferSize -= avail;
-              myBuf->readOffset += avail;
+void
+LocalSocketFd::SetDirectRead (WaitQueueEntry *wq, const struct iovec *iov, int iovcnt)
+{
+  if (0 != m_directWait)
+    {
+      // another reader is first.
+      return;
+    }
+  m_directWait = wq;
+  m_directIov = iov;
+  m_directIovcnt = iovcnt;
+  m_directProcess = Current ()->process;
+  m_directFill = -1;
+  m_directMsgSize = 0;
+}
 
-              if (myBuf->readOffset >= myBuf->size)
-                {
-                  free (myBuf->data);
-                  myBuf->data = 0;
-                  m_readBuffer.pop_front ();
-                  delete myBuf;
-                }
-            }
-          else
-            {
-              break;
-            }
-        }
+ssize_t
+LocalSocketFd::TakeDirectRead (WaitQueueEntry *wq, size_t *msgSize)
+{
+  if ((0 == m_directWait) || (wq != m_directWait))
+    {
+      return -1;
     }
+  ssize_t fill = m_directFill;
+  if (0 != msgSize)
+    {
+      *msgSize = m_directMsgSize;
+    }
+  m_directWait = 0;
+  m_directIov = 0;
+  m_directProcess = 0;
+  m_directFill = -1;
   return fill;
 }
 
 void
-LocalSocketFd::ClearReadBuffer (void)
+LocalSocketFd::RemoveWaitQueue (WaitQueueEntry* old, bool andUnregister)
 {
-  NS_LOG_FUNCTION (this);
-  for (std::list<struct Buffer *>::iterator i = m_readBuffer.begin (); i != m_readBuffer.end (); ++i)
+  if ((0 != m_directWait) && (old == m_directWait))
     {
-      struct Buffer *b = *i;
-      if (0 != b->data)
-        {
-          free (b->data);
-        }
-      b->data = 0;
-      b->size = 0;
-      b->readOffset = 0;
-      delete b;
+      // The reader went away without taking its data (its thread was
+      // killed): its buffer must not be written any more.
+      m_directWait = 0;
+      m_directIov = 0;
+      m_directProcess = 0;
+      m_directFill = -1;
     }
-  m_readBuffer.clear ();
+  UnixFd::RemoveWaitQueue (old, andUnregister);
+}
+
+void
+LocalSocketFd::ClearReadBuffer (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_readBuffer.Clear ();
   m_readBufferSize = 0;
 }
 
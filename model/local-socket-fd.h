@@ -22,6 +22,7 @@
 #define LOCAL_SOCKET_FD_H
 
 #include "unix-fd.h"
+#include "ring-buffer.h"
 #include "ns3/ptr.h"
 #include <list>
 #include "ns3/nstime.h"
@@ -90,6 +91,7 @@ protected:
   void ClearReadBuffer (void);
   virtual void ClearAll (bool andWakeUp) = 0;
   virtual bool IsClosed (void) const = 0;
+  virtual void RemoveWaitQueue (WaitQueueEntry* old, bool andUnregister);
 
   Time GetRecvTimeout (void);
   Time GetSendTimeout (void);
@@ -99,19 +101,27 @@ protected:
   //  or -1 if fatal error occurs
   //  or -2 if read part is shuted down
   ssize_t DoRecvPacket (uint8_t* buf, size_t len);
+  ssize_t DoRecvPacket (const struct iovec *iov, int iovcnt);
 
   size_t ReadData (uint8_t* buf, size_t len, bool peek);
-
-  struct Buffer
-  {
-    uint8_t *data;
-    size_t size;
-    size_t readOffset;
-  };
-  typedef std::list<struct Buffer*> FifoData;
-
-  FifoData m_readBuffer;
+  // msgSize is set to the size of the message read, which may be more
+  // than what iov could hold.
+  size_t ReadData (const struct iovec *iov, int iovcnt, bool peek, size_t *msgSize);
+  bool HasReadData (void) const;
+  bool HasRoom (void) const;
+
+  // A reader about to wait in wq lets the writers of its process copy
+  // the data straight to iov while the read buffer is empty; the others
+  // go through the buffer. TakeDirectRead
+  // must be called before removing wq and returns -1 if nothing came.
+  void SetDirectRead (WaitQueueEntry *wq, const struct iovec *iov, int iovcnt);
+  ssize_t TakeDirectRead (WaitQueueEntry *wq, size_t *msgSize);
+
+  // Stream data is queued as is, datagrams framed by their length.
+  RingBuffer m_readBuffer;
+  // Number of data bytes in m_readBuffer.
   size_t m_readBufferSize;
+  bool m_framed;
 
   Time m_sendTimeout;
   Time m_recvTimeout;
@@ -121,6 +131,14 @@ protected:
   std::string m_connectPath;
   bool m_shutRead;
   bool m_shutWrite;
+
+private:
+  WaitQueueEntry *m_directWait;
+  const struct iovec *m_directIov;
+  struct Process *m_directProcess; // of the reader
+  int m_directIovcnt;
+  ssize_t m_directFill;
+  size_t m_directMsgSize;
 };
 
 } // namespace ns3
@@ -300,8 +300,18 @@ LocalStreamSocketFd::Read (void *buf, size_t count)
               wq = new WaitQueueEntryTimeout (POLLIN | POLLHUP, GetRecvTimeout ());
             }
           AddWaitQueue (wq, true);
+          // the writer may fill our buffer directly.
+          struct iovec iov;
+          iov.iov_base = (uint8_t*) buf + filled;
+          iov.iov_len = count - filled;
+          SetDirectRead (wq, &iov, 1);
           WaitPoint::Result res = wq->Wait ();
+          ssize_t direct = TakeDirectRead (wq, 0);
           RemoveWaitQueue (wq, true);
+          if (direct > 0)
+            {
+              filled += direct;
+            }
 
           switch (res)
             {
@@ -747,7 +757,7 @@ LocalStreamSocketFd::Bind (const struct sockaddr *my_addr, socklen_t addrlen)
       return -1;
     }
 
-  std::string realPath = UtilsGetRealFilePath (std::string (((struct sockaddr_un*) my_addr)->sun_path));
+  std::string realPath = UtilsGetWritableFilePath (std::string (((struct sockaddr_un*) my_addr)->sun_path), true);
 
   struct sockaddr_un realAddr;
 
@@ -1004,7 +1014,7 @@ LocalStreamSocketFd::CanRecv (void) const
 bool
 LocalStreamSocketFd::CanSend (void) const
 {
-  return ((CONNECTED == m_state) && (0 != m_peer) && (m_peer->m_readBufferSize < LOCAL_SOCKET_MAX_BUFFER))
+  return ((CONNECTED == m_state) && (0 != m_peer) && m_peer->HasRoom ())
          || (CONNECTED != m_state);
 }
 bool
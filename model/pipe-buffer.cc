@@ -0,0 +1,305 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "pipe-buffer.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("PipeBuffer");
+
+// Pages kept for reuse once freed.
+#define PIPE_PAGE_CACHE 256
+
+namespace ns3 {
+
+struct PipePage
+{
+  uint32_t refs;
+  uint8_t data[PIPE_PAGE_SIZE];
+};
+
+namespace {
+struct PageCache : public std::vector<struct PipePage *>
+{
+  ~PageCache ()
+  {
+    for (iterator i = begin (); i != end (); ++i)
+      {
+        free (*i);
+      }
+  }
+} g_freePages;
+
+struct PipePage *
+PageAlloc (void)
+{
+  struct PipePage *page;
+  if (!g_freePages.empty ())
+    {
+      page = g_freePages.back ();
+      g_freePages.pop_back ();
+    }
+  else
+    {
+      page = (struct PipePage *) malloc (sizeof (struct PipePage));
+      if (page == 0)
+        {
+          return 0;
+        }
+    }
+  page->refs = 1;
+  return page;
+}
+
+void
+PageUnref (struct PipePage *page)
+{
+  page->refs--;
+  if (page->refs != 0)
+    {
+      return;
+    }
+  if (g_freePages.size () < PIPE_PAGE_CACHE)
+    {
+      g_freePages.push_back (page);
+    }
+  else
+    {
+      free (page);
+    }
+}
+} // anonymous namespace
+
+PipeBuffer::PipeBuffer (size_t capacity)
+  : m_size (0),
+    m_reserved (0),
+    m_capacity (capacity)
+{
+}
+PipeBuffer::~PipeBuffer (void)
+{
+  while (!m_slices.empty ())
+    {
+      PopFront ();
+    }
+}
+void
+PipeBuffer::PopFront (void)
+{
+  PageUnref (m_slices.front ().page);
+  m_slices.pop_front ();
+}
+size_t
+PipeBuffer::Write (const uint8_t *buf, size_t len)
+{
+  NS_LOG_FUNCTION (this << len << m_size);
+  size_t written = 0;
+  while (written < len)
+    {
+      size_t room;
+      uint8_t *area = GetWriteArea (&room);
+      if (area == 0)
+        {
+          break;
+        }
+      room = std::min (room, len - written);
+      memcpy (area, buf + written, room);
+      Commit (room);
+      written += room;
+    }
+  return written;
+}
+size_t
+PipeBuffer::Read (uint8_t *buf, size_t len)
+{
+  NS_LOG_FUNCTION (this << len << m_size);
+  size_t read = 0;
+  while (read < len && !m_slices.empty ())
+    {
+      size_t l;
+      const uint8_t *data = Peek (&l);
+      l = std::min (l, len - read);
+      memcpy (buf + read, data, l);
+      Drop (l);
+      read += l;
+    }
+  return read;
+}
+uint8_t *
+PipeBuffer::GetWriteArea (size_t *len)
+{
+  size_t space = GetSpace ();
+  if (space == 0)
+    {
+      return 0;
+    }
+  if (!m_slices.empty ())
+    {
+      struct Slice &last = m_slices.back ();
+      uint32_t end = last.offset + last.len;
+      // the free end of a page is ours only if no one else refers to it.
+      if (last.page->refs == 1 && end < PIPE_PAGE_SIZE)
+        {
+          *len = std::min ((size_t)(PIPE_PAGE_SIZE - end), space);
+          return last.page->data + end;
+        }
+    }
+  struct Slice slice;
+  slice.page = PageAlloc ();
+  if (slice.page == 0)
+    {
+      return 0;
+    }
+  slice.offset = 0;
+  slice.len = 0;
+  m_slices.push_back (slice);
+  *len = std::min ((size_t) PIPE_PAGE_SIZE, space);
+  return slice.page->data;
+}
+void
+PipeBuffer::Commit (size_t len)
+{
+  struct Slice &last = m_slices.back ();
+  last.len += len;
+  m_size += len;
+  if (last.len == 0)
+    {
+      PageUnref (last.page);
+      m_slices.pop_back ();
+    }
+}
+const uint8_t *
+PipeBuffer::Peek (size_t *len) const
+{
+  if (m_slices.empty ())
+    {
+      *len = 0;
+      return 0;
+    }
+  const struct Slice &first = m_slices.front ();
+  *len = first.len;
+  return first.page->data + first.offset;
+}
+void
+PipeBuffer::Drop (size_t len)
+{
+  while (len > 0 && !m_slices.empty ())
+    {
+      struct Slice &first = m_slices.front ();
+      size_t l = std::min (len, (size_t) first.len);
+      first.offset += l;
+      first.len -= l;
+      m_size -= l;
+      len -= l;
+      if (first.len == 0)
+        {
+          PopFront ();
+        }
+    }
+}
+size_t
+PipeBuffer::Splice (PipeBuffer *to, size_t len)
+{
+  NS_LOG_FUNCTION (this << to << len << m_size);
+  size_t moved = 0;
+  while (moved < len && !m_slices.empty () && to->GetSpace () > 0)
+    {
+      struct Slice &first = m_slices.front ();
+      size_t l = std::min (std::min (len - moved, (size_t) first.len), to->GetSpace ());
+      if (l == first.len)
+        {
+          // the reference goes with the slice.
+          to->m_slices.push_back (first);
+          m_slices.pop_front ();
+        }
+      else
+        {
+          struct Slice part = first;
+          part.len = l;
+          part.page->refs++;
+          to->m_slices.push_back (part);
+          first.offset += l;
+          first.len -= l;
+        }
+      m_size -= l;
+      to->m_size += l;
+      moved += l;
+    }
+  return moved;
+}
+size_t
+PipeBuffer::Tee (PipeBuffer *to, size_t len) const
+{
+  NS_LOG_FUNCTION (this << to << len << m_size);
+  size_t copied = 0;
+  for (std::deque<struct Slice>::const_iterator i = m_slices.begin ();
+       i != m_slices.end () && copied < len && to->GetSpace () > 0; ++i)
+    {
+      struct Slice part = *i;
+      part.len = std::min (std::min (len - copied, (size_t) part.len), to->GetSpace ());
+      part.page->refs++;
+      to->m_slices.push_back (part);
+      to->m_size += part.len;
+      copied += part.len;
+    }
+  return copied;
+}
+void
+PipeBuffer::Prepend (PipeBuffer *from)
+{
+  NS_ASSERT (m_size + from->m_size <= m_capacity);
+  m_slices.insert (m_slices.begin (), from->m_slices.begin (), from->m_slices.end ());
+  m_size += from->m_size;
+  from->m_slices.clear ();
+  from->m_size = 0;
+}
+void
+PipeBuffer::Append (PipeBuffer *from)
+{
+  NS_ASSERT (m_size + from->m_size <= m_capacity);
+  m_slices.insert (m_slices.end (), from->m_slices.begin (), from->m_slices.end ());
+  m_size += from->m_size;
+  from->m_slices.clear ();
+  from->m_size = 0;
+}
+void
+PipeBuffer::Reserve (size_t len)
+{
+  NS_ASSERT (len <= GetSpace ());
+  m_reserved += len;
+}
+void
+PipeBuffer::Unreserve (size_t len)
+{
+  NS_ASSERT (len <= m_reserved);
+  m_reserved -= len;
+}
+size_t
+PipeBuffer::GetSize (void) const
+{
+  return m_size;
+}
+size_t
+PipeBuffer::GetSpace (void) const
+{
+  return (m_size + m_reserved < m_capacity) ? m_capacity - m_size - m_reserved : 0;
+}
+size_t
+PipeBuffer::GetCapacity (void) const
+{
+  return m_capacity;
+}
+bool
+PipeBuffer::SetCapacity (size_t capacity)
+{
+  if (capacity < m_size + m_reserved)
+    {
+      return false;
+    }
+  m_capacity = capacity;
+  return true;
+}
+
+} // namespace ns3
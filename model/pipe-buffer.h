@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef PIPE_BUFFER_H
+#define PIPE_BUFFER_H
+
+#include <stdint.h>
+#include <unistd.h>
+#include <deque>
+
+#define PIPE_PAGE_SIZE 4096
+
+namespace ns3 {
+
+struct PipePage;
+
+/**
+ * The content of a pipe: a chain of slices of refcounted pages.
+ *
+ * Written bytes are copied in pages. Splice moves slices from a buffer
+ * to another and Tee shares them, so that data going from pipe to pipe
+ * is never copied. A page shared by several slices is never written
+ * again.
+ */
+class PipeBuffer
+{
+public:
+  PipeBuffer (size_t capacity);
+  ~PipeBuffer (void);
+
+  // Copy at most len bytes, as many as there is room for.
+  size_t Write (const uint8_t *buf, size_t len);
+  // Copy out and remove at most len bytes.
+  size_t Read (uint8_t *buf, size_t len);
+
+  /**
+   * Room at the end of the buffer which can be filled in place, then
+   * added with Commit.
+   * \return 0 if the buffer is full or out of memory.
+   */
+  uint8_t * GetWriteArea (size_t *len);
+  void Commit (size_t len);
+
+  /**
+   * The bytes at the head of the buffer which are contiguous in memory,
+   * to be removed with Drop once consumed.
+   */
+  const uint8_t * Peek (size_t *len) const;
+  void Drop (size_t len);
+
+  // Move at most len bytes to the end of to, as many as it has room for.
+  size_t Splice (PipeBuffer *to, size_t len);
+  // Same as Splice without removing anything from this buffer.
+  size_t Tee (PipeBuffer *to, size_t len) const;
+  // Move everything from the end of from to the head of this buffer,
+  // or from its head to the end of this buffer, into room reserved for it.
+  void Prepend (PipeBuffer *from);
+  void Append (PipeBuffer *from);
+  // Keep len bytes of room out of GetSpace, for data held outside of the
+  // buffer which comes back with Prepend or Append.
+  void Reserve (size_t len);
+  void Unreserve (size_t len);
+
+  size_t GetSize (void) const;
+  size_t GetSpace (void) const;
+  size_t GetCapacity (void) const;
+  // Fails if the data would not fit.
+  bool SetCapacity (size_t capacity);
+
+private:
+  struct Slice
+  {
+    struct PipePage *page;
+    uint32_t offset;
+    uint32_t len;
+  };
+  void PopFront (void);
+
+  std::deque<struct Slice> m_slices;
+  size_t m_size;
+  size_t m_reserved;
+  size_t m_capacity;
+};
+
+} // namespace ns3
+
+#endif /* PIPE_BUFFER_H */
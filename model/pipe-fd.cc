@@ -25,10 +25,19 @@
 #include <poll.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/uio.h>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("PipeFd");
 
 #define PIPE_CAPACITY 65536
+// Same as /proc/sys/fs/pipe-max-size
+#define PIPE_MAX_CAPACITY 1048576
+
+#ifndef F_SETPIPE_SZ
+#define F_SETPIPE_SZ 1031
+#define F_GETPIPE_SZ 1032
+#endif
 
 namespace ns3 {
 PipeFd::PipeFd () : m_peer (0),
@@ -66,55 +75,65 @@ PipeFd::Close (void)
 ssize_t
 PipeFd::Write (const void *buf, size_t count)
 {
-  NS_LOG_FUNCTION (this);
-  if (m_peer)
+  NS_LOG_FUNCTION (this << buf << count);
+  if (m_readSide)
     {
-      if (m_readSide)
-        {
-          Current ()->err = EBADF;
-          return -1;
-        }
-      size_t r = m_peer->DoRecvPacket ((uint8_t*)buf, count);
-      if (r > 0)
-        {
-          short po = POLLOUT;
-          WakeWaiters (&po); // WakeUp
-        }
-      return r;
+      Current ()->err = EBADF;
+      return -1;
     }
-  UtilsSendSignal (Current ()->process, SIGPIPE);
-  UtilsDoSignal ();
-  Current ()->err = EPIPE;
-  return -1;
+  if (WaitRoom (false) < 0)
+    {
+      return -1;
+    }
+  size_t r = m_peer->m_buf.Write ((const uint8_t *)buf, count);
+  NotifyData ();
+  return r;
 }
+
 ssize_t
-PipeFd::DoRecvPacket (uint8_t* buf, size_t len)
+PipeFd::Read (void *buf, size_t count)
+{
+  NS_LOG_FUNCTION (this << buf << count);
+  if (!m_readSide)
+    {
+      Current ()->err = EBADF;
+      return -1;
+    }
+  int status = WaitData (false);
+  if (status <= 0)
+    {
+      return status;
+    }
+  size_t r = m_buf.Read ((uint8_t *)buf, count);
+  NotifyRoom ();
+  return r;
+}
+
+int
+PipeFd::WaitData (bool nonBlock)
 {
   Thread *current = Current ();
-  NS_LOG_FUNCTION (this << (long)buf << len);
+  NS_LOG_FUNCTION (this << nonBlock);
   NS_ASSERT (current != 0);
+  NS_ASSERT (m_readSide);
 
   WaitQueueEntryTimeout *wq = 0;
 
-  while (true)
+  while (m_buf.GetSize () == 0)
     {
-      ssize_t r = m_buf.Write (buf, len);
-      if (r > 0)
+      if (0 == m_peer)
         {
-          short pi = POLLIN;
-          WakeWaiters (&pi); // WakeUp reader or poller for read or select for read
-
-          RETURNFREE (r);
+          // no more writer
+          RETURNFREE (0);
         }
-      if (m_peer->m_statusFlags & O_NONBLOCK)
+      if (nonBlock || (m_statusFlags & O_NONBLOCK))
         {
-          Current ()->err = EAGAIN;
+          current->err = EAGAIN;
           RETURNFREE (-1);
         }
-
       if (!wq)
         {
-          wq = new WaitQueueEntryTimeout (POLLOUT | POLLHUP, Time (0));
+          wq = new WaitQueueEntryTimeout (POLLIN | POLLHUP, Time (0));
         }
       AddWaitQueue (wq, true);
       PollTable::Result res = wq->Wait ();
@@ -127,7 +146,6 @@ PipeFd::DoRecvPacket (uint8_t* buf, size_t len)
         case PollTable::INTERRUPTED:
           {
             UtilsDoSignal ();
-
             current->err = EINTR;
             RETURNFREE (-1);
           }
@@ -140,50 +158,41 @@ PipeFd::DoRecvPacket (uint8_t* buf, size_t len)
           break;
         }
     }
+  RETURNFREE (1);
 }
 
-ssize_t
-PipeFd::Read (void *buf, size_t count)
+int
+PipeFd::WaitRoom (bool nonBlock)
 {
   Thread *current = Current ();
-  NS_LOG_FUNCTION (this << (long)buf << count);
+  NS_LOG_FUNCTION (this << nonBlock);
   NS_ASSERT (current != 0);
+  NS_ASSERT (!m_readSide);
 
-  if (!m_readSide)
-    {
-      Current ()->err = EBADF;
-      return -1;
-    }
   WaitQueueEntryTimeout *wq = 0;
 
   while (true)
     {
-      ssize_t r = m_buf.Read ((uint8_t*)buf, count);
-      if (r > 0)
-        {
-          short po = POLLOUT;
-          if (m_peer)
-            {
-              // WakeUp
-              m_peer->WakeWaiters (&po);
-            }
-          WakeWaiters (&po);
-
-          RETURNFREE (r);
-        }
       if (0 == m_peer)
         {
-          Current ()->err = EPIPE;
+          // no more reader
+          UtilsSendSignal (current->process, SIGPIPE);
+          UtilsDoSignal ();
+          current->err = EPIPE;
           RETURNFREE (-1);
         }
-      if (m_statusFlags & O_NONBLOCK)
+      if (m_peer->m_buf.GetSpace () > 0)
         {
-          Current ()->err = EAGAIN;
+          RETURNFREE (1);
+        }
+      if (nonBlock || (m_statusFlags & O_NONBLOCK))
+        {
+          current->err = EAGAIN;
           RETURNFREE (-1);
         }
       if (!wq)
         {
-          wq = new WaitQueueEntryTimeout (POLLIN | POLLHUP, Time (0));
+          wq = new WaitQueueEntryTimeout (POLLOUT | POLLHUP, Time (0));
         }
       AddWaitQueue (wq, true);
       PollTable::Result res = wq->Wait ();
@@ -210,6 +219,256 @@ PipeFd::Read (void *buf, size_t count)
     }
 }
 
+void
+PipeFd::NotifyRoom (void)
+{
+  if (m_peer)
+    {
+      short po = POLLOUT;
+      m_peer->WakeWaiters (&po);
+    }
+}
+
+void
+PipeFd::NotifyData (void)
+{
+  if (m_peer)
+    {
+      short pi = POLLIN;
+      m_peer->WakeWaiters (&pi);
+    }
+}
+
+PipeBuffer *
+PipeFd::GetBuffer (void)
+{
+  if (m_readSide)
+    {
+      return &m_buf;
+    }
+  return m_peer ? &m_peer->m_buf : 0;
+}
+
+ssize_t
+PipeFd::Splice (PipeFd *out, size_t len, bool nonBlock)
+{
+  NS_LOG_FUNCTION (this << out << len << nonBlock);
+  if (!m_readSide || out->m_readSide)
+    {
+      Current ()->err = EBADF;
+      return -1;
+    }
+  if (out->m_peer == this)
+    {
+      Current ()->err = EINVAL;
+      return -1;
+    }
+  while (true)
+    {
+      int status = WaitData (nonBlock);
+      if (status <= 0)
+        {
+          return status;
+        }
+      if (out->WaitRoom (nonBlock) < 0)
+        {
+          return -1;
+        }
+      // the pages change of pipe: nothing is copied.
+      size_t moved = m_buf.Splice (&out->m_peer->m_buf, len);
+      if (moved > 0)
+        {
+          NotifyRoom ();
+          out->NotifyData ();
+          return moved;
+        }
+      // someone else emptied the pipe while we waited for room.
+    }
+}
+
+ssize_t
+PipeFd::Tee (PipeFd *out, size_t len, bool nonBlock)
+{
+  NS_LOG_FUNCTION (this << out << len << nonBlock);
+  if (!m_readSide || out->m_readSide)
+    {
+      Current ()->err = EBADF;
+      return -1;
+    }
+  if (out->m_peer == this)
+    {
+      Current ()->err = EINVAL;
+      return -1;
+    }
+  while (true)
+    {
+      int status = WaitData (nonBlock);
+      if (status <= 0)
+        {
+          return status;
+        }
+      if (out->WaitRoom (nonBlock) < 0)
+        {
+          return -1;
+        }
+      // both pipes share the pages.
+      size_t copied = m_buf.Tee (&out->m_peer->m_buf, len);
+      if (copied > 0)
+        {
+          out->NotifyData ();
+          return copied;
+        }
+    }
+}
+
+ssize_t
+PipeFd::SpliceTo (UnixFd *out, size_t len, bool nonBlock)
+{
+  NS_LOG_FUNCTION (this << out << len << nonBlock);
+  if (!m_readSide)
+    {
+      Current ()->err = EBADF;
+      return -1;
+    }
+  int status = WaitData (nonBlock);
+  if (status <= 0)
+    {
+      return status;
+    }
+  // The pages are taken out of the pipe while out writes them, since it
+  // may block, and what out did not take goes back in front: their room
+  // stays reserved, the writers of the pipe cannot fill it meanwhile.
+  PipeBuffer held (len);
+  m_buf.Splice (&held, len);
+  size_t reserved = held.GetSize ();
+  m_buf.Reserve (reserved);
+  ssize_t done = 0;
+  while (held.GetSize () > 0)
+    {
+      size_t l;
+      const uint8_t *data = held.Peek (&l);
+      ssize_t w = out->Write (data, l);
+      if (w < 0)
+        {
+          if (done == 0)
+            {
+              done = -1;
+            }
+          break;
+        }
+      held.Drop (w);
+      done += w;
+      if ((size_t)w < l)
+        {
+          break;
+        }
+    }
+  m_buf.Unreserve (reserved);
+  m_buf.Prepend (&held);
+  if (done > 0)
+    {
+      NotifyRoom ();
+    }
+  return done;
+}
+
+ssize_t
+PipeFd::SpliceFrom (UnixFd *in, size_t len, bool nonBlock)
+{
+  NS_LOG_FUNCTION (this << in << len << nonBlock);
+  if (m_readSide)
+    {
+      Current ()->err = EBADF;
+      return -1;
+    }
+  if (WaitRoom (nonBlock) < 0)
+    {
+      return -1;
+    }
+  // in reads straight in pages which then join the pipe, in room
+  // reserved for them since in may block.
+  PipeBuffer held (std::min (len, m_peer->m_buf.GetSpace ()));
+  size_t reserved = held.GetCapacity ();
+  m_peer->m_buf.Reserve (reserved);
+  while (held.GetSpace () > 0)
+    {
+      size_t l;
+      uint8_t *area = held.GetWriteArea (&l);
+      if (area == 0)
+        {
+          break;
+        }
+      ssize_t r = in->Read (area, l);
+      if (r < 0)
+        {
+          held.Commit (0);
+          if (held.GetSize () == 0)
+            {
+              if (m_peer != 0)
+                {
+                  m_peer->m_buf.Unreserve (reserved);
+                }
+              return -1;
+            }
+          break;
+        }
+      held.Commit (r);
+      // stop at the end of what is available without waiting again.
+      if ((size_t)r < l || ((in->Poll (0) & POLLIN) == 0))
+        {
+          break;
+        }
+    }
+  if (0 == m_peer)
+    {
+      Current ()->err = EPIPE;
+      return -1;
+    }
+  size_t done = held.GetSize ();
+  m_peer->m_buf.Unreserve (reserved);
+  m_peer->m_buf.Append (&held);
+  NotifyData ();
+  return done;
+}
+
+ssize_t
+PipeFd::Vmsplice (const struct iovec *iov, size_t iovcnt, bool nonBlock)
+{
+  NS_LOG_FUNCTION (this << iov << iovcnt << nonBlock);
+  // The pages of the process can not be given to the pipe since the
+  // simulated process may reuse them at once: they are copied.
+  ssize_t done = 0;
+  if (m_readSide)
+    {
+      int status = WaitData (nonBlock);
+      if (status <= 0)
+        {
+          return status;
+        }
+      for (size_t i = 0; i < iovcnt && m_buf.GetSize () > 0; i++)
+        {
+          done += m_buf.Read ((uint8_t *) iov[i].iov_base, iov[i].iov_len);
+        }
+      NotifyRoom ();
+      return done;
+    }
+  if (WaitRoom (nonBlock) < 0)
+    {
+      return -1;
+    }
+  for (size_t i = 0; i < iovcnt; i++)
+    {
+      size_t w = m_peer->m_buf.Write ((const uint8_t *) iov[i].iov_base, iov[i].iov_len);
+      done += w;
+      if (w < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+  NotifyData ();
+  return done;
+}
+
 ssize_t
 PipeFd::Recvmsg (struct msghdr *msg, int flags)
 {
@@ -388,6 +647,37 @@ PipeFd::Fcntl (int cmd, unsigned long arg)
     case F_SETFD:
       NS_LOG_WARN ("GETFD/SETFD ot implemented on pipe");
       break;
+    case F_GETPIPE_SZ:
+    case F_SETPIPE_SZ:
+      {
+        PipeBuffer *buf = GetBuffer ();
+        if (buf == 0)
+          {
+            Current ()->err = EPIPE;
+            return -1;
+          }
+        if (cmd == F_GETPIPE_SZ)
+          {
+            return buf->GetCapacity ();
+          }
+        if (arg > PIPE_MAX_CAPACITY)
+          {
+            Current ()->err = EPERM;
+            return -1;
+          }
+        // a power of two number of pages, as the kernel does.
+        size_t capacity = PIPE_PAGE_SIZE;
+        while (capacity < arg)
+          {
+            capacity *= 2;
+          }
+        if (!buf->SetCapacity (capacity))
+          {
+            Current ()->err = EBUSY;
+            return -1;
+          }
+        return capacity;
+      }
     default:
       NS_FATAL_ERROR ("fcntl not implemented on pipe");
       return -1;
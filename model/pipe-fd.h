@@ -22,7 +22,7 @@
 #define PIPE_FD_H
 
 #include "unix-fd.h"
-#include "fifo-buffer.h"
+#include "pipe-buffer.h"
 namespace ns3 {
 /**
 *
@@ -78,13 +78,34 @@ public:
   virtual int Poll (PollTable* ptable);
   virtual int Fsync (void);
 
+  // splice (2) from this read side to the write side out.
+  ssize_t Splice (PipeFd *out, size_t len, bool nonBlock);
+  // tee (2) from this read side to the write side out.
+  ssize_t Tee (PipeFd *out, size_t len, bool nonBlock);
+  // splice (2) from this read side to any other file.
+  ssize_t SpliceTo (UnixFd *out, size_t len, bool nonBlock);
+  // splice (2) from any other file to this write side.
+  ssize_t SpliceFrom (UnixFd *in, size_t len, bool nonBlock);
+  // vmsplice (2) on either side.
+  ssize_t Vmsplice (const struct iovec *iov, size_t iovcnt, bool nonBlock);
+
 private:
-  ssize_t DoRecvPacket (uint8_t* buf, size_t len);
+  // Return 1 when there is something to read, 0 at end of file and -1
+  // on error.
+  int WaitData (bool nonBlock);
+  // Return 1 when there is room to write and -1 on error.
+  int WaitRoom (bool nonBlock);
+  // Wake up the writers, called on the read side.
+  void NotifyRoom (void);
+  // Wake up the readers, called on the write side.
+  void NotifyData (void);
+  // The data of the pipe, kept by the read side.
+  PipeBuffer * GetBuffer (void);
 
   PipeFd* m_peer;
   bool m_readSide;
   int m_statusFlags;
-  FifoBuffer m_buf;
+  PipeBuffer m_buf;
 
 };
 } // namespace ns3
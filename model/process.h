@@ -50,6 +50,7 @@ class Loader;
 class Task;
 class FileUsage;
 class PollTable;
+struct SyscallProfile;
 
 struct Mutex
 {
@@ -74,9 +75,14 @@ struct Condition
   uint32_t cid; // condition var id
   std::list<Thread *> waiting;
 };
+// Signals 1 to DCE_NSIG: the pending signals are kept in one 64-bit
+// word, bit signum - 1 for signal signum.
+#define DCE_NSIG 64
+#define DCE_SIGBIT(signum) (((uint64_t)1) << ((signum) - 1))
+
 struct SignalHandler
 {
-  int signal;
+  int signal; // 0 if no handler is installed.
   int flags;
   sigset_t mask;
   void (*handler)(int);
@@ -141,15 +147,18 @@ struct Process
   std::map<int,FileUsage *> openFiles;
   std::vector<FILE *> openStreams;
   std::vector<DIR *> openDirs;
-  std::vector<SignalHandler> signalHandlers;
+  // indexed by signal number - 1.
+  struct SignalHandler signalHandlers[DCE_NSIG];
   std::vector<Thread *> threads;
   std::vector<Mutex *> mutexes;
   std::vector<Semaphore *> semaphores;
   std::vector<Condition *> conditions;
   std::vector<struct AtExitHandler> atExitHandlers;
   std::set<uint16_t> children;
-  sigset_t pendingSignals;
+  uint64_t pendingSignals; // see DCE_SIGBIT
   Time itimerInterval;
+  Time itimerExpire; // time of the next expiration, see UtilsItimerArm
+  bool itimerStalled;
   EventId itimer;
   uint32_t nextMid;
   uint32_t nextSid;
@@ -194,6 +203,12 @@ struct Process
   // Current umask
   mode_t uMask;
   struct ProcessActivity timing;
+  // Not zero if the SyscallProfiling attribute of the manager is set.
+  struct SyscallProfile *syscallProfile;
+  // Busy poll statistics, see UtilsSpin.
+  uint64_t spinCalls; // non-blocking calls without progress
+  uint64_t spinWaits; // calls which made the thread wait
+  Time spinSkipped; // simulated time spent in these waits
 };
 
 struct ThreadKeyValue
@@ -220,11 +235,16 @@ struct Thread
   Process *process;
   std::list<struct ThreadKeyValue> keyValues;
   sigset_t signalMask;
-  sigset_t pendingSignals;
+  uint64_t pendingSignals; // see DCE_SIGBIT
   Time lastTime; // Last time of a possible infinite loop checkpoint.
+  uint32_t spinCount; // Consecutive calls without progress at lastTime.
   Waiter *childWaiter; // Not zero if thread waiting for a child in wait or waitall ...
   PollTable *pollTable; // No 0 if a poll is running on this thread
+  PollTable *pollTableCache; // Table of the last poll, reused by the next one.
   std::pair <UnixFd*, WaitQueueEntry*> ioWait;   // Filled if the current thread is currently waiting for IO
+  // Host time spent switched out, to be removed from the profiled calls.
+  uint64_t profileBlocked;
+  uint64_t profileSwitchOut;
 };
 
 } // namespace ns3
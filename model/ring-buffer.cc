@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "ring-buffer.h"
+#include "ns3/log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("RingBuffer");
+
+#define MIN_ALLOC 4096
+
+namespace ns3 {
+
+RingBuffer::RingBuffer (size_t maxSize)
+  : m_maxSize (maxSize),
+    m_buffer (0),
+    m_capacity (0),
+    m_head (0),
+    m_size (0)
+{
+}
+RingBuffer::~RingBuffer (void)
+{
+  Clear ();
+}
+size_t
+RingBuffer::GetSize (void) const
+{
+  return m_size;
+}
+size_t
+RingBuffer::GetSpace (void) const
+{
+  return m_maxSize - m_size;
+}
+bool
+RingBuffer::Reserve (size_t len)
+{
+  if (len > GetSpace ())
+    {
+      return false;
+    }
+  size_t size = m_size + len;
+  if (size <= m_capacity)
+    {
+      return true;
+    }
+  size_t capacity = std::max (m_capacity, (size_t)MIN_ALLOC);
+  while (capacity < size)
+    {
+      capacity *= 2;
+    }
+  capacity = std::min (capacity, m_maxSize);
+  NS_LOG_FUNCTION (this << m_capacity << capacity);
+  uint8_t *buffer = (uint8_t *) malloc (capacity);
+  if (buffer == 0)
+    {
+      return false;
+    }
+  // the data starts at the beginning of the new block.
+  Peek (buffer, m_size, 0);
+  free (m_buffer);
+  m_buffer = buffer;
+  m_capacity = capacity;
+  m_head = 0;
+  return true;
+}
+bool
+RingBuffer::Write (const uint8_t *buf, size_t len)
+{
+  if (!Reserve (len))
+    {
+      return false;
+    }
+  if (len == 0)
+    {
+      // the block may not be allocated yet.
+      return true;
+    }
+  size_t tail = (m_head + m_size) % m_capacity;
+  size_t first = std::min (len, m_capacity - tail);
+  memcpy (m_buffer + tail, buf, first);
+  memcpy (m_buffer, buf + first, len - first);
+  m_size += len;
+  return true;
+}
+size_t
+RingBuffer::Peek (uint8_t *buf, size_t len, size_t offset) const
+{
+  if (offset >= m_size)
+    {
+      return 0;
+    }
+  len = std::min (len, m_size - offset);
+  size_t start = (m_head + offset) % m_capacity;
+  size_t first = std::min (len, m_capacity - start);
+  memcpy (buf, m_buffer + start, first);
+  memcpy (buf + first, m_buffer, len - first);
+  return len;
+}
+size_t
+RingBuffer::Peekv (const struct iovec *iov, int iovcnt, size_t len, size_t offset) const
+{
+  size_t copied = 0;
+  for (int i = 0; i < iovcnt && copied < len; i++)
+    {
+      size_t l = Peek ((uint8_t *) iov[i].iov_base, std::min (iov[i].iov_len, len - copied),
+                       offset + copied);
+      copied += l;
+      if (l < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+  return copied;
+}
+void
+RingBuffer::Drop (size_t len)
+{
+  len = std::min (len, m_size);
+  m_size -= len;
+  m_head = (m_size == 0) ? 0 : (m_head + len) % m_capacity;
+}
+void
+RingBuffer::Clear (void)
+{
+  free (m_buffer);
+  m_buffer = 0;
+  m_capacity = 0;
+  m_head = 0;
+  m_size = 0;
+}
+
+} // namespace ns3
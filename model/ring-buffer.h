@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+namespace ns3 {
+
+/**
+ * A byte queue of at most maxSize bytes stored in one contiguous
+ * circular block. The block grows, by doubling, only when the data does
+ * not fit in it any more: once it reached the working size of the queue,
+ * writing and reading do not allocate.
+ */
+class RingBuffer
+{
+public:
+  RingBuffer (size_t maxSize);
+  ~RingBuffer (void);
+
+  // number of bytes queued.
+  size_t GetSize (void) const;
+  // number of bytes which can still be queued.
+  size_t GetSpace (void) const;
+  /**
+   * Make sure that len more bytes can be written without allocating.
+   * \return false if there is not enough space or memory.
+   */
+  bool Reserve (size_t len);
+  /**
+   * Append the len bytes of buf, or nothing if they do not fit.
+   * \return false if there is not enough space or memory.
+   */
+  bool Write (const uint8_t *buf, size_t len);
+  /**
+   * Copy at most the len first bytes of the queue, after offset,
+   * without removing them.
+   * \return the number of bytes copied.
+   */
+  size_t Peek (uint8_t *buf, size_t len, size_t offset) const;
+  // same as Peek, scattering the bytes in iov.
+  size_t Peekv (const struct iovec *iov, int iovcnt, size_t len, size_t offset) const;
+  // Remove the len first bytes.
+  void Drop (size_t len);
+  // Remove everything and free the block.
+  void Clear (void);
+
+private:
+  const size_t m_maxSize;
+  uint8_t *m_buffer;
+  size_t m_capacity;
+  size_t m_head; // offset of the first byte in m_buffer.
+  size_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_H */
@@ -0,0 +1,129 @@
+/* -*-	Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "startup-profiler.h"
+#include "ns3/log.h"
+#include "utils.h"
+#include <string.h>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("StartupProfiler");
+
+namespace ns3 {
+
+StartupProfiler::Span::Span (StartupProfiler *profiler, uint16_t pid, const std::string &binary, const char *phase)
+  : m_profiler (profiler),
+    m_pid (pid),
+    m_phase (phase),
+    m_start (0)
+{
+  // the name is only copied when profiling.
+  if (m_profiler != 0)
+    {
+      m_binary = binary;
+      m_start = UtilsGetHostTime ();
+    }
+}
+
+StartupProfiler::Span::~Span ()
+{
+  if (m_profiler != 0)
+    {
+      m_profiler->Record (m_pid, m_binary, m_phase, UtilsGetHostTime () - m_start);
+    }
+}
+
+StartupProfiler::StartupProfiler ()
+{
+}
+
+void
+StartupProfiler::Record (uint16_t pid, const std::string &binary, const char *phase, uint64_t duration)
+{
+  NS_LOG_FUNCTION (this << pid << binary << phase << duration);
+  // binaries are aggregated by basename, whatever the path used to start them.
+  std::string::size_type slash = binary.find_last_of ('/');
+  struct Binary &b = m_binaries[(slash != std::string::npos) ? binary.substr (slash + 1) : binary];
+  std::map<std::string, struct Phase>::iterator i = b.phases.find (phase);
+  if (i == b.phases.end ())
+    {
+      struct Phase p;
+      memset (&p, 0, sizeof (p));
+      p.min = duration;
+      i = b.phases.insert (std::make_pair (std::string (phase), p)).first;
+      b.order.push_back (phase);
+    }
+  struct Phase &p = i->second;
+  p.count++;
+  p.total += duration;
+  p.min = std::min (p.min, duration);
+  p.max = std::max (p.max, duration);
+  uint64_t us = duration / 1000;
+  uint32_t bucket = 0;
+  while (us != 0 && bucket < NUM_BUCKETS - 1)
+    {
+      us >>= 1;
+      bucket++;
+    }
+  p.buckets[bucket]++;
+
+  m_pending[pid].push_back (std::make_pair (phase, duration));
+}
+
+std::string
+StartupProfiler::Flush (uint16_t pid)
+{
+  std::map<uint16_t, std::vector<std::pair<const char *, uint64_t> > >::iterator i = m_pending.find (pid);
+  if (i == m_pending.end ())
+    {
+      return "";
+    }
+  std::ostringstream oss;
+  oss << "Startup profile (us):";
+  for (std::vector<std::pair<const char *, uint64_t> >::const_iterator j = i->second.begin ();
+       j != i->second.end (); ++j)
+    {
+      oss << ' ' << j->first << '=' << (j->second / 1000.0);
+    }
+  m_pending.erase (i);
+  return oss.str ();
+}
+
+void
+StartupProfiler::Report (std::ostream &os) const
+{
+  for (std::map<std::string, struct Binary>::const_iterator i = m_binaries.begin ();
+       i != m_binaries.end (); ++i)
+    {
+      const struct Binary &b = i->second;
+      os << "BINARY " << i->first << std::endl;
+      os << "  " << std::left << std::setw (24) << "PHASE"
+         << std::right << std::setw (10) << "COUNT"
+         << std::setw (14) << "TOTAL(ms)"
+         << std::setw (12) << "MEAN(us)"
+         << std::setw (12) << "MIN(us)"
+         << std::setw (12) << "MAX(us)"
+         << "  HISTOGRAM(us: count)" << std::endl;
+      for (std::vector<std::string>::const_iterator j = b.order.begin (); j != b.order.end (); ++j)
+        {
+          const struct Phase &p = b.phases.find (*j)->second;
+          os << "  " << std::left << std::setw (24) << *j
+             << std::right << std::setw (10) << p.count
+             << std::setw (14) << std::fixed << std::setprecision (3) << (p.total / 1000000.0)
+             << std::setw (12) << std::setprecision (1) << (p.total / 1000.0 / p.count)
+             << std::setw (12) << (p.min / 1000.0)
+             << std::setw (12) << (p.max / 1000.0)
+             << " ";
+          for (uint32_t k = 0; k < NUM_BUCKETS; k++)
+            {
+              if (p.buckets[k] != 0)
+                {
+                  os << " <" << (1ULL << k) << ':' << p.buckets[k];
+                }
+            }
+          os << std::endl;
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,77 @@
+/* -*-	Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef STARTUP_PROFILER_H
+#define STARTUP_PROFILER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \brief Records the host wall-clock time spent in each phase of the
+ *        creation of DCE processes.
+ *
+ * Spans are aggregated by binary name and by phase into log2 histograms
+ * and the pending spans of each process can be flushed to its status
+ * file once the process is started. Enabled by the StartupProfiling
+ * attribute of ns3::DceManager.
+ */
+class StartupProfiler
+{
+public:
+  StartupProfiler ();
+
+  /**
+   * Measures the lifetime of a scope. Does nothing if the profiler is 0.
+   */
+  class Span
+  {
+  public:
+    Span (StartupProfiler *profiler, uint16_t pid, const std::string &binary, const char *phase);
+    ~Span ();
+  private:
+    StartupProfiler *m_profiler;
+    uint16_t m_pid;
+    std::string m_binary;
+    const char *m_phase;
+    uint64_t m_start;
+  };
+
+  void Record (uint16_t pid, const std::string &binary, const char *phase, uint64_t duration);
+  /**
+   * \returns one line describing all the spans recorded for pid since
+   *          the last call and forget them.
+   */
+  std::string Flush (uint16_t pid);
+  void Report (std::ostream &os) const;
+
+private:
+  enum
+  {
+    NUM_BUCKETS = 32
+  };
+  struct Phase
+  {
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    // bucket i counts the spans of [2^(i-1), 2^i[ microseconds.
+    uint64_t buckets[NUM_BUCKETS];
+  };
+  // phases are kept in the order in which they are first seen.
+  struct Binary
+  {
+    std::vector<std::string> order;
+    std::map<std::string, struct Phase> phases;
+  };
+  std::map<std::string, struct Binary> m_binaries;
+  std::map<uint16_t, std::vector<std::pair<const char *, uint64_t> > > m_pending;
+};
+
+} // namespace ns3
+
+#endif /* STARTUP_PROFILER_H */
@@ -574,4 +574,9 @@ TaskManager::GetNoSignal ()
   m_noSignal = false;
   return ret;
 }
+bool
+TaskManager::IsForkSafe (void) const
+{
+  return m_fiberManager->IsForkSafe ();
+}
 } // namespace ns3
@@ -157,6 +157,8 @@ public:
   EventId ScheduleMain (Time const &time, EventImpl *e);
 
   bool GetNoSignal ();
+  // true if a fork of the host process keeps the tasks. See FiberManager.
+  bool IsForkSafe (void) const;
 
 private:
   enum FiberManagerType
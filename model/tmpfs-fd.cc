@@ -0,0 +1,285 @@
+#include "tmpfs-fd.h"
+#include "utils.h"
+#include "process.h"
+#include "ns3/log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <poll.h>
+
+NS_LOG_COMPONENT_DEFINE ("TmpfsFd");
+
+namespace ns3 {
+
+TmpfsFd::TmpfsFd (Ptr<Tmpfs> fs, Ptr<TmpfsInode> inode, int flags)
+  : m_fs (fs),
+    m_inode (inode),
+    m_offset (0)
+{
+  m_statusFlags = flags & (O_ACCMODE | O_APPEND | O_NONBLOCK);
+  if (flags & O_CLOEXEC)
+    {
+      m_fdFlags = FD_CLOEXEC;
+    }
+}
+
+ssize_t
+TmpfsFd::Error (ssize_t status)
+{
+  if (status < 0)
+    {
+      Current ()->err = -status;
+      return -1;
+    }
+  return status;
+}
+
+int
+TmpfsFd::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the pages of an unlinked file go with the last reference.
+  m_inode = 0;
+  m_fs = 0;
+  return 0;
+}
+
+ssize_t
+TmpfsFd::Write (const void *buf, size_t count)
+{
+  NS_LOG_FUNCTION (this << buf << count);
+  if ((m_statusFlags & O_ACCMODE) == O_RDONLY)
+    {
+      Current ()->err = EBADF;
+      return -1;
+    }
+  if (m_statusFlags & O_APPEND)
+    {
+      m_offset = m_inode->GetSize ();
+    }
+  ssize_t ret = m_fs->Write (m_inode, buf, count, m_offset);
+  if (ret > 0)
+    {
+      m_offset += ret;
+    }
+  return Error (ret);
+}
+ssize_t
+TmpfsFd::Read (void *buf, size_t count)
+{
+  NS_LOG_FUNCTION (this << buf << count);
+  if ((m_statusFlags & O_ACCMODE) == O_WRONLY)
+    {
+      Current ()->err = EBADF;
+      return -1;
+    }
+  ssize_t ret = m_fs->Read (m_inode, buf, count, m_offset);
+  if (ret > 0)
+    {
+      m_offset += ret;
+    }
+  return Error (ret);
+}
+ssize_t
+TmpfsFd::Recvmsg (struct msghdr *msg, int flags)
+{
+  NS_LOG_FUNCTION (this << msg << flags);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+ssize_t
+TmpfsFd::Sendmsg (const struct msghdr *msg, int flags)
+{
+  NS_LOG_FUNCTION (this << msg << flags);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+bool
+TmpfsFd::Isatty (void) const
+{
+  return false;
+}
+int
+TmpfsFd::Setsockopt (int level, int optname,
+                     const void *optval, socklen_t optlen)
+{
+  NS_LOG_FUNCTION (this << level << optname << optval << optlen);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+int
+TmpfsFd::Getsockopt (int level, int optname,
+                     void *optval, socklen_t *optlen)
+{
+  NS_LOG_FUNCTION (this << level << optname << optval << optlen);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+int
+TmpfsFd::Getsockname (struct sockaddr *name, socklen_t *namelen)
+{
+  NS_LOG_FUNCTION (this << name << namelen);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+int
+TmpfsFd::Getpeername (struct sockaddr *name, socklen_t *namelen)
+{
+  NS_LOG_FUNCTION (this << name << namelen);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+int
+TmpfsFd::Ioctl (unsigned long request, char *argp)
+{
+  NS_LOG_FUNCTION (this << request << argp);
+  Thread *current = Current ();
+  current->err = ENOTTY;
+  return -1;
+}
+int
+TmpfsFd::Bind (const struct sockaddr *my_addr, socklen_t addrlen)
+{
+  NS_LOG_FUNCTION (this << my_addr << addrlen);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+int
+TmpfsFd::Connect (const struct sockaddr *my_addr, socklen_t addrlen)
+{
+  NS_LOG_FUNCTION (this << my_addr << addrlen);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+int
+TmpfsFd::Listen (int backlog)
+{
+  NS_LOG_FUNCTION (this << backlog);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+int
+TmpfsFd::Shutdown (int how)
+{
+  NS_LOG_FUNCTION (this << how);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+int
+TmpfsFd::Accept (struct sockaddr *my_addr, socklen_t *addrlen)
+{
+  NS_LOG_FUNCTION (this << my_addr << addrlen);
+  Thread *current = Current ();
+  current->err = ENOTSOCK;
+  return -1;
+}
+void *
+TmpfsFd::Mmap (void *start, size_t length, int prot, int flags, off64_t offset)
+{
+  NS_LOG_FUNCTION (this << start << length << prot << flags << offset);
+  // the pages are not contiguous.
+  Thread *current = Current ();
+  current->err = ENODEV;
+  return MAP_FAILED;
+}
+off64_t
+TmpfsFd::Lseek (off64_t offset, int whence)
+{
+  NS_LOG_FUNCTION (this << offset << whence);
+  off64_t base;
+  switch (whence)
+    {
+    case SEEK_SET:
+      base = 0;
+      break;
+    case SEEK_CUR:
+      base = m_offset;
+      break;
+    case SEEK_END:
+      base = m_inode->GetSize ();
+      break;
+    default:
+      Current ()->err = EINVAL;
+      return -1;
+    }
+  if (base + offset < 0)
+    {
+      Current ()->err = EINVAL;
+      return -1;
+    }
+  m_offset = base + offset;
+  return m_offset;
+}
+int
+TmpfsFd::Fxstat (int ver, struct ::stat *buf)
+{
+  NS_LOG_FUNCTION (this << buf);
+  m_inode->Stat (buf);
+  return 0;
+}
+int
+TmpfsFd::Fxstat64 (int ver, struct ::stat64 *buf)
+{
+  NS_LOG_FUNCTION (this << buf);
+  m_inode->Stat64 (buf);
+  return 0;
+}
+int
+TmpfsFd::Settime (int flags,
+                  const struct itimerspec *new_value,
+                  struct itimerspec *old_value)
+{
+  NS_LOG_FUNCTION (this << flags << new_value << old_value);
+  Thread *current = Current ();
+  current->err = EINVAL;
+  return -1;
+}
+int
+TmpfsFd::Gettime (struct itimerspec *cur_value) const
+{
+  NS_LOG_FUNCTION (this << cur_value);
+  Thread *current = Current ();
+  current->err = EINVAL;
+  return -1;
+}
+int
+TmpfsFd::Ftruncate (off_t length)
+{
+  NS_LOG_FUNCTION (this << length);
+  if ((m_statusFlags & O_ACCMODE) == O_RDONLY || length < 0)
+    {
+      Current ()->err = EINVAL;
+      return -1;
+    }
+  return Error (m_fs->Truncate (m_inode, length));
+}
+bool
+TmpfsFd::HangupReceived (void) const
+{
+  return false;
+}
+int
+TmpfsFd::Poll (PollTable* ptable)
+{
+  // like a file of the disk: never blocks.
+  return POLLIN | POLLOUT;
+}
+int
+TmpfsFd::Fsync (void)
+{
+  NS_LOG_FUNCTION (this);
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,586 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "tmpfs.h"
+#include "utils.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sstream>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("Tmpfs");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (Tmpfs);
+
+TmpfsInode::TmpfsInode (ino_t ino, mode_t mode)
+  : m_ino (ino),
+    m_mode (mode),
+    m_size (0)
+{
+  m_atime = m_mtime = m_ctime = UtilsTimeToTimespec (UtilsSimulationTimeToTime (Now ()));
+}
+
+TmpfsInode::~TmpfsInode ()
+{
+  for (std::map<uint64_t, uint8_t *>::iterator i = m_pages.begin (); i != m_pages.end (); ++i)
+    {
+      delete [] i->second;
+    }
+}
+
+bool
+TmpfsInode::IsDir (void) const
+{
+  return S_ISDIR (m_mode);
+}
+
+uint64_t
+TmpfsInode::GetSize (void) const
+{
+  return m_size;
+}
+
+void
+TmpfsInode::Stat (struct stat *buf) const
+{
+  memset (buf, 0, sizeof (*buf));
+  buf->st_ino = m_ino;
+  buf->st_mode = m_mode;
+  buf->st_nlink = IsDir () ? 2 : 1;
+  buf->st_size = IsDir () ? PAGE_SIZE : m_size;
+  buf->st_blksize = PAGE_SIZE;
+  buf->st_blocks = m_pages.size () * (PAGE_SIZE / 512);
+  buf->st_atim = m_atime;
+  buf->st_mtim = m_mtime;
+  buf->st_ctim = m_ctime;
+}
+
+void
+TmpfsInode::Stat64 (struct stat64 *buf) const
+{
+  memset (buf, 0, sizeof (*buf));
+  buf->st_ino = m_ino;
+  buf->st_mode = m_mode;
+  buf->st_nlink = IsDir () ? 2 : 1;
+  buf->st_size = IsDir () ? PAGE_SIZE : m_size;
+  buf->st_blksize = PAGE_SIZE;
+  buf->st_blocks = m_pages.size () * (PAGE_SIZE / 512);
+  buf->st_atim = m_atime;
+  buf->st_mtim = m_mtime;
+  buf->st_ctim = m_ctime;
+}
+
+TypeId
+Tmpfs::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Tmpfs")
+    .SetParent<Object> ()
+    .AddConstructor<Tmpfs> ()
+    .AddAttribute ("MaxSize", "The maximum number of bytes of the files, 0 for no limit. "
+                   "Writes beyond fail with ENOSPC.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Tmpfs::m_maxSize),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("Dump", "At the end of the simulation, write the files to the files-N "
+                   "directory of the node, where they would have been without the Tmpfs.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Tmpfs::m_dump),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+Tmpfs::Tmpfs ()
+  : m_maxSize (0),
+    m_used (0),
+    m_dump (false),
+    m_nextIno (2),
+    m_nodeId (0)
+{
+  m_inodes[""] = Create<TmpfsInode> (1, S_IFDIR | 0755);
+}
+
+Tmpfs::~Tmpfs ()
+{
+}
+
+void
+Tmpfs::SetMountPoint (uint32_t nodeId, std::string path)
+{
+  m_nodeId = nodeId;
+  m_mountPoint = path;
+}
+
+void
+Tmpfs::DoDispose (void)
+{
+  if (m_dump && !m_mountPoint.empty ())
+    {
+      std::ostringstream oss;
+      oss << "files-" << m_nodeId << m_mountPoint;
+      Dump (oss.str ());
+    }
+  m_inodes.clear ();
+  m_unlinked.clear ();
+  m_used = 0;
+  Object::DoDispose ();
+}
+
+std::string
+Tmpfs::Parent (std::string path)
+{
+  std::string::size_type slash = path.rfind ('/');
+  return (slash == std::string::npos) ? "" : path.substr (0, slash);
+}
+
+void
+Tmpfs::Touch (Ptr<TmpfsInode> inode, bool modified) const
+{
+  struct timespec now = UtilsTimeToTimespec (UtilsSimulationTimeToTime (Now ()));
+  inode->m_atime = now;
+  if (modified)
+    {
+      inode->m_mtime = inode->m_ctime = now;
+    }
+}
+
+Ptr<TmpfsInode>
+Tmpfs::Lookup (std::string path) const
+{
+  std::map<std::string, Ptr<TmpfsInode> >::const_iterator i = m_inodes.find (path);
+  return (i == m_inodes.end ()) ? 0 : i->second;
+}
+
+int
+Tmpfs::Open (std::string path, int flags, mode_t mode, Ptr<TmpfsInode> *inode)
+{
+  NS_LOG_FUNCTION (this << path << flags);
+  Ptr<TmpfsInode> found = Lookup (path);
+  if (found == 0)
+    {
+      if (!(flags & O_CREAT))
+        {
+          return -ENOENT;
+        }
+      Ptr<TmpfsInode> parent = Lookup (Parent (path));
+      if (parent == 0)
+        {
+          return -ENOENT;
+        }
+      if (!parent->IsDir ())
+        {
+          return -ENOTDIR;
+        }
+      found = Create<TmpfsInode> (m_nextIno++, S_IFREG | (mode & 07777));
+      m_inodes[path] = found;
+      Touch (parent, true);
+    }
+  else if ((flags & O_CREAT) && (flags & O_EXCL))
+    {
+      return -EEXIST;
+    }
+  else if ((flags & O_DIRECTORY) && !found->IsDir ())
+    {
+      return -ENOTDIR;
+    }
+  else if (found->IsDir () && (flags & O_ACCMODE) != O_RDONLY)
+    {
+      return -EISDIR;
+    }
+  else if ((flags & O_TRUNC) && (flags & O_ACCMODE) != O_RDONLY)
+    {
+      Truncate (found, 0);
+    }
+  *inode = found;
+  return 0;
+}
+
+int
+Tmpfs::Mkdir (std::string path, mode_t mode)
+{
+  NS_LOG_FUNCTION (this << path);
+  if (Lookup (path) != 0)
+    {
+      return -EEXIST;
+    }
+  Ptr<TmpfsInode> parent = Lookup (Parent (path));
+  if (parent == 0)
+    {
+      return -ENOENT;
+    }
+  if (!parent->IsDir ())
+    {
+      return -ENOTDIR;
+    }
+  m_inodes[path] = Create<TmpfsInode> (m_nextIno++, S_IFDIR | (mode & 07777));
+  Touch (parent, true);
+  return 0;
+}
+
+int
+Tmpfs::Rmdir (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::map<std::string, Ptr<TmpfsInode> >::iterator i = m_inodes.find (path);
+  if (i == m_inodes.end ())
+    {
+      return -ENOENT;
+    }
+  if (!i->second->IsDir ())
+    {
+      return -ENOTDIR;
+    }
+  if (path.empty ())
+    {
+      return -EBUSY;
+    }
+  // not the next key: dir.bak or dir-x sort between dir and dir/.
+  std::string prefix = path + "/";
+  std::map<std::string, Ptr<TmpfsInode> >::iterator child = m_inodes.lower_bound (prefix);
+  if (child != m_inodes.end () && child->first.compare (0, prefix.size (), prefix) == 0)
+    {
+      return -ENOTEMPTY;
+    }
+  m_inodes.erase (i);
+  Touch (Lookup (Parent (path)), true);
+  return 0;
+}
+
+int
+Tmpfs::Unlink (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::map<std::string, Ptr<TmpfsInode> >::iterator i = m_inodes.find (path);
+  if (i == m_inodes.end ())
+    {
+      return -ENOENT;
+    }
+  if (i->second->IsDir ())
+    {
+      return -EISDIR;
+    }
+  // the pages are freed with the inode, once closed, and count until
+  // then: an open file keeps its space, as on Linux.
+  Release ();
+  m_unlinked.push_back (i->second);
+  m_inodes.erase (i);
+  Touch (Lookup (Parent (path)), true);
+  return 0;
+}
+
+int
+Tmpfs::Rename (std::string from, std::string to)
+{
+  NS_LOG_FUNCTION (this << from << to);
+  Ptr<TmpfsInode> inode = Lookup (from);
+  if (inode == 0)
+    {
+      return -ENOENT;
+    }
+  if (from.empty () || to.empty ())
+    {
+      return -EBUSY;
+    }
+  if (from == to)
+    {
+      return 0;
+    }
+  Ptr<TmpfsInode> parent = Lookup (Parent (to));
+  if (parent == 0)
+    {
+      return -ENOENT;
+    }
+  if (to.compare (0, from.size () + 1, from + "/") == 0)
+    {
+      return -EINVAL;
+    }
+  Ptr<TmpfsInode> target = Lookup (to);
+  if (target != 0)
+    {
+      int status = inode->IsDir () ? (target->IsDir () ? Rmdir (to) : -ENOTDIR)
+        : (target->IsDir () ? -EISDIR : Unlink (to));
+      if (status < 0)
+        {
+          return status;
+        }
+    }
+  m_inodes.erase (from);
+  m_inodes[to] = inode;
+  if (inode->IsDir ())
+    {
+      // the entries below it
+      std::string prefix = from + "/";
+      std::map<std::string, Ptr<TmpfsInode> >::iterator i = m_inodes.lower_bound (prefix);
+      std::vector<std::pair<std::string, Ptr<TmpfsInode> > > moved;
+      while (i != m_inodes.end () && i->first.compare (0, prefix.size (), prefix) == 0)
+        {
+          moved.push_back (std::make_pair (to + "/" + i->first.substr (prefix.size ()), i->second));
+          m_inodes.erase (i++);
+        }
+      m_inodes.insert (moved.begin (), moved.end ());
+    }
+  Touch (Lookup (Parent (from)), true);
+  Touch (parent, true);
+  return 0;
+}
+
+int
+Tmpfs::Stat (std::string path, struct stat *buf) const
+{
+  Ptr<TmpfsInode> inode = Lookup (path);
+  if (inode == 0)
+    {
+      return -ENOENT;
+    }
+  inode->Stat (buf);
+  return 0;
+}
+
+int
+Tmpfs::Stat64 (std::string path, struct stat64 *buf) const
+{
+  Ptr<TmpfsInode> inode = Lookup (path);
+  if (inode == 0)
+    {
+      return -ENOENT;
+    }
+  inode->Stat64 (buf);
+  return 0;
+}
+
+int
+Tmpfs::List (std::string path, std::vector<std::string> *names) const
+{
+  Ptr<TmpfsInode> inode = Lookup (path);
+  if (inode == 0)
+    {
+      return -ENOENT;
+    }
+  if (!inode->IsDir ())
+    {
+      return -ENOTDIR;
+    }
+  std::string prefix = path.empty () ? "" : path + "/";
+  std::map<std::string, Ptr<TmpfsInode> >::const_iterator i = m_inodes.lower_bound (prefix);
+  for (; i != m_inodes.end () && i->first.compare (0, prefix.size (), prefix) == 0; ++i)
+    {
+      std::string name = i->first.substr (prefix.size ());
+      if (!name.empty () && name.find ('/') == std::string::npos)
+        {
+          names->push_back (name);
+        }
+    }
+  return 0;
+}
+
+ssize_t
+Tmpfs::Read (Ptr<TmpfsInode> inode, void *buf, size_t count, uint64_t offset)
+{
+  if (inode->IsDir ())
+    {
+      return -EISDIR;
+    }
+  if (offset >= inode->m_size)
+    {
+      return 0;
+    }
+  count = std::min<uint64_t> (count, inode->m_size - offset);
+  uint8_t *out = (uint8_t *) buf;
+  size_t done = 0;
+  while (done < count)
+    {
+      uint64_t page = (offset + done) / TmpfsInode::PAGE_SIZE;
+      size_t start = (offset + done) % TmpfsInode::PAGE_SIZE;
+      size_t len = std::min<size_t> (count - done, TmpfsInode::PAGE_SIZE - start);
+      std::map<uint64_t, uint8_t *>::const_iterator i = inode->m_pages.find (page);
+      if (i == inode->m_pages.end ())
+        {
+          // a hole
+          memset (out + done, 0, len);
+        }
+      else
+        {
+          memcpy (out + done, i->second + start, len);
+        }
+      done += len;
+    }
+  Touch (inode, false);
+  return count;
+}
+
+ssize_t
+Tmpfs::Write (Ptr<TmpfsInode> inode, const void *buf, size_t count, uint64_t offset)
+{
+  if (inode->IsDir ())
+    {
+      return -EISDIR;
+    }
+  const uint8_t *in = (const uint8_t *) buf;
+  size_t done = 0;
+  while (done < count)
+    {
+      uint64_t page = (offset + done) / TmpfsInode::PAGE_SIZE;
+      size_t start = (offset + done) % TmpfsInode::PAGE_SIZE;
+      size_t len = std::min<size_t> (count - done, TmpfsInode::PAGE_SIZE - start);
+      std::map<uint64_t, uint8_t *>::iterator i = inode->m_pages.find (page);
+      if (i == inode->m_pages.end ())
+        {
+          if (m_maxSize != 0 && m_used + TmpfsInode::PAGE_SIZE > m_maxSize)
+            {
+              // the unlinked files closed since give their pages back.
+              Release ();
+            }
+          if (m_maxSize != 0 && m_used + TmpfsInode::PAGE_SIZE > m_maxSize)
+            {
+              break;
+            }
+          uint8_t *data = new uint8_t [TmpfsInode::PAGE_SIZE];
+          memset (data, 0, TmpfsInode::PAGE_SIZE);
+          i = inode->m_pages.insert (std::make_pair (page, data)).first;
+          m_used += TmpfsInode::PAGE_SIZE;
+        }
+      memcpy (i->second + start, in + done, len);
+      done += len;
+    }
+  if (done == 0 && count != 0)
+    {
+      return -ENOSPC;
+    }
+  inode->m_size = std::max<uint64_t> (inode->m_size, offset + done);
+  Touch (inode, true);
+  return done;
+}
+
+void
+Tmpfs::FreePages (Ptr<TmpfsInode> inode, uint64_t from)
+{
+  std::map<uint64_t, uint8_t *>::iterator i = inode->m_pages.lower_bound (from);
+  while (i != inode->m_pages.end ())
+    {
+      delete [] i->second;
+      m_used -= TmpfsInode::PAGE_SIZE;
+      inode->m_pages.erase (i++);
+    }
+}
+
+int
+Tmpfs::Truncate (Ptr<TmpfsInode> inode, uint64_t length)
+{
+  if (inode->IsDir ())
+    {
+      return -EISDIR;
+    }
+  if (length < inode->m_size)
+    {
+      uint64_t keep = (length + TmpfsInode::PAGE_SIZE - 1) / TmpfsInode::PAGE_SIZE;
+      FreePages (inode, keep);
+      size_t start = length % TmpfsInode::PAGE_SIZE;
+      std::map<uint64_t, uint8_t *>::iterator i = inode->m_pages.find (length / TmpfsInode::PAGE_SIZE);
+      if (start != 0 && i != inode->m_pages.end ())
+        {
+          // what is read again after extending the file is zero.
+          memset (i->second + start, 0, TmpfsInode::PAGE_SIZE - start);
+        }
+    }
+  inode->m_size = length;
+  Touch (inode, true);
+  return 0;
+}
+
+uint64_t
+Tmpfs::GetReleased (void) const
+{
+  uint64_t released = 0;
+  for (std::vector<Ptr<TmpfsInode> >::const_iterator i = m_unlinked.begin ();
+       i != m_unlinked.end (); ++i)
+    {
+      // only referenced here.
+      if ((*i)->GetReferenceCount () == 1)
+        {
+          released += (*i)->m_pages.size () * TmpfsInode::PAGE_SIZE;
+        }
+    }
+  return released;
+}
+
+void
+Tmpfs::Release (void)
+{
+  m_used -= GetReleased ();
+  std::vector<Ptr<TmpfsInode> >::iterator i = m_unlinked.begin ();
+  while (i != m_unlinked.end ())
+    {
+      if ((*i)->GetReferenceCount () == 1)
+        {
+          i = m_unlinked.erase (i);
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
+uint64_t
+Tmpfs::GetUsed (void) const
+{
+  return m_used - GetReleased ();
+}
+
+void
+Tmpfs::Dump (std::string dir) const
+{
+  NS_LOG_FUNCTION (this << dir);
+  UtilsEnsureAllDirectoriesExist (dir + "/");
+  // in path order: the directories before their entries.
+  for (std::map<std::string, Ptr<TmpfsInode> >::const_iterator i = m_inodes.begin ();
+       i != m_inodes.end (); ++i)
+    {
+      if (i->first.empty ())
+        {
+          continue;
+        }
+      std::string path = dir + "/" + i->first;
+      Ptr<TmpfsInode> inode = i->second;
+      if (inode->IsDir ())
+        {
+          ::mkdir (path.c_str (), inode->m_mode & 07777);
+          continue;
+        }
+      int fd = ::open (path.c_str (), O_WRONLY | O_CREAT | O_TRUNC, inode->m_mode & 07777);
+      if (fd == -1)
+        {
+          NS_LOG_WARN ("could not dump " << path << ": " << strerror (errno));
+          continue;
+        }
+      for (std::map<uint64_t, uint8_t *>::const_iterator j = inode->m_pages.begin ();
+           j != inode->m_pages.end (); ++j)
+        {
+          uint64_t offset = j->first * TmpfsInode::PAGE_SIZE;
+          if (offset >= inode->m_size)
+            {
+              break;
+            }
+          size_t len = std::min<uint64_t> (TmpfsInode::PAGE_SIZE, inode->m_size - offset);
+          if (::pwrite (fd, j->second, len, offset) != (ssize_t) len)
+            {
+              NS_LOG_WARN ("could not dump " << path << ": " << strerror (errno));
+              break;
+            }
+        }
+      // the holes
+      if (::ftruncate (fd, inode->m_size) == -1)
+        {
+          NS_LOG_WARN ("could not dump " << path << ": " << strerror (errno));
+        }
+      ::close (fd);
+    }
+}
+
+} // namespace ns3
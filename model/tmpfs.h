@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef TMPFS_H
+#define TMPFS_H
+
+#include "ns3/object.h"
+#include "ns3/simple-ref-count.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * A file or a directory of a Tmpfs. The data of a file is kept in pages
+ * allocated when they are written: the holes of a sparse file cost
+ * nothing. An inode stays alive while a TmpfsFd uses it, even unlinked,
+ * and its pages count in the size of the Tmpfs until it is freed.
+ */
+class TmpfsInode : public SimpleRefCount<TmpfsInode>
+{
+public:
+  enum
+  {
+    PAGE_SIZE = 4096
+  };
+  TmpfsInode (ino_t ino, mode_t mode);
+  ~TmpfsInode ();
+
+  bool IsDir (void) const;
+  uint64_t GetSize (void) const;
+  void Stat (struct stat *buf) const;
+  void Stat64 (struct stat64 *buf) const;
+
+private:
+  friend class Tmpfs;
+  ino_t m_ino;
+  mode_t m_mode; // with S_IFREG or S_IFDIR
+  uint64_t m_size;
+  std::map<uint64_t, uint8_t *> m_pages; // by page index
+  struct timespec m_atime;
+  struct timespec m_mtime;
+  struct timespec m_ctime;
+};
+
+/**
+ * \brief A file system in memory for a path of a node, /tmp or /var/log
+ * for example, instead of the files of the host under files-N.
+ *
+ * The paths given to the methods are relative to the mount point,
+ * without leading slash: "" is the root of the file system. The methods
+ * return -errno on error. See DceManager::Mount and
+ * DceManagerHelper::AddTmpfs.
+ */
+class Tmpfs : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  Tmpfs ();
+  virtual ~Tmpfs ();
+
+  // set by DceManager::Mount, for Dump.
+  void SetMountPoint (uint32_t nodeId, std::string path);
+
+  Ptr<TmpfsInode> Lookup (std::string path) const;
+  // flags of open(2): O_CREAT, O_EXCL, O_TRUNC, O_DIRECTORY.
+  int Open (std::string path, int flags, mode_t mode, Ptr<TmpfsInode> *inode);
+  int Mkdir (std::string path, mode_t mode);
+  int Rmdir (std::string path);
+  int Unlink (std::string path);
+  int Rename (std::string from, std::string to);
+  int Stat (std::string path, struct stat *buf) const;
+  int Stat64 (std::string path, struct stat64 *buf) const;
+  // the names of the entries of the directory at path.
+  int List (std::string path, std::vector<std::string> *names) const;
+
+  ssize_t Read (Ptr<TmpfsInode> inode, void *buf, size_t count, uint64_t offset);
+  ssize_t Write (Ptr<TmpfsInode> inode, const void *buf, size_t count, uint64_t offset);
+  int Truncate (Ptr<TmpfsInode> inode, uint64_t length);
+
+  // bytes of the pages allocated.
+  uint64_t GetUsed (void) const;
+  // Write the files to dir, on the disk of the host.
+  void Dump (std::string dir) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  static std::string Parent (std::string path);
+  void FreePages (Ptr<TmpfsInode> inode, uint64_t from);
+  void Touch (Ptr<TmpfsInode> inode, bool modified) const;
+  // the bytes of the pages of the unlinked inodes nobody uses anymore.
+  uint64_t GetReleased (void) const;
+  // forget them, their pages are freed.
+  void Release (void);
+
+  std::map<std::string, Ptr<TmpfsInode> > m_inodes;
+  // the unlinked inodes, until their last TmpfsFd is closed.
+  std::vector<Ptr<TmpfsInode> > m_unlinked;
+  uint64_t m_maxSize;
+  uint64_t m_used;
+  bool m_dump;
+  ino_t m_nextIno;
+  uint32_t m_nodeId;
+  std::string m_mountPoint;
+};
+
+} // namespace ns3
+
+#endif /* TMPFS_H */
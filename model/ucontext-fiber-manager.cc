@@ -280,6 +280,11 @@ UcontextFiberManager::SetSwitchNotification (void (*fn)(void))
 {
   m_notifySwitch = fn;
 }
+bool
+UcontextFiberManager::IsForkSafe (void) const
+{
+  return true;
+}
 
 
 
@@ -22,6 +22,7 @@ public:
                          const struct Fiber *to);
   virtual uint32_t GetStackSize (struct Fiber *fiber) const;
   virtual void SetSwitchNotification (void (*fn)(void));
+  virtual bool IsForkSafe (void) const;
 private:
   static void SegfaultHandler (int sig, siginfo_t *si, void *unused);
   // invoked as atexit handler
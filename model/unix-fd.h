@@ -65,7 +65,7 @@ public:
   friend class DceManager;
 protected:
   UnixFd ();
-  void RemoveWaitQueue (WaitQueueEntry*, bool andUnregister);
+  virtual void RemoveWaitQueue (WaitQueueEntry*, bool andUnregister);
   void AddWaitQueue (WaitQueueEntry*, bool andRegister);
   void WakeWaiters (void *key);
   int m_fdFlags;
@@ -5,7 +5,9 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "task-manager.h"
+#include "wait-queue.h"
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <poll.h>
 
@@ -14,21 +16,29 @@ NS_LOG_COMPONENT_DEFINE ("UnixTimerFd");
 namespace ns3 {
 
 UnixTimerFd::UnixTimerFd (int clockid, int flags)
-  : m_period (Seconds (0.0)),
-    m_skipped (0),
-    m_timer (),
-    m_waiter (0)
-{
+  : m_armed (false),
+    m_closed (false),
+    m_expire (Seconds (0.0)),
+    m_period (Seconds (0.0)),
+    m_timer ()
+{
+  // TFD_NONBLOCK and TFD_CLOEXEC have the values of their O_ counterparts.
+  m_statusFlags = flags & O_NONBLOCK;
+  if (flags & O_CLOEXEC)
+    {
+      m_fdFlags = FD_CLOEXEC;
+    }
 }
 
 int
 UnixTimerFd::Close (void)
 {
   m_timer.Cancel ();
-  if (m_waiter != 0)
-    {
-      m_waiter->process->manager->Wakeup (m_waiter);
-    }
+  m_armed = false;
+  m_closed = true;
+  // no expiration will wake up the readers any more.
+  short ph = POLLHUP;
+  WakeWaiters (&ph);
   return 0;
 }
 
@@ -49,20 +59,58 @@ UnixTimerFd::Read (void *buf, size_t count)
       current->err = EINVAL;
       return -1;
     }
-  uint64_t *counter = (uint64_t *)buf;
-  if (m_skipped > 0)
+  WaitQueueEntryTimeout *wq = 0;
+  uint64_t expirations;
+  while ((expirations = GetExpirations ()) == 0)
     {
-      *counter = m_skipped;
-      m_skipped = 0;
-      return 0;
-    }
-  m_waiter = current;
-  current->process->manager->Wait ();
-  m_waiter = 0;
-  *counter = m_skipped;
-  m_skipped = 0;
+      if (m_closed)
+        {
+          current->err = EBADF;
+          RETURNFREE (-1);
+        }
+      if (m_statusFlags & O_NONBLOCK)
+        {
+          current->err = EAGAIN;
+          RETURNFREE (-1);
+        }
+      ScheduleWakeup ();
+      if (!wq)
+        {
+          wq = new WaitQueueEntryTimeout (POLLIN | POLLHUP, Time (0));
+        }
+      AddWaitQueue (wq, true);
+      PollTable::Result res = wq->Wait ();
+      RemoveWaitQueue (wq, true);
 
-  return 0;
+      switch (res)
+        {
+        case PollTable::OK:
+          break;
+        case PollTable::INTERRUPTED:
+          {
+            UtilsDoSignal ();
+            current->err = EINTR;
+            RETURNFREE (-1);
+          }
+          break;
+        case PollTable::TIMEOUT:
+          {
+            current->err = EAGAIN;
+            RETURNFREE (-1);
+          }
+          break;
+        }
+    }
+  if (m_period.IsZero ())
+    {
+      m_armed = false;
+    }
+  else
+    {
+      m_expire += NanoSeconds (m_period.GetNanoSeconds () * expirations);
+    }
+  *(uint64_t *)buf = expirations;
+  RETURNFREE (8);
 }
 ssize_t
 UnixTimerFd::Recvmsg (struct msghdr *msg, int flags)
@@ -200,64 +248,89 @@ UnixTimerFd::Fxstat64 (int ver, struct ::stat64 *buf)
 int
 UnixTimerFd::Fcntl (int cmd, unsigned long arg)
 {
-  // XXX: this really needs to be fixed
-  return 0;
+  NS_LOG_FUNCTION (this << cmd << arg);
+  switch (cmd)
+    {
+    case F_GETFL:
+    case F_SETFL:
+    case F_GETFD:
+    case F_SETFD:
+      // O_NONBLOCK is all read looks at.
+      return UnixFd::Fcntl (cmd, arg);
+    default:
+      Current ()->err = EINVAL;
+      return -1;
+    }
 }
-void
-UnixTimerFd::TimerExpired (void)
+uint64_t
+UnixTimerFd::GetExpirations (void) const
 {
-  if (!m_period.IsZero ())
+  Time now = Now ();
+  if (!m_armed || now < m_expire)
+    {
+      return 0;
+    }
+  if (m_period.IsZero ())
     {
-      m_timer = Simulator::Schedule (m_period,
-                                     &UnixTimerFd::TimerExpired,
-                                     this);
+      return 1;
     }
-  m_skipped++;
-  if (m_waiter != 0)
+  return 1 + (now - m_expire).GetNanoSeconds () / m_period.GetNanoSeconds ();
+}
+void
+UnixTimerFd::ScheduleWakeup (void)
+{
+  if (!m_armed || m_timer.IsRunning ())
     {
-      m_waiter->process->manager->Wakeup (m_waiter);
+      return;
     }
+  NS_LOG_FUNCTION (this << m_expire);
+  m_timer = TaskManager::Current ()->ScheduleMain (m_expire - Now (),
+                                                   MakeEvent (&UnixTimerFd::TimerExpired, this));
 }
 void
-UnixTimerFd::SettimeMain (Time t)
+UnixTimerFd::TimerExpired (void)
 {
-  m_timer =  Simulator::Schedule (t,
-                                  &UnixTimerFd::TimerExpired,
-                                  this);
+  NS_LOG_FUNCTION (this);
+  short pi = POLLIN;
+  WakeWaiters (&pi);
 }
 int
 UnixTimerFd::Settime (int flags,
                       const struct itimerspec *new_value,
                       struct itimerspec *old_value)
 {
+  NS_LOG_FUNCTION (this << flags << new_value << old_value);
   NS_ASSERT (flags == 0);
   if (old_value != 0)
     {
       Gettime (old_value);
     }
-  m_skipped = 0;
+  // someone is blocked if a wakeup is pending.
+  bool waited = m_timer.IsRunning ();
   m_timer.Cancel ();
   m_period = UtilsTimespecToTime (new_value->it_interval);
   Time initial = UtilsTimespecToTime (new_value->it_value);
-  if (!initial.IsZero ())
+  m_armed = !initial.IsZero ();
+  m_expire = Now () + initial;
+  if (waited)
     {
-      TaskManager::Current ()->ExecOnMain (MakeEvent (&UnixTimerFd::SettimeMain,
-                                                      this, initial));
+      ScheduleWakeup ();
     }
   return 0;
 }
 int
 UnixTimerFd::Gettime (struct itimerspec *cur_value) const
 {
-  if (!m_timer.IsRunning ())
+  uint64_t expirations = GetExpirations ();
+  if (!m_armed || (expirations > 0 && m_period.IsZero ()))
     {
       cur_value->it_value.tv_sec = 0;
       cur_value->it_value.tv_nsec = 0;
     }
   else
     {
-      Time left = Simulator::GetDelayLeft (m_timer);
-      cur_value->it_value = UtilsTimeToTimespec (left);
+      Time next = m_expire + NanoSeconds (m_period.GetNanoSeconds () * expirations);
+      cur_value->it_value = UtilsTimeToTimespec (next - Now ());
     }
   cur_value->it_interval = UtilsTimeToTimespec (m_period);
   return 0;
@@ -266,8 +339,7 @@ UnixTimerFd::Gettime (struct itimerspec *cur_value) const
 bool
 UnixTimerFd::CanRecv (void) const
 {
-  // XXX ?
-  return false;
+  return GetExpirations () > 0;
 }
 bool
 UnixTimerFd::CanSend (void) const
@@ -277,7 +349,7 @@ UnixTimerFd::CanSend (void) const
 bool
 UnixTimerFd::HangupReceived (void) const
 {
-  return false;
+  return m_closed;
 }
 int
 UnixTimerFd::Poll (PollTable* ptable)
@@ -300,6 +372,10 @@ UnixTimerFd::Poll (PollTable* ptable)
   if (ptable)
     {
       ptable->PollWait (this);
+      if (ret == 0)
+        {
+          ScheduleWakeup ();
+        }
     }
 
   return ret;
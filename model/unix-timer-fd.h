@@ -49,13 +49,20 @@ public:
   virtual int Fsync (void);
 
 private:
+  // Expirations since the last read, counted from the clock.
+  uint64_t GetExpirations (void) const;
+  void ScheduleWakeup (void);
   void TimerExpired (void);
-  void SettimeMain (Time t);
 
+  // A periodic timer does not schedule one event per period: the
+  // expirations are counted when the fd is read or polled, and an event
+  // is scheduled only to wake up a blocked reader or poller.
+  bool m_armed;
+  // a reader blocked when the fd is closed gets EBADF.
+  bool m_closed;
+  Time m_expire; // first expiration not read yet.
   Time m_period;
-  uint64_t m_skipped;
   EventId m_timer;
-  Thread * m_waiter;
 };
 
 } // namespace ns3
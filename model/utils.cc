@@ -3,6 +3,7 @@
 #include "unix-fd.h"
 #include "process.h"
 #include "task-manager.h"
+#include "dce-poll.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include <sstream>
@@ -14,9 +15,14 @@
 #include <list>
 #include <fcntl.h>
 #include <unistd.h>
+#include <time.h>
 #include "file-usage.h"
 #include "ns3/global-value.h"
 #include "ns3/uinteger.h"
+#include "ns3/string.h"
+#ifdef DCE_MPI
+#include "ns3/mpi-interface.h"
+#endif
 
 NS_LOG_COMPONENT_DEFINE ("ProcessUtils");
 
@@ -30,6 +36,13 @@ GlobalValue g_timeBase = GlobalValue ("SimulationTimeBase",
   //   unsigned long secondsSinceEpochOnFridayApril042008 = 1207284276;
   //   return secondsSinceEpochOnFridayApril042008;
 
+GlobalValue g_filesBase = GlobalValue ("DceFilesBase",
+                                       "A directory shared by the files of all the nodes, read only: "
+                                       "what is not in files-N is read from there, and copied to "
+                                       "files-N to be written. Empty for none.",
+                                       StringValue (""),
+                                       MakeStringChecker ());
+
 uint32_t UtilsGetNodeId (void)
 {
   if (gDisposingThreadContext)
@@ -38,6 +51,44 @@ uint32_t UtilsGetNodeId (void)
     }
   return Simulator::GetContext ();
 }
+uint32_t UtilsGetSystemId (void)
+{
+#ifdef DCE_MPI
+  return MpiInterface::GetSystemId ();
+#else
+  return 0;
+#endif
+}
+uint32_t UtilsGetSystemCount (void)
+{
+#ifdef DCE_MPI
+  if (MpiInterface::IsEnabled ())
+    {
+      return MpiInterface::GetSize ();
+    }
+#endif
+  return 1;
+}
+std::string UtilsGetRankFile (std::string name, uint32_t systemId)
+{
+  if (systemId == 0)
+    {
+      return name;
+    }
+  std::ostringstream oss;
+  oss << name << "-" << systemId;
+  return oss.str ();
+}
+std::string UtilsGetExitProcsFile (uint32_t systemId)
+{
+  return UtilsGetRankFile ("exitprocs", systemId);
+}
+uint64_t UtilsGetHostTime (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
 static std::string UtilsGetRealFilePath (uint32_t node)
 {
   std::ostringstream oss;
@@ -58,6 +109,135 @@ std::string UtilsGetAbsRealFilePath (uint32_t node, std::string path)
   return nodeDir + path;
 }
 
+/*
+ * The files of a node are in two layers: files-N, written by the node,
+ * over the base layer DceFilesBase, shared by all the nodes and never
+ * written. A file of the base layer is copied to files-N the first time
+ * it is written. A file of the base layer which is deleted is hidden by
+ * a whiteout, an empty .wh.<name> file in the directory of files-N, and
+ * one which is replaced by a new file, after it was deleted, by a
+ * .wh..opq.<name> file: nothing below it comes from the base layer
+ * anymore.
+ */
+static std::string
+UtilsGetFilesBase (void)
+{
+  StringValue value;
+  g_filesBase.GetValue (value);
+  return value.Get ();
+}
+
+static bool
+UtilsExists (std::string realPath)
+{
+  struct stat st;
+  return ::lstat (realPath.c_str (), &st) == 0;
+}
+
+// true if the base layer is hidden at path or at one of its parents.
+static bool
+UtilsIsHidden (std::string nodeDir, std::string path)
+{
+  std::string::size_type start = 1;
+  while (start < path.size ())
+    {
+      std::string::size_type end = path.find ('/', start);
+      if (end == std::string::npos)
+        {
+          end = path.size ();
+        }
+      std::string parent = nodeDir + path.substr (0, start);
+      std::string name = path.substr (start, end - start);
+      if (!name.empty () && name != "." && name != ".."
+          && (UtilsExists (parent + ".wh." + name) || UtilsExists (parent + ".wh..opq." + name)))
+        {
+          return true;
+        }
+      start = end + 1;
+    }
+  return false;
+}
+
+static int
+UtilsCopyFile (std::string from, std::string to, mode_t mode)
+{
+  int in = ::open (from.c_str (), O_RDONLY);
+  if (in == -1)
+    {
+      return -1;
+    }
+  int out = ::open (to.c_str (), O_WRONLY | O_CREAT | O_EXCL, mode & 07777);
+  if (out == -1)
+    {
+      ::close (in);
+      return -1;
+    }
+  char buffer[65536];
+  ssize_t len;
+  while ((len = ::read (in, buffer, sizeof (buffer))) > 0)
+    {
+      if (::write (out, buffer, len) != len)
+        {
+          len = -1;
+          break;
+        }
+    }
+  ::close (in);
+  ::close (out);
+  return (len == 0) ? 0 : -1;
+}
+
+// Hide the entry of the base layer at path, a virtual path.
+static void
+UtilsWhiteout (std::string nodeDir, std::string path)
+{
+  std::string::size_type slash = path.rfind ('/');
+  std::string parent = path.substr (0, slash + 1);
+  std::string name = path.substr (slash + 1);
+  UtilsGetWritableFilePath (parent, false);
+  int fd = ::open ((nodeDir + parent + ".wh." + name).c_str (), O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR);
+  if (fd != -1)
+    {
+      ::close (fd);
+    }
+  ::unlink ((nodeDir + parent + ".wh..opq." + name).c_str ());
+}
+
+// true if the merged directory at path has no entry, base being "" if
+// the base layer has no directory at path.
+static bool
+UtilsIsDirEmpty (std::string nodeDir, std::string base, std::string path)
+{
+  bool empty = true;
+  ::DIR *dir = base.empty () ? 0 : ::opendir ((base + path).c_str ());
+  if (dir != 0 && !UtilsIsHidden (nodeDir, path))
+    {
+      struct dirent *entry;
+      while (empty && (entry = ::readdir (dir)) != 0)
+        {
+          std::string name = entry->d_name;
+          empty = name == "." || name == ".."
+            || UtilsExists (nodeDir + path + "/.wh." + name);
+        }
+    }
+  if (dir != 0)
+    {
+      ::closedir (dir);
+    }
+  dir = ::opendir ((nodeDir + path).c_str ());
+  if (dir != 0)
+    {
+      struct dirent *entry;
+      while (empty && (entry = ::readdir (dir)) != 0)
+        {
+          std::string name = entry->d_name;
+          empty = name == "." || name == ".." || name.compare (0, 4, ".wh.") == 0;
+        }
+      ::closedir (dir);
+    }
+  return empty;
+}
+
 std::string
 UtilsGetRealFilePath (std::string path)
 {
@@ -65,7 +245,227 @@ UtilsGetRealFilePath (std::string path)
 
   std::string nodeDir = UtilsGetRealFilePath ();
   UtilsEnsureDirectoryExists (nodeDir);
-  return nodeDir + UtilsGetVirtualFilePath (path);
+  std::string vpath = UtilsGetVirtualFilePath (path);
+  std::string base = UtilsGetFilesBase ();
+  if (base.empty () || UtilsExists (nodeDir + vpath)
+      || UtilsIsHidden (nodeDir, vpath) || !UtilsExists (base + vpath))
+    {
+      return nodeDir + vpath;
+    }
+  return base + vpath;
+}
+
+std::string
+UtilsGetWritableFilePath (std::string path, bool create)
+{
+  NS_LOG_FUNCTION (Current () << path << create);
+
+  std::string nodeDir = UtilsGetRealFilePath ();
+  UtilsEnsureDirectoryExists (nodeDir);
+  std::string vpath = UtilsGetVirtualFilePath (path);
+  std::string upper = nodeDir + vpath;
+  std::string base = UtilsGetFilesBase ();
+  if (base.empty () || UtilsExists (upper))
+    {
+      return upper;
+    }
+  std::string::size_type slash = vpath.rfind ('/');
+  if (slash != std::string::npos && slash > 0)
+    {
+      UtilsGetWritableFilePath (vpath.substr (0, slash), false);
+    }
+  if (UtilsIsHidden (nodeDir, vpath))
+    {
+      if (create && slash != std::string::npos)
+        {
+          // the new file replaces the one deleted.
+          std::string parent = nodeDir + vpath.substr (0, slash + 1);
+          std::string name = vpath.substr (slash + 1);
+          ::rename ((parent + ".wh." + name).c_str (), (parent + ".wh..opq." + name).c_str ());
+        }
+      return upper;
+    }
+  struct stat st;
+  if (::lstat ((base + vpath).c_str (), &st) == -1)
+    {
+      return upper;
+    }
+  NS_LOG_DEBUG ("copy up " << base + vpath);
+  if (S_ISDIR (st.st_mode))
+    {
+      ::mkdir (upper.c_str (), st.st_mode & 07777);
+    }
+  else if (S_ISLNK (st.st_mode))
+    {
+      char target[PATH_MAX];
+      ssize_t len = ::readlink ((base + vpath).c_str (), target, sizeof (target) - 1);
+      if (len >= 0)
+        {
+          target[len] = 0;
+          ::symlink (target, upper.c_str ());
+        }
+    }
+  else if (S_ISREG (st.st_mode))
+    {
+      if (UtilsCopyFile (base + vpath, upper, st.st_mode) == -1)
+        {
+          ::unlink (upper.c_str ());
+        }
+    }
+  return upper;
+}
+
+int
+UtilsRemoveFile (std::string path, bool dir)
+{
+  NS_LOG_FUNCTION (Current () << path << dir);
+
+  std::string nodeDir = UtilsGetRealFilePath ();
+  UtilsEnsureDirectoryExists (nodeDir);
+  std::string vpath = UtilsGetVirtualFilePath (path);
+  std::string upper = nodeDir + vpath;
+  std::string base = UtilsGetFilesBase ();
+  if (base.empty ())
+    {
+      return dir ? ::rmdir (upper.c_str ()) : ::unlink (upper.c_str ());
+    }
+  std::string::size_type slash = vpath.rfind ('/');
+  struct stat st;
+  bool inBase = !UtilsIsHidden (nodeDir, vpath.substr (0, slash + 1))
+    && !UtilsExists (nodeDir + vpath.substr (0, slash + 1) + ".wh." + vpath.substr (slash + 1))
+    && ::lstat ((base + vpath).c_str (), &st) == 0;
+  if (UtilsExists (upper))
+    {
+      if (dir)
+        {
+          if (!UtilsIsDirEmpty (nodeDir, inBase ? base : "", vpath))
+            {
+              errno = ENOTEMPTY;
+              return -1;
+            }
+          // the whiteouts of the directory
+          ::DIR *d = ::opendir (upper.c_str ());
+          struct dirent *entry;
+          while (d != 0 && (entry = ::readdir (d)) != 0)
+            {
+              if (strncmp (entry->d_name, ".wh.", 4) == 0)
+                {
+                  ::unlink ((upper + "/" + entry->d_name).c_str ());
+                }
+            }
+          if (d != 0)
+            {
+              ::closedir (d);
+            }
+          if (::rmdir (upper.c_str ()) == -1)
+            {
+              return -1;
+            }
+        }
+      else if (::unlink (upper.c_str ()) == -1)
+        {
+          return -1;
+        }
+    }
+  else if (!inBase || UtilsIsHidden (nodeDir, vpath))
+    {
+      errno = ENOENT;
+      return -1;
+    }
+  else if (dir && !S_ISDIR (st.st_mode))
+    {
+      errno = ENOTDIR;
+      return -1;
+    }
+  else if (!dir && S_ISDIR (st.st_mode))
+    {
+      errno = EISDIR;
+      return -1;
+    }
+  else if (dir && !UtilsIsDirEmpty (nodeDir, base, vpath))
+    {
+      errno = ENOTEMPTY;
+      return -1;
+    }
+  if (inBase)
+    {
+      UtilsWhiteout (nodeDir, vpath);
+    }
+  return 0;
+}
+
+int
+UtilsRenameFile (std::string oldPath, std::string newPath)
+{
+  NS_LOG_FUNCTION (Current () << oldPath << newPath);
+
+  std::string base = UtilsGetFilesBase ();
+  if (base.empty ())
+    {
+      return ::rename (UtilsGetRealFilePath (oldPath).c_str (),
+                       UtilsGetRealFilePath (newPath).c_str ());
+    }
+  std::string nodeDir = UtilsGetRealFilePath ();
+  std::string oldVpath = UtilsGetVirtualFilePath (oldPath);
+  std::string newVpath = UtilsGetVirtualFilePath (newPath);
+  struct stat st;
+  bool inBase = !UtilsIsHidden (nodeDir, oldVpath)
+    && ::lstat ((base + oldVpath).c_str (), &st) == 0;
+  if (inBase && S_ISDIR (st.st_mode))
+    {
+      // as overlayfs: the entries of the base layer cannot be moved.
+      errno = EXDEV;
+      return -1;
+    }
+  std::string from = UtilsGetWritableFilePath (oldPath, false);
+  std::string to = UtilsGetWritableFilePath (newPath, true);
+  if (::rename (from.c_str (), to.c_str ()) == -1)
+    {
+      return -1;
+    }
+  if (inBase)
+    {
+      UtilsWhiteout (nodeDir, oldVpath);
+    }
+  if (!UtilsIsHidden (nodeDir, newVpath) && ::lstat (to.c_str (), &st) == 0 && S_ISDIR (st.st_mode)
+      && UtilsExists (base + newVpath))
+    {
+      // nothing below the directory moved comes from the base layer.
+      std::string::size_type slash = newVpath.rfind ('/');
+      std::string marker = nodeDir + newVpath.substr (0, slash + 1) + ".wh..opq." + newVpath.substr (slash + 1);
+      int fd = ::open (marker.c_str (), O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR);
+      if (fd != -1)
+        {
+          ::close (fd);
+        }
+    }
+  return 0;
+}
+
+std::string
+UtilsGetLowerDirPath (std::string path)
+{
+  std::string base = UtilsGetFilesBase ();
+  if (base.empty ())
+    {
+      return "";
+    }
+  std::string nodeDir = UtilsGetRealFilePath ();
+  std::string vpath = UtilsGetVirtualFilePath (path);
+  struct stat st;
+  if (!UtilsExists (nodeDir + vpath) || UtilsIsHidden (nodeDir, vpath)
+      || ::stat ((base + vpath).c_str (), &st) == -1 || !S_ISDIR (st.st_mode))
+    {
+      return "";
+    }
+  return base + vpath;
+}
+
+std::string
+UtilsGetBaseFilePath (std::string path)
+{
+  std::string base = UtilsGetFilesBase ();
+  return base.empty () ? "" : base + path;
 }
 
 void
@@ -134,8 +534,7 @@ Thread * Current (void)
 }
 bool HasPendingSignal (void)
 {
-  bool isPending = sigisemptyset (&(Current ()->process->pendingSignals)) == 0;
-  return isPending;
+  return Current ()->process->pendingSignals != 0;
 }
 struct timeval UtilsTimeToTimeval (Time time)
 {
@@ -188,7 +587,8 @@ Time UtilsTimespecToTime (struct timespec tm)
 void
 UtilsSendSignal (Process *process, int signum)
 {
-  sigaddset (&process->pendingSignals, signum);
+  NS_ASSERT (signum > 0 && signum <= DCE_NSIG);
+  process->pendingSignals |= DCE_SIGBIT (signum);
   for (std::vector<Thread *>::iterator i = process->threads.begin ();
        i != process->threads.end (); ++i)
     {
@@ -206,6 +606,21 @@ UtilsSendSignal (Process *process, int signum)
   // Could not find any candidate thread to receive signal.
   // signal pending until a thread unblocks it.
 }
+static void
+UtilsDeliverSignal (struct SignalHandler *handler)
+{
+  NS_LOG_DEBUG ("deliver signal=" << handler->signal);
+  if (handler->flags & SA_SIGINFO)
+    {
+      siginfo_t info;
+      ucontext_t ctx;
+      handler->sigaction (handler->signal, &info, &ctx);
+    }
+  else
+    {
+      handler->handler (handler->signal);
+    }
+}
 void UtilsDoSignal (void)
 {
   Thread *current = Current ();
@@ -213,55 +628,90 @@ void UtilsDoSignal (void)
     {
       return;
     }
-
   // we try to check if we
   // have pending signals and we deliver them if we have any.
-  for (std::vector<SignalHandler>::iterator i = current->process->signalHandlers.begin ();
-       i != current->process->signalHandlers.end (); ++i)
+  // In the common case, there is none and this is a single test.
+  uint64_t pending = current->pendingSignals | current->process->pendingSignals;
+  while (pending != 0)
     {
-      if (sigismember (&current->signalMask, i->signal) == 1
-          && i->signal != SIGKILL
-          && i->signal != SIGSTOP)
+      int signum = __builtin_ctzll (pending) + 1;
+      uint64_t bit = DCE_SIGBIT (signum);
+      pending &= ~bit;
+      struct SignalHandler *handler = &current->process->signalHandlers[signum - 1];
+      if (handler->signal == 0)
+        {
+          // no handler: the signal stays pending.
+          continue;
+        }
+      if (sigismember (&current->signalMask, signum) == 1
+          && signum != SIGKILL
+          && signum != SIGSTOP)
         {
           // don't deliver signals which are masked
           // ignore the signal mask for SIGKILL and SIGSTOP
           // though.
           continue;
         }
-      if (sigismember (&current->pendingSignals, i->signal) == 1)
+      if (current->pendingSignals & bit)
         {
-          NS_LOG_DEBUG ("deliver signal=" << i->signal);
           // the signal is pending so, we try to deliver it.
-          if (i->flags & SA_SIGINFO)
-            {
-              siginfo_t info;
-              ucontext_t ctx;
-              i->sigaction (i->signal, &info, &ctx);
-            }
-          else
-            {
-              i->handler (i->signal);
-            }
-          sigdelset (&current->pendingSignals, i->signal);
+          UtilsDeliverSignal (handler);
+          current->pendingSignals &= ~bit;
         }
-      if (sigismember (&current->process->pendingSignals, i->signal) == 1)
+      if (current->process->pendingSignals & bit)
         {
-          NS_LOG_DEBUG ("deliver signal=" << i->signal);
-          // the signal is pending so, we try to deliver it.
-          if (i->flags & SA_SIGINFO)
+          UtilsDeliverSignal (handler);
+          current->process->pendingSignals &= ~bit;
+          if (signum == SIGALRM && current->process->itimerStalled)
             {
-              siginfo_t info;
-              ucontext_t ctx;
-              i->sigaction (i->signal, &info, &ctx);
+              UtilsItimerArm (current->process, UtilsItimerLeft (current->process));
             }
-          else
-            {
-              i->handler (i->signal);
-            }
-          sigdelset (&current->process->pendingSignals, i->signal);
         }
     }
 }
+static void
+UtilsItimerExpired (Process *process)
+{
+  if (process->itimerInterval.IsZero ())
+    {
+      UtilsSendSignal (process, SIGALRM);
+      return;
+    }
+  if (process->pendingSignals & DCE_SIGBIT (SIGALRM))
+    {
+      // The SIGALRM of an earlier expiration is not delivered yet and
+      // this one would merge with it: rather than expire for nothing
+      // every period, the timer waits for the delivery to start again.
+      process->itimerStalled = true;
+      return;
+    }
+  process->itimerExpire += process->itimerInterval;
+  process->itimer = Simulator::Schedule (process->itimerInterval,
+                                         &UtilsItimerExpired, process);
+  UtilsSendSignal (process, SIGALRM);
+}
+void
+UtilsItimerArm (Process *process, Time delay)
+{
+  NS_LOG_FUNCTION (process << delay);
+  process->itimer.Cancel ();
+  process->itimerStalled = false;
+  process->itimerExpire = Now () + delay;
+  process->itimer = TaskManager::Current ()->ScheduleMain (delay,
+                                                           MakeEvent (&UtilsItimerExpired, process));
+}
+Time
+UtilsItimerLeft (Process *process)
+{
+  if (!process->itimerStalled)
+    {
+      return Simulator::GetDelayLeft (process->itimer);
+    }
+  // the periods which went by while stalled are skipped.
+  int64_t interval = process->itimerInterval.GetNanoSeconds ();
+  int64_t late = (Now () - process->itimerExpire).GetNanoSeconds ();
+  return NanoSeconds (interval - late % interval);
+}
 int UtilsAllocateFd (void)
 {
   Thread *current = Current ();
@@ -282,19 +732,49 @@ int UtilsAllocateFd (void)
   return -1;
 }
 // Little hack to advance time when detecting a possible infinite loop.
-void UtilsAdvanceTime (Thread *current)
+int UtilsSpin (Thread *current, struct pollfd *fds, nfds_t nfds)
 {
-  Time now = Now ();
+  int count = 0;
+  Time wait = current->process->manager->NotifySpin (current);
 
-  if (now == current->lastTime)
+  if (wait.IsStrictlyPositive ())
     {
-//      NS_LOG_DEBUG ("UtilsAdvanceTime current thread wait 1ms.");
-      //current->process->manager->Wait (Time (MilliSeconds (1)));
-      NS_LOG_DEBUG ("UtilsAdvanceTime current thread wait 1µs.");
-      current->process->manager->Wait (Time (MicroSeconds (1)));
+      NS_LOG_DEBUG ("UtilsSpin current thread wait " << wait);
+      Time start = Now ();
+      int err = current->err;
+      if (nfds != 0)
+        {
+          count = PollTimeout (fds, nfds, wait);
+        }
+      else
+        {
+          current->process->manager->Wait (wait);
+        }
+      current->err = err;
+      current->process->spinSkipped += Now () - start;
     }
-
   current->lastTime = Now ();
+
+  return count;
+}
+void UtilsSpinProgress (Thread *current)
+{
+  current->spinCount = 0;
+}
+void UtilsSpinIo (Thread *current, int fd, short events, ssize_t ret)
+{
+  if (ret >= 0)
+    {
+      UtilsSpinProgress (current);
+    }
+  else if (current->err == EAGAIN)
+    {
+      struct pollfd pollFd;
+      pollFd.fd = fd;
+      pollFd.events = events;
+      pollFd.revents = 0;
+      UtilsSpin (current, &pollFd, 1);
+    }
 }
 
 std::string
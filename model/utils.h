@@ -5,6 +5,7 @@
 #include <list>
 #include <sys/time.h>
 #include <sys/stat.h>
+#include <poll.h>
 #include "ns3/nstime.h"
 
 #define GET_CURRENT(x)                                  \
@@ -33,10 +34,36 @@ extern Thread *gDisposingThreadContext;
 
 void UtilsEnsureDirectoryExists (std::string realPath);
 void UtilsEnsureAllDirectoriesExist (std::string realPath);
+// The file of the node at path to read it: the one of files-N if any,
+// else the one of the base layer DceFilesBase, see utils.cc.
 std::string UtilsGetRealFilePath (std::string path);
+// The file of the node at path to write it, in files-N: copied from the
+// base layer if it is there. With create, the file may be a new one.
+std::string UtilsGetWritableFilePath (std::string path, bool create);
+// unlink, or rmdir with dir, the file of the node at path in both layers.
+// -1 and errno on error.
+int UtilsRemoveFile (std::string path, bool dir);
+int UtilsRenameFile (std::string oldPath, std::string newPath);
+// The directory of the base layer to list with the directory of files-N
+// at path, "" if there is none.
+std::string UtilsGetLowerDirPath (std::string path);
+// path in the base layer, "" without base layer.
+std::string UtilsGetBaseFilePath (std::string path);
 std::string UtilsGetAbsRealFilePath (uint32_t node, std::string path);
 std::string UtilsGetVirtualFilePath (std::string path);
 uint32_t UtilsGetNodeId (void);
+// The MPI rank of the host process in a distributed simulation, else 0.
+uint32_t UtilsGetSystemId (void);
+// The number of MPI ranks of a distributed simulation, else 1.
+uint32_t UtilsGetSystemCount (void);
+// The file name written by the rank systemId, the ranks sharing their
+// directory: name, name-<systemId> for the other ranks than 0.
+std::string UtilsGetRankFile (std::string name, uint32_t systemId);
+// The file of the exit statuses of the processes of the rank systemId.
+std::string UtilsGetExitProcsFile (uint32_t systemId);
+// The monotonic clock of the host in nanoseconds, for the profilers: not
+// the simulated time.
+uint64_t UtilsGetHostTime (void);
 Thread * Current (void);
 bool HasPendingSignal (void);
 Time UtilsTimeToSimulationTime (Time time);
@@ -48,9 +75,23 @@ Time UtilsTimevalToTime (struct timeval tv);
 Time UtilsTimevalToTime (const struct timeval *tv);
 void UtilsSendSignal (Process *process, int signum);
 void UtilsDoSignal (void);
+// ITIMER_REAL: start the timer of process to expire in delay, then
+// every process->itimerInterval.
+void UtilsItimerArm (Process *process, Time delay);
+// Time left before the next expiration of the timer of process.
+Time UtilsItimerLeft (Process *process);
 int UtilsAllocateFd (void);
-// Little hack to advance time when detecting a possible infinite loop.
-void UtilsAdvanceTime (Thread *current);
+// Busy poll detection: called by the non-blocking calls which did not
+// make progress (poll with a 0 timeout, read giving EAGAIN,
+// sched_yield). If the thread seems to spin, wait in simulated time,
+// for one of fds to be ready if any, and return the result of the poll
+// of fds (0 without fds). See the Spin* attributes of DceManager.
+int UtilsSpin (Thread *current, struct pollfd *fds, nfds_t nfds);
+// called by the same calls when they made progress.
+void UtilsSpinProgress (Thread *current);
+// read-like call on fd which returned ret: UtilsSpin on EAGAIN,
+// UtilsSpinProgress on success.
+void UtilsSpinIo (Thread *current, int fd, short events, ssize_t ret);
 std::string GetTimeStamp ();
 bool CheckExeMode (struct stat *st, uid_t uid, gid_t gid);
 std::string FindExecFile (std::string root, std::string envPath, std::string fileName, uid_t uid, gid_t gid, int *errNo);
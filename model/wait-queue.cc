@@ -35,7 +35,8 @@ WaitQueueEntry::WaitQueueEntry ()
 {
 }
 
-WaitQueueEntryPoll::WaitQueueEntryPoll (Callback<void> cb) : m_func (cb)
+WaitQueueEntryPoll::WaitQueueEntryPoll (PollTable *table) : m_table (table),
+                                                             m_pollTableEntry (0)
 {
 }
 
@@ -52,18 +53,20 @@ WaitQueueEntryPoll::WakeUp (void *key)
 
   if ((m_pollTableEntry) && (m_pollTableEntry->IsEventMatch (event)))
     {
-      m_func ();
+      m_table->WakeUpIndex (m_pollTableEntry->GetIndex ());
     }
 }
 PollTableEntry::PollTableEntry () :  m_file (0),
                                      m_wait (0),
-                                     m_eventMask (0)
+                                     m_eventMask (0),
+                                     m_index (0)
 {
 }
-PollTableEntry::PollTableEntry (UnixFd *file, WaitQueueEntryPoll *wait, short em)
+PollTableEntry::PollTableEntry (UnixFd *file, WaitQueueEntryPoll *wait, short em, uint32_t index)
   : m_file (file),
     m_wait (wait),
-    m_eventMask (em)
+    m_eventMask (em),
+    m_index (index)
 {
 }
 PollTableEntry::~PollTableEntry ()
@@ -84,6 +87,23 @@ PollTableEntry::IsEventMatch (short e) const
 {
   return e & m_eventMask;
 }
+uint32_t
+PollTableEntry::GetIndex (void) const
+{
+  return m_index;
+}
+WaitQueueEntryPoll*
+PollTableEntry::GetWait (void) const
+{
+  return m_wait;
+}
+void
+PollTableEntry::Reset (UnixFd *file, short em, uint32_t index)
+{
+  m_file = file;
+  m_eventMask = em;
+  m_index = index;
+}
 //WaitPoint
 WaitPoint::WaitPoint () : m_waitTask (0)
 {
@@ -132,42 +152,68 @@ WaitPoint::WakeUpCallback ()
 }
 
 
-PollTable::PollTable ()
+PollTable::PollTable () : m_pollEntryUsed (0),
+                          m_eventMask (0),
+                          m_index (0),
+                          m_rescan (false)
 {
 }
 
 PollTable::~PollTable ()
 {
-  for (std::list <PollTableEntry*>::iterator i = m_pollEntryList.begin ();
+  for (std::vector<PollTableEntry*>::iterator i = m_pollEntryList.begin ();
        i != m_pollEntryList.end (); ++i)
     {
       delete (*i);
     }
   m_pollEntryList.clear ();
+  for (std::vector<PollTableEntry*>::iterator i = m_linuxEntryList.begin ();
+       i != m_linuxEntryList.end (); ++i)
+    {
+      delete (*i);
+    }
+  m_linuxEntryList.clear ();
 }
 
 void
 PollTable::PollWait (UnixFd* file)
 {
-  WaitQueueEntryPoll* we = new WaitQueueEntryPoll (MakeCallback (&PollTable::WakeUpCallback, this));
-  PollTableEntry* e = new PollTableEntry (file, we, m_eventMask);
-  we->SetPollTableEntry (e);
-  m_pollEntryList.push_back (e);
+  if (m_pollEntryUsed < m_pollEntryList.size ())
+    {
+      m_pollEntryList[m_pollEntryUsed]->Reset (file, m_eventMask, m_index);
+    }
+  else
+    {
+      WaitQueueEntryPoll* we = new WaitQueueEntryPoll (this);
+      PollTableEntry* e = new PollTableEntry (file, we, m_eventMask, m_index);
+      we->SetPollTableEntry (e);
+      m_pollEntryList.push_back (e);
+    }
+  WaitQueueEntryPoll* we = m_pollEntryList[m_pollEntryUsed]->GetWait ();
+  m_pollEntryUsed++;
   file->AddWaitQueue (we, false);
 }
 void
 PollTable::PollWait (void *ref, Callback<void, void*> cb)
 {
-  m_pollEntryList.push_back (new PollTableEntryLinux (ref, cb));
+  m_linuxEntryList.push_back (new PollTableEntryLinux (ref, cb));
 }
 void
 PollTable::FreeWait ()
 {
-  for (std::list <PollTableEntry*> :: iterator i = m_pollEntryList.begin ();
-       i != m_pollEntryList.end (); ++i)
+  for (uint32_t i = 0; i < m_pollEntryUsed; i++)
+    {
+      m_pollEntryList[i]->FreeWait ();
+    }
+  m_pollEntryUsed = 0;
+  for (std::vector<PollTableEntry*>::iterator i = m_linuxEntryList.begin ();
+       i != m_linuxEntryList.end (); ++i)
     {
       (*i)->FreeWait ();
+      delete (*i);
     }
+  m_linuxEntryList.clear ();
+  ClearReady ();
 }
 void
 PollTable::SetEventMask (short e)
@@ -179,6 +225,54 @@ PollTable::GetEventMask () const
 {
   return m_eventMask;
 }
+void
+PollTable::SetIndex (uint32_t index)
+{
+  m_index = index;
+}
+void
+PollTable::WakeUpIndex (uint32_t index)
+{
+  m_ready.push_back (index);
+  if (!m_wakeUpCb.IsNull ())
+    {
+      m_wakeUpCb ();
+      return;
+    }
+  WakeUpCallback ();
+}
+void
+PollTable::WakeUpAll (void)
+{
+  m_rescan = true;
+  if (!m_wakeUpCb.IsNull ())
+    {
+      m_wakeUpCb ();
+      return;
+    }
+  WakeUpCallback ();
+}
+void
+PollTable::SetWakeUpCallback (Callback<void> cb)
+{
+  m_wakeUpCb = cb;
+}
+bool
+PollTable::IsRescanNeeded (void) const
+{
+  return m_rescan;
+}
+const std::vector<uint32_t> &
+PollTable::GetReady (void) const
+{
+  return m_ready;
+}
+void
+PollTable::ClearReady (void)
+{
+  m_ready.clear ();
+  m_rescan = false;
+}
 WaitQueueEntryTimeout::WaitQueueEntryTimeout (short em, Time to) : m_waitTask (0),
                                                                    m_eventMask (em)
 {
@@ -24,6 +24,8 @@
 #include "ns3/callback.h"
 #include "ns3/nstime.h"
 #include <list>
+#include <vector>
+#include <stdint.h>
 
 namespace ns3 {
 
@@ -52,6 +54,7 @@ public:
 };
 
 class PollTableEntry;
+class PollTable;
 
 /**
  * WaitQueueEntry specialised for poll usage.
@@ -60,16 +63,16 @@ class WaitQueueEntryPoll : public WaitQueueEntry
 {
 public:
   /**
-   * \param: cb callback used to wake up the waiter task.
+   * \param: table poll table of the waiter task.
    */
-  WaitQueueEntryPoll (Callback<void> cb);
+  WaitQueueEntryPoll (PollTable *table);
 //  virtual ~WaitQueueEntryPoll ();
 
   virtual void WakeUp (void *key);
   void SetPollTableEntry (PollTableEntry* p);
 
 private:
-  Callback<void> const m_func;
+  PollTable * const m_table;
   PollTableEntry* m_pollTableEntry;
 };
 
@@ -86,8 +89,9 @@ public:
    * \param file: the involved file,
    * \param wait: the wait queue entry in the wait queue of the file,
    * \param eventMask: Set of wanted events
+   * \param index: index of the polled item, given back by the wakeups.
    */
-  PollTableEntry (UnixFd *file, WaitQueueEntryPoll* wait, short eventMask);
+  PollTableEntry (UnixFd *file, WaitQueueEntryPoll* wait, short eventMask, uint32_t index);
   virtual ~PollTableEntry ();
 
   /**
@@ -95,11 +99,18 @@ public:
    */
   virtual void FreeWait ();
   int IsEventMatch (short e) const;
+  uint32_t GetIndex (void) const;
+  WaitQueueEntryPoll* GetWait (void) const;
+  /**
+   * Reuse this entry (and its wait queue entry) for another file.
+   */
+  void Reset (UnixFd *file, short eventMask, uint32_t index);
 
 private:
-  UnixFd* const m_file;
+  UnixFd* m_file;
   WaitQueueEntryPoll* const m_wait;
-  short const m_eventMask;
+  short m_eventMask;
+  uint32_t m_index;
 };
 
 /**
@@ -127,6 +138,15 @@ private:
 };
 /**
  * Poll table used to store WaitQueues of waiting files.
+ *
+ * The entries are kept from one use of the table to the next one so
+ * that a thread polling the same files again and again does not
+ * allocate them again: see Thread::pollTableCache.
+ *
+ * The wakeups of the entries registered by PollWait (UnixFd*) record the
+ * index given to SetIndex at registration time so that the caller only
+ * polls again the items which may be ready. Other wakeups (WakeUpAll)
+ * ask for a poll of every item.
  */
 class PollTable : public WaitPoint
 {
@@ -134,17 +154,39 @@ public:
   PollTable ();
   ~PollTable ();
 
-  // Remove from every wait queues
+  // Remove from every wait queues and forget the ready items.
   void FreeWait ();
   // Add new file to Poll table and add corresponding poll table entry to file's wait queue.
   void PollWait (UnixFd* file);
   void PollWait (void *ref, Callback<void, void*> cb);
   void SetEventMask (short e);
   short GetEventMask () const;
+  // index of the item registered by the next calls to PollWait.
+  void SetIndex (uint32_t index);
+
+  // called by the entry of item index on a matching event.
+  void WakeUpIndex (uint32_t index);
+  // wakeup from a source which does not tell the item.
+  void WakeUpAll (void);
+  // Called by the wakeups instead of waking up the waiting thread, for
+  // the tables which no thread waits on.
+  void SetWakeUpCallback (Callback<void> cb);
+  // true if some wakeup did not tell its item.
+  bool IsRescanNeeded (void) const;
+  // the items woken up since the last ClearReady, maybe several times.
+  const std::vector<uint32_t> & GetReady (void) const;
+  void ClearReady (void);
 
 private:
-  std::list <PollTableEntry*> m_pollEntryList;
+  std::vector<PollTableEntry*> m_pollEntryList;
+  // number of entries of m_pollEntryList in use, the other ones are free.
+  uint32_t m_pollEntryUsed;
+  std::vector<PollTableEntry*> m_linuxEntryList;
   short m_eventMask;
+  uint32_t m_index;
+  std::vector<uint32_t> m_ready;
+  bool m_rescan;
+  Callback<void> m_wakeUpCb;
 };
 
 
@@ -21,10 +21,15 @@
 #include "ns3/applications-module.h"
 #include "ns3/dce-module.h"
 #include "ns3/mpi-interface.h"
+#include <sstream>
 
 using namespace ns3;
 
-// Run Hint :  $ mpirun -np 2 dce-mpi-udp
+// Run Hint :  $ mpirun -np 2 dce-mpi-udp --nNodes=8
+//
+// A chain of nNodes nodes, the client at one end, the server at the
+// other. DceMpiHelper spreads the nodes on the ranks: the links are 1ms
+// long but every fourth, 10ms long, on which the chain is cut.
 
 int
 main (int argc, char *argv[])
@@ -35,46 +40,49 @@ main (int argc, char *argv[])
 
   uint32_t systemId = MpiInterface::GetSystemId ();
   uint32_t systemCount = MpiInterface::GetSize ();
+  uint32_t nNodes = 2;
 
+  CommandLine cmd;
+  cmd.AddValue ("nNodes", "number of nodes in the chain", nNodes);
+  cmd.Parse (argc, argv);
 
-  // Check for valid distributed parameters.
-  // Must have 2 and only 2 Logical Processors (LPs)
-
-  if (systemCount != 2)
+  if (nNodes < 2)
     {
-      std::cout << "This simulation requires 2 and only 2 logical processors." << std::endl;
+      std::cout << "This simulation requires 2 nodes at least." << std::endl;
       return 1;
     }
 
   //-------------------------------------------------
 
-
-  CommandLine cmd;
-  cmd.Parse (argc, argv);
-
-  NodeContainer nodes;
-  Ptr<Node> node1 = CreateObject<Node> (0); // <------ for MPI, it goes to run in core_1 (process 1)
-  Ptr<Node> node2 = CreateObject<Node> (1); // <------ for MPI,                   "   _2          2
-  nodes.Add (node1);
-  nodes.Add (node2);
+  DceMpiHelper mpi;
+  for (uint32_t i = 0; i + 1 < nNodes; i++)
+    {
+      mpi.AddLink (i, i + 1, MilliSeconds ((i % 4 == 3) ? 10 : 1));
+    }
+  NodeContainer nodes = mpi.Create (nNodes, systemCount);
 
   InternetStackHelper stack;
   stack.Install (nodes);
 
   PointToPointHelper pointToPoint;
   pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
-  pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
-
-  NetDeviceContainer devices;
-  devices = pointToPoint.Install (nodes);
 
   Ipv4AddressHelper address;
-  address.SetBase ("10.1.1.0", "255.255.255.252");
-  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  Ipv4InterfaceContainer interfaces;
+  for (uint32_t i = 0; i + 1 < nNodes; i++)
+    {
+      std::ostringstream oss;
+      oss << "10.1." << i << ".0";
+      pointToPoint.SetChannelAttribute ("Delay", TimeValue (MilliSeconds ((i % 4 == 3) ? 10 : 1)));
+      NetDeviceContainer devices = pointToPoint.Install (nodes.Get (i), nodes.Get (i + 1));
+      address.SetBase (oss.str ().c_str (), "255.255.255.252");
+      interfaces = address.Assign (devices);
+    }
 
   // setup ip routes
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
+  // only the nodes of this rank get DCE.
   DceManagerHelper dceManager;
   dceManager.Install (nodes);
 
@@ -83,23 +91,18 @@ main (int argc, char *argv[])
 
   dce.SetStackSize (1 << 20);
 
-  if (0 == systemId)
-    {
-      dce.SetBinary ("udp-server");
-      dce.ResetArguments ();
-      apps = dce.Install (node1);
-      apps.Start (Seconds (4.0));
-    }
-
-  if (1 == systemId)
-    {
-      dce.SetBinary ("udp-client");
-      dce.ResetArguments ();
-      dce.AddArgument ("10.1.1.1");
-      apps = dce.Install (node2);
-      apps.Start (Seconds (4.5));
-    }
+  dce.SetBinary ("udp-server");
+  dce.ResetArguments ();
+  apps = dce.Install (nodes.Get (nNodes - 1));
+  apps.Start (Seconds (4.0));
 
+  std::ostringstream server;
+  interfaces.GetAddress (1).Print (server);
+  dce.SetBinary ("udp-client");
+  dce.ResetArguments ();
+  dce.AddArgument (server.str ());
+  apps = dce.Install (nodes.Get (0));
+  apps.Start (Seconds (4.5));
 
   Simulator::Stop (Seconds (1050.0));
   Simulator::Run ();
@@ -107,6 +110,16 @@ main (int argc, char *argv[])
 
   //-------------------------------------------------
 
+  std::vector<ProcStatus> status = DceMpiHelper::MergeProcStatus ();
+  if (systemId == 0)
+    {
+      for (std::vector<ProcStatus>::const_iterator i = status.begin (); i != status.end (); ++i)
+        {
+          std::cout << "node " << i->GetNode () << " exit " << i->GetExitCode ()
+                    << " " << i->GetCmdLine ();
+        }
+    }
+
   // Exit the MPI execution environment
   MpiInterface::Disable ();
   return 0;
@@ -0,0 +1,383 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "netlink-encoder.h"
+#include "netlink-message.h"
+#include "ns3/packet.h"
+#include "ns3/assert.h"
+#include <string.h>
+#include <algorithm>
+
+namespace ns3 {
+
+namespace {
+// The byte order of Buffer::Iterator::WriteU16 and friends, which the
+// Serialize methods of the netlink messages use.
+void
+Store16 (uint8_t *p, uint16_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+}
+void
+Store32 (uint8_t *p, uint32_t v)
+{
+  Store16 (p, v);
+  Store16 (p + 2, v >> 16);
+}
+uint16_t
+Load16 (const uint8_t *p)
+{
+  return p[0] | (p[1] << 8);
+}
+uint32_t
+Load32 (const uint8_t *p)
+{
+  return Load16 (p) | ((uint32_t)Load16 (p + 2) << 16);
+}
+
+const uint32_t HEADER_SIZE = 16; // struct nlmsghdr
+const uint32_t ATTRIBUTE_SIZE = 4; // struct nlattr
+} // anonymous namespace
+
+/***********************************************************************************
+* \ NetlinkEncoder
+***********************************************************************************/
+
+NetlinkEncoder::NetlinkEncoder ()
+  : m_size (0),
+    m_message (0)
+{
+}
+
+void
+NetlinkEncoder::Reserve (uint32_t size)
+{
+  if (m_size + size > m_buffer.size ())
+    {
+      m_buffer.resize (m_size + size);
+    }
+}
+
+uint8_t *
+NetlinkEncoder::Append (uint32_t size)
+{
+  size = NETLINK_MSG_ALIGN (size);
+  if (m_size + size > m_buffer.size ())
+    {
+      m_buffer.resize (std::max<size_t> (m_size + size, m_buffer.size () * 2));
+    }
+  uint8_t *p = &m_buffer[m_size];
+  memset (p, 0, size);
+  m_size += size;
+  return p;
+}
+
+void
+NetlinkEncoder::BeginMessage (uint16_t type, uint16_t flags, uint32_t seq, uint32_t pid)
+{
+  m_message = m_size;
+  uint8_t *p = Append (HEADER_SIZE);
+  // the length is known in EndMessage
+  Store16 (p + 4, type);
+  Store16 (p + 6, flags);
+  Store32 (p + 8, seq);
+  Store32 (p + 12, pid);
+}
+
+void
+NetlinkEncoder::PutRouteTemplate (uint8_t family, uint8_t dstLen, uint8_t srcLen, uint8_t tos,
+                                  uint8_t table, uint8_t protocol, uint8_t scope, uint8_t type,
+                                  uint32_t flags)
+{
+  uint8_t *p = Append (12);
+  p[0] = family;
+  p[1] = dstLen;
+  p[2] = srcLen;
+  p[3] = tos;
+  p[4] = table;
+  p[5] = protocol;
+  p[6] = scope;
+  p[7] = type;
+  Store32 (p + 8, flags);
+}
+
+void
+NetlinkEncoder::PutAddressTemplate (uint8_t family, uint8_t length, uint8_t flags,
+                                    uint8_t scope, uint32_t index)
+{
+  uint8_t *p = Append (8);
+  p[0] = family;
+  p[1] = length;
+  p[2] = flags;
+  p[3] = scope;
+  Store32 (p + 4, index);
+}
+
+void
+NetlinkEncoder::PutInterfaceTemplate (uint8_t family, uint16_t deviceType, uint32_t index,
+                                      uint32_t flags, uint32_t change)
+{
+  uint8_t *p = Append (16);
+  p[0] = family;
+  Store16 (p + 2, deviceType);
+  Store32 (p + 4, index);
+  Store32 (p + 8, flags);
+  Store32 (p + 12, change);
+}
+
+void
+NetlinkEncoder::PutAttribute (uint16_t type, const uint8_t *payload, uint32_t size)
+{
+  uint8_t *p = Append (ATTRIBUTE_SIZE + size);
+  Store16 (p, ATTRIBUTE_SIZE + size);
+  Store16 (p + 2, type);
+  memcpy (p + ATTRIBUTE_SIZE, payload, size);
+}
+
+void
+NetlinkEncoder::PutU8 (uint16_t type, uint8_t v)
+{
+  PutAttribute (type, &v, 1);
+}
+void
+NetlinkEncoder::PutU16 (uint16_t type, uint16_t v)
+{
+  uint8_t buf[2];
+  Store16 (buf, v);
+  PutAttribute (type, buf, 2);
+}
+void
+NetlinkEncoder::PutU32 (uint16_t type, uint32_t v)
+{
+  uint8_t buf[4];
+  Store32 (buf, v);
+  PutAttribute (type, buf, 4);
+}
+void
+NetlinkEncoder::PutU64 (uint16_t type, uint64_t v)
+{
+  uint8_t buf[8];
+  Store32 (buf, v);
+  Store32 (buf + 4, v >> 32);
+  PutAttribute (type, buf, 8);
+}
+void
+NetlinkEncoder::PutString (uint16_t type, const char *v)
+{
+  PutAttribute (type, (const uint8_t *)v, strlen (v) + 1);
+}
+void
+NetlinkEncoder::PutAddress (uint16_t type, Ipv4Address v)
+{
+  uint8_t buf[4];
+  v.Serialize (buf);
+  PutAttribute (type, buf, 4);
+}
+void
+NetlinkEncoder::PutAddress (uint16_t type, Ipv6Address v)
+{
+  uint8_t buf[16];
+  v.Serialize (buf);
+  PutAttribute (type, buf, 16);
+}
+void
+NetlinkEncoder::PutAddress (uint16_t type, const Address &v)
+{
+  uint8_t buf[Address::MAX_SIZE];
+  uint32_t len = v.CopyTo (buf);
+  PutAttribute (type, buf, len);
+}
+
+void
+NetlinkEncoder::EndMessage (void)
+{
+  NS_ASSERT (m_size >= m_message + HEADER_SIZE);
+  Store32 (&m_buffer[m_message], m_size - m_message);
+}
+
+const uint8_t *
+NetlinkEncoder::GetData (void) const
+{
+  return m_size ? &m_buffer[0] : 0;
+}
+uint32_t
+NetlinkEncoder::GetSize (void) const
+{
+  return m_size;
+}
+Ptr<Packet>
+NetlinkEncoder::ToPacket (void) const
+{
+  return Create<Packet> (GetData (), m_size);
+}
+
+/***********************************************************************************
+* \ NetlinkAttributeView
+***********************************************************************************/
+
+NetlinkAttributeView::NetlinkAttributeView ()
+  : m_attribute (0)
+{
+}
+NetlinkAttributeView::NetlinkAttributeView (const uint8_t *attribute)
+  : m_attribute (attribute)
+{
+}
+uint16_t
+NetlinkAttributeView::GetType (void) const
+{
+  return Load16 (m_attribute + 2);
+}
+uint16_t
+NetlinkAttributeView::GetPayloadSize (void) const
+{
+  return Load16 (m_attribute) - ATTRIBUTE_SIZE;
+}
+const uint8_t *
+NetlinkAttributeView::GetPayload (void) const
+{
+  return m_attribute + ATTRIBUTE_SIZE;
+}
+uint8_t
+NetlinkAttributeView::GetU8 (void) const
+{
+  NS_ASSERT (GetPayloadSize () >= 1);
+  return GetPayload ()[0];
+}
+uint16_t
+NetlinkAttributeView::GetU16 (void) const
+{
+  NS_ASSERT (GetPayloadSize () >= 2);
+  return Load16 (GetPayload ());
+}
+uint32_t
+NetlinkAttributeView::GetU32 (void) const
+{
+  NS_ASSERT (GetPayloadSize () >= 4);
+  return Load32 (GetPayload ());
+}
+uint64_t
+NetlinkAttributeView::GetU64 (void) const
+{
+  NS_ASSERT (GetPayloadSize () >= 8);
+  return Load32 (GetPayload ()) | ((uint64_t)Load32 (GetPayload () + 4) << 32);
+}
+const char *
+NetlinkAttributeView::GetString (void) const
+{
+  return (const char *)GetPayload ();
+}
+Ipv4Address
+NetlinkAttributeView::GetIpv4Address (void) const
+{
+  NS_ASSERT (GetPayloadSize () >= 4);
+  return Ipv4Address::Deserialize (GetPayload ());
+}
+Ipv6Address
+NetlinkAttributeView::GetIpv6Address (void) const
+{
+  NS_ASSERT (GetPayloadSize () >= 16);
+  return Ipv6Address::Deserialize (GetPayload ());
+}
+
+/***********************************************************************************
+* \ NetlinkDecoder
+***********************************************************************************/
+
+NetlinkDecoder::NetlinkDecoder (const uint8_t *data, uint32_t size)
+  : m_data (data),
+    m_size (size),
+    m_message (0),
+    m_messageSize (0),
+    m_attribute (0)
+{
+}
+
+bool
+NetlinkDecoder::NextMessage (void)
+{
+  uint32_t next = m_message + NETLINK_MSG_ALIGN (m_messageSize);
+  if (next + HEADER_SIZE > m_size)
+    {
+      return false;
+    }
+  uint32_t len = Load32 (m_data + next);
+  if (len < HEADER_SIZE || next + len > m_size)
+    {
+      return false;
+    }
+  m_message = next;
+  m_messageSize = len;
+  m_attribute = m_message + HEADER_SIZE + NETLINK_MSG_ALIGN (GetTemplateSize (GetMsgType ()));
+  return true;
+}
+
+uint16_t
+NetlinkDecoder::GetMsgType (void) const
+{
+  return Load16 (m_data + m_message + 4);
+}
+uint16_t
+NetlinkDecoder::GetMsgFlags (void) const
+{
+  return Load16 (m_data + m_message + 6);
+}
+uint32_t
+NetlinkDecoder::GetMsgSeq (void) const
+{
+  return Load32 (m_data + m_message + 8);
+}
+uint32_t
+NetlinkDecoder::GetMsgPid (void) const
+{
+  return Load32 (m_data + m_message + 12);
+}
+const uint8_t *
+NetlinkDecoder::GetTemplate (void) const
+{
+  return m_data + m_message + HEADER_SIZE;
+}
+
+bool
+NetlinkDecoder::NextAttribute (NetlinkAttributeView *attribute)
+{
+  uint32_t end = m_message + m_messageSize;
+  if (m_attribute + ATTRIBUTE_SIZE > end)
+    {
+      return false;
+    }
+  uint16_t len = Load16 (m_data + m_attribute);
+  if (len < ATTRIBUTE_SIZE || m_attribute + len > end)
+    {
+      return false;
+    }
+  *attribute = NetlinkAttributeView (m_data + m_attribute);
+  m_attribute += NETLINK_MSG_ALIGN (len);
+  return true;
+}
+
+uint32_t
+NetlinkDecoder::GetTemplateSize (uint16_t type)
+{
+  switch (type)
+    {
+    case NETLINK_MSG_ERROR:
+      return 20; // struct nlmsgerr
+    case NETLINK_RTM_NEWLINK:
+    case NETLINK_RTM_DELLINK:
+    case NETLINK_RTM_GETLINK:
+    case NETLINK_RTM_SETLINK:
+      return 16;
+    case NETLINK_RTM_NEWADDR:
+    case NETLINK_RTM_DELADDR:
+    case NETLINK_RTM_GETADDR:
+      return 8;
+    case NETLINK_RTM_NEWROUTE:
+    case NETLINK_RTM_DELROUTE:
+    case NETLINK_RTM_GETROUTE:
+      return 12;
+    default:
+      return 0;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef NETLINK_ENCODER_H
+#define NETLINK_ENCODER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief Write netlink messages directly in one contiguous buffer.
+ *
+ * Unlike MultipartNetlinkMessage, no object is built per message or per
+ * attribute: headers, templates and TLV attributes are written in place
+ * and the length of each message is patched by EndMessage. The bytes are
+ * those of the Serialize methods of netlink-message.h, so what one
+ * writes the other reads.
+ */
+class NetlinkEncoder
+{
+public:
+  NetlinkEncoder ();
+
+  // make room for size bytes, to avoid growing the buffer while encoding.
+  void Reserve (uint32_t size);
+
+  void BeginMessage (uint16_t type, uint16_t flags, uint32_t seq, uint32_t pid);
+  // struct rtmsg
+  void PutRouteTemplate (uint8_t family, uint8_t dstLen, uint8_t srcLen, uint8_t tos,
+                         uint8_t table, uint8_t protocol, uint8_t scope, uint8_t type,
+                         uint32_t flags);
+  // struct ifaddrmsg
+  void PutAddressTemplate (uint8_t family, uint8_t length, uint8_t flags,
+                           uint8_t scope, uint32_t index);
+  // struct ifinfomsg
+  void PutInterfaceTemplate (uint8_t family, uint16_t deviceType, uint32_t index,
+                             uint32_t flags, uint32_t change);
+  void PutU8 (uint16_t type, uint8_t v);
+  void PutU16 (uint16_t type, uint16_t v);
+  void PutU32 (uint16_t type, uint32_t v);
+  void PutU64 (uint16_t type, uint64_t v);
+  // with its terminating nul.
+  void PutString (uint16_t type, const char *v);
+  void PutAddress (uint16_t type, Ipv4Address v);
+  void PutAddress (uint16_t type, Ipv6Address v);
+  void PutAddress (uint16_t type, const Address &v);
+  void EndMessage (void);
+
+  const uint8_t *GetData (void) const;
+  uint32_t GetSize (void) const;
+  Ptr<Packet> ToPacket (void) const;
+
+private:
+  // size aligned bytes at the end of the message, zeroed.
+  uint8_t *Append (uint32_t size);
+  void PutAttribute (uint16_t type, const uint8_t *payload, uint32_t size);
+
+  std::vector<uint8_t> m_buffer;
+  uint32_t m_size;
+  uint32_t m_message; // offset of the message being written
+};
+
+/**
+ * \brief A netlink attribute inside a buffer, read in place.
+ */
+class NetlinkAttributeView
+{
+public:
+  NetlinkAttributeView ();
+  explicit NetlinkAttributeView (const uint8_t *attribute);
+
+  uint16_t GetType (void) const;
+  uint16_t GetPayloadSize (void) const;
+  const uint8_t *GetPayload (void) const;
+  uint8_t GetU8 (void) const;
+  uint16_t GetU16 (void) const;
+  uint32_t GetU32 (void) const;
+  uint64_t GetU64 (void) const;
+  // the payload, which is nul terminated when written by PutString.
+  const char *GetString (void) const;
+  Ipv4Address GetIpv4Address (void) const;
+  Ipv6Address GetIpv6Address (void) const;
+
+private:
+  const uint8_t *m_attribute;
+};
+
+/**
+ * \brief Walk the messages and attributes of a netlink buffer without
+ * copying them.
+ */
+class NetlinkDecoder
+{
+public:
+  NetlinkDecoder (const uint8_t *data, uint32_t size);
+
+  /**
+   * \returns false at the end of the buffer or if the next message is
+   * truncated.
+   */
+  bool NextMessage (void);
+  uint16_t GetMsgType (void) const;
+  uint16_t GetMsgFlags (void) const;
+  uint32_t GetMsgSeq (void) const;
+  uint32_t GetMsgPid (void) const;
+  // the template of the message, rtmsg, ifaddrmsg, ...
+  const uint8_t *GetTemplate (void) const;
+  /**
+   * \returns false after the last attribute of the current message.
+   */
+  bool NextAttribute (NetlinkAttributeView *attribute);
+
+  // the size of the template of the messages of type, 0 if they have none.
+  static uint32_t GetTemplateSize (uint16_t type);
+
+private:
+  const uint8_t *m_data;
+  uint32_t m_size;
+  uint32_t m_message; // offset of the current message
+  uint32_t m_messageSize;
+  uint32_t m_attribute; // offset of the next attribute
+};
+
+} // namespace ns3
+
+#endif /* NETLINK_ENCODER_H */
@@ -24,10 +24,12 @@
 
 #include "ns3/socket-factory.h"
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
 class Socket;
+class NetlinkSocket;
 
 /**
  * This can be used as an interface in a node in order for the node to
@@ -48,6 +50,8 @@ public:
   virtual Ptr<Socket> CreateSocket (void);
 
   std::multiset<uint32_t> m_pidsList; // to prevent PID reuse (unique per node)
+  // the sockets of the node bound to each multicast group, by group bit.
+  std::vector<NetlinkSocket *> m_groupSockets[32];
 };
 
 } // namespace ns3
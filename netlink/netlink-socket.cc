@@ -33,6 +33,7 @@
 #include "ns3/trace-source-accessor.h"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6.h"
 #include "ns3/ipv4-l3-protocol.h"
@@ -51,36 +52,13 @@
 #include <linux/if.h>
 #include <errno.h>
 #include "netlink-socket-factory.h"
+#include "netlink-encoder.h"
 //#include "ns3/ipv4-list-routing.h"
 
 NS_LOG_COMPONENT_DEFINE ("DceNetlinkSocket");
 
 namespace ns3 {
 
-// GroupSockets store the netlinksocket with noero group value
-// it was due to the mulitcast netlink messages.
-class GroupSockets
-{
-public:
-  static uint32_t GetNSockets (void)
-  {
-    return m_Sockets.size ();
-  }
-  static Ptr<NetlinkSocket> GetSocket (uint32_t index)
-  {
-    NS_ASSERT (index < m_Sockets.size ());
-    return m_Sockets[index];
-  }
-  static void AddSocket (Ptr<NetlinkSocket>sock)
-  {
-    m_Sockets.push_back (sock);
-  }
-private:
-  /*use a std::vector to store the sockets with nozero group value*/
-  static std::vector<Ptr<NetlinkSocket> >m_Sockets;
-};
-std::vector<Ptr<NetlinkSocket> >GroupSockets::m_Sockets;
-
 NS_OBJECT_ENSURE_REGISTERED (NetlinkSocket);
 
 /*
@@ -120,6 +98,7 @@ NetlinkSocket::NetlinkSocket ()
 NetlinkSocket::~NetlinkSocket ()
 {
   NS_LOG_FUNCTION (this);
+  LeaveGroups ();
 }
 void
 NetlinkSocket::DoDispose (void)
@@ -240,6 +219,7 @@ NetlinkSocket::DoBind (const NetlinkSocketAddress &address)
 {
   NS_LOG_FUNCTION (this << address);
 
+  LeaveGroups ();
   m_Pid = address.GetProcessID ();
   m_Groups = address.GetGroupsMask ();
 
@@ -262,10 +242,7 @@ NetlinkSocket::DoBind (const NetlinkSocketAddress &address)
       nsf->m_pidsList.insert (m_Pid);
     }
 
-  if (m_Groups)
-    {
-      GroupSockets::AddSocket (this);
-    }
+  JoinGroups ();
 
   Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4> ();
   NS_ASSERT_MSG (ipv4 != 0, "Netlink Socket requires IPv4 stack to be installed on the node");
@@ -335,10 +312,57 @@ NetlinkSocket::Close (void)
           nsf->m_pidsList.erase (i);
         }
     }
+  LeaveGroups ();
 
   return 0;
 }
 
+void
+NetlinkSocket::JoinGroups (void)
+{
+  NS_LOG_FUNCTION (this << m_Groups);
+  if (m_Groups == 0 || m_Pid == m_kernelPid || m_node == 0)
+    {
+      return;
+    }
+  Ptr<NetlinkSocketFactory> nsf = m_node->GetObject<NetlinkSocketFactory> ();
+  if (nsf == 0)
+    {
+      return;
+    }
+  for (uint32_t bit = 0; bit < 32; bit++)
+    {
+      if (m_Groups & (1U << bit))
+        {
+          nsf->m_groupSockets[bit].push_back (this);
+        }
+    }
+}
+
+void
+NetlinkSocket::LeaveGroups (void)
+{
+  NS_LOG_FUNCTION (this << m_Groups);
+  if (m_Groups == 0 || m_node == 0)
+    {
+      return;
+    }
+  Ptr<NetlinkSocketFactory> nsf = m_node->GetObject<NetlinkSocketFactory> ();
+  if (nsf == 0)
+    {
+      return;
+    }
+  for (uint32_t bit = 0; bit < 32; bit++)
+    {
+      std::vector<NetlinkSocket *> &sockets = nsf->m_groupSockets[bit];
+      std::vector<NetlinkSocket *>::iterator i = std::find (sockets.begin (), sockets.end (), this);
+      if (i != sockets.end ())
+        {
+          sockets.erase (i);
+        }
+    }
+}
+
 int
 NetlinkSocket::Connect (const Address &address)
 {
@@ -540,23 +564,37 @@ NetlinkSocket::SendMessageBroadcast (const MultipartNetlinkMessage &nlmsg,
                                      Ptr<Node> node)
 {
   NS_LOG_FUNCTION ("SendMessageBroadcast" << group);
-  //fisrt find the dest netlink socket through group value, then attach this nlmsg to its recv-queue
-  for (uint32_t i = 0; i < GroupSockets::GetNSockets (); i++)
+  Ptr<NetlinkSocketFactory> nsf = node->GetObject<NetlinkSocketFactory> ();
+  if (nsf == 0)
     {
-      Ptr<NetlinkSocket> nlsock = GroupSockets::GetSocket (i);
-
-      if ((nlsock->GetGroups () & group)
-          && (nlsock->GetPid () != m_kernelPid)
-          && node == nlsock->GetNode ())
+      return 0;
+    }
+  // the message is serialized once, every subscriber gets a copy-on-write
+  // reference to the same buffer.
+  Ptr<Packet> p = 0;
+  for (uint32_t bit = 0; bit < 32; bit++)
+    {
+      if (!(group & (1U << bit)))
         {
+          continue;
+        }
+      const std::vector<NetlinkSocket *> &sockets = nsf->m_groupSockets[bit];
+      for (uint32_t i = 0; i < sockets.size (); i++)
+        {
+          NetlinkSocket *nlsock = sockets[i];
+          if (nlsock->GetGroups () & group & ((1U << bit) - 1))
+            {
+              // already sent to it for a lower group
+              continue;
+            }
           NS_LOG_DEBUG ("SendMessageBroadcast to pid " << nlsock->GetPid ());
-
-          //here we send message instantly
-          Ptr<Packet> p = Create<Packet> ();
-          p->AddHeader (nlmsg);
-
+          if (p == 0)
+            {
+              p = Create<Packet> ();
+              p->AddHeader (nlmsg);
+            }
           //send packet to user space
-          nlsock->ForwardUp (p, NetlinkSocketAddress (m_kernelPid,group));
+          nlsock->ForwardUp (p->Copy (), NetlinkSocketAddress (m_kernelPid,group));
         }
     }
   return 0;
@@ -687,7 +725,14 @@ NetlinkSocket::DumpNetlinkRouteMessage (const NetlinkMessage &nlmsg, uint16_t ty
     }
   else if (type == NETLINK_RTM_GETROUTE)
     {
-      nlmsg_dump = BuildRouteDumpMessages ();
+      // routing tables can be large, they are written straight to the
+      // packet instead.
+      NetlinkEncoder encoder;
+      EncodeRouteDump (encoder, nhr.GetMsgSeq ());
+      encoder.BeginMessage (NETLINK_MSG_DONE, NETLINK_MSG_F_MULTI, nhr.GetMsgSeq (), m_kernelPid);
+      encoder.EndMessage ();
+      ForwardUp (encoder.ToPacket (), NetlinkSocketAddress (m_kernelPid,0));
+      return 0;
     }
   else
     {
@@ -928,85 +973,54 @@ NetlinkSocket::BuildInterfaceInfoDumpMessages ()
     }
   return nlmsg_dump;
 }
-MultipartNetlinkMessage
-NetlinkSocket::BuildRouteDumpMessages ()
+void
+NetlinkSocket::EncodeRouteDump (NetlinkEncoder &encoder, uint32_t seq)
 {
-  NS_LOG_FUNCTION (this);
-  MultipartNetlinkMessage nlmsg_dump;
+  NS_LOG_FUNCTION (this << seq);
 
   if (0 == m_ipv4Routing)
     {
-      return nlmsg_dump;
+      return;
     }
 
-  NS_ASSERT_MSG (m_ipv4Routing != 0, "Should not happen");
-
+  Ptr<Ipv6> ipv6 = m_node->GetObject<Ipv6> ();
   // We only care about staticRouting for netlink support
+  Ipv6StaticRoutingHelper routingHelper6;
+  Ptr<Ipv6StaticRouting> ipv6Static = routingHelper6.GetStaticRouting (ipv6);
+
+  // nlmsghdr, rtmsg and four attributes of an IPv6 route at most
+  encoder.Reserve ((m_ipv4Routing->GetNRoutes () + ipv6Static->GetNRoutes ()) * 88);
+
   for (uint32_t i = 0; i < m_ipv4Routing->GetNRoutes (); i++)
     {
-      NetlinkMessage nlmsg_rt;
-      NetlinkMessageHeader nhr = NetlinkMessageHeader (NETLINK_RTM_NEWROUTE, NETLINK_MSG_F_MULTI, 0, m_kernelPid);
-      RouteMessage rtmsg;
       Ipv4RoutingTableEntry route = m_ipv4Routing->GetRoute (i);
 
-      rtmsg.SetFamily (AF_INET);
-      rtmsg.SetDstLength (32);
-      rtmsg.SetSrcLength (0);
-      rtmsg.SetTos (0); //not clear
-      rtmsg.SetTableId (RouteMessage::RT_TABLE_MAIN);
-      rtmsg.SetScope (RouteMessage::RT_SCOPE_UNIVERSE);
-      rtmsg.SetProtocol (RouteMessage::RT_PROT_UNSPEC);
-      rtmsg.SetFlags (RouteMessage::RT_F_CLONED);
-
-      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_DST, ADDRESS, route.GetDest ()));
+      encoder.BeginMessage (NETLINK_RTM_NEWROUTE, NETLINK_MSG_F_MULTI, seq, m_kernelPid);
+      encoder.PutRouteTemplate (AF_INET, 32, 0, 0, RouteMessage::RT_TABLE_MAIN,
+                                RouteMessage::RT_PROT_UNSPEC, RouteMessage::RT_SCOPE_UNIVERSE,
+                                0, RouteMessage::RT_F_CLONED);
+      encoder.PutAddress (RouteMessage::RT_A_DST, route.GetDest ());
       // ns3 use local address as the route src address
-      //      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_SRC, ADDRESS, route.GetSource()));
-      //      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_PREFSRC, ADDRESS, route.GetSource()));//not used in ns3
-      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_IIF, U32, route.GetInterface ()));
-      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_OIF, U32, route.GetInterface ()));
-      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_GATEWAY, ADDRESS, route.GetGateway ()));
-
-      nlmsg_rt.SetHeader (nhr);
-      nlmsg_rt.SetRouteMessage (rtmsg);
-      nlmsg_dump.AppendMessage (nlmsg_rt);
+      encoder.PutU32 (RouteMessage::RT_A_IIF, route.GetInterface ());
+      encoder.PutU32 (RouteMessage::RT_A_OIF, route.GetInterface ());
+      encoder.PutAddress (RouteMessage::RT_A_GATEWAY, route.GetGateway ());
+      encoder.EndMessage ();
     }
 
-  Ptr<Ipv6> ipv6 = m_node->GetObject<Ipv6> ();
-  // We only care about staticRouting for netlink support
-  Ipv6StaticRoutingHelper routingHelper6;
-  Ptr<Ipv6StaticRouting> ipv6Static = routingHelper6.GetStaticRouting (ipv6);
   for (uint32_t i = 0; i < ipv6Static->GetNRoutes (); i++)
     {
-      NetlinkMessage nlmsg_rt;
-      NetlinkMessageHeader nhr = NetlinkMessageHeader (NETLINK_RTM_NEWROUTE, NETLINK_MSG_F_MULTI, 0, m_kernelPid);
-      RouteMessage rtmsg;
       Ipv6RoutingTableEntry route = ipv6Static->GetRoute (i);
 
-      rtmsg.SetFamily (AF_INET6);
-      rtmsg.SetDstLength (128);
-      rtmsg.SetSrcLength (0);
-      rtmsg.SetTos (0); //not clear
-      rtmsg.SetTableId (RouteMessage::RT_TABLE_MAIN);
-      rtmsg.SetScope (RouteMessage::RT_SCOPE_UNIVERSE);
-      rtmsg.SetProtocol (RouteMessage::RT_PROT_UNSPEC);
-      rtmsg.SetFlags (RouteMessage::RT_F_CLONED);
-
-      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_DST, ADDRESS, route.GetDest ()));
-      //ns3 use local address as the route src address
-      // rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_SRC, ADDRESS,
-      //                                          ipv6->GetSourceAddress(route.GetDest ())));
-      // rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_PREFSRC, ADDRESS,
-      //                                          ipv6->GetSourceAddress(route.GetDest ())));
-      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_IIF, U32, route.GetInterface ()));
-      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_OIF, U32, route.GetInterface ()));
-      rtmsg.AppendAttribute (NetlinkAttribute (RouteMessage::RT_A_GATEWAY, ADDRESS, route.GetGateway ()));
-
-      nlmsg_rt.SetHeader (nhr);
-      nlmsg_rt.SetRouteMessage (rtmsg);
-      nlmsg_dump.AppendMessage (nlmsg_rt);
+      encoder.BeginMessage (NETLINK_RTM_NEWROUTE, NETLINK_MSG_F_MULTI, seq, m_kernelPid);
+      encoder.PutRouteTemplate (AF_INET6, 128, 0, 0, RouteMessage::RT_TABLE_MAIN,
+                                RouteMessage::RT_PROT_UNSPEC, RouteMessage::RT_SCOPE_UNIVERSE,
+                                0, RouteMessage::RT_F_CLONED);
+      encoder.PutAddress (RouteMessage::RT_A_DST, route.GetDest ());
+      encoder.PutU32 (RouteMessage::RT_A_IIF, route.GetInterface ());
+      encoder.PutU32 (RouteMessage::RT_A_OIF, route.GetInterface ());
+      encoder.PutAddress (RouteMessage::RT_A_GATEWAY, route.GetGateway ());
+      encoder.EndMessage ();
     }
-
-  return nlmsg_dump;
 }
 
 int32_t
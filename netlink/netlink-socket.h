@@ -38,6 +38,7 @@ class Node;
 class Packet;
 class NetlinkSocketAddress;
 class Ipv4DceRouting;
+class NetlinkEncoder;
 
 /**
 * \brief A NetlinkSocket is  used  to transfer information
@@ -120,6 +121,9 @@ public:
 
 private:
   int DoBind (const NetlinkSocketAddress &address);
+  // add or remove the socket from the subscribers of the groups of the node.
+  void JoinGroups (void);
+  void LeaveGroups (void);
   virtual void DoDispose (void);
   void ForwardUp (Ptr<Packet> p, const NetlinkSocketAddress &address);
 
@@ -192,8 +196,10 @@ private:
   MultipartNetlinkMessage
   BuildInterfaceInfoDumpMessages ();
 
-  MultipartNetlinkMessage
-  BuildRouteDumpMessages ();
+  /**
+   * \brief Write a NEWROUTE message per route of the node
+   */
+  void EncodeRouteDump (NetlinkEncoder &encoder, uint32_t seq);
 
   /**
   * \returns 0 if doing operation(ADD/DEL/GET) is OK, < 0 for an error.
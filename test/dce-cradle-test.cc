@@ -5,6 +5,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
+#include <map>
 
 static std::string g_testError;
 
@@ -129,6 +130,431 @@ DceCradleTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (status, 1, "Process did not return successfully: " << g_testError);
 }
 
+// More connections accepted on one node than MAX_FDS: the ns-3 sockets
+// of the kernel stack share the fd table of the socket process of the
+// node, an accepted socket must not keep its fd there.
+class DceCradleAcceptTestCase : public TestCase
+{
+public:
+  DceCradleAcceptTestCase (bool skip);
+private:
+  virtual void DoRun (void);
+  void Listen (Ptr<Node> node);
+  void Connect (Ptr<Node> node, Address server, uint32_t left);
+  void Connected (Ptr<Socket> socket);
+  bool Request (Ptr<Socket> socket, const Address &from);
+  void Accepted (Ptr<Socket> socket, const Address &from);
+
+  bool m_skip;
+  Ptr<Socket> m_listener;
+  uint32_t m_connected;
+  uint32_t m_accepted;
+};
+
+DceCradleAcceptTestCase::DceCradleAcceptTestCase (bool skip)
+  : TestCase (std::string ("") + (skip ? "(SKIP) " : "")
+              + "Check that a node accepts more connections than MAX_FDS."),
+    m_skip (skip),
+    m_connected (0),
+    m_accepted (0)
+{
+}
+void
+DceCradleAcceptTestCase::Listen (Ptr<Node> node)
+{
+  m_listener = Socket::CreateSocket (node, TypeId::LookupByName ("ns3::LinuxTcpSocketFactory"));
+  m_listener->SetAcceptCallback (MakeCallback (&DceCradleAcceptTestCase::Request, this),
+                                 MakeCallback (&DceCradleAcceptTestCase::Accepted, this));
+  m_listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  m_listener->Listen ();
+}
+void
+DceCradleAcceptTestCase::Connect (Ptr<Node> node, Address server, uint32_t left)
+{
+  if (left == 0)
+    {
+      return;
+    }
+  Ptr<Socket> socket = Socket::CreateSocket (node, TypeId::LookupByName ("ns3::LinuxTcpSocketFactory"));
+  socket->SetConnectCallback (MakeCallback (&DceCradleAcceptTestCase::Connected, this),
+                              MakeNullCallback<void, Ptr<Socket> > ());
+  socket->Connect (server);
+  Simulator::Schedule (MilliSeconds (10), &DceCradleAcceptTestCase::Connect, this,
+                       node, server, left - 1);
+}
+void
+DceCradleAcceptTestCase::Connected (Ptr<Socket> socket)
+{
+  m_connected++;
+  socket->Close ();
+}
+bool
+DceCradleAcceptTestCase::Request (Ptr<Socket> socket, const Address &from)
+{
+  return true;
+}
+void
+DceCradleAcceptTestCase::Accepted (Ptr<Socket> socket, const Address &from)
+{
+  m_accepted++;
+  socket->Close ();
+}
+void
+DceCradleAcceptTestCase::DoRun (void)
+{
+  if (m_skip)
+    {
+      return;
+    }
+  // MAX_FDS, and the 76 more fds that would still be taken.
+  const uint32_t connections = 1100;
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  DceManagerHelper dceManager;
+  dceManager.SetNetworkStack ("ns3::LinuxSocketFdFactory",
+                              "Library", StringValue ("liblinux.so"));
+  dceManager.Install (nodes);
+
+  LinuxStackHelper stack;
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Simulator::Schedule (Seconds (1.0), &DceCradleAcceptTestCase::Listen, this, nodes.Get (1));
+  Simulator::Schedule (Seconds (2.0), &DceCradleAcceptTestCase::Connect, this,
+                       nodes.Get (0), Address (InetSocketAddress (interfaces.GetAddress (1), 9)),
+                       connections);
+
+  Simulator::Stop (Seconds (2.0) + MilliSeconds (10 * connections) + Seconds (5.0));
+  Simulator::Run ();
+  m_listener = 0;
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_connected, connections, "not all the connections succeeded");
+  NS_TEST_ASSERT_MSG_EQ (m_accepted, connections, "not all the connections were accepted");
+}
+
+// LinuxStackHelper::AddRoutes on a chain of three nodes: the routes
+// through the middle node are only known from it, behind more routes
+// than one netlink message of LinuxSocketFdFactory::AddRoutes holds and
+// a route the kernel refuses.
+class DceCradleRoutesTestCase : public TestCase
+{
+public:
+  DceCradleRoutesTestCase (bool skip);
+private:
+  virtual void DoRun (void);
+  void Listen (Ptr<Node> node);
+  void Connect (Ptr<Node> node, Address server);
+  void Connected (Ptr<Socket> socket);
+  bool Request (Ptr<Socket> socket, const Address &from);
+  void Accepted (Ptr<Socket> socket, const Address &from);
+
+  bool m_skip;
+  Ptr<Socket> m_listener;
+  uint32_t m_connected;
+  uint32_t m_accepted;
+};
+
+DceCradleRoutesTestCase::DceCradleRoutesTestCase (bool skip)
+  : TestCase (std::string ("") + (skip ? "(SKIP) " : "")
+              + "Check that the routes added in one pass are all installed."),
+    m_skip (skip),
+    m_connected (0),
+    m_accepted (0)
+{
+}
+void
+DceCradleRoutesTestCase::Listen (Ptr<Node> node)
+{
+  m_listener = Socket::CreateSocket (node, TypeId::LookupByName ("ns3::LinuxTcpSocketFactory"));
+  m_listener->SetAcceptCallback (MakeCallback (&DceCradleRoutesTestCase::Request, this),
+                                 MakeCallback (&DceCradleRoutesTestCase::Accepted, this));
+  m_listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  m_listener->Listen ();
+}
+void
+DceCradleRoutesTestCase::Connect (Ptr<Node> node, Address server)
+{
+  Ptr<Socket> socket = Socket::CreateSocket (node, TypeId::LookupByName ("ns3::LinuxTcpSocketFactory"));
+  socket->SetConnectCallback (MakeCallback (&DceCradleRoutesTestCase::Connected, this),
+                              MakeNullCallback<void, Ptr<Socket> > ());
+  socket->Connect (server);
+}
+void
+DceCradleRoutesTestCase::Connected (Ptr<Socket> socket)
+{
+  m_connected++;
+  socket->Close ();
+}
+bool
+DceCradleRoutesTestCase::Request (Ptr<Socket> socket, const Address &from)
+{
+  return true;
+}
+void
+DceCradleRoutesTestCase::Accepted (Ptr<Socket> socket, const Address &from)
+{
+  m_accepted++;
+  socket->Close ();
+}
+void
+DceCradleRoutesTestCase::DoRun (void)
+{
+  if (m_skip)
+    {
+      return;
+    }
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer left = pointToPoint.Install (nodes.Get (0), nodes.Get (1));
+  NetDeviceContainer right = pointToPoint.Install (nodes.Get (1), nodes.Get (2));
+
+  DceManagerHelper dceManager;
+  dceManager.SetNetworkStack ("ns3::LinuxSocketFdFactory",
+                              "Library", StringValue ("liblinux.so"));
+  dceManager.Install (nodes);
+
+  LinuxStackHelper stack;
+  stack.Install (nodes);
+  stack.SysctlSet (nodes.Get (1), ".net.ipv4.ip_forward", "1");
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer leftInterfaces = address.Assign (left);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer rightInterfaces = address.Assign (right);
+
+  // 1000 host routes take three messages, the one of 10.1.2.0/24 is in
+  // the last one, after a route refused as already there.
+  std::vector<Ipv4RoutingTableEntry> routes;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      routes.push_back (Ipv4RoutingTableEntry::CreateHostRouteTo (Ipv4Address (0x0a640000 + i),
+                                                                  leftInterfaces.GetAddress (1), 1));
+    }
+  routes.push_back (routes.back ());
+  routes.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo ("10.1.2.0", "255.255.255.0",
+                                                                 leftInterfaces.GetAddress (1), 1));
+  LinuxStackHelper::AddRoutes (nodes.Get (0), Seconds (1.0), routes);
+  routes.clear ();
+  routes.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo ("10.1.1.0", "255.255.255.0",
+                                                                 rightInterfaces.GetAddress (0), 1));
+  LinuxStackHelper::AddRoutes (nodes.Get (2), Seconds (1.0), routes);
+
+  Simulator::Schedule (Seconds (1.0), &DceCradleRoutesTestCase::Listen, this, nodes.Get (2));
+  Simulator::Schedule (Seconds (2.0), &DceCradleRoutesTestCase::Connect, this,
+                       nodes.Get (0), Address (InetSocketAddress (rightInterfaces.GetAddress (1), 9)));
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  m_listener = 0;
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_connected, 1, "no route to the far node");
+  NS_TEST_ASSERT_MSG_EQ (m_accepted, 1, "no route back from the far node");
+}
+
+// LinuxStackHelper::SysctlSet with a list of values, written from one
+// kernel task in order, and read back through the index of the sysctl
+// tree: the entries of a device, and one which does not exist.
+class DceCradleSysctlTestCase : public TestCase
+{
+public:
+  DceCradleSysctlTestCase (bool skip);
+private:
+  virtual void DoRun (void);
+  static void Got (std::string path, std::string value);
+
+  bool m_skip;
+  static std::map<std::string,std::string> m_values;
+};
+
+std::map<std::string,std::string> DceCradleSysctlTestCase::m_values;
+
+DceCradleSysctlTestCase::DceCradleSysctlTestCase (bool skip)
+  : TestCase (std::string ("") + (skip ? "(SKIP) " : "")
+              + "Check that sysctl values set at once are all written, in order."),
+    m_skip (skip)
+{
+}
+void
+DceCradleSysctlTestCase::Got (std::string path, std::string value)
+{
+  // the kernel ends the value with a newline.
+  m_values[path] = value.substr (0, value.find ('\n'));
+}
+void
+DceCradleSysctlTestCase::DoRun (void)
+{
+  if (m_skip)
+    {
+      return;
+    }
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  DceManagerHelper dceManager;
+  dceManager.SetNetworkStack ("ns3::LinuxSocketFdFactory",
+                              "Library", StringValue ("liblinux.so"));
+  dceManager.Install (nodes);
+
+  LinuxStackHelper stack;
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (devices);
+
+  std::vector<std::pair<std::string,std::string> > values;
+  values.push_back (std::make_pair (".net.ipv4.ip_default_ttl", "32"));
+  values.push_back (std::make_pair (".net.ipv4.no_such_value", "1"));
+  values.push_back (std::make_pair (".net.ipv4.tcp_syn_retries", "4"));
+  // after the forwarding of all the devices set by the stack.
+  values.push_back (std::make_pair (".net.ipv4.conf.sim0.forwarding", "0"));
+  values.push_back (std::make_pair (".net.ipv4.ip_default_ttl", "33"));
+  stack.SysctlSet (nodes, values);
+
+  m_values.clear ();
+  LinuxStackHelper::SysctlGet (nodes.Get (0), Seconds (1.0), ".net.ipv4.ip_default_ttl", &Got);
+  LinuxStackHelper::SysctlGet (nodes.Get (0), Seconds (1.0), ".net.ipv4.tcp_syn_retries", &Got);
+  LinuxStackHelper::SysctlGet (nodes.Get (0), Seconds (1.0), ".net.ipv4.conf.sim0.forwarding", &Got);
+  LinuxStackHelper::SysctlGet (nodes.Get (0), Seconds (1.0), ".net.ipv4.conf.all.forwarding", &Got);
+  LinuxStackHelper::SysctlGet (nodes.Get (0), Seconds (1.0), ".net.ipv4.no_such_value", &Got);
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_values[".net.ipv4.ip_default_ttl"], "33", "the last value set is not kept");
+  NS_TEST_ASSERT_MSG_EQ (m_values[".net.ipv4.tcp_syn_retries"], "4", "a value after a missing one is lost");
+  NS_TEST_ASSERT_MSG_EQ (m_values[".net.ipv4.conf.sim0.forwarding"], "0", "the entry of a device is not found");
+  NS_TEST_ASSERT_MSG_EQ (m_values[".net.ipv4.conf.all.forwarding"], "1", "the values of the stack are lost");
+  NS_TEST_ASSERT_MSG_EQ (m_values.count (".net.ipv4.no_such_value"), 1U, "no answer for a missing value");
+  NS_TEST_ASSERT_MSG_EQ (m_values[".net.ipv4.no_such_value"], "", "a missing value is read");
+}
+
+// The data a peer sends right before it closes comes with the hangup:
+// the receiver is notified of both, the data first.
+class DceCradleHangupTestCase : public TestCase
+{
+public:
+  DceCradleHangupTestCase (bool skip);
+private:
+  virtual void DoRun (void);
+  void Listen (Ptr<Node> node);
+  void Connect (Ptr<Node> node, Address server);
+  bool Request (Ptr<Socket> socket, const Address &from);
+  void Accepted (Ptr<Socket> socket, const Address &from);
+  void Received (Ptr<Socket> socket);
+
+  bool m_skip;
+  Ptr<Socket> m_listener;
+  Ptr<Socket> m_client;
+  uint32_t m_received;
+};
+
+DceCradleHangupTestCase::DceCradleHangupTestCase (bool skip)
+  : TestCase (std::string ("") + (skip ? "(SKIP) " : "")
+              + "Check that the data sent before a close is received."),
+    m_skip (skip),
+    m_received (0)
+{
+}
+void
+DceCradleHangupTestCase::Listen (Ptr<Node> node)
+{
+  m_listener = Socket::CreateSocket (node, TypeId::LookupByName ("ns3::LinuxTcpSocketFactory"));
+  m_listener->SetAcceptCallback (MakeCallback (&DceCradleHangupTestCase::Request, this),
+                                 MakeCallback (&DceCradleHangupTestCase::Accepted, this));
+  m_listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  m_listener->Listen ();
+}
+void
+DceCradleHangupTestCase::Connect (Ptr<Node> node, Address server)
+{
+  m_client = Socket::CreateSocket (node, TypeId::LookupByName ("ns3::LinuxTcpSocketFactory"));
+  m_client->SetRecvCallback (MakeCallback (&DceCradleHangupTestCase::Received, this));
+  m_client->Connect (server);
+}
+bool
+DceCradleHangupTestCase::Request (Ptr<Socket> socket, const Address &from)
+{
+  return true;
+}
+void
+DceCradleHangupTestCase::Accepted (Ptr<Socket> socket, const Address &from)
+{
+  // in one segment with the FIN, the window is far larger.
+  socket->Send (Create<Packet> (1000));
+  socket->Close ();
+}
+void
+DceCradleHangupTestCase::Received (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()) != 0 && packet->GetSize () > 0)
+    {
+      m_received += packet->GetSize ();
+    }
+}
+void
+DceCradleHangupTestCase::DoRun (void)
+{
+  if (m_skip)
+    {
+      return;
+    }
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  DceManagerHelper dceManager;
+  dceManager.SetNetworkStack ("ns3::LinuxSocketFdFactory",
+                              "Library", StringValue ("liblinux.so"));
+  dceManager.Install (nodes);
+
+  LinuxStackHelper stack;
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Simulator::Schedule (Seconds (1.0), &DceCradleHangupTestCase::Listen, this, nodes.Get (1));
+  Simulator::Schedule (Seconds (2.0), &DceCradleHangupTestCase::Connect, this,
+                       nodes.Get (0), Address (InetSocketAddress (interfaces.GetAddress (1), 9)));
+
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+  m_client->Close ();
+  m_client = 0;
+  m_listener = 0;
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, 1000, "the data before the hangup is lost");
+}
+
 static class DceCradleTestSuite : public TestSuite
 {
 public:
@@ -177,6 +603,14 @@ DceCradleTestSuite::DceCradleTestSuite ()
                                           ), 
                    TestCase::QUICK);
     }
+  AddTestCase (new DceCradleAcceptTestCase (filePath.length () <= 0),
+               TestCase::QUICK);
+  AddTestCase (new DceCradleRoutesTestCase (filePath.length () <= 0),
+               TestCase::QUICK);
+  AddTestCase (new DceCradleSysctlTestCase (filePath.length () <= 0),
+               TestCase::QUICK);
+  AddTestCase (new DceCradleHangupTestCase (filePath.length () <= 0),
+               TestCase::QUICK);
 }
 
 } // namespace ns3
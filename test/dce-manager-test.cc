@@ -4,11 +4,28 @@
 #include "ns3/uinteger.h"
 #include "ns3/boolean.h"
 #include "ns3/string.h"
+#include "ns3/global-value.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/dce-module.h"
 #include "ns3/ipv4-dce-routing-helper.h"
+#include "ns3/elf-dependencies.h"
+#include "ns3/chacha-stream.h"
+#include "ns3/dce-mpi-helper.h"
+#include "ns3/dce-checkpoint-helper.h"
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <limits.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
 //#include <mcheck.h>
 
 static std::string g_testError;
@@ -24,8 +41,11 @@ namespace ns3 {
 class DceManagerTestCase : public TestCase
 {
 public:
+  // configures the manager of the node for one test, before it is installed.
+  typedef void (*Setup)(DceManagerHelper &dceManager);
+
   DceManagerTestCase (std::string filename, Time maxDuration, std::string stdinFilename,
-                      bool useNet, std::string stack, bool skip);
+                      bool useNet, std::string stack, bool skip, Setup setup = 0);
 private:
   virtual void DoRun (void);
   static void Finished (int *pstatus, uint16_t pid, int status);
@@ -36,11 +56,12 @@ private:
   std::string m_netstack;
   bool m_useNet;
   bool m_skip;
+  Setup m_setup;
 };
 
 DceManagerTestCase::DceManagerTestCase (std::string filename, Time maxDuration,
                                         std::string stdin, bool useNet, std::string stack,
-                                        bool skip)
+                                        bool skip, Setup setup)
   : TestCase (std::string ("") + (skip ? "(SKIP) " : "") +
               "Check that process \"" + filename +
               "(" + stack +")" +
@@ -50,7 +71,8 @@ DceManagerTestCase::DceManagerTestCase (std::string filename, Time maxDuration,
     m_maxDuration (maxDuration),
     m_netstack (stack),
     m_useNet (useNet),
-    m_skip (skip)
+    m_skip (skip),
+    m_setup (setup)
 {
 //  mtrace ();
 }
@@ -73,6 +95,11 @@ DceManagerTestCase::DoRun (void)
   ApplicationContainer apps;
   DceManagerHelper dceManager;
 
+  if (m_setup != 0)
+    {
+      m_setup (dceManager);
+    }
+
   if (m_useNet)
     {
       if (m_netstack == "linux")
@@ -151,6 +178,582 @@ DceManagerTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (status, 0, "Process did not return successfully: " << g_testError);
 }
 
+// /dev/urandom must differ from a node to another, and from a run to
+// another.
+class DceRandomTestCase : public TestCase
+{
+public:
+  DceRandomTestCase ();
+private:
+  virtual void DoRun (void);
+  static std::vector<uint8_t> Read (Ptr<Node> node);
+};
+
+DceRandomTestCase::DceRandomTestCase ()
+  : TestCase ("Check that /dev/urandom depends on the node and on the run")
+{
+}
+std::vector<uint8_t>
+DceRandomTestCase::Read (Ptr<Node> node)
+{
+  std::vector<uint8_t> bytes (64);
+  node->GetObject<DceNodeContext> ()->RandomRead (&bytes[0], bytes.size ());
+  return bytes;
+}
+void
+DceRandomTestCase::DoRun (void)
+{
+  uint32_t run = SeedManager::GetRun ();
+  std::vector<uint8_t> first[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      SeedManager::SetRun (run + i);
+      NodeContainer nodes;
+      nodes.Create (2);
+      DceManagerHelper dceManager;
+      dceManager.Install (nodes);
+      std::vector<uint8_t> a = Read (nodes.Get (0));
+      std::vector<uint8_t> b = Read (nodes.Get (1));
+      NS_TEST_ASSERT_MSG_EQ ((a != b), true, "Two nodes read the same bytes");
+      NS_TEST_ASSERT_MSG_EQ ((a != std::vector<uint8_t> (a.size (), 0)), true, "Only zeroes");
+      first[i] = a;
+      Simulator::Destroy ();
+    }
+  SeedManager::SetRun (run);
+  NS_TEST_ASSERT_MSG_EQ ((first[0] != first[1]), true, "Two runs read the same bytes");
+}
+
+// The keystream of /dev/urandom is ChaCha20: the known answer of RFC 7539
+// section 2.4.2, whose 96-bit nonce and 32-bit counter give the same input
+// block as the 64-bit ones of ChaChaStream for a counter below 2^32.
+class DceChaChaTestCase : public TestCase
+{
+public:
+  DceChaChaTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+DceChaChaTestCase::DceChaChaTestCase ()
+  : TestCase ("Check the ChaCha20 keystream against RFC 7539")
+{
+}
+void
+DceChaChaTestCase::DoRun (void)
+{
+  static const char plaintext[] = "Ladies and Gentlemen of the class of '99: If I could offer you only one "
+    "tip for the future, sunscreen would be it.";
+  static const uint8_t ciphertext[] = {
+    0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28, 0xdd, 0x0d, 0x69, 0x81,
+    0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b,
+    0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33, 0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57,
+    0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8,
+    0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e,
+    0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36,
+    0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42,
+    0x87, 0x4d
+  };
+  const size_t len = sizeof (ciphertext);
+  NS_TEST_ASSERT_MSG_EQ (strlen (plaintext), len, "Plaintext");
+  // the key is the bytes 0 to 31, little endian words.
+  uint32_t key[8];
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      key[i] = (4 * i) | ((4 * i + 1) << 8) | ((4 * i + 2) << 16) | ((4 * i + 3) << 24);
+    }
+  // nonce 00:00:00:00 00:00:00:4a 00:00:00:00, the first word as the high
+  // word of the counter.
+  uint64_t nonce = 0x4a000000;
+
+  // the counter starts at 1: block 0 is skipped. Read in odd pieces, the
+  // keystream is the same.
+  for (size_t piece = 1; piece <= len; piece += 37)
+    {
+      ChaChaStream stream;
+      stream.SetKey (key, nonce);
+      uint8_t block[64];
+      stream.Generate (block, sizeof (block));
+      uint8_t out[sizeof (ciphertext)];
+      for (size_t done = 0; done < len; done += piece)
+        {
+          stream.Generate (out + done, std::min (piece, len - done));
+        }
+      for (size_t i = 0; i < len; i++)
+        {
+          out[i] ^= plaintext[i];
+        }
+      NS_TEST_ASSERT_MSG_EQ (memcmp (out, ciphertext, len), 0, "Wrong keystream, read by " << piece);
+    }
+}
+
+// The dependencies of a binary touched or replaced on the host between
+// two loads are resolved again.
+class DceElfCacheTestCase : public TestCase
+{
+public:
+  DceElfCacheTestCase ();
+private:
+  virtual void DoRun (void);
+  static void Copy (std::string from, std::string to);
+};
+
+DceElfCacheTestCase::DceElfCacheTestCase ()
+  : TestCase ("Check that the dependency cache notices a binary changed between two loads")
+{
+}
+void
+DceElfCacheTestCase::Copy (std::string from, std::string to)
+{
+  std::ifstream in (from.c_str (), std::ios::binary);
+  std::ofstream out (to.c_str (), std::ios::binary | std::ios::trunc);
+  out << in.rdbuf ();
+}
+void
+DceElfCacheTestCase::DoRun (void)
+{
+  char tmp[] = "/tmp/dce-elf-cache-XXXXXX";
+  NS_TEST_ASSERT_MSG_NE (mkdtemp (tmp), 0, "No temporary directory");
+  std::string directory = tmp;
+  std::string binary = directory + "/elf-cache-test";
+  // any ELF binary with dependencies: this one.
+  Copy ("/proc/self/exe", binary);
+
+  uint64_t hits = ElfDependencies::GetStats ().hits;
+  ElfDependencies first (binary);
+  NS_TEST_ASSERT_MSG_EQ (ElfDependencies::GetStats ().hits, hits, "First load found in cache");
+  ElfDependencies again (binary);
+  NS_TEST_ASSERT_MSG_EQ (ElfDependencies::GetStats ().hits, hits + 1, "Same binary not found in cache");
+
+  struct stat st;
+  NS_TEST_ASSERT_MSG_EQ (stat (binary.c_str (), &st), 0, "No binary");
+  struct timeval times[2];
+  times[0].tv_sec = st.st_mtime + 10;
+  times[0].tv_usec = 0;
+  times[1] = times[0];
+  NS_TEST_ASSERT_MSG_EQ (utimes (binary.c_str (), times), 0, "Could not touch the binary");
+  ElfDependencies touched (binary);
+  NS_TEST_ASSERT_MSG_EQ (ElfDependencies::GetStats ().hits, hits + 1, "Touched binary found in cache");
+
+  // a new inode, as when a library is reinstalled.
+  Copy ("/proc/self/exe", binary + ".new");
+  NS_TEST_ASSERT_MSG_EQ (rename ((binary + ".new").c_str (), binary.c_str ()), 0, "Could not replace the binary");
+  ElfDependencies replaced (binary);
+  NS_TEST_ASSERT_MSG_EQ (ElfDependencies::GetStats ().hits, hits + 1, "Replaced binary found in cache");
+  NS_TEST_ASSERT_MSG_EQ ((replaced.Begin () != replaced.End ()), true, "No dependencies");
+
+  // a dependency found first in the directory, then reinstalled there.
+  std::string library = first.Begin ()->required;
+  bool isSet = getenv ("LD_LIBRARY_PATH") != 0;
+  std::string ldLibraryPath = isSet ? getenv ("LD_LIBRARY_PATH") : "";
+  setenv ("LD_LIBRARY_PATH", (directory + ":" + ldLibraryPath).c_str (), 1);
+  Copy (first.Begin ()->found, directory + "/" + library);
+  ElfDependencies local (binary);
+  bool found = false;
+  for (ElfDependencies::Iterator i = local.Begin (); i != local.End (); ++i)
+    {
+      found = found || i->found == directory + "/" + library;
+    }
+  hits = ElfDependencies::GetStats ().hits;
+  ElfDependencies localAgain (binary);
+  uint64_t localHits = ElfDependencies::GetStats ().hits;
+  Copy (first.Begin ()->found, directory + "/" + library + ".new");
+  rename ((directory + "/" + library + ".new").c_str (), (directory + "/" + library).c_str ());
+  ElfDependencies reinstalled (binary);
+  uint64_t reinstalledHits = ElfDependencies::GetStats ().hits;
+  if (isSet)
+    {
+      setenv ("LD_LIBRARY_PATH", ldLibraryPath.c_str (), 1);
+    }
+  else
+    {
+      unsetenv ("LD_LIBRARY_PATH");
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (::system (("rm -rf " + directory).c_str ()), 0, "Could not clean " << directory);
+  NS_TEST_ASSERT_MSG_EQ (found, true, library << " not found in " << directory);
+  NS_TEST_ASSERT_MSG_EQ (localHits, hits + 1, "Same dependencies not found in cache");
+  NS_TEST_ASSERT_MSG_EQ (reinstalledHits, hits + 1, "Reinstalled dependency found in cache");
+}
+
+// DceMpiHelper::Partition keeps the shortest links in the ranks and
+// balances the nodes.
+class DceMpiPartitionTestCase : public TestCase
+{
+public:
+  DceMpiPartitionTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+DceMpiPartitionTestCase::DceMpiPartitionTestCase ()
+  : TestCase ("Check the partition of the nodes on MPI ranks and its lookahead")
+{
+}
+void
+DceMpiPartitionTestCase::DoRun (void)
+{
+  // a chain of 8 nodes, 1ms links: cut in the middle.
+  DceMpiHelper chain;
+  for (uint32_t i = 0; i + 1 < 8; i++)
+    {
+      chain.AddLink (i, i + 1, MilliSeconds (1));
+    }
+  std::vector<uint32_t> partition = chain.Partition (8, 2);
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (partition[i], (i < 4) ? 0 : 1, "Node " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (chain.GetLookahead (partition), MilliSeconds (1), "Chain lookahead");
+
+  // one rank: nothing is cut.
+  partition = chain.Partition (8, 1);
+  NS_TEST_ASSERT_MSG_EQ ((partition == std::vector<uint32_t> (8, 0)), true, "One rank");
+  NS_TEST_ASSERT_MSG_EQ (chain.GetLookahead (partition), Time::Max (), "Nothing cut");
+
+  // as myscripts/dce-mpi-udp: every fourth link is 10ms long, and the cut
+  // is there.
+  DceMpiHelper cut;
+  for (uint32_t i = 0; i + 1 < 8; i++)
+    {
+      cut.AddLink (i, i + 1, MilliSeconds ((i % 4 == 3) ? 10 : 1));
+    }
+  partition = cut.Partition (8, 2);
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (partition[i], (i < 4) ? 0 : 1, "Node " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (cut.GetLookahead (partition), MilliSeconds (10), "Cut lookahead");
+
+  // 16 nodes on 4 ranks: the 1ms groups of 4 fit a rank each.
+  DceMpiHelper four;
+  for (uint32_t i = 0; i + 1 < 16; i++)
+    {
+      four.AddLink (i, i + 1, MilliSeconds ((i % 4 == 3) ? 10 : 1));
+    }
+  partition = four.Partition (16, 4);
+  std::vector<uint32_t> load (4, 0);
+  for (uint32_t i = 0; i < 16; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (partition[i], partition[i - i % 4], "Group of node " << i << " split");
+      load[partition[i]]++;
+    }
+  NS_TEST_ASSERT_MSG_EQ ((load == std::vector<uint32_t> (4, 4)), true, "Unbalanced ranks");
+  NS_TEST_ASSERT_MSG_EQ (four.GetLookahead (partition), MilliSeconds (10), "Four ranks lookahead");
+}
+
+// A process keeps its syscall profile across exec.
+class DceExecProfileTestCase : public TestCase
+{
+public:
+  DceExecProfileTestCase ();
+private:
+  virtual void DoRun (void);
+  static void Finished (uint16_t *ppid, int *pstatus, uint16_t pid, int status);
+};
+
+DceExecProfileTestCase::DceExecProfileTestCase ()
+  : TestCase ("Check that the syscall profile counts the calls of an exec'ed image")
+{
+}
+void
+DceExecProfileTestCase::Finished (uint16_t *ppid, int *pstatus, uint16_t pid, int status)
+{
+  *ppid = pid;
+  *pstatus = status;
+}
+void
+DceExecProfileTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  DceManagerHelper dceManager;
+  dceManager.SetAttribute ("SyscallProfiling", BooleanValue (true));
+  // all the entries.
+  dceManager.SetAttribute ("SyscallProfilingTopN", UintegerValue (1000));
+  dceManager.Install (nodes);
+
+  uint16_t pid = 0;
+  int status = -1;
+  DceApplicationHelper dce;
+  dce.SetBinary ("test-exec-profile");
+  dce.SetStackSize (1 << 20);
+  dce.SetFinishedCallback (MakeBoundCallback (&DceExecProfileTestCase::Finished, &pid, &status));
+  ApplicationContainer apps = dce.Install (nodes.Get (0));
+  apps.Start (Seconds (1.0));
+
+  Simulator::Stop (Seconds (100));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (status, 0, "Process did not return successfully: " << g_testError);
+
+  std::ostringstream oss;
+  oss << "files-0/var/log/" << pid << "/status";
+  std::ifstream in (oss.str ().c_str ());
+  std::string line, calls;
+  while (std::getline (in, line))
+    {
+      if (line.find ("Top calls") != std::string::npos)
+        {
+          calls = line;
+        }
+    }
+  NS_TEST_ASSERT_MSG_NE (calls, "", "No profile in " << oss.str ());
+  // only the new image yields.
+  NS_TEST_ASSERT_MSG_NE (calls.find (" sched_yield=1/"), std::string::npos, calls);
+}
+
+// The startup profile of a process goes to its status file, the report of
+// the node to the startup-profile file of the rank, 0 here.
+class DceStartupProfileTestCase : public TestCase
+{
+public:
+  DceStartupProfileTestCase ();
+private:
+  virtual void DoRun (void);
+  static void Finished (uint16_t *ppid, int *pstatus, uint16_t pid, int status);
+};
+
+DceStartupProfileTestCase::DceStartupProfileTestCase ()
+  : TestCase ("Check that the startup profile is written to the status and the report of the rank")
+{
+}
+void
+DceStartupProfileTestCase::Finished (uint16_t *ppid, int *pstatus, uint16_t pid, int status)
+{
+  *ppid = pid;
+  *pstatus = status;
+}
+void
+DceStartupProfileTestCase::DoRun (void)
+{
+  unlink ("startup-profile");
+  NodeContainer nodes;
+  nodes.Create (1);
+  DceManagerHelper dceManager;
+  dceManager.SetAttribute ("StartupProfiling", BooleanValue (true));
+  dceManager.Install (nodes);
+
+  uint16_t pid = 0;
+  int status = -1;
+  DceApplicationHelper dce;
+  dce.SetBinary ("test-empty");
+  dce.SetStackSize (1 << 20);
+  dce.SetFinishedCallback (MakeBoundCallback (&DceStartupProfileTestCase::Finished, &pid, &status));
+  ApplicationContainer apps = dce.Install (nodes.Get (0));
+  apps.Start (Seconds (1.0));
+
+  Simulator::Stop (Seconds (100));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (status, 0, "Process did not return successfully: " << g_testError);
+
+  std::ostringstream oss;
+  oss << "files-0/var/log/" << pid << "/status";
+  std::ifstream in (oss.str ().c_str ());
+  std::string line, profile;
+  while (std::getline (in, line))
+    {
+      if (line.find ("Startup profile") != std::string::npos)
+        {
+          profile = line;
+        }
+    }
+  NS_TEST_ASSERT_MSG_NE (profile, "", "No profile in " << oss.str ());
+  NS_TEST_ASSERT_MSG_NE (profile.find (" create-process="), std::string::npos, profile);
+  NS_TEST_ASSERT_MSG_NE (profile.find (" load-main="), std::string::npos, profile);
+
+  std::ifstream report ("startup-profile");
+  bool node = false, binary = false, phase = false;
+  while (std::getline (report, line))
+    {
+      node = node || line == "NODE 0";
+      binary = binary || line == "BINARY test-empty";
+      phase = phase || (binary && line.find ("  load-main ") == 0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (node, true, "No node in startup-profile");
+  NS_TEST_ASSERT_MSG_EQ (binary, true, "No binary in startup-profile");
+  NS_TEST_ASSERT_MSG_EQ (phase, true, "No phase in startup-profile");
+  unlink ("startup-profile");
+}
+
+// Two copies restored from one snapshot go on each in its own directory,
+// with their own files-N and exit statuses.
+class DceCheckpointTestCase : public TestCase
+{
+public:
+  DceCheckpointTestCase ();
+  static uint32_t CountProcesses (std::string directory);
+private:
+  virtual void DoRun (void);
+};
+
+DceCheckpointTestCase::DceCheckpointTestCase ()
+  : TestCase ("Check that the copies restored from a snapshot run apart")
+{
+}
+uint32_t
+DceCheckpointTestCase::CountProcesses (std::string directory)
+{
+  // a directory per process in var/log.
+  uint32_t n = 0;
+  DIR *dir = ::opendir ((directory + "/files-0/var/log").c_str ());
+  if (dir == 0)
+    {
+      return 0;
+    }
+  struct dirent *entry;
+  while ((entry = ::readdir (dir)) != 0)
+    {
+      if (entry->d_name[0] != '.')
+        {
+          n++;
+        }
+    }
+  ::closedir (dir);
+  return n;
+}
+void
+DceCheckpointTestCase::DoRun (void)
+{
+  char cwd[PATH_MAX];
+  NS_TEST_ASSERT_MSG_NE (getcwd (cwd, sizeof (cwd)), 0, "No working directory");
+  char tmp[] = "/tmp/dce-checkpoint-XXXXXX";
+  NS_TEST_ASSERT_MSG_NE (mkdtemp (tmp), 0, "No temporary directory");
+  std::string directory = tmp;
+  NS_TEST_ASSERT_MSG_EQ (chdir (tmp), 0, "Could not enter " << directory);
+
+  NodeContainer nodes;
+  nodes.Create (1);
+  DceManagerHelper dceManager;
+  dceManager.SetTaskManagerAttribute ("FiberManagerType", StringValue ("UcontextFiberManager"));
+  dceManager.Install (nodes);
+  DceApplicationHelper dce;
+  dce.SetBinary ("test-empty");
+  dce.SetStackSize (1 << 20);
+  ApplicationContainer apps = dce.Install (nodes.Get (0));
+  apps.Start (Seconds (1.0));
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  DceCheckpointHelper checkpoint;
+  checkpoint.Checkpoint ("snapshot");
+  if (checkpoint.IsRestored ())
+    {
+      // in a copy: one more process, and the processes which exited
+      // successfully as exit status.
+      apps = dce.Install (nodes.Get (0));
+      apps.Start (Seconds (3.0));
+      Simulator::Stop (Seconds (100.0));
+      Simulator::Run ();
+      Simulator::Destroy ();
+      std::vector<ProcStatus> procs = DceManagerHelper::GetProcStatus ();
+      int succeeded = 0;
+      for (std::vector<ProcStatus>::const_iterator i = procs.begin (); i != procs.end (); ++i)
+        {
+          succeeded += (i->GetExitCode () == 0) ? 1 : 0;
+        }
+      ::_exit (succeeded);
+    }
+  pid_t a = checkpoint.Restore ("run-a", "a");
+  pid_t b = checkpoint.Restore ("run-b", "b");
+  int statusA = checkpoint.Wait (a);
+  int statusB = checkpoint.Wait (b);
+  checkpoint.Release ();
+  Simulator::Destroy ();
+
+  uint32_t original = CountProcesses (directory);
+  uint32_t runA = CountProcesses (directory + "/run-a");
+  uint32_t runB = CountProcesses (directory + "/run-b");
+  NS_TEST_ASSERT_MSG_EQ (chdir (cwd), 0, "Could not go back to " << cwd);
+  NS_TEST_ASSERT_MSG_EQ (::system (("rm -rf " + directory).c_str ()), 0, "Could not clean " << directory);
+
+  NS_TEST_ASSERT_MSG_EQ ((a > 0 && b > 0), true, "Could not restore");
+  NS_TEST_ASSERT_MSG_EQ ((WIFEXITED (statusA) && WEXITSTATUS (statusA) == 2), true, "run-a: " << statusA);
+  NS_TEST_ASSERT_MSG_EQ ((WIFEXITED (statusB) && WEXITSTATUS (statusB) == 2), true, "run-b: " << statusB);
+  NS_TEST_ASSERT_MSG_EQ (original, 1, "The copies wrote in the files of the original");
+  NS_TEST_ASSERT_MSG_EQ (runA, 2, "Processes in run-a");
+  NS_TEST_ASSERT_MSG_EQ (runB, 2, "Processes in run-b");
+}
+
+// Each variant of a fork sweep goes on in its own sweep-<i>, with its
+// own files-N and exitprocs: variant i starts i + 1 more processes.
+class DceForkSweepTestCase : public TestCase
+{
+public:
+  DceForkSweepTestCase ();
+private:
+  virtual void DoRun (void);
+  static void StartVariant (Ptr<Node> node, uint32_t i);
+};
+
+DceForkSweepTestCase::DceForkSweepTestCase ()
+  : TestCase ("Check that the variants of a fork sweep run apart")
+{
+}
+void
+DceForkSweepTestCase::StartVariant (Ptr<Node> node, uint32_t i)
+{
+  DceApplicationHelper dce;
+  dce.SetBinary ("test-empty");
+  dce.SetStackSize (1 << 20);
+  for (uint32_t j = 0; j <= i; j++)
+    {
+      ApplicationContainer apps = dce.Install (node);
+      apps.Start (Seconds (1.0 + j));
+    }
+}
+void
+DceForkSweepTestCase::DoRun (void)
+{
+  char cwd[PATH_MAX];
+  NS_TEST_ASSERT_MSG_NE (getcwd (cwd, sizeof (cwd)), 0, "No working directory");
+  char tmp[] = "/tmp/dce-fork-sweep-XXXXXX";
+  NS_TEST_ASSERT_MSG_NE (mkdtemp (tmp), 0, "No temporary directory");
+  std::string directory = tmp;
+  NS_TEST_ASSERT_MSG_EQ (chdir (tmp), 0, "Could not enter " << directory);
+
+  NodeContainer nodes;
+  nodes.Create (1);
+  DceManagerHelper dceManager;
+  dceManager.SetTaskManagerAttribute ("FiberManagerType", StringValue ("UcontextFiberManager"));
+  dceManager.Install (nodes);
+  DceApplicationHelper dce;
+  dce.SetBinary ("test-empty");
+  dce.SetStackSize (1 << 20);
+  ApplicationContainer apps = dce.Install (nodes.Get (0));
+  apps.Start (Seconds (1.0));
+  DceManagerHelper::ForkSweep (Seconds (2.0), 2,
+                               MakeBoundCallback (&DceForkSweepTestCase::StartVariant, nodes.Get (0)));
+  Simulator::Stop (Seconds (100.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  if (DceManagerHelper::GetSweepIndex () >= 0)
+    {
+      // in a variant: the processes which exited successfully.
+      std::vector<ProcStatus> procs = DceManagerHelper::GetProcStatus ();
+      int succeeded = 0;
+      for (std::vector<ProcStatus>::const_iterator i = procs.begin (); i != procs.end (); ++i)
+        {
+          succeeded += (i->GetExitCode () == 0) ? 1 : 0;
+        }
+      ::_exit (succeeded);
+    }
+  std::vector<int> status = DceManagerHelper::GetSweepStatus ();
+
+  uint32_t original = DceCheckpointTestCase::CountProcesses (directory);
+  uint32_t sweep0 = DceCheckpointTestCase::CountProcesses (directory + "/sweep-0");
+  uint32_t sweep1 = DceCheckpointTestCase::CountProcesses (directory + "/sweep-1");
+  NS_TEST_ASSERT_MSG_EQ (chdir (cwd), 0, "Could not go back to " << cwd);
+  NS_TEST_ASSERT_MSG_EQ (::system (("rm -rf " + directory).c_str ()), 0, "Could not clean " << directory);
+
+  NS_TEST_ASSERT_MSG_EQ (status.size (), 2, "Variants");
+  NS_TEST_ASSERT_MSG_EQ ((WIFEXITED (status[0]) && WEXITSTATUS (status[0]) == 2), true, "sweep-0: " << status[0]);
+  NS_TEST_ASSERT_MSG_EQ ((WIFEXITED (status[1]) && WEXITSTATUS (status[1]) == 3), true, "sweep-1: " << status[1]);
+  NS_TEST_ASSERT_MSG_EQ (original, 1, "The variants wrote in the files of the original");
+  NS_TEST_ASSERT_MSG_EQ (sweep0, 2, "Processes in sweep-0");
+  NS_TEST_ASSERT_MSG_EQ (sweep1, 3, "Processes in sweep-1");
+}
+
 static class DceManagerTestSuite : public TestSuite
 {
 public:
@@ -159,6 +762,60 @@ private:
 } g_processTests;
 //
 
+static void
+SetupTmpfs (DceManagerHelper &dceManager)
+{
+  dceManager.AddTmpfs ("/tmpfs", "MaxSize", UintegerValue (64 * 4096));
+}
+
+static std::string g_overlayBase;
+
+static void
+RemoveOverlay (void)
+{
+  GlobalValue::Bind ("DceFilesBase", StringValue (""));
+  if (::system (("rm -rf " + g_overlayBase).c_str ()) != 0)
+    {
+      NS_FATAL_ERROR ("Could not clean " << g_overlayBase);
+    }
+}
+
+// A base layer in a temporary directory, removed with the nodes, and
+// nothing left in files-0 by a previous run.
+static void
+SetupOverlay (DceManagerHelper &dceManager)
+{
+  char tmp[] = "/tmp/dce-overlay-XXXXXX";
+  if (mkdtemp (tmp) == 0)
+    {
+      NS_FATAL_ERROR ("No temporary directory");
+    }
+  g_overlayBase = tmp;
+  mkdir ((g_overlayBase + "/overlay").c_str (), S_IRWXU);
+  mkdir ((g_overlayBase + "/overlay/dir").c_str (), S_IRWXU);
+  std::ofstream shared ((g_overlayBase + "/overlay/shared").c_str ());
+  shared << "base\n";
+  shared.close ();
+  std::ofstream deleted ((g_overlayBase + "/overlay/deleted").c_str ());
+  deleted << "base\n";
+  deleted.close ();
+  std::ofstream file ((g_overlayBase + "/overlay/dir/file").c_str ());
+  file.close ();
+  if (::system ("rm -rf files-0/overlay") != 0)
+    {
+      NS_FATAL_ERROR ("Could not clean files-0");
+    }
+  GlobalValue::Bind ("DceFilesBase", StringValue (g_overlayBase));
+  // the nodes were created first: they are disposed of before.
+  Simulator::ScheduleDestroy (&RemoveOverlay);
+}
+
+static void
+SetupSpinOff (DceManagerHelper &dceManager)
+{
+  dceManager.SetAttribute ("SpinDetection", BooleanValue (false));
+}
+
 #define NS3_STACK      (1 << 0)
 #define LINUX_STACK    (1 << 1)
 #define FREEBSD_STACK  (1 << 2)
@@ -174,6 +831,7 @@ DceManagerTestSuite::DceManagerTestSuite ()
     bool useNet;
     bool skipUctx;
     uint32_t stackMask;
+    DceManagerTestCase::Setup setup; // 0 when left out
   } testPair;
 
   const testPair tests[] = {
@@ -200,6 +858,7 @@ DceManagerTestSuite::DceManagerTestSuite ()
     {  "test-nanosleep", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK},
     {  "test-random", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK},
     {  "test-local-socket", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK},
+    {  "test-splice", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK},
     {  "test-poll", 3200, "", true, false, NS3_STACK|LINUX_STACK},
     {  "test-epoll", 3200, "", true, false, NS3_STACK|LINUX_STACK},
     {  "test-tcp-socket", 320, "", true, false, NS3_STACK|LINUX_STACK},
@@ -214,6 +873,9 @@ DceManagerTestSuite::DceManagerTestSuite ()
     {  "test-tsearch", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK},
     {  "test-clock-gettime", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK},
     {  "test-gcc-builtin-apply", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK},
+    {  "test-overlay", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK, SetupOverlay},
+    {  "test-tmpfs", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK, SetupTmpfs},
+    {  "test-spin-off", 0, "", false, false, NS3_STACK|LINUX_STACK|FREEBSD_STACK, SetupSpinOff},
     // XXX: not completely tested      {  "test-signal", 30, "" , false},
   };
 
@@ -245,6 +907,15 @@ DceManagerTestSuite::DceManagerTestSuite ()
         }
     }
 
+  AddTestCase (new DceRandomTestCase (), TestCase::QUICK);
+  AddTestCase (new DceChaChaTestCase (), TestCase::QUICK);
+  AddTestCase (new DceElfCacheTestCase (), TestCase::QUICK);
+  AddTestCase (new DceMpiPartitionTestCase (), TestCase::QUICK);
+  AddTestCase (new DceExecProfileTestCase (), TestCase::QUICK);
+  AddTestCase (new DceStartupProfileTestCase (), TestCase::QUICK);
+  AddTestCase (new DceCheckpointTestCase (), TestCase::QUICK);
+  AddTestCase (new DceForkSweepTestCase (), TestCase::QUICK);
+
   // ns-3 stack
   for (unsigned int i = 0; i < sizeof(tests) / sizeof(testPair); i++)
     {
@@ -254,7 +925,8 @@ DceManagerTestSuite::DceManagerTestSuite ()
                                            tests[i].useNet,
                                            "ns3",
                                            (tests[i].stackMask & NS3_STACK) ?
-                                           (isUctxFiber ? tests[i].skipUctx : false) : true
+                                           (isUctxFiber ? tests[i].skipUctx : false) : true,
+                                           tests[i].setup
                                            ),
                    TestCase::QUICK);
     }
@@ -272,7 +944,8 @@ DceManagerTestSuite::DceManagerTestSuite ()
                                                tests[i].useNet,
                                                "linux",
                                                (tests[i].stackMask & LINUX_STACK) ?
-                                               (isUctxFiber ? tests[i].skipUctx : false) : true
+                                               (isUctxFiber ? tests[i].skipUctx : false) : true,
+                                               tests[i].setup
                                                ),
                        TestCase::QUICK);
         }
@@ -290,7 +963,8 @@ DceManagerTestSuite::DceManagerTestSuite ()
                                                tests[i].useNet,
                                                "freebsd",
                                                (tests[i].stackMask & FREEBSD_STACK) ?
-                                               (isUctxFiber ? tests[i].skipUctx : false) : true
+                                               (isUctxFiber ? tests[i].skipUctx : false) : true,
+                                               tests[i].setup
                                                ),
                        TestCase::QUICK);
         }
@@ -35,8 +35,10 @@
 #include "ns3/socket.h"
 #include "netlink-message.h"
 #include "netlink-socket-address.h"
+#include "netlink-encoder.h"
 #include <sys/socket.h>
 #include <string>
+#include <string.h>
 #include <list>
 
 
@@ -64,13 +66,16 @@ private:
   bool CheckIsEqual (MultipartNetlinkMessage mulmsg1, MultipartNetlinkMessage mulmsg2);
 
   void TestNetlinkSerialization ();
+  void TestNetlinkEncoder ();
   void TestInterfaceAddressMessage ();
   void TestInferfaceInfoMessage ();
   void TestRouteMessage ();
+  void TestNodeBroadcast (Ptr<Node> other);
   void TestBroadcastMessage ();
 
   void ReceiveUnicastPacket (Ptr<Socket> socket);
   void ReceiveMulticastPacket (Ptr<Socket> socket);
+  void ReceiveOtherNodePacket (Ptr<Socket> socket);
   void SendCmdToKernel (uint16_t type);
   void SendNetlinkMessage (NetlinkMessage nlmsg);
   void MonitorKernelChanges ();
@@ -78,6 +83,7 @@ private:
 
   std::list<MultipartNetlinkMessage> m_unicastList;
   std::list<MultipartNetlinkMessage> m_multicastList;
+  std::list<MultipartNetlinkMessage> m_otherNodeList;
   Ptr<Socket> m_cmdSock;
   Ptr<Socket> m_groupSock;
   int m_pid;
@@ -248,6 +254,55 @@ NetlinkSocketTestCase::TestNetlinkSerialization ()
   NS_TEST_ASSERT_MSG_EQ (CheckIsEqual (multinlmsg1, multinlmsg2), true, "Should be equal");
 }
 void
+NetlinkSocketTestCase::TestNetlinkEncoder ()
+{
+  //the encoder should write the bytes MultipartNetlinkMessage does
+  uint16_t flags = NETLINK_MSG_F_MULTI | NETLINK_MSG_F_ACK | NETLINK_MSG_F_REQUEST | NETLINK_MSG_F_CREATE;
+  NetlinkEncoder encoder;
+  encoder.BeginMessage (NETLINK_RTM_NEWROUTE, flags, 0, m_pid);
+  encoder.PutRouteTemplate (AF_INET, 0, 0, 0, 0, 0, 0, 0, 0);
+  encoder.PutAddress (RouteMessage::RT_A_DST, Ipv4Address ("192.168.0.10"));
+  encoder.PutAddress (RouteMessage::RT_A_SRC, Ipv4Address ("192.168.2.10"));
+  encoder.PutAddress (RouteMessage::RT_A_GATEWAY, Ipv4Address ("10.1.1.10"));
+  encoder.PutU32 (RouteMessage::RT_A_OIF, 2);
+  encoder.EndMessage ();
+  encoder.BeginMessage (NETLINK_MSG_DONE, NETLINK_MSG_F_MULTI, 1, m_pid);
+  encoder.EndMessage ();
+
+  MultipartNetlinkMessage multinlmsg;
+  NetlinkMessage done;
+  multinlmsg.AppendMessage (BuildRouteMessage (NETLINK_RTM_NEWROUTE, NETLINK_MSG_F_MULTI));
+  done.SetHeader (NetlinkMessageHeader (NETLINK_MSG_DONE, NETLINK_MSG_F_MULTI, 1, m_pid));
+  multinlmsg.AppendMessage (done);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (multinlmsg);
+  uint8_t buf[256];
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), encoder.GetSize (), "Should be the same size");
+  p->CopyData (buf, sizeof (buf));
+  NS_TEST_ASSERT_MSG_EQ (memcmp (buf, encoder.GetData (), encoder.GetSize ()), 0, "Should be the same bytes");
+
+  //then read it back in place
+  NetlinkDecoder decoder (encoder.GetData (), encoder.GetSize ());
+  NetlinkAttributeView attr;
+  NS_TEST_ASSERT_MSG_EQ (decoder.NextMessage (), true, "Should have a route");
+  NS_TEST_ASSERT_MSG_EQ (decoder.GetMsgType (), NETLINK_RTM_NEWROUTE, "Should be a route");
+  NS_TEST_ASSERT_MSG_EQ (decoder.GetMsgPid (), (uint32_t)m_pid, "Wrong pid");
+  NS_TEST_ASSERT_MSG_EQ (decoder.GetTemplate ()[0], AF_INET, "Wrong family");
+  NS_TEST_ASSERT_MSG_EQ (decoder.NextAttribute (&attr), true, "Should have a destination");
+  NS_TEST_ASSERT_MSG_EQ (attr.GetType (), RouteMessage::RT_A_DST, "Should be the destination");
+  NS_TEST_ASSERT_MSG_EQ (attr.GetIpv4Address (), Ipv4Address ("192.168.0.10"), "Wrong destination");
+  NS_TEST_ASSERT_MSG_EQ (decoder.NextAttribute (&attr), true, "Should have a source");
+  NS_TEST_ASSERT_MSG_EQ (decoder.NextAttribute (&attr), true, "Should have a gateway");
+  NS_TEST_ASSERT_MSG_EQ (attr.GetIpv4Address (), Ipv4Address ("10.1.1.10"), "Wrong gateway");
+  NS_TEST_ASSERT_MSG_EQ (decoder.NextAttribute (&attr), true, "Should have an interface");
+  NS_TEST_ASSERT_MSG_EQ (attr.GetType (), RouteMessage::RT_A_OIF, "Should be the interface");
+  NS_TEST_ASSERT_MSG_EQ (attr.GetU32 (), 2U, "Wrong interface");
+  NS_TEST_ASSERT_MSG_EQ (decoder.NextAttribute (&attr), false, "Should be the last attribute");
+  NS_TEST_ASSERT_MSG_EQ (decoder.NextMessage (), true, "Should have done");
+  NS_TEST_ASSERT_MSG_EQ (decoder.GetMsgType (), NETLINK_MSG_DONE, "Should be done");
+  NS_TEST_ASSERT_MSG_EQ (decoder.NextMessage (), false, "Should be the end");
+}
+void
 NetlinkSocketTestCase::TestInterfaceAddressMessage ()
 {
   MultipartNetlinkMessage dump1, dump2, dump3;
@@ -359,6 +414,38 @@ NetlinkSocketTestCase::TestInferfaceInfoMessage ()
                          true, "msg might be incorrect");
 }
 
+void
+NetlinkSocketTestCase::TestNodeBroadcast (Ptr<Node> other)
+{
+  // a socket of another node in the same groups as m_groupSock.
+  Ptr<SocketFactory> otherFactory = CreateNetlinkFactory ();
+  other->AggregateObject (otherFactory);
+  Ptr<Socket> otherSock = otherFactory->CreateSocket ();
+  otherSock->SetRecvCallback (MakeCallback (&NetlinkSocketTestCase::ReceiveOtherNodePacket, this));
+  NetlinkSocketAddress addr;
+  addr.SetProcessID (m_pid + 1);
+  addr.SetGroupsMask (NETLINK_RTM_GRP_IPV4_IFADDR | NETLINK_RTM_GRP_IPV4_ROUTE);
+  otherSock->Bind (addr);
+
+  m_multicastList.clear ();
+  m_otherNodeList.clear ();
+  SendNetlinkMessage (BuildRouteMessage (NETLINK_RTM_NEWROUTE, 0));
+  SendNetlinkMessage (BuildRouteMessage (NETLINK_RTM_DELROUTE, 0));
+  NS_TEST_ASSERT_MSG_EQ (m_unicastList.size (), 2, "queue size should be 2 (acks)");
+  m_unicastList.clear ();
+
+  // only the subscriber of the node of m_cmdSock hears of its changes.
+  NS_TEST_ASSERT_MSG_EQ (m_multicastList.size (), 2, "group socket of the node should get 2 messages");
+  NS_TEST_ASSERT_MSG_EQ (m_multicastList.front ().GetMessage (0).GetMsgType (), NETLINK_RTM_NEWROUTE,
+                         "first broadcast should be RTM_NEWROUTE");
+  NS_TEST_ASSERT_MSG_EQ (m_multicastList.back ().GetMessage (0).GetMsgType (), NETLINK_RTM_DELROUTE,
+                         "second broadcast should be RTM_DELROUTE");
+  NS_TEST_ASSERT_MSG_EQ (m_otherNodeList.size (), 0, "group socket of another node should get nothing");
+  m_multicastList.clear ();
+
+  otherSock->Close ();
+}
+
 void
 NetlinkSocketTestCase::TestBroadcastMessage ()
 {
@@ -442,6 +529,17 @@ NetlinkSocketTestCase::ReceiveMulticastPacket (Ptr<Socket> socket)
     }
 }
 void
+NetlinkSocketTestCase::ReceiveOtherNodePacket (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while (packet = socket->Recv ())
+    {
+      MultipartNetlinkMessage nlmsg;
+      packet->RemoveHeader (nlmsg);
+      m_otherNodeList.push_back (nlmsg);
+    }
+}
+void
 NetlinkSocketTestCase::MonitorKernelChanges ()
 {
   NS_LOG_INFO ("At = " << Simulator::Now ().GetSeconds () << "s, group socket check the recv list");
@@ -553,6 +651,7 @@ NetlinkSocketTestCase::DoRun (void)
 
   /*test 1: for Serialize and Deserialize*/
   TestNetlinkSerialization ();
+  TestNetlinkEncoder ();
 
   /*test 2: for interface address dump/add/get message*/
   TestInterfaceAddressMessage ();
@@ -563,7 +662,10 @@ NetlinkSocketTestCase::DoRun (void)
   /*test 4: for route dump/add/get message*/
   TestRouteMessage ();
 
-  /*test 5: for netlink broadcast */
+  /*test 5: for netlink broadcast, to the sockets of the node only */
+  TestNodeBroadcast (nodes.Get (2));
+
+  /*test 6: for netlink broadcast */
   TestBroadcastMessage ();
 
   Simulator::Run ();
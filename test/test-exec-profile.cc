@@ -0,0 +1,22 @@
+#include <unistd.h>
+#include <sched.h>
+#include <stdlib.h>
+#include "test-macros.h"
+
+// Execs itself once: only the new image calls sched_yield, which the
+// syscall profile of the process must count, see dce-manager-test.cc.
+
+int main (int argc, char *argv[])
+{
+  if (argc == 1)
+    {
+      execl ("/bin_dce/test-exec-profile", "test-exec-profile", "exec", NULL);
+      TEST_ASSERT (false); // Must not be reached
+    }
+  int status = sched_yield ();
+  TEST_ASSERT_EQUAL (status, 0);
+
+  exit (0);
+  // never reached.
+  return -1;
+}
@@ -1,4 +1,7 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include "test-macros.h"
 
 
@@ -10,8 +13,41 @@ void test_atof (void)
   TEST_ASSERT_EQUAL (i_val, 10);
 }
 
+static int compare_int (const void *a, const void *b)
+{
+  return *(const int *)a - *(const int *)b;
+}
+
+// functions going through the typed stubs of libc.cc
+void test_typed (void)
+{
+  int v[] = { 3, 1, 2 };
+  qsort (v, 3, sizeof (int), compare_int);
+  TEST_ASSERT_EQUAL (v[0], 1);
+  TEST_ASSERT_EQUAL (v[2], 3);
+
+  unsigned long long int ull = strtoull ("18446744073709551615", 0, 10);
+  TEST_ASSERT_EQUAL (ull, 18446744073709551615ULL);
+
+  TEST_ASSERT_EQUAL (ldexp (1.5, 3), 12.0);
+  TEST_ASSERT_EQUAL (pow (2.0, 10.0), 1024.0);
+  char s[] = "a,b";
+  TEST_ASSERT_EQUAL (strchr (s, ','), s + 1);
+}
+
+// variadic functions still go through __builtin_apply
+void test_variadic (void)
+{
+  char buf[64];
+  int n = sprintf (buf, "%d %s %.1f %lld", 1, "two", 3.0, 4LL);
+  TEST_ASSERT_EQUAL (n, 11);
+  TEST_ASSERT_EQUAL (strcmp (buf, "1 two 3.0 4"), 0);
+}
+
 int main (int argc, char *argv[])
 {
   test_atof ();
+  test_typed ();
+  test_variadic ();
   return 0;
 }
@@ -0,0 +1,69 @@
+#ifndef TEST_MANY_PIPES_H
+#define TEST_MANY_PIPES_H
+
+// Many pipes of which one at a time becomes ready, for the tests of
+// poll and select: a thread writes to the pipe picked a second later.
+
+#include <unistd.h>
+#include <pthread.h>
+#include "test-macros.h"
+
+#define MANY_PIPES 500
+static int g_manyPipes[MANY_PIPES][2];
+static const long g_manyPicks[] = { 0, MANY_PIPES / 2, MANY_PIPES - 1 };
+#define MANY_PICKS (sizeof (g_manyPicks) / sizeof (g_manyPicks[0]))
+
+static void *
+many_writer (void *arg)
+{
+  long k = (long) arg;
+
+  sleep (1);
+  int status = write (g_manyPipes[k][1], "x", 1);
+  TEST_ASSERT_EQUAL (status, 1);
+
+  return arg;
+}
+
+static void
+many_open (void)
+{
+  for (int i = 0; i < MANY_PIPES; i++)
+    {
+      int status = pipe (g_manyPipes[i]);
+      TEST_ASSERT_EQUAL (status, 0);
+    }
+}
+
+static pthread_t
+many_start (long k)
+{
+  pthread_t writer;
+  int status = pthread_create (&writer, NULL, many_writer, (void *) k);
+  TEST_ASSERT_EQUAL (status, 0);
+  return writer;
+}
+
+// empty the pipe k again.
+static void
+many_finish (pthread_t writer, long k)
+{
+  char c;
+  int status = read (g_manyPipes[k][0], &c, 1);
+  TEST_ASSERT_EQUAL (status, 1);
+
+  status = pthread_join (writer, NULL);
+  TEST_ASSERT_EQUAL (status, 0);
+}
+
+static void
+many_close (void)
+{
+  for (int i = 0; i < MANY_PIPES; i++)
+    {
+      close (g_manyPipes[i][0]);
+      close (g_manyPipes[i][1]);
+    }
+}
+
+#endif /* TEST_MANY_PIPES_H */
@@ -1,7 +1,25 @@
 #define _GNU_SOURCE 1
 #include <netdb.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <poll.h>
 #include "test-macros.h"
 
+static void
+write_file (const char *path, const char *content)
+{
+  FILE *f = fopen (path, "w");
+  TEST_ASSERT_UNEQUAL (f, 0);
+  fputs (content, f);
+  fclose (f);
+}
+
 void test_gethostbyname (void)
 {
   struct hostent *host;
@@ -30,11 +48,198 @@ void test_getaddrinfo (void)
   TEST_ASSERT (gai_strerror (status) != 0);
 }
 
+// the names come from the /etc/hosts of the node.
+void test_hosts (void)
+{
+  mkdir ("/etc", 0755);
+  write_file ("/etc/hosts",
+              "# test\n"
+              "10.1.2.3 server.example.com server www\n"
+              "10.1.2.4 other\n"
+              "2001:db8::3 server.example.com\n");
+
+  struct hostent *host = gethostbyname ("WWW");
+  TEST_ASSERT_UNEQUAL (host, 0);
+  TEST_ASSERT_EQUAL (strcmp (host->h_name, "server.example.com"), 0);
+  TEST_ASSERT_EQUAL (strcmp (host->h_aliases[0], "server"), 0);
+  TEST_ASSERT_EQUAL (host->h_length, 4);
+  TEST_ASSERT_EQUAL (memcmp (host->h_addr_list[0], "\x0a\x01\x02\x03", 4), 0);
+  TEST_ASSERT_EQUAL (host->h_addr_list[1], 0);
+  TEST_ASSERT_EQUAL (gethostbyname ("unknown"), 0);
+
+  struct addrinfo hints;
+  memset (&hints, 0, sizeof (hints));
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_CANONNAME;
+  struct addrinfo *info;
+  int status = getaddrinfo ("server", "80", &hints, &info);
+  TEST_ASSERT_EQUAL (status, 0);
+  TEST_ASSERT_EQUAL (strcmp (info->ai_canonname, "server.example.com"), 0);
+  // ipv4 first
+  TEST_ASSERT_EQUAL (info->ai_family, AF_INET);
+  TEST_ASSERT_EQUAL (((struct sockaddr_in *) info->ai_addr)->sin_port, htons (80));
+  TEST_ASSERT_UNEQUAL (info->ai_next, 0);
+  TEST_ASSERT_EQUAL (info->ai_next->ai_family, AF_INET6);
+  TEST_ASSERT_EQUAL (info->ai_next->ai_next, 0);
+  freeaddrinfo (info);
+  TEST_ASSERT_EQUAL (getaddrinfo ("unknown", "80", &hints, &info), EAI_NONAME);
+  hints.ai_flags = AI_NUMERICHOST;
+  TEST_ASSERT_EQUAL (getaddrinfo ("server", "80", &hints, &info), EAI_NONAME);
+
+  struct sockaddr_in addr;
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons (80);
+  inet_pton (AF_INET, "10.1.2.4", &addr.sin_addr);
+  char name[64];
+  char serv[16];
+  status = getnameinfo ((struct sockaddr *) &addr, sizeof (addr), name, sizeof (name),
+                        serv, sizeof (serv), NI_NUMERICSERV);
+  TEST_ASSERT_EQUAL (status, 0);
+  TEST_ASSERT_EQUAL (strcmp (name, "other"), 0);
+  TEST_ASSERT_EQUAL (strcmp (serv, "80"), 0);
+  inet_pton (AF_INET, "10.9.9.9", &addr.sin_addr);
+  status = getnameinfo ((struct sockaddr *) &addr, sizeof (addr), name, sizeof (name),
+                        0, 0, NI_NAMEREQD);
+  TEST_ASSERT_EQUAL (status, EAI_NONAME);
+
+  // a new file is read again.
+  write_file ("/etc/hosts", "10.1.2.5 unknown\n");
+  host = gethostbyname ("unknown");
+  TEST_ASSERT_UNEQUAL (host, 0);
+  TEST_ASSERT_EQUAL (gethostbyname ("server"), 0);
+  // localhost is always known.
+  TEST_ASSERT_UNEQUAL (gethostbyname ("localhost"), 0);
+  unlink ("/etc/hosts");
+}
+
+void test_services (void)
+{
+  write_file ("/etc/services", "myservice 4242/udp alias\n");
+  struct servent *serv = getservbyname ("alias", "udp");
+  TEST_ASSERT_UNEQUAL (serv, 0);
+  TEST_ASSERT_EQUAL (serv->s_port, htons (4242));
+  TEST_ASSERT_EQUAL (strcmp (serv->s_name, "myservice"), 0);
+  TEST_ASSERT_EQUAL (getservbyname ("alias", "tcp"), 0);
+  struct servent *byPort = getservbyport (htons (4242), 0);
+  TEST_ASSERT_UNEQUAL (byPort, 0);
+  TEST_ASSERT_EQUAL (strcmp (byPort->s_proto, "udp"), 0);
+  unlink ("/etc/services");
+}
+
+// A nameserver of the node which knows two names: dns.aa and dns.bb.
+static volatile bool g_dnsStop = false;
+
+static void *
+dns_server (void *arg)
+{
+  int sock = *(int *) arg;
+  while (!g_dnsStop)
+    {
+      struct pollfd pfd;
+      pfd.fd = sock;
+      pfd.events = POLLIN;
+      if (poll (&pfd, 1, 100) <= 0)
+        {
+          continue;
+        }
+      unsigned char msg[512];
+      struct sockaddr_in from;
+      socklen_t fromlen = sizeof (from);
+      ssize_t len = recvfrom (sock, msg, sizeof (msg) - 16, 0,
+                              (struct sockaddr *) &from, &fromlen);
+      TEST_ASSERT (len > 12);
+      // the question is the name and 4 bytes of type and class.
+      const char *name = (const char *) msg + 12;
+      int type = (msg[len - 4] << 8) | msg[len - 3];
+      const char *address = 0;
+      if (memcmp (name, "\3dns\2aa", 8) == 0)
+        {
+          address = "\x0a\x09\x08\x07";
+        }
+      else if (memcmp (name, "\3dns\2bb", 8) == 0)
+        {
+          address = "\x0a\x09\x08\x08";
+        }
+      msg[2] |= 0x80; // response
+      msg[3] = (address != 0) ? 0 : 3; // no such name
+      if (address != 0 && type == 1)
+        {
+          msg[7] = 1;
+          // the name of the question, type A, class IN, ttl 0.
+          const unsigned char rr[] = { 0xc0, 12, 0, 1, 0, 1, 0, 0, 0, 0, 0, 4 };
+          memcpy (msg + len, rr, sizeof (rr));
+          memcpy (msg + len + sizeof (rr), address, 4);
+          len += sizeof (rr) + 4;
+        }
+      ssize_t sent = sendto (sock, msg, len, 0, (struct sockaddr *) &from, fromlen);
+      TEST_ASSERT_EQUAL (sent, len);
+    }
+  return 0;
+}
+
+// the names which are not in /etc/hosts are asked to the nameserver.
+void test_dns (void)
+{
+  int sock = socket (AF_INET, SOCK_DGRAM, 0);
+  TEST_ASSERT (sock >= 0);
+  struct sockaddr_in addr;
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons (53);
+  inet_pton (AF_INET, "127.0.0.1", &addr.sin_addr);
+  int status = bind (sock, (struct sockaddr *) &addr, sizeof (addr));
+  TEST_ASSERT_EQUAL (status, 0);
+  pthread_t server;
+  status = pthread_create (&server, 0, dns_server, &sock);
+  TEST_ASSERT_EQUAL (status, 0);
+
+  write_file ("/etc/resolv.conf",
+              "nameserver 127.0.0.1\n"
+              "search aa\n"
+              "options timeout:1 attempts:1\n");
+  struct hostent *host = gethostbyname ("dns");
+  TEST_ASSERT_UNEQUAL (host, 0);
+  TEST_ASSERT_EQUAL (host->h_length, 4);
+  TEST_ASSERT_EQUAL (memcmp (host->h_addr_list[0], "\x0a\x09\x08\x07", 4), 0);
+  TEST_ASSERT_EQUAL (gethostbyname ("nx"), 0);
+
+  struct addrinfo hints;
+  memset (&hints, 0, sizeof (hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  struct addrinfo *info;
+  status = getaddrinfo ("dns.bb", "53", &hints, &info);
+  TEST_ASSERT_EQUAL (status, 0);
+  TEST_ASSERT_EQUAL (memcmp (&((struct sockaddr_in *) info->ai_addr)->sin_addr,
+                             "\x0a\x09\x08\x08", 4), 0);
+  freeaddrinfo (info);
+  TEST_ASSERT_EQUAL (getaddrinfo ("nx.aa", "53", &hints, &info), EAI_NONAME);
+
+  // rewritten at once with the same size: seen by its nanoseconds.
+  write_file ("/etc/resolv.conf",
+              "nameserver 127.0.0.1\n"
+              "search bb\n"
+              "options timeout:1 attempts:1\n");
+  host = gethostbyname ("dns");
+  TEST_ASSERT_UNEQUAL (host, 0);
+  TEST_ASSERT_EQUAL (memcmp (host->h_addr_list[0], "\x0a\x09\x08\x08", 4), 0);
+
+  unlink ("/etc/resolv.conf");
+  TEST_ASSERT_EQUAL (gethostbyname ("dns"), 0);
+  g_dnsStop = true;
+  status = pthread_join (server, 0);
+  TEST_ASSERT_EQUAL (status, 0);
+  close (sock);
+}
 
 int main (int argc, char *argv[])
 {
   test_gethostbyname ();
   test_gethostbyname2 ();
   test_getaddrinfo ();
+  test_hosts ();
+  test_services ();
+  test_dns ();
   return 0;
 }
@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <string>
+#include "test-macros.h"
+
+// The test runs with a base layer in a temporary directory, which has
+// /overlay/shared, /overlay/deleted and /overlay/dir/file, see
+// SetupOverlay in dce-manager-test.cc.
+
+static std::string
+read_file (const char *path)
+{
+  char buf[256];
+  int fd = open (path, O_RDONLY);
+  TEST_ASSERT (fd >= 0);
+  ssize_t len = read (fd, buf, sizeof (buf));
+  TEST_ASSERT (len >= 0);
+  close (fd);
+  return std::string (buf, len);
+}
+
+static int
+count_entries (const char *path, const char *name)
+{
+  DIR *dir = opendir (path);
+  TEST_ASSERT (dir != 0);
+  int count = 0;
+  struct dirent *entry;
+  while ((entry = readdir (dir)) != 0)
+    {
+      TEST_ASSERT_UNEQUAL (strncmp (entry->d_name, ".wh.", 4), 0);
+      if (strcmp (entry->d_name, name) == 0)
+        {
+          count++;
+        }
+    }
+  closedir (dir);
+  return count;
+}
+
+static void
+test_read (void)
+{
+  struct stat st;
+  TEST_ASSERT_EQUAL (stat ("/overlay/shared", &st), 0);
+  TEST_ASSERT_EQUAL (st.st_size, 5);
+  TEST_ASSERT (read_file ("/overlay/shared") == "base\n");
+  TEST_ASSERT_EQUAL (count_entries ("/overlay", "shared"), 1);
+}
+
+static void
+test_write (void)
+{
+  int fd = open ("/overlay/shared", O_WRONLY | O_APPEND);
+  TEST_ASSERT (fd >= 0);
+  TEST_ASSERT_EQUAL (write (fd, "node\n", 5), 5);
+  close (fd);
+  TEST_ASSERT (read_file ("/overlay/shared") == "base\nnode\n");
+  // listed once, from the node.
+  TEST_ASSERT_EQUAL (count_entries ("/overlay", "shared"), 1);
+
+  fd = open ("/overlay/dir/new", O_WRONLY | O_CREAT, 0644);
+  TEST_ASSERT (fd >= 0);
+  close (fd);
+  TEST_ASSERT_EQUAL (count_entries ("/overlay/dir", "file"), 1);
+  TEST_ASSERT_EQUAL (count_entries ("/overlay/dir", "new"), 1);
+}
+
+static void
+test_delete (void)
+{
+  struct stat st;
+  TEST_ASSERT_EQUAL (unlink ("/overlay/deleted"), 0);
+  TEST_ASSERT_EQUAL (stat ("/overlay/deleted", &st), -1);
+  TEST_ASSERT_EQUAL (errno, ENOENT);
+  TEST_ASSERT_EQUAL (open ("/overlay/deleted", O_RDONLY), -1);
+  TEST_ASSERT_EQUAL (count_entries ("/overlay", "deleted"), 0);
+  TEST_ASSERT_EQUAL (unlink ("/overlay/deleted"), -1);
+  TEST_ASSERT_EQUAL (errno, ENOENT);
+
+  // a new file, not the one of the base layer.
+  int fd = open ("/overlay/deleted", O_WRONLY | O_CREAT, 0644);
+  TEST_ASSERT (fd >= 0);
+  TEST_ASSERT_EQUAL (write (fd, "new\n", 4), 4);
+  close (fd);
+  TEST_ASSERT_EQUAL (stat ("/overlay/deleted", &st), 0);
+  TEST_ASSERT_EQUAL (st.st_size, 4);
+  TEST_ASSERT (read_file ("/overlay/deleted") == "new\n");
+  TEST_ASSERT_EQUAL (count_entries ("/overlay", "deleted"), 1);
+
+  TEST_ASSERT_EQUAL (rmdir ("/overlay/dir"), -1);
+  TEST_ASSERT_EQUAL (errno, ENOTEMPTY);
+  TEST_ASSERT_EQUAL (unlink ("/overlay/dir/file"), 0);
+  TEST_ASSERT_EQUAL (unlink ("/overlay/dir/new"), 0);
+  TEST_ASSERT_EQUAL (rmdir ("/overlay/dir"), 0);
+  TEST_ASSERT_EQUAL (count_entries ("/overlay", "dir"), 0);
+  TEST_ASSERT_EQUAL (mkdir ("/overlay/dir", 0755), 0);
+  TEST_ASSERT_EQUAL (count_entries ("/overlay/dir", "file"), 0);
+}
+
+static void
+test_rename (void)
+{
+  TEST_ASSERT_EQUAL (rename ("/overlay/shared", "/overlay/moved"), 0);
+  TEST_ASSERT_EQUAL (access ("/overlay/shared", F_OK), -1);
+  TEST_ASSERT (read_file ("/overlay/moved") == "base\nnode\n");
+}
+
+int main (int argc, char *argv[])
+{
+  test_read ();
+  test_write ();
+  test_delete ();
+  test_rename ();
+
+  exit (0);
+  // never reached.
+  return -1;
+}
@@ -14,6 +14,7 @@
 #include <fcntl.h>
 #include <poll.h>
 #include "test-macros.h"
+#include "test-many-pipes.h"
 #include <sys/un.h>
 
 static bool
@@ -801,6 +802,98 @@ server_last (void *arg)
   return arg;
 }
 
+// Test, poll over many fds with one of them becoming ready.
+static void
+test_poll_many (void)
+{
+  static struct pollfd fds[MANY_PIPES];
+  int status;
+
+  many_open ();
+  for (int i = 0; i < MANY_PIPES; i++)
+    {
+      fds[i].fd = g_manyPipes[i][0];
+      fds[i].events = POLLIN;
+    }
+
+  for (uint32_t p = 0; p < MANY_PICKS; p++)
+    {
+      pthread_t writer = many_start (g_manyPicks[p]);
+      status = poll (fds, MANY_PIPES, 10 * 1000);
+      TEST_ASSERT_EQUAL (status, 1);
+      for (int i = 0; i < MANY_PIPES; i++)
+        {
+          TEST_ASSERT_EQUAL (fds[i].revents, (i == g_manyPicks[p]) ? POLLIN : 0);
+        }
+      many_finish (writer, g_manyPicks[p]);
+    }
+
+  // nothing ready any more.
+  status = poll (fds, MANY_PIPES, 0);
+  TEST_ASSERT_EQUAL (status, 0);
+
+  many_close ();
+}
+
+// Test, a busy loop around poll with a 0 timeout or a non-blocking read
+// does not need an iteration per microsecond to see a write one second
+// later.
+static void *
+busy_writer (void *arg)
+{
+  int fd = *(int *) arg;
+
+  sleep (1);
+  int status = write (fd, "x", 1);
+  TEST_ASSERT_EQUAL (status, 1);
+
+  return arg;
+}
+
+static void
+test_poll_busy (void)
+{
+  int fds[2];
+  pthread_t writer;
+  long loops;
+  char c;
+
+  int status = pipe (fds);
+  TEST_ASSERT_EQUAL (status, 0);
+
+  status = pthread_create (&writer, NULL, busy_writer, &fds[1]);
+  TEST_ASSERT_EQUAL (status, 0);
+  struct pollfd fd;
+  fd.fd = fds[0];
+  fd.events = POLLIN;
+  for (loops = 0; poll (&fd, 1, 0) == 0; loops++)
+    {
+    }
+  printf ("test_poll_busy: poll %ld loops\n", loops);
+  TEST_ASSERT (loops < 100000);
+  TEST_ASSERT (fd.revents & POLLIN);
+  status = read (fds[0], &c, 1);
+  TEST_ASSERT_EQUAL (status, 1);
+  status = pthread_join (writer, NULL);
+  TEST_ASSERT_EQUAL (status, 0);
+
+  status = fcntl (fds[0], F_SETFL, O_NONBLOCK);
+  TEST_ASSERT_EQUAL (status, 0);
+  status = pthread_create (&writer, NULL, busy_writer, &fds[1]);
+  TEST_ASSERT_EQUAL (status, 0);
+  for (loops = 0; read (fds[0], &c, 1) < 0; loops++)
+    {
+      TEST_ASSERT_EQUAL (errno, EAGAIN);
+    }
+  printf ("test_poll_busy: read %ld loops\n", loops);
+  TEST_ASSERT (loops < 100000);
+  status = pthread_join (writer, NULL);
+  TEST_ASSERT_EQUAL (status, 0);
+
+  close (fds[0]);
+  close (fds[1]);
+}
+
 static void
 launch (void *(*clientStart)(void *), void *(*serverStart)(void *))
 {
@@ -845,6 +938,8 @@ main (int argc, char *argv[])
   launch (client5, server5);
   launch (client4, server4);
   launch (client6, server6);
+  test_poll_many ();
+  test_poll_busy ();
 
   launch (client_last, server_last);
 
@@ -1,6 +1,46 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include "test-macros.h"
 
+// sys/random.h is only in glibc 2.25 and later: the getrandom of DCE is
+// there anyway.
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25)
+#include <sys/random.h>
+#endif
+#ifndef GRND_NONBLOCK
+#define GRND_NONBLOCK 0x01
+#define GRND_RANDOM 0x02
+extern "C" ssize_t getrandom (void *buf, size_t buflen, unsigned int flags);
+#endif
+
+static void
+test_urandom (void)
+{
+  uint8_t a[4096];
+  uint8_t b[4096];
+  uint8_t zero[4096];
+  memset (zero, 0, sizeof (zero));
+
+  int fd = open ("/dev/urandom", O_RDONLY);
+  TEST_ASSERT (fd >= 0);
+  TEST_ASSERT_EQUAL (read (fd, a, sizeof (a)), sizeof (a));
+  TEST_ASSERT_EQUAL (read (fd, b, sizeof (b)), sizeof (b));
+  TEST_ASSERT_UNEQUAL (memcmp (a, b, sizeof (a)), 0);
+  TEST_ASSERT_UNEQUAL (memcmp (a, zero, sizeof (a)), 0);
+  close (fd);
+
+  TEST_ASSERT_EQUAL (getrandom (a, 1000, 0), 1000);
+  TEST_ASSERT_EQUAL (getrandom (b, 1000, GRND_NONBLOCK), 1000);
+  TEST_ASSERT_UNEQUAL (memcmp (a, b, 1000), 0);
+  TEST_ASSERT_EQUAL (getrandom (a, 1000, 0x100), -1);
+  TEST_ASSERT_EQUAL (errno, EINVAL);
+}
+
 int main (int argc, char *argv[])
 {
   srand (0);
@@ -10,6 +50,8 @@ int main (int argc, char *argv[])
   TEST_ASSERT_UNEQUAL (a, 0);
   TEST_ASSERT_UNEQUAL (a, b);
 
+  test_urandom ();
+
   exit (0);
   // never reached.
   return -1;
@@ -16,6 +16,7 @@
 #include <sys/un.h>
 
 #include "test-macros.h"
+#include "test-many-pipes.h"
 
 // test, that select () with timeout={0,0} exits immediately
 static void
@@ -852,6 +853,45 @@ static void test_select_timeout (void)
   
 }
 
+// Test, select over many fds with one of them becoming ready.
+static void
+test_select_many (void)
+{
+  int status;
+  int maxFd = 0;
+
+  many_open ();
+  for (int i = 0; i < MANY_PIPES; i++)
+    {
+      TEST_ASSERT (g_manyPipes[i][1] < FD_SETSIZE);
+      maxFd = g_manyPipes[i][1] > maxFd ? g_manyPipes[i][1] : maxFd;
+    }
+
+  for (uint32_t p = 0; p < MANY_PICKS; p++)
+    {
+      fd_set rFd;
+      FD_ZERO (&rFd);
+      for (int i = 0; i < MANY_PIPES; i++)
+        {
+          FD_SET (g_manyPipes[i][0], &rFd);
+        }
+      struct timeval timeOut;
+      timeOut.tv_sec = 10;
+      timeOut.tv_usec = 0;
+
+      pthread_t writer = many_start (g_manyPicks[p]);
+      status = select (maxFd + 1, &rFd, NULL, NULL, &timeOut);
+      TEST_ASSERT_EQUAL (status, 1);
+      for (int i = 0; i < MANY_PIPES; i++)
+        {
+          TEST_ASSERT_EQUAL (FD_ISSET (g_manyPipes[i][0], &rFd) != 0, i == g_manyPicks[p]);
+        }
+      many_finish (writer, g_manyPicks[p]);
+    }
+
+  many_close ();
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -873,6 +913,7 @@ main (int argc, char *argv[])
       launch (client4, server4);
       launch (client5, server5);
       launch (client6, server6);
+      test_select_many ();
     }
 
   printf ("test-select end.\n ");
@@ -0,0 +1,84 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include "test-macros.h"
+
+// The test runs with the SpinDetection attribute of the DceManager set
+// to false, see dce-manager-test.cc: each call without progress repeated
+// at the same time waits 1us, no more, and a busy loop still ends.
+
+static long long
+now_us (void)
+{
+  struct timeval tv;
+  int status = gettimeofday (&tv, 0);
+  TEST_ASSERT_EQUAL (status, 0);
+  return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+static void *
+late_writer (void *arg)
+{
+  int fd = *(int *) arg;
+
+  usleep (1000);
+  int status = write (fd, "x", 1);
+  TEST_ASSERT_EQUAL (status, 1);
+
+  return arg;
+}
+
+int main (int argc, char *argv[])
+{
+  int fds[2];
+  char c;
+
+  int status = pipe (fds);
+  TEST_ASSERT_EQUAL (status, 0);
+  status = fcntl (fds[0], F_SETFL, O_NONBLOCK);
+  TEST_ASSERT_EQUAL (status, 0);
+  struct pollfd fd;
+  fd.fd = fds[0];
+  fd.events = POLLIN;
+
+  long long start = now_us ();
+  for (int i = 0; i < 100; i++)
+    {
+      status = poll (&fd, 1, 0);
+      TEST_ASSERT_EQUAL (status, 0);
+      status = read (fds[0], &c, 1);
+      TEST_ASSERT_EQUAL (status, -1);
+      TEST_ASSERT_EQUAL (errno, EAGAIN);
+      status = sched_yield ();
+      TEST_ASSERT_EQUAL (status, 0);
+    }
+  // 300 calls, the first one maybe at a new time.
+  long long elapsed = now_us () - start;
+  TEST_ASSERT (elapsed == 299 || elapsed == 300);
+
+  // a busy loop around poll sees a write 1ms later.
+  pthread_t writer;
+  status = pthread_create (&writer, NULL, late_writer, &fds[1]);
+  TEST_ASSERT_EQUAL (status, 0);
+  long loops;
+  for (loops = 0; poll (&fd, 1, 0) == 0; loops++)
+    {
+    }
+  TEST_ASSERT (loops >= 999 && loops <= 1001);
+  status = read (fds[0], &c, 1);
+  TEST_ASSERT_EQUAL (status, 1);
+  status = pthread_join (writer, NULL);
+  TEST_ASSERT_EQUAL (status, 0);
+
+  close (fds[0]);
+  close (fds[1]);
+
+  exit (0);
+  // never reached.
+  return -1;
+}
@@ -0,0 +1,363 @@
+#include "test-macros.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+
+#define IN_PATH "/tmp/splice-in"
+#define OUT_PATH "/tmp/splice-out"
+#define LEN 100000
+
+static uint8_t g_data[LEN];
+
+static void
+fill (uint8_t *buf, size_t len, size_t offset)
+{
+  for (size_t i = 0; i < len; i++)
+    {
+      buf[i] = (uint8_t)((offset + i) % 251);
+    }
+}
+
+static void
+read_all (int fd, uint8_t *buf, size_t len)
+{
+  size_t done = 0;
+  while (done < len)
+    {
+      ssize_t r = read (fd, buf + done, len - done);
+      TEST_ASSERT (r > 0);
+      done += r;
+    }
+}
+
+static void
+test_pipe_size (void)
+{
+  int p[2];
+  TEST_ASSERT_EQUAL (pipe (p), 0);
+  TEST_ASSERT_EQUAL (fcntl (p[0], F_GETPIPE_SZ), 65536);
+  TEST_ASSERT_EQUAL (fcntl (p[1], F_SETPIPE_SZ, 100000), 131072);
+  TEST_ASSERT_EQUAL (fcntl (p[0], F_GETPIPE_SZ), 131072);
+
+  // the new capacity is usable at once.
+  TEST_ASSERT_EQUAL (fcntl (p[1], F_SETFL, O_NONBLOCK), 0);
+  size_t total = 0;
+  while (true)
+    {
+      ssize_t w = write (p[1], g_data, 4096);
+      if (w < 0)
+        {
+          TEST_ASSERT_EQUAL (errno, EAGAIN);
+          break;
+        }
+      total += w;
+    }
+  TEST_ASSERT_EQUAL (total, 131072);
+
+  // it can not shrink below its content.
+  TEST_ASSERT_EQUAL (fcntl (p[1], F_SETPIPE_SZ, 4096), -1);
+  TEST_ASSERT_EQUAL (errno, EBUSY);
+
+  close (p[0]);
+  close (p[1]);
+}
+
+static void
+test_pipe_to_pipe (void)
+{
+  int a[2], b[2], c[2];
+  uint8_t buf[LEN];
+  TEST_ASSERT_EQUAL (pipe (a), 0);
+  TEST_ASSERT_EQUAL (pipe (b), 0);
+  TEST_ASSERT_EQUAL (pipe (c), 0);
+
+  TEST_ASSERT_EQUAL (write (a[1], g_data, 10000), 10000);
+  // tee leaves the data in a.
+  TEST_ASSERT_EQUAL (tee (a[0], b[1], 10000, 0), 10000);
+  TEST_ASSERT_EQUAL (splice (a[0], NULL, c[1], NULL, 10000, 0), 10000);
+
+  read_all (b[0], buf, 10000);
+  TEST_ASSERT_EQUAL (memcmp (buf, g_data, 10000), 0);
+  read_all (c[0], buf, 10000);
+  TEST_ASSERT_EQUAL (memcmp (buf, g_data, 10000), 0);
+
+  // nothing left in a.
+  TEST_ASSERT_EQUAL (splice (a[0], NULL, c[1], NULL, 10000, SPLICE_F_NONBLOCK), -1);
+  TEST_ASSERT_EQUAL (errno, EAGAIN);
+
+  // pipes have no offset.
+  loff_t off = 0;
+  TEST_ASSERT_EQUAL (splice (a[0], &off, c[1], NULL, 10000, 0), -1);
+  TEST_ASSERT_EQUAL (errno, ESPIPE);
+
+  // end of file.
+  close (a[1]);
+  TEST_ASSERT_EQUAL (splice (a[0], NULL, c[1], NULL, 10000, 0), 0);
+
+  close (a[0]);
+  close (b[0]);
+  close (b[1]);
+  close (c[0]);
+  close (c[1]);
+}
+
+static void
+test_file (void)
+{
+  int p[2];
+  uint8_t buf[LEN];
+  TEST_ASSERT_EQUAL (pipe (p), 0);
+
+  int in = open (IN_PATH, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  TEST_ASSERT (in >= 0);
+  TEST_ASSERT_EQUAL (write (in, g_data, LEN), LEN);
+  int out = open (OUT_PATH, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  TEST_ASSERT (out >= 0);
+
+  // file -> pipe -> file, from offset 1000 to the end.
+  loff_t inOff = 1000;
+  size_t total = 0;
+  while (total < LEN - 1000)
+    {
+      ssize_t r = splice (in, &inOff, p[1], NULL, LEN, 0);
+      TEST_ASSERT (r > 0);
+      ssize_t w = 0;
+      while (w < r)
+        {
+          ssize_t l = splice (p[0], NULL, out, NULL, r - w, 0);
+          TEST_ASSERT (l > 0);
+          w += l;
+        }
+      total += r;
+    }
+  TEST_ASSERT_EQUAL (inOff, LEN);
+  // the offset given does not move the file.
+  TEST_ASSERT_EQUAL (lseek (in, 0, SEEK_CUR), LEN);
+
+  TEST_ASSERT_EQUAL (lseek (out, 0, SEEK_SET), 0);
+  read_all (out, buf, LEN - 1000);
+  TEST_ASSERT_EQUAL (memcmp (buf, g_data + 1000, LEN - 1000), 0);
+
+  // one of the two must be a pipe.
+  TEST_ASSERT_EQUAL (splice (in, NULL, out, NULL, 10, 0), -1);
+  TEST_ASSERT_EQUAL (errno, EINVAL);
+
+  close (in);
+  close (out);
+  close (p[0]);
+  close (p[1]);
+  unlink (IN_PATH);
+  unlink (OUT_PATH);
+}
+
+static void
+test_vmsplice (void)
+{
+  int p[2];
+  uint8_t buf[LEN];
+  TEST_ASSERT_EQUAL (pipe (p), 0);
+
+  struct iovec iov[2];
+  iov[0].iov_base = g_data;
+  iov[0].iov_len = 3000;
+  iov[1].iov_base = g_data + 3000;
+  iov[1].iov_len = 5000;
+  TEST_ASSERT_EQUAL (vmsplice (p[1], iov, 2, 0), 8000);
+  read_all (p[0], buf, 8000);
+  TEST_ASSERT_EQUAL (memcmp (buf, g_data, 8000), 0);
+
+  close (p[0]);
+  close (p[1]);
+}
+
+// The pages a splice holds while its output blocks keep their room in
+// the pipe: a writer finds it full until they are written.
+static int g_held[2];
+static int g_out[2];
+
+static void *
+held_splicer (void *arg)
+{
+  size_t moved = 0;
+  while (moved < 65536)
+    {
+      ssize_t r = splice (g_held[0], NULL, g_out[0], NULL, 65536 - moved, 0);
+      TEST_ASSERT (r > 0);
+      moved += r;
+    }
+  return arg;
+}
+
+static void
+test_held (void)
+{
+  uint8_t buf[LEN];
+  pthread_t splicer;
+  TEST_ASSERT_EQUAL (pipe (g_held), 0);
+  TEST_ASSERT_EQUAL (socketpair (AF_UNIX, SOCK_STREAM, 0, g_out), 0);
+
+  // the socket is full, then the pipe.
+  TEST_ASSERT_EQUAL (fcntl (g_out[0], F_SETFL, O_NONBLOCK), 0);
+  memset (buf, 0xff, sizeof (buf));
+  size_t filled = 0;
+  while (true)
+    {
+      ssize_t w = write (g_out[0], buf, 4096);
+      if (w < 0)
+        {
+          TEST_ASSERT_EQUAL (errno, EAGAIN);
+          break;
+        }
+      filled += w;
+    }
+  TEST_ASSERT_EQUAL (fcntl (g_out[0], F_SETFL, 0), 0);
+  TEST_ASSERT_EQUAL (write (g_held[1], g_data, 65536), 65536);
+
+  TEST_ASSERT_EQUAL (pthread_create (&splicer, NULL, held_splicer, 0), 0);
+  sleep (1);
+  TEST_ASSERT_EQUAL (fcntl (g_held[1], F_SETFL, O_NONBLOCK), 0);
+  TEST_ASSERT_EQUAL (write (g_held[1], g_data, 4096), -1);
+  TEST_ASSERT_EQUAL (errno, EAGAIN);
+
+  // the data comes out once, in order.
+  size_t left = filled;
+  while (left > 0)
+    {
+      ssize_t r = read (g_out[1], buf, left < sizeof (buf) ? left : sizeof (buf));
+      TEST_ASSERT (r > 0);
+      left -= r;
+    }
+  read_all (g_out[1], buf, 65536);
+  TEST_ASSERT_EQUAL (memcmp (buf, g_data, 65536), 0);
+  TEST_ASSERT_EQUAL (pthread_join (splicer, NULL), 0);
+  TEST_ASSERT_EQUAL (write (g_held[1], g_data, 65536), 65536);
+
+  close (g_held[0]);
+  close (g_held[1]);
+  close (g_out[0]);
+  close (g_out[1]);
+}
+
+// A cat | filter | cat pipeline made of three threads: the filter moves
+// the data from a pipe to the other with read and write or with splice.
+// A few times the capacity of the pipes, for the writers to block. The
+// cost of the filter is measured by example/libc-bench.cc.
+static size_t g_total = 4 * 65536 + 1000;
+static int g_first[2];
+static int g_second[2];
+static bool g_useSplice;
+
+static void *
+source (void *arg)
+{
+  uint8_t *buf = (uint8_t *) malloc (65536);
+  for (size_t sent = 0; sent < g_total; )
+    {
+      size_t len = (g_total - sent < 65536) ? g_total - sent : 65536;
+      fill (buf, len, sent);
+      ssize_t w = write (g_first[1], buf, len);
+      TEST_ASSERT (w > 0);
+      sent += w;
+    }
+  free (buf);
+  close (g_first[1]);
+  return arg;
+}
+
+static void *
+filter (void *arg)
+{
+  uint8_t *buf = (uint8_t *) malloc (65536);
+  while (true)
+    {
+      ssize_t r;
+      if (g_useSplice)
+        {
+          r = splice (g_first[0], NULL, g_second[1], NULL, 65536, 0);
+        }
+      else
+        {
+          r = read (g_first[0], buf, 65536);
+          for (ssize_t w = 0; w < r; )
+            {
+              ssize_t l = write (g_second[1], buf + w, r - w);
+              TEST_ASSERT (l > 0);
+              w += l;
+            }
+        }
+      TEST_ASSERT (r >= 0);
+      if (r == 0)
+        {
+          break;
+        }
+    }
+  free (buf);
+  close (g_first[0]);
+  close (g_second[1]);
+  return arg;
+}
+
+static void *
+sink (void *arg)
+{
+  uint8_t *buf = (uint8_t *) malloc (65536);
+  uint8_t *expected = (uint8_t *) malloc (65536);
+  size_t received = 0;
+  while (true)
+    {
+      ssize_t r = read (g_second[0], buf, 65536);
+      TEST_ASSERT (r >= 0);
+      if (r == 0)
+        {
+          break;
+        }
+      fill (expected, r, received);
+      TEST_ASSERT_EQUAL (memcmp (buf, expected, r), 0);
+      received += r;
+    }
+  TEST_ASSERT_EQUAL (received, g_total);
+  free (expected);
+  free (buf);
+  close (g_second[0]);
+  return arg;
+}
+
+static void
+test_pipeline (bool useSplice)
+{
+  pthread_t threads[3];
+  g_useSplice = useSplice;
+  TEST_ASSERT_EQUAL (pipe (g_first), 0);
+  TEST_ASSERT_EQUAL (pipe (g_second), 0);
+
+  TEST_ASSERT_EQUAL (pthread_create (&threads[0], NULL, sink, 0), 0);
+  TEST_ASSERT_EQUAL (pthread_create (&threads[1], NULL, filter, 0), 0);
+  TEST_ASSERT_EQUAL (pthread_create (&threads[2], NULL, source, 0), 0);
+  for (int i = 0; i < 3; i++)
+    {
+      TEST_ASSERT_EQUAL (pthread_join (threads[i], NULL), 0);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  fill (g_data, sizeof (g_data), 0);
+  test_pipe_size ();
+  test_pipe_to_pipe ();
+  test_file ();
+  test_vmsplice ();
+  test_held ();
+  test_pipeline (false);
+  test_pipeline (true);
+  return 0;
+}
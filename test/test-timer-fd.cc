@@ -8,6 +8,9 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stdint.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
 #include "test-macros.h"
 
 static void test_file (void)
@@ -87,6 +90,51 @@ static void test_timerfd (void)
   TEST_ASSERT_EQUAL (status, 0);
 }
 
+static void test_periodic (void)
+{
+  int fd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK);
+  TEST_ASSERT_UNEQUAL (fd, -1);
+
+  struct itimerspec new_value;
+  new_value.it_value.tv_sec = 0;
+  new_value.it_value.tv_nsec = 10000000;
+  new_value.it_interval.tv_sec = 0;
+  new_value.it_interval.tv_nsec = 10000000;
+  int status = timerfd_settime (fd, 0, &new_value, 0);
+  TEST_ASSERT_EQUAL (status, 0);
+
+  // all the expirations of the last second are counted.
+  sleep (1);
+  uint64_t buf;
+  ssize_t bytes_read = read (fd, &buf, 8);
+  TEST_ASSERT_EQUAL (bytes_read, 8);
+  TEST_ASSERT_EQUAL (buf, 100);
+  bytes_read = read (fd, &buf, 8);
+  TEST_ASSERT_EQUAL (bytes_read, -1);
+  TEST_ASSERT_EQUAL (errno, EAGAIN);
+
+  struct pollfd fds;
+  fds.fd = fd;
+  fds.events = POLLIN;
+  fds.revents = 0;
+  status = poll (&fds, 1, 1000);
+  TEST_ASSERT_EQUAL (status, 1);
+  TEST_ASSERT (fds.revents & POLLIN);
+  bytes_read = read (fd, &buf, 8);
+  TEST_ASSERT_EQUAL (bytes_read, 8);
+  TEST_ASSERT_EQUAL (buf, 1);
+
+  struct itimerspec cur_value;
+  status = timerfd_gettime (fd, &cur_value);
+  TEST_ASSERT_EQUAL (status, 0);
+  TEST_ASSERT_EQUAL (cur_value.it_value.tv_sec, 0);
+  TEST_ASSERT (cur_value.it_value.tv_nsec <= 10000000);
+  TEST_ASSERT_EQUAL (cur_value.it_interval.tv_nsec, 10000000);
+
+  status = close (fd);
+  TEST_ASSERT_EQUAL (status, 0);
+}
+
 static void test_otherops (void)
 {
   int fd = timerfd_create (CLOCK_MONOTONIC, 0);
@@ -120,6 +168,15 @@ static void test_otherops (void)
   TEST_ASSERT_EQUAL (status, -1);
   TEST_ASSERT_EQUAL (errno, EINVAL);
 
+  status = fcntl (fd, F_SETFD, FD_CLOEXEC);
+  TEST_ASSERT_EQUAL (status, 0);
+  status = fcntl (fd, F_GETFD);
+  TEST_ASSERT_EQUAL (status, FD_CLOEXEC);
+  // not a command of timers.
+  status = fcntl (fd, 0x7fff);
+  TEST_ASSERT_EQUAL (status, -1);
+  TEST_ASSERT_EQUAL (errno, EINVAL);
+
   // Why this is so is beyond me but it's legal to call
   // fstat on a timer fd.
   struct stat stbuf;
@@ -131,12 +188,54 @@ static void test_otherops (void)
 }
 
 
+static int g_closed;
+
+static void *
+blocked_reader (void *arg)
+{
+  uint64_t buf;
+  ssize_t bytes_read = read (g_closed, &buf, 8);
+  TEST_ASSERT_EQUAL (bytes_read, -1);
+  TEST_ASSERT_EQUAL (errno, EBADF);
+  return arg;
+}
+
+// closing the fd wakes up a reader blocked on it, long before the timer
+// would expire.
+static void test_close (void)
+{
+  g_closed = timerfd_create (CLOCK_MONOTONIC, 0);
+  TEST_ASSERT_UNEQUAL (g_closed, -1);
+
+  struct itimerspec new_value;
+  new_value.it_value.tv_sec = 100;
+  new_value.it_value.tv_nsec = 0;
+  new_value.it_interval.tv_sec = 0;
+  new_value.it_interval.tv_nsec = 0;
+  int status = timerfd_settime (g_closed, 0, &new_value, 0);
+  TEST_ASSERT_EQUAL (status, 0);
+
+  time_t start = time (0);
+  pthread_t reader;
+  status = pthread_create (&reader, NULL, blocked_reader, 0);
+  TEST_ASSERT_EQUAL (status, 0);
+  sleep (1);
+  status = close (g_closed);
+  TEST_ASSERT_EQUAL (status, 0);
+  status = pthread_join (reader, NULL);
+  TEST_ASSERT_EQUAL (status, 0);
+  TEST_ASSERT (time (0) - start < 100);
+}
+
+
 
 
 int main (int argc, char *argv[])
 {
   test_timerfd ();
+  test_periodic ();
   test_otherops ();
+  test_close ();
   test_file ();
 
   return 0;
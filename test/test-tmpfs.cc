@@ -0,0 +1,203 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "test-macros.h"
+
+// The test runs with a Tmpfs of 64 pages mounted on /tmpfs, see
+// dce-manager-test.cc.
+
+static int
+count_entries (const char *path, const char *name)
+{
+  DIR *dir = opendir (path);
+  TEST_ASSERT (dir != 0);
+  int count = 0;
+  struct dirent *entry;
+  while ((entry = readdir (dir)) != 0)
+    {
+      if (strcmp (entry->d_name, name) == 0)
+        {
+          count++;
+        }
+    }
+  closedir (dir);
+  return count;
+}
+
+static void
+test_file (void)
+{
+  char buf[16];
+  struct stat st;
+  int fd = open ("/tmpfs/file", O_RDWR | O_CREAT | O_EXCL, 0644);
+  TEST_ASSERT (fd >= 0);
+  TEST_ASSERT_EQUAL (write (fd, "hello", 5), 5);
+  TEST_ASSERT_EQUAL (lseek (fd, 0, SEEK_SET), 0);
+  TEST_ASSERT_EQUAL (read (fd, buf, sizeof (buf)), 5);
+  TEST_ASSERT_EQUAL (memcmp (buf, "hello", 5), 0);
+  TEST_ASSERT_EQUAL (fstat (fd, &st), 0);
+  TEST_ASSERT (S_ISREG (st.st_mode));
+  TEST_ASSERT_EQUAL (st.st_size, 5);
+  close (fd);
+
+  TEST_ASSERT_EQUAL (open ("/tmpfs/file", O_RDWR | O_CREAT | O_EXCL, 0644), -1);
+  TEST_ASSERT_EQUAL (errno, EEXIST);
+  TEST_ASSERT_EQUAL (open ("/tmpfs/none", O_RDONLY), -1);
+  TEST_ASSERT_EQUAL (errno, ENOENT);
+
+  // append and relative paths.
+  fd = open ("/tmpfs/./../tmpfs/file", O_WRONLY | O_APPEND);
+  TEST_ASSERT (fd >= 0);
+  TEST_ASSERT_EQUAL (write (fd, " world", 6), 6);
+  close (fd);
+  TEST_ASSERT_EQUAL (stat ("/tmpfs/file", &st), 0);
+  TEST_ASSERT_EQUAL (st.st_size, 11);
+  TEST_ASSERT_EQUAL (access ("/tmpfs/file", R_OK), 0);
+
+  // not on the disk of the host.
+  TEST_ASSERT_EQUAL (access ("/tmp/file", F_OK), -1);
+}
+
+static void
+test_sparse (void)
+{
+  char buf[4];
+  struct stat st;
+  int fd = open ("/tmpfs/sparse", O_RDWR | O_CREAT | O_TRUNC, 0644);
+  TEST_ASSERT (fd >= 0);
+  TEST_ASSERT_EQUAL (lseek (fd, 1 << 20, SEEK_SET), 1 << 20);
+  TEST_ASSERT_EQUAL (write (fd, "end", 3), 3);
+  TEST_ASSERT_EQUAL (fstat (fd, &st), 0);
+  TEST_ASSERT_EQUAL (st.st_size, (1 << 20) + 3);
+  // one page, not 257.
+  TEST_ASSERT_EQUAL (st.st_blocks, 4096 / 512);
+  TEST_ASSERT_EQUAL (lseek (fd, 4096, SEEK_SET), 4096);
+  TEST_ASSERT_EQUAL (read (fd, buf, 4), 4);
+  TEST_ASSERT_EQUAL (memcmp (buf, "\0\0\0\0", 4), 0);
+  TEST_ASSERT_EQUAL (ftruncate (fd, 2), 0);
+  TEST_ASSERT_EQUAL (fstat (fd, &st), 0);
+  TEST_ASSERT_EQUAL (st.st_size, 2);
+  close (fd);
+  TEST_ASSERT_EQUAL (unlink ("/tmpfs/sparse"), 0);
+}
+
+static void
+test_full (void)
+{
+  char page[4096];
+  memset (page, 'x', sizeof (page));
+  int fd = open ("/tmpfs/big", O_WRONLY | O_CREAT, 0644);
+  TEST_ASSERT (fd >= 0);
+  ssize_t written;
+  int pages = 0;
+  while ((written = write (fd, page, sizeof (page))) == sizeof (page))
+    {
+      pages++;
+    }
+  TEST_ASSERT_EQUAL (written, -1);
+  TEST_ASSERT_EQUAL (errno, ENOSPC);
+  // /tmpfs/file uses one page.
+  TEST_ASSERT_EQUAL (pages, 63);
+  close (fd);
+  // the pages come back.
+  TEST_ASSERT_EQUAL (unlink ("/tmpfs/big"), 0);
+  fd = open ("/tmpfs/big", O_WRONLY | O_CREAT, 0644);
+  TEST_ASSERT (fd >= 0);
+  TEST_ASSERT_EQUAL (write (fd, page, sizeof (page)), sizeof (page));
+  close (fd);
+  TEST_ASSERT_EQUAL (unlink ("/tmpfs/big"), 0);
+}
+
+// an unlinked file keeps its pages until it is closed.
+static void
+test_unlinked (void)
+{
+  char page[4096];
+  memset (page, 'x', sizeof (page));
+  int held = open ("/tmpfs/held", O_RDWR | O_CREAT, 0644);
+  TEST_ASSERT (held >= 0);
+  for (int i = 0; i < 10; i++)
+    {
+      TEST_ASSERT_EQUAL (write (held, page, sizeof (page)), sizeof (page));
+    }
+  TEST_ASSERT_EQUAL (unlink ("/tmpfs/held"), 0);
+
+  int fd = open ("/tmpfs/big", O_WRONLY | O_CREAT, 0644);
+  TEST_ASSERT (fd >= 0);
+  int pages = 0;
+  while (write (fd, page, sizeof (page)) == sizeof (page))
+    {
+      pages++;
+    }
+  TEST_ASSERT_EQUAL (errno, ENOSPC);
+  // /tmpfs/file uses one page, the unlinked file 10.
+  TEST_ASSERT_EQUAL (pages, 53);
+  // still readable.
+  char c;
+  TEST_ASSERT_EQUAL (pread (held, &c, 1, 0), 1);
+  TEST_ASSERT_EQUAL (c, 'x');
+  close (held);
+  // its pages come back once closed.
+  TEST_ASSERT_EQUAL (write (fd, page, sizeof (page)), sizeof (page));
+  close (fd);
+  TEST_ASSERT_EQUAL (unlink ("/tmpfs/big"), 0);
+}
+
+static void
+test_dir (void)
+{
+  struct stat st;
+  TEST_ASSERT_EQUAL (mkdir ("/tmpfs/dir", 0755), 0);
+  TEST_ASSERT_EQUAL (mkdir ("/tmpfs/dir", 0755), -1);
+  TEST_ASSERT_EQUAL (errno, EEXIST);
+  TEST_ASSERT_EQUAL (stat ("/tmpfs/dir", &st), 0);
+  TEST_ASSERT (S_ISDIR (st.st_mode));
+  int fd = open ("/tmpfs/dir/file", O_WRONLY | O_CREAT, 0644);
+  TEST_ASSERT (fd >= 0);
+  close (fd);
+  TEST_ASSERT_EQUAL (count_entries ("/tmpfs", "dir"), 1);
+  TEST_ASSERT_EQUAL (count_entries ("/tmpfs/dir", "file"), 1);
+  TEST_ASSERT_EQUAL (count_entries ("/tmpfs", "file"), 1);
+
+  TEST_ASSERT_EQUAL (rmdir ("/tmpfs/dir"), -1);
+  TEST_ASSERT_EQUAL (errno, ENOTEMPTY);
+  // siblings which sort between dir and its entries.
+  TEST_ASSERT_EQUAL (mkdir ("/tmpfs/dir.bak", 0755), 0);
+  fd = open ("/tmpfs/dir-x", O_WRONLY | O_CREAT, 0644);
+  TEST_ASSERT (fd >= 0);
+  close (fd);
+  TEST_ASSERT_EQUAL (rmdir ("/tmpfs/dir"), -1);
+  TEST_ASSERT_EQUAL (errno, ENOTEMPTY);
+  TEST_ASSERT_EQUAL (rmdir ("/tmpfs/dir.bak"), 0);
+  TEST_ASSERT_EQUAL (unlink ("/tmpfs/dir-x"), 0);
+  TEST_ASSERT_EQUAL (rename ("/tmpfs/dir", "/tmpfs/moved"), 0);
+  TEST_ASSERT_EQUAL (access ("/tmpfs/moved/file", F_OK), 0);
+  TEST_ASSERT_EQUAL (access ("/tmpfs/dir/file", F_OK), -1);
+  TEST_ASSERT_EQUAL (rename ("/tmpfs/moved/file", "/tmp/file"), -1);
+  TEST_ASSERT_EQUAL (errno, EXDEV);
+
+  TEST_ASSERT_EQUAL (chdir ("/tmpfs/moved"), 0);
+  TEST_ASSERT_EQUAL (remove ("file"), 0);
+  TEST_ASSERT_EQUAL (chdir ("/"), 0);
+  TEST_ASSERT_EQUAL (remove ("/tmpfs/moved"), 0);
+  TEST_ASSERT_EQUAL (count_entries ("/tmpfs", "moved"), 0);
+}
+
+int main (int argc, char *argv[])
+{
+  test_file ();
+  test_sparse ();
+  test_full ();
+  test_unlinked ();
+  test_dir ();
+
+  exit (0);
+  // never reached.
+  return -1;
+}
@@ -0,0 +1,42 @@
+#!/bin/sh
+# How linear-udp-perf scales with the number of nodes, and with the
+# number of ranks its chain is partitioned on: linear-udp-perf-mpi, one
+# host process per rank. Needs ./waf configure --enable-mpi. Run from the
+# top directory of ns-3-dce, in ./waf shell:
+#
+#   ./utils/linear-udp-perf-scaling.sh > scaling.csv
+#
+# Each line gives the wall time of one run, and what linear-udp-perf-mpi
+# prints: the lookahead of the ranks and the packets per second.
+
+cd `dirname $0`/../
+
+OUTPUT="output/scaling-`date \"+%y%m%d_%H%M\"`"
+SIZES=${SIZES:-"2 4 8 16 32 64 128"}
+RANKS=${RANKS:-"1 2 4 `nproc`"}
+DURATION=${DURATION:-10}
+DELAY=${DELAY:-1ms}
+FIBER=${FIBER:-UcontextFiberManager}
+MPIRUN=${MPIRUN:-mpirun}
+RUN="`pwd`/build/bin/linear-udp-perf-mpi"
+
+mkdir -p ${OUTPUT}
+echo "ranks,n nodes,wall(s),lookahead(ms),run wall(s),pps"
+
+for ranks in $RANKS
+do
+for size in $SIZES
+do
+# the ranks of a run share its directory, for the files-N of their nodes.
+DIR=${OUTPUT}/$ranks-$size
+mkdir -p $DIR
+START=`date +%s.%N`
+( cd $DIR && \
+  NS_ATTRIBUTE_DEFAULT="ns3::TaskManager::FiberManagerType=$FIBER" \
+  $MPIRUN -np $ranks $RUN --Size=$size --Duration=${DURATION}s --Delay=$DELAY > stdout 2> stderr )
+END=`date +%s.%N`
+WALL=`echo "$START $END" | awk '{printf "%.3f", $2 - $1}'`
+RESULT=`tail -n 1 $DIR/stdout | cut -d, -f3-5`
+echo "$ranks,$size,$WALL,$RESULT"
+done
+done